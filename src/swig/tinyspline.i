@@ -97,6 +97,18 @@
 %ignore tsError;
 %ignore tsStatus;
 %ignore tsDeBoorNet;
+%ignore tsTask;
+%ignore tsExecutor;
+%ignore tsEvalPlan;
+%ignore tsStreamFitter;
+%ignore tsArcLengthTable;
+%ignore tsProjector;
+%ignore tsBSplineCollection;
+%ignore tsBSplineSurface;
+%ignore tsAllocator;
+%ignore tsArena;
+%ignore ts_bspline_write_json;
+%ignore ts_bspline_read_json;
 %ignore tinyspline::DeBoorNet::data;
 %ignore tsBSpline;
 %ignore tinyspline::BSpline::data;
@@ -1,12 +1,119 @@
 #include "tinyspline.h"
-#include "parson.h" /* serialization */
 
 #include <stdlib.h> /* malloc, free */
 #include <math.h>   /* fabs, sqrt */
+#include <float.h>  /* FLT_EPSILON, DBL_EPSILON */
 #include <string.h> /* memcpy, memmove, strcmp */
-#include <stdio.h>  /* FILE, fopen */
+#include <stdio.h>  /* FILE, fopen, sprintf */
 #include <stdarg.h> /* varargs */
 
+/* SIMD instruction sets used by the evaluation kernels. SSE2 and NEON are
+ * selected at compile time, AVX is detected at runtime (GCC and Clang only).
+ * Define TINYSPLINE_DISABLE_SIMD to use the scalar kernels only. */
+#ifndef TINYSPLINE_DISABLE_SIMD
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TS_INT_SSE2
+#include <emmintrin.h>
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__clang__) || \
+	__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define TS_INT_AVX
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define TS_INT_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+/* Number of knots evaluated simultaneously by ts_int_bspline_eval_lanes
+ * (256 bit). */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_LANES 8
+#else
+#define TS_INT_LANES 4
+#endif
+
+/* Machine epsilon of tsReal. */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_REAL_EPSILON FLT_EPSILON
+#else
+#define TS_INT_REAL_EPSILON DBL_EPSILON
+#endif
+
+/* Number of knots evaluated by a single task of
+ * ts_bspline_eval_all_parallel. */
+#define TS_INT_TASK_SIZE 2048
+
+/* Number of splines of a group of a tsBSplineCollection that are evaluated
+ * by a single task of ts_bsplinecollection_eval. */
+#define TS_INT_COLLECTION_TILE 256
+
+/* Maximum number of knots of the splines of a group of a tsBSplineCollection
+ * whose spans are located by counting (rather than by binary search). */
+#define TS_INT_COLLECTION_SCAN 64
+
+/* Number of rows of a grid that are evaluated by a single task of
+ * ts_bsplinesurface_eval_grid. */
+#define TS_INT_SURFACE_ROWS 16
+
+/* Number of columns of the control net that are solved for by a single task
+ * of ts_bsplinesurface_loft. */
+#define TS_INT_LOFT_COLUMNS 256
+
+/* Number of Bezier segments that are elevated or reduced by a single task of
+ * ts_bspline_elevate_degree and ts_bspline_reduce_degree. */
+#define TS_INT_DEGREE_SEGMENTS 64
+
+/* Number of values of the workspace that ts_bspline_eval_point keeps on the
+ * stack if no workspace is passed. */
+#define TS_INT_EVAL_STACK 64
+
+/* Default capacity (in bytes) of the first block of a tsArena. */
+#define TS_INT_ARENA_CAPACITY 65536
+
+/* Alignment (in bytes) of the chunks of a tsArena. */
+#define TS_INT_ARENA_ALIGN sizeof(union tsArenaAlign)
+
+/* Significant digits of tsReal that are always preserved when converting
+ * decimals to tsReal and back (TS_INT_REAL_DIG), and that are required to
+ * convert any tsReal to a decimal and back (TS_INT_REAL_DIG_MAX). */
+#ifdef TINYSPLINE_FLOAT_PRECISION
+#define TS_INT_REAL_DIG FLT_DIG
+#define TS_INT_REAL_DIG_MAX 9
+#else
+#define TS_INT_REAL_DIG DBL_DIG
+#define TS_INT_REAL_DIG_MAX 17
+#endif
+
+/* Maximum nesting of unknown values skipped by the JSON parser. */
+#define TS_INT_JSON_DEPTH 64
+
+/* Layout of the binary format (cf. ts_bspline_save_binary). The header
+ * stores little endian integers, the control points and knots start at
+ * offset TS_INT_BINARY_DATA. The space between the header and the data is
+ * used by ts_bspline_map_binary to place the impl of the mapped spline. */
+#define TS_INT_BINARY_MAGIC "TSBS"
+#define TS_INT_BINARY_VERSION 1
+#define TS_INT_BINARY_HEADER 52
+#define TS_INT_BINARY_DATA 256
+#define TS_INT_BINARY_LITTLE 1
+#define TS_INT_BINARY_BIG 2
+
+/* Memory-mapped files used by ts_bspline_map_binary. */
+#ifdef TINYSPLINE_HAVE_MMAP
+#include <sys/mman.h> /* mmap, munmap */
+#include <sys/stat.h> /* fstat */
+#include <fcntl.h>    /* open */
+#include <unistd.h>   /* close */
+#endif
+
+/* POSIX threads used by ts_executor_default. */
+#ifdef TINYSPLINE_HAVE_PTHREAD
+#include <pthread.h>
+#include <unistd.h> /* sysconf */
+#endif
+
 /* Suppress some useless MSVC warnings. */
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -42,6 +149,7 @@ struct tsBSplineImpl
 	size_t dim; /**< Dimension of control points (2D => x, y) */
 	size_t n_ctrlp; /**< Number of control points. */
 	size_t n_knots; /**< Number of knots (n_ctrlp + deg + 1). */
+	tsAllocator allocator; /**< Allocator of this object. */
 };
 
 /**
@@ -55,6 +163,212 @@ struct tsDeBoorNetImpl
 	size_t h; /**< Number of insertions required to obtain result. */
 	size_t dim; /**< Dimension of points. (2D => x, y) */
 	size_t n_points; /** Number of points in 'points'. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * Stores the private data of a ::tsEvalPlan. The impl is followed by the
+ * index of the first control point of each knot (size_t), the knot vector of
+ * the corresponding spline, and 'order' weights for each knot.
+ */
+struct tsEvalPlanImpl
+{
+	size_t deg; /**< Degree of the corresponding spline. */
+	size_t n_ctrlp; /**< Number of control points of the spline. */
+	size_t n_knots; /**< Number of knots of the spline. */
+	size_t n_points; /**< Number of evaluated knots. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * Stores the private data of a ::tsStreamFitter. The impl is followed by the
+ * window of (at most) 2 * lookahead + 1 recent points, the corresponding
+ * values of the forward sweep of the Thomas algorithm (the modified right-hand
+ * sides and the modified upper diagonal), and the solution of the back
+ * substitution. The solution of the first point of the window is final.
+ */
+struct tsStreamFitterImpl
+{
+	size_t dim; /**< Dimension of points. */
+	size_t lookahead; /**< Number of points required to finalize. */
+	size_t n_points; /**< Number of pushed points. */
+	size_t len; /**< Number of points in the window. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * Stores the private data of a ::tsArcLengthTable. The impl is followed by
+ * the span of the first derivative of each interval (cf.
+ * ts_int_arclengthtable_speed), the state of the first derivative of the
+ * corresponding spline (cf. ts_int_bspline_sof_state), the knots of the
+ * table entries, the cumulative lengths of the table entries, and the start
+ * and end speed of each interval. Entry i (i > 0) describes the interval
+ * between the knots of entry i-1 and i.
+ */
+struct tsArcLengthTableImpl
+{
+	size_t n_entries; /**< Number of table entries. */
+	size_t sof_deriv; /**< Size of the state of the derivative. */
+	tsReal epsilon; /**< Tolerance of the lengths. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * Stores the private data of a ::tsProjector. The impl is followed by the
+ * domain (minimum and maximum knot) of each Bezier segment, the power basis
+ * coefficients of each segment ('order' points per segment), the Bezier
+ * control points of each segment ('order' points per segment), and the
+ * bounding boxes (minimum and maximum) of the 2 * n_segs - 1 nodes of the
+ * bounding volume hierarchy (cf. ts_int_projector_build).
+ */
+struct tsProjectorImpl
+{
+	size_t deg; /**< Degree of the segments. */
+	size_t dim; /**< Dimension of the segments. */
+	size_t n_segs; /**< Number of Bezier segments. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * Stores the private data of a ::tsBSplineCollection. The impl is followed by
+ * the groups of the collection (cf. tsBSplineGroup) and the arrays of the
+ * groups. Each part is aligned to TS_INT_ARENA_ALIGN.
+ */
+struct tsBSplineCollectionImpl
+{
+	size_t n_splines; /**< Number of splines. */
+	size_t len_points; /**< Sum of the dimensions of the splines. */
+	size_t n_groups; /**< Number of groups. */
+	size_t n_tiles; /**< Number of tiles of all groups. */
+	size_t max_dim; /**< Maximum dimension of the splines. */
+	size_t max_order; /**< Maximum order of the splines. */
+	size_t size; /**< Size of the impl including all groups and arrays. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * A group of a ::tsBSplineCollection, i.e., the splines of a collection with
+ * equal degree, dimension, and number of control points. The arrays of a
+ * group are referenced by their offset (in bytes) relative to the impl of
+ * the collection so that collections can be copied with memcpy. The control
+ * points are stored as structure of arrays: value d of control point j of
+ * the i-th spline of the group is located at ctrlp[(j * dim + d) * n + i],
+ * where n is the number of splines of the group. Thus, the splines of a group
+ * are evaluated with contiguous loops (cf. ts_int_bsplinegroup_eval_tile).
+ * The groups are split into tiles of TS_INT_COLLECTION_TILE splines.
+ */
+struct tsBSplineGroup
+{
+	size_t deg; /**< Degree of the splines. */
+	size_t dim; /**< Dimension of the splines. */
+	size_t n_ctrlp; /**< Number of control points of each spline. */
+	size_t n_splines; /**< Number of splines. */
+	int shared; /**< Whether all splines have the same knot vector. */
+	size_t first_tile; /**< Index of the first tile of the group. */
+	size_t indices; /**< Index of each spline in the collection. */
+	size_t offsets; /**< Offset of the point of each spline. */
+	size_t ctrlp; /**< The control points of the splines. */
+	size_t knots; /**< The knot vectors (just one if shared). */
+};
+
+/**
+ * Stores the private data of a ::tsBSplineSurface. The impl is followed by
+ * the control net (cf. tsBSplineSurface), the knot vector in u direction,
+ * and the knot vector in v direction.
+ */
+struct tsBSplineSurfaceImpl
+{
+	size_t deg_u; /**< Degree in u direction. */
+	size_t deg_v; /**< Degree in v direction. */
+	size_t dim; /**< Dimension of the control points. */
+	size_t n_ctrlp_u; /**< Number of control points in u direction. */
+	size_t n_ctrlp_v; /**< Number of control points in v direction. */
+	tsAllocator allocator; /**< Allocator of this object. */
+};
+
+/**
+ * A block of memory of a ::tsArena. The block is followed by 'capacity'
+ * bytes, of which the first 'used' bytes are allocated. Each allocation is
+ * preceded by a header (cf. ts_int_arena_allocate) storing its size.
+ */
+struct tsArenaBlock
+{
+	struct tsArenaBlock *next; /**< The previous block (or NULL). */
+	size_t capacity; /**< Number of bytes of this block. */
+	size_t used; /**< Number of allocated bytes of this block. */
+};
+
+/**
+ * Stores the private data of a ::tsArena. Allocations are served from the
+ * most recent block.
+ */
+struct tsArenaImpl
+{
+	struct tsArenaBlock *blocks; /**< The most recent block. */
+};
+
+/**
+ * Precedes the allocations of ts_int_mapped_allocate. Splines that have been
+ * loaded with ts_bspline_map_binary store the address and length of their
+ * mapping, heap allocations store a length of 0.
+ */
+struct tsMappedHeader
+{
+	void *base; /**< Address of the mapping. */
+	size_t len; /**< Length of the mapping (0 if allocated). */
+};
+
+/**
+ * The output of the JSON serializer, which is either a file or a growing
+ * buffer.
+ */
+struct tsJsonWriter
+{
+	FILE *file; /**< Output file (NULL to write into buf). */
+	char *buf; /**< Output buffer (allocated with malloc). */
+	size_t len; /**< Number of characters in buf. */
+	size_t cap; /**< Capacity of buf. */
+	int failed; /**< Whether writing failed. */
+};
+
+/**
+ * The input of the JSON parser, which is either a file or a string.
+ */
+struct tsJsonReader
+{
+	FILE *file; /**< Input file (NULL to read from str). */
+	const char *str; /**< Input string. */
+	char buf[4096]; /**< Characters read from file. */
+	size_t pos; /**< Position of the next character. */
+	size_t len; /**< Number of characters in buf. */
+};
+
+/**
+ * The header of a binary spline file (cf. ts_bspline_save_binary).
+ */
+struct tsBinaryHeader
+{
+	int endianness; /**< Byte order of the data. */
+	size_t sof_real; /**< Size of the reals of the data. */
+	size_t offset; /**< Offset of the data in the file. */
+	size_t deg; /**< Degree of the spline. */
+	size_t dim; /**< Dimension of the spline. */
+	size_t n_ctrlp; /**< Number of control points. */
+	size_t n_knots; /**< Number of knots. */
+	unsigned long checksum; /**< Adler-32 of the data. */
+};
+
+/**
+ * The alignment of the allocations of a ::tsArena, which is sufficient for
+ * all data types of TinySpline.
+ */
+union tsArenaAlign
+{
+	long double ld;
+	double d;
+	long l;
+	void *p;
+	void (*f)(void);
 };
 
 
@@ -64,6 +378,111 @@ struct tsDeBoorNetImpl
 * :: Forward Declarations & Internal Utility Functions                        *
 *                                                                             *
 ******************************************************************************/
+void * ts_int_default_allocate(void *ctx, size_t size)
+{
+	(void) ctx;
+	return malloc(size);
+}
+
+void * ts_int_default_reallocate(void *ctx, void *ptr, size_t size)
+{
+	(void) ctx;
+	return realloc(ptr, size);
+}
+
+void ts_int_default_deallocate(void *ctx, void *ptr)
+{
+	(void) ctx;
+	free(ptr);
+}
+
+/* The global allocator (cf. ts_allocator_set_global). */
+static tsAllocator ts_int_allocator = {
+	ts_int_default_allocate,
+	ts_int_default_reallocate,
+	ts_int_default_deallocate,
+	NULL
+};
+
+/* Allocates temporary buffers with the global allocator. Buffers that are
+ * returned to the caller must be allocated with malloc instead. */
+void * ts_int_malloc(size_t size)
+{
+	return ts_int_allocator.allocate(ts_int_allocator.ctx, size);
+}
+
+void * ts_int_realloc(void *ptr, size_t size)
+{
+	return ts_int_allocator.reallocate(ts_int_allocator.ctx, ptr, size);
+}
+
+void ts_int_free(void *ptr)
+{
+	if (ptr)
+		ts_int_allocator.deallocate(ts_int_allocator.ctx, ptr);
+}
+
+/* Returns \p allocator or, if \p allocator is NULL, the global allocator. */
+tsAllocator ts_int_allocator_or_global(const tsAllocator *allocator)
+{
+	return allocator ? *allocator : ts_int_allocator;
+}
+
+/* Returns whether \p allocator is the default allocator (malloc, realloc,
+ * and free), which, unlike arenas, is thread-safe. */
+int ts_int_allocator_is_default(const tsAllocator *allocator)
+{
+	return allocator->allocate == ts_int_default_allocate &&
+		allocator->reallocate == ts_int_default_reallocate &&
+		allocator->deallocate == ts_int_default_deallocate;
+}
+
+/* Allocates the impl of an object with \p allocator. */
+void * ts_int_allocate(const tsAllocator *allocator, size_t size)
+{
+	return allocator->allocate(allocator->ctx, size);
+}
+
+/* Releases the impl \p impl of an object, which has been allocated with
+ * \p allocator. The allocator is passed by value because it is usually
+ * stored in \p impl. */
+void ts_int_deallocate(tsAllocator allocator, void *impl)
+{
+	allocator.deallocate(allocator.ctx, impl);
+}
+
+/* Rounds \p size up to a multiple of TS_INT_ARENA_ALIGN. */
+size_t ts_int_arena_round(size_t size)
+{
+	return (size + TS_INT_ARENA_ALIGN - 1) / TS_INT_ARENA_ALIGN *
+		TS_INT_ARENA_ALIGN;
+}
+
+char * ts_int_arena_block_data(struct tsArenaBlock *block)
+{
+	return (char *) block + ts_int_arena_round(sizeof(struct tsArenaBlock));
+}
+
+/* Allocates a block of \p capacity bytes that precedes \p next. The memory
+ * of an arena is always allocated with malloc. */
+struct tsArenaBlock * ts_int_arena_block_new(size_t capacity,
+	struct tsArenaBlock *next)
+{
+	struct tsArenaBlock *block = (struct tsArenaBlock *) malloc(
+		ts_int_arena_round(sizeof(struct tsArenaBlock)) + capacity);
+	if (block) {
+		block->next = next;
+		block->capacity = capacity;
+		block->used = 0;
+	}
+	return block;
+}
+
+void ts_int_arena_init(tsArena *arena)
+{
+	arena->pImpl = NULL;
+}
+
 void ts_int_bspline_init(tsBSpline *_spline_)
 {
 	_spline_->pImpl = NULL;
@@ -121,9 +540,10 @@ void ts_int_deboornet_init(tsDeBoorNet *_deBoorNet_)
 
 size_t ts_int_deboornet_sof_state(const tsDeBoorNet *net)
 {
+	/* The result is stored in 'points' (cf.
+	 * ts_int_deboornet_access_result). */
 	return sizeof(struct tsDeBoorNetImpl) +
-		ts_deboornet_sof_points(net) +
-		ts_deboornet_sof_result(net);
+		ts_deboornet_sof_points(net);
 }
 
 tsReal * ts_int_deboornet_access_points(const tsDeBoorNet *net)
@@ -143,6 +563,234 @@ tsReal * ts_int_deboornet_access_result(const tsDeBoorNet *net)
 	}
 }
 
+void ts_int_evalplan_init(tsEvalPlan *plan)
+{
+	plan->pImpl = NULL;
+}
+
+size_t ts_int_evalplan_sof_state(const tsEvalPlan *plan)
+{
+	const struct tsEvalPlanImpl *impl = plan->pImpl;
+	return sizeof(struct tsEvalPlanImpl) +
+		impl->n_points * sizeof(size_t) +
+		(impl->n_knots + impl->n_points * (impl->deg + 1)) *
+		sizeof(tsReal);
+}
+
+size_t * ts_int_evalplan_access_first(const tsEvalPlan *plan)
+{
+	return (size_t *) (& plan->pImpl[1]);
+}
+
+tsReal * ts_int_evalplan_access_knots(const tsEvalPlan *plan)
+{
+	return (tsReal *) (ts_int_evalplan_access_first(plan) +
+		plan->pImpl->n_points);
+}
+
+tsReal * ts_int_evalplan_access_weights(const tsEvalPlan *plan)
+{
+	return ts_int_evalplan_access_knots(plan) + plan->pImpl->n_knots;
+}
+
+void ts_int_streamfitter_init(tsStreamFitter *fitter)
+{
+	fitter->pImpl = NULL;
+}
+
+size_t ts_int_streamfitter_capacity(const tsStreamFitter *fitter)
+{
+	return 2 * fitter->pImpl->lookahead + 1;
+}
+
+size_t ts_int_streamfitter_sof_state(const tsStreamFitter *fitter)
+{
+	const size_t cap = ts_int_streamfitter_capacity(fitter);
+	return sizeof(struct tsStreamFitterImpl) +
+		(3 * cap * fitter->pImpl->dim + cap) * sizeof(tsReal);
+}
+
+tsReal * ts_int_streamfitter_access_points(const tsStreamFitter *fitter)
+{
+	return (tsReal *) (& fitter->pImpl[1]);
+}
+
+tsReal * ts_int_streamfitter_access_rhs(const tsStreamFitter *fitter)
+{
+	return ts_int_streamfitter_access_points(fitter) +
+		ts_int_streamfitter_capacity(fitter) * fitter->pImpl->dim;
+}
+
+tsReal * ts_int_streamfitter_access_solution(const tsStreamFitter *fitter)
+{
+	return ts_int_streamfitter_access_rhs(fitter) +
+		ts_int_streamfitter_capacity(fitter) * fitter->pImpl->dim;
+}
+
+tsReal * ts_int_streamfitter_access_upper(const tsStreamFitter *fitter)
+{
+	return ts_int_streamfitter_access_solution(fitter) +
+		ts_int_streamfitter_capacity(fitter) * fitter->pImpl->dim;
+}
+
+void ts_int_arclengthtable_init(tsArcLengthTable *table)
+{
+	table->pImpl = NULL;
+}
+
+size_t ts_int_arclengthtable_sof_state(const tsArcLengthTable *table)
+{
+	return sizeof(struct tsArcLengthTableImpl) +
+		table->pImpl->n_entries * sizeof(size_t) +
+		table->pImpl->sof_deriv +
+		4 * table->pImpl->n_entries * sizeof(tsReal);
+}
+
+size_t * ts_int_arclengthtable_access_spans(const tsArcLengthTable *table)
+{
+	return (size_t *) (& table->pImpl[1]);
+}
+
+/* Makes \p deriv a (read-only) view of the derivative stored in \p table.
+ * \p deriv must not be freed. */
+void ts_int_arclengthtable_access_deriv(const tsArcLengthTable *table,
+	tsBSpline *deriv)
+{
+	deriv->pImpl = (struct tsBSplineImpl *)
+		(ts_int_arclengthtable_access_spans(table) +
+		table->pImpl->n_entries);
+}
+
+tsReal * ts_int_arclengthtable_access_knots(const tsArcLengthTable *table)
+{
+	return (tsReal *) ((char *) (ts_int_arclengthtable_access_spans(table) +
+		table->pImpl->n_entries) + table->pImpl->sof_deriv);
+}
+
+tsReal * ts_int_arclengthtable_access_lengths(const tsArcLengthTable *table)
+{
+	return ts_int_arclengthtable_access_knots(table) +
+		table->pImpl->n_entries;
+}
+
+tsReal * ts_int_arclengthtable_access_speeds(const tsArcLengthTable *table)
+{
+	return ts_int_arclengthtable_access_lengths(table) +
+		table->pImpl->n_entries;
+}
+
+void ts_int_projector_init(tsProjector *projector)
+{
+	projector->pImpl = NULL;
+}
+
+size_t ts_int_projector_sof_state(const tsProjector *projector)
+{
+	const size_t n_segs = projector->pImpl->n_segs;
+	const size_t order = projector->pImpl->deg + 1;
+	const size_t dim = projector->pImpl->dim;
+	return sizeof(struct tsProjectorImpl) + (2 * n_segs +
+		2 * n_segs * order * dim + (2 * n_segs - 1) * 2 * dim) *
+		sizeof(tsReal);
+}
+
+tsReal * ts_int_projector_access_domains(const tsProjector *projector)
+{
+	return (tsReal *) (& projector->pImpl[1]);
+}
+
+tsReal * ts_int_projector_access_coeffs(const tsProjector *projector)
+{
+	return ts_int_projector_access_domains(projector) +
+		2 * projector->pImpl->n_segs;
+}
+
+tsReal * ts_int_projector_access_ctrlp(const tsProjector *projector)
+{
+	return ts_int_projector_access_coeffs(projector) +
+		projector->pImpl->n_segs * (projector->pImpl->deg + 1) *
+		projector->pImpl->dim;
+}
+
+tsReal * ts_int_projector_access_boxes(const tsProjector *projector)
+{
+	return ts_int_projector_access_ctrlp(projector) +
+		projector->pImpl->n_segs * (projector->pImpl->deg + 1) *
+		projector->pImpl->dim;
+}
+
+void ts_int_bsplinecollection_init(tsBSplineCollection *collection)
+{
+	collection->pImpl = NULL;
+}
+
+/* Returns the address at \p offset (in bytes) relative to \p impl. */
+void * ts_int_bsplinecollection_at(
+	const struct tsBSplineCollectionImpl *impl, size_t offset)
+{
+	return (char *) impl + offset;
+}
+
+struct tsBSplineGroup * ts_int_bsplinecollection_access_groups(
+	const struct tsBSplineCollectionImpl *impl)
+{
+	return (struct tsBSplineGroup *) ts_int_bsplinecollection_at(impl,
+		ts_int_arena_round(sizeof(struct tsBSplineCollectionImpl)));
+}
+
+void ts_int_bsplinesurface_init(tsBSplineSurface *surface)
+{
+	surface->pImpl = NULL;
+}
+
+size_t ts_int_bsplinesurface_len_ctrlp(
+	const struct tsBSplineSurfaceImpl *impl)
+{
+	return impl->n_ctrlp_u * impl->n_ctrlp_v * impl->dim;
+}
+
+/* Returns the size (in bytes) of \p impl including its control net and knot
+ * vectors. */
+size_t ts_int_bsplinesurface_sof_impl(
+	const struct tsBSplineSurfaceImpl *impl)
+{
+	return sizeof(struct tsBSplineSurfaceImpl) +
+		(ts_int_bsplinesurface_len_ctrlp(impl) +
+		impl->n_ctrlp_u + impl->deg_u + 1 +
+		impl->n_ctrlp_v + impl->deg_v + 1) * sizeof(tsReal);
+}
+
+tsReal * ts_int_bsplinesurface_access_ctrlp(const tsBSplineSurface *surface)
+{
+	return (tsReal *) (& surface->pImpl[1]);
+}
+
+tsReal * ts_int_bsplinesurface_access_knots_u(
+	const tsBSplineSurface *surface)
+{
+	return ts_int_bsplinesurface_access_ctrlp(surface) +
+		ts_int_bsplinesurface_len_ctrlp(surface->pImpl);
+}
+
+tsReal * ts_int_bsplinesurface_access_knots_v(
+	const tsBSplineSurface *surface)
+{
+	return ts_int_bsplinesurface_access_knots_u(surface) +
+		ts_bsplinesurface_num_knots_u(surface);
+}
+
+tsError ts_int_bspline_find_knot_from(const tsBSpline *spline, tsReal knot,
+	size_t *index, size_t *multiplicity, tsStatus *status);
+
+void ts_int_bspline_basis(const tsBSpline *spline, tsReal u, size_t k,
+	size_t s, size_t *first, tsReal *weights, tsReal *scratch);
+
+tsError ts_int_knots_span(const tsReal *knots, size_t deg, size_t n_ctrlp,
+	tsReal u, size_t *k, tsStatus *status);
+
+void ts_int_knots_basis_derivs(const tsReal *knots, size_t deg, tsReal u,
+	size_t k, tsReal *values, tsReal *derivs, tsReal *scratch);
+
 
 
 /******************************************************************************
@@ -273,39 +921,106 @@ tsError ts_bspline_set_control_point_at(tsBSpline *spline, size_t index,
 	TS_END_TRY_RETURN(err)
 }
 
-size_t ts_bspline_num_knots(const tsBSpline *spline)
-{
-	return spline->pImpl->n_knots;
-}
-
-size_t ts_bspline_sof_knots(const tsBSpline *spline)
-{
-	return ts_bspline_num_knots(spline) * sizeof(tsReal);
-}
-
-tsError ts_bspline_knots(const tsBSpline *spline, tsReal **knots,
+/* Checks whether \p spline can be interpreted as rational spline, i.e.,
+ * whether its control points have a weight and at least one coordinate. */
+tsError ts_int_bspline_check_rational(const tsBSpline *spline,
 	tsStatus *status)
 {
-	const size_t size = ts_bspline_sof_knots(spline);
-	*knots = (tsReal*) malloc(size);
-	if (!*knots)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-	memcpy(*knots, ts_int_bspline_access_knots(spline), size);
+	if (ts_bspline_dimension(spline) < 2) {
+		TS_RETURN_0(status, TS_DIM_ZERO,
+			"rational splines require a dimension >= 2")
+	}
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_knot_at(const tsBSpline *spline, size_t index, tsReal *knot,
-	tsStatus *status)
+tsError ts_bspline_rational_control_points(const tsBSpline *spline,
+	tsReal **ctrlp, tsReal **weights, tsStatus *status)
 {
-	return ts_int_bspline_access_knot_at(spline, index, knot, status);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num = ts_bspline_num_control_points(spline);
+	const tsReal *from = ts_int_bspline_access_ctrlp(spline);
+	size_t i, d;
+	tsError err;
+
+	*ctrlp = *weights = NULL;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_int_bspline_check_rational(
+			spline, status))
+		*ctrlp = (tsReal *) malloc(num * (dim-1) * sizeof(tsReal));
+		*weights = (tsReal *) malloc(num * sizeof(tsReal));
+		if (!*ctrlp || !*weights) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		for (i = 0; i < num; i++) {
+			(*weights)[i] = from[i * dim + dim-1];
+			for (d = 0; d < dim-1; d++) {
+				(*ctrlp)[i * (dim-1) + d] =
+					from[i * dim + d] / (*weights)[i];
+			}
+		}
+	TS_CATCH(err)
+		if (*ctrlp)
+			free(*ctrlp);
+		if (*weights)
+			free(*weights);
+		*ctrlp = *weights = NULL;
+	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
+tsError ts_bspline_set_rational_control_points(tsBSpline *spline,
+	const tsReal *ctrlp, const tsReal *weights, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num = ts_bspline_num_control_points(spline);
+	tsReal *to = ts_int_bspline_access_ctrlp(spline);
+	size_t i, d;
+	tsError err;
+
+	TS_CALL_ROE(err, ts_int_bspline_check_rational(spline, status))
+	for (i = 0; i < num; i++) {
+		for (d = 0; d < dim-1; d++) {
+			to[i * dim + d] =
+				ctrlp[i * (dim-1) + d] * weights[i];
+		}
+		to[i * dim + dim-1] = weights[i];
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+size_t ts_bspline_num_knots(const tsBSpline *spline)
+{
+	return spline->pImpl->n_knots;
+}
+
+size_t ts_bspline_sof_knots(const tsBSpline *spline)
+{
+	return ts_bspline_num_knots(spline) * sizeof(tsReal);
+}
+
+tsError ts_bspline_knots(const tsBSpline *spline, tsReal **knots,
 	tsStatus *status)
 {
 	const size_t size = ts_bspline_sof_knots(spline);
-	const size_t num_knots = ts_bspline_num_knots(spline);
-	const size_t order = ts_bspline_order(spline);
+	*knots = (tsReal*) malloc(size);
+	if (!*knots)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(*knots, ts_int_bspline_access_knots(spline), size);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_knot_at(const tsBSpline *spline, size_t index, tsReal *knot,
+	tsStatus *status)
+{
+	return ts_int_bspline_access_knot_at(spline, index, knot, status);
+}
+
+/* Checks whether the knot vector \p knots (with \p num_knots values) of a
+ * spline of order \p order is sorted and whether the multiplicity of its
+ * knots does not exceed \p order. */
+tsError ts_int_knots_check(const tsReal *knots, size_t num_knots,
+	size_t order, tsStatus *status)
+{
 	size_t idx, mult;
 	tsReal lst_knot, knot;
 	lst_knot = knots[0];
@@ -319,7 +1034,7 @@ tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
 				"decreasing knot vector at index: %lu",
 				(unsigned long) idx)
 		} else {
-			mult = 0;
+			mult = 1;
 		}
 		if (mult > order) {
 			TS_RETURN_3(status, TS_MULTIPLICITY,
@@ -329,6 +1044,17 @@ tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
 		}
 		lst_knot = knot;
 	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_set_knots(tsBSpline *spline, const tsReal *knots,
+	tsStatus *status)
+{
+	const size_t size = ts_bspline_sof_knots(spline);
+	tsError err;
+	TS_CALL_ROE(err, ts_int_knots_check(knots,
+		ts_bspline_num_knots(spline), ts_bspline_order(spline),
+		status))
 	memmove(ts_int_bspline_access_knots(spline), knots, size);
 	TS_RETURN_SUCCESS(status)
 }
@@ -463,6 +1189,193 @@ tsError ts_deboornet_result(const tsDeBoorNet *net, tsReal **result,
 	TS_RETURN_SUCCESS(status)
 }
 
+/* ------------------------------------------------------------------------- */
+
+size_t ts_evalplan_num_points(const tsEvalPlan *plan)
+{
+	return plan->pImpl->n_points;
+}
+
+size_t ts_evalplan_degree(const tsEvalPlan *plan)
+{
+	return plan->pImpl->deg;
+}
+
+size_t ts_evalplan_num_control_points(const tsEvalPlan *plan)
+{
+	return plan->pImpl->n_ctrlp;
+}
+
+/* ------------------------------------------------------------------------- */
+
+size_t ts_streamfitter_dimension(const tsStreamFitter *fitter)
+{
+	return fitter->pImpl->dim;
+}
+
+size_t ts_streamfitter_num_points(const tsStreamFitter *fitter)
+{
+	return fitter->pImpl->n_points;
+}
+
+/* ------------------------------------------------------------------------- */
+
+size_t ts_arclengthtable_num_entries(const tsArcLengthTable *table)
+{
+	return table->pImpl->n_entries;
+}
+
+tsReal ts_arclengthtable_length(const tsArcLengthTable *table)
+{
+	return ts_int_arclengthtable_access_lengths(table)[
+		table->pImpl->n_entries - 1];
+}
+
+/* ------------------------------------------------------------------------- */
+
+size_t ts_projector_dimension(const tsProjector *projector)
+{
+	return projector->pImpl->dim;
+}
+
+size_t ts_projector_num_segments(const tsProjector *projector)
+{
+	return projector->pImpl->n_segs;
+}
+
+/* ------------------------------------------------------------------------- */
+
+size_t ts_bsplinecollection_num_splines(
+	const tsBSplineCollection *collection)
+{
+	return collection->pImpl->n_splines;
+}
+
+size_t ts_bsplinecollection_num_groups(
+	const tsBSplineCollection *collection)
+{
+	return collection->pImpl->n_groups;
+}
+
+size_t ts_bsplinecollection_len_points(
+	const tsBSplineCollection *collection)
+{
+	return collection->pImpl->len_points;
+}
+
+/* ------------------------------------------------------------------------- */
+
+size_t ts_bsplinesurface_degree_u(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->deg_u;
+}
+
+size_t ts_bsplinesurface_degree_v(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->deg_v;
+}
+
+size_t ts_bsplinesurface_dimension(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->dim;
+}
+
+size_t ts_bsplinesurface_num_control_points_u(
+	const tsBSplineSurface *surface)
+{
+	return surface->pImpl->n_ctrlp_u;
+}
+
+size_t ts_bsplinesurface_num_control_points_v(
+	const tsBSplineSurface *surface)
+{
+	return surface->pImpl->n_ctrlp_v;
+}
+
+size_t ts_bsplinesurface_len_control_points(const tsBSplineSurface *surface)
+{
+	return ts_int_bsplinesurface_len_ctrlp(surface->pImpl);
+}
+
+size_t ts_bsplinesurface_num_knots_u(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->n_ctrlp_u + surface->pImpl->deg_u + 1;
+}
+
+size_t ts_bsplinesurface_num_knots_v(const tsBSplineSurface *surface)
+{
+	return surface->pImpl->n_ctrlp_v + surface->pImpl->deg_v + 1;
+}
+
+tsError ts_bsplinesurface_control_points(const tsBSplineSurface *surface,
+	tsReal **ctrlp, tsStatus *status)
+{
+	const size_t size = ts_bsplinesurface_len_control_points(surface) *
+		sizeof(tsReal);
+	*ctrlp = (tsReal*) malloc(size);
+	if (!*ctrlp)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(*ctrlp, ts_int_bsplinesurface_access_ctrlp(surface), size);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bsplinesurface_set_control_points(tsBSplineSurface *surface,
+	const tsReal *ctrlp, tsStatus *status)
+{
+	const size_t size = ts_bsplinesurface_len_control_points(surface) *
+		sizeof(tsReal);
+	memmove(ts_int_bsplinesurface_access_ctrlp(surface), ctrlp, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bsplinesurface_knots_u(const tsBSplineSurface *surface,
+	tsReal **knots, tsStatus *status)
+{
+	const size_t size = ts_bsplinesurface_num_knots_u(surface) *
+		sizeof(tsReal);
+	*knots = (tsReal*) malloc(size);
+	if (!*knots)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(*knots, ts_int_bsplinesurface_access_knots_u(surface), size);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bsplinesurface_knots_v(const tsBSplineSurface *surface,
+	tsReal **knots, tsStatus *status)
+{
+	const size_t size = ts_bsplinesurface_num_knots_v(surface) *
+		sizeof(tsReal);
+	*knots = (tsReal*) malloc(size);
+	if (!*knots)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(*knots, ts_int_bsplinesurface_access_knots_v(surface), size);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bsplinesurface_set_knots_u(tsBSplineSurface *surface,
+	const tsReal *knots, tsStatus *status)
+{
+	const size_t num_knots = ts_bsplinesurface_num_knots_u(surface);
+	tsError err;
+	TS_CALL_ROE(err, ts_int_knots_check(knots, num_knots,
+		surface->pImpl->deg_u + 1, status))
+	memmove(ts_int_bsplinesurface_access_knots_u(surface), knots,
+		num_knots * sizeof(tsReal));
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bsplinesurface_set_knots_v(tsBSplineSurface *surface,
+	const tsReal *knots, tsStatus *status)
+{
+	const size_t num_knots = ts_bsplinesurface_num_knots_v(surface);
+	tsError err;
+	TS_CALL_ROE(err, ts_int_knots_check(knots, num_knots,
+		surface->pImpl->deg_v + 1, status))
+	memmove(ts_int_bsplinesurface_access_knots_v(surface), knots,
+		num_knots * sizeof(tsReal));
+	TS_RETURN_SUCCESS(status)
+}
+
 
 
 /******************************************************************************
@@ -477,15 +1390,14 @@ tsBSpline ts_bspline_init()
 	return spline;
 }
 
-tsError ts_int_bspline_generate_knots(const tsBSpline *spline,
+/* Fills the knot vector \p knots (with \p n_knots values) of a spline of
+ * degree \p deg according to \p type. */
+tsError ts_int_knots_generate(tsReal *knots, size_t n_knots, size_t deg,
 	tsBSplineType type, tsStatus *status)
 {
-	const size_t n_knots = ts_bspline_num_knots(spline);
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t order = ts_bspline_order(spline);
+	const size_t order = deg + 1;
 	tsReal fac; /**< Factor used to calculate the knot values. */
 	size_t i; /**< Used in for loops. */
-	tsReal *knots; /**< Pointer to the knots of \p _result_. */
 
 	/* order >= 1 implies 2*order >= 2 implies n_knots >= 2 */
 	if (type == TS_BEZIERS && n_knots % order != 0) {
@@ -494,8 +1406,6 @@ tsError ts_int_bspline_generate_knots(const tsBSpline *spline,
 			(unsigned long) n_knots, (unsigned long) order)
 	}
 
-	knots = ts_int_bspline_access_knots(spline);
-
 	if (type == TS_OPENED) {
 		knots[0] = TS_DOMAIN_DEFAULT_MIN; /* n_knots >= 2 */
 		fac = (TS_DOMAIN_DEFAULT_MAX - TS_DOMAIN_DEFAULT_MIN)
@@ -524,9 +1434,26 @@ tsError ts_int_bspline_generate_knots(const tsBSpline *spline,
 	TS_RETURN_SUCCESS(status)
 }
 
+tsError ts_int_bspline_generate_knots(const tsBSpline *spline,
+	tsBSplineType type, tsStatus *status)
+{
+	return ts_int_knots_generate(ts_int_bspline_access_knots(spline),
+		ts_bspline_num_knots(spline), ts_bspline_degree(spline), type,
+		status);
+}
+
 tsError ts_bspline_new(size_t num_control_points, size_t dimension,
 	size_t degree, tsBSplineType type, tsBSpline *spline, tsStatus *status)
 {
+	return ts_bspline_new_with_allocator(num_control_points, dimension,
+		degree, type, NULL, spline, status);
+}
+
+tsError ts_bspline_new_with_allocator(size_t num_control_points,
+	size_t dimension, size_t degree, tsBSplineType type,
+	const tsAllocator *allocator, tsBSpline *spline, tsStatus *status)
+{
+	const tsAllocator alloc = ts_int_allocator_or_global(allocator);
 	const size_t order = degree + 1;
 	const size_t num_knots = num_control_points + order;
 	const size_t len_ctrlp = num_control_points * dimension;
@@ -555,10 +1482,12 @@ tsError ts_bspline_new(size_t num_control_points, size_t dimension,
 			(unsigned long) num_control_points)
 	}
 
-	spline->pImpl = (struct tsBSplineImpl *) malloc(sof_spline);
+	spline->pImpl = (struct tsBSplineImpl *) ts_int_allocate(
+		&alloc, sof_spline);
 	if (!spline->pImpl)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 
+	spline->pImpl->allocator = alloc;
 	spline->pImpl->deg = degree;
 	spline->pImpl->dim = dimension;
 	spline->pImpl->n_ctrlp = num_control_points;
@@ -608,13 +1537,31 @@ tsError ts_bspline_copy(const tsBSpline *src, tsBSpline *dest,
 		TS_RETURN_SUCCESS(status)
 	ts_int_bspline_init(dest);
 	size = ts_int_bspline_sof_state(src);
-	dest->pImpl = (struct tsBSplineImpl *) malloc(size);
+	dest->pImpl = (struct tsBSplineImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
 	if (!dest->pImpl)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	memcpy(dest->pImpl, src->pImpl, size);
 	TS_RETURN_SUCCESS(status)
 }
 
+tsError ts_bspline_copy_with_allocator(const tsBSpline *src,
+	const tsAllocator *allocator, tsBSpline *dest, tsStatus *status)
+{
+	const tsAllocator alloc = ts_int_allocator_or_global(allocator);
+	const size_t size = ts_int_bspline_sof_state(src);
+	struct tsBSplineImpl *impl;
+	impl = (struct tsBSplineImpl *) ts_int_allocate(&alloc, size);
+	if (!impl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(impl, src->pImpl, size);
+	impl->allocator = alloc;
+	if (src == dest)
+		ts_bspline_free(dest);
+	dest->pImpl = impl;
+	TS_RETURN_SUCCESS(status)
+}
+
 void ts_bspline_move(tsBSpline *src, tsBSpline *dest)
 {
 	if (src == dest)
@@ -626,7 +1573,7 @@ void ts_bspline_move(tsBSpline *src, tsBSpline *dest)
 void ts_bspline_free(tsBSpline *spline)
 {
 	if (spline->pImpl)
-		free(spline->pImpl);
+		ts_int_deallocate(spline->pImpl->allocator, spline->pImpl);
 	ts_int_bspline_init(spline);
 }
 
@@ -652,12 +1599,15 @@ tsError ts_int_deboornet_new(const tsBSpline *spline, tsDeBoorNet *net,
 	const size_t sof_real = sizeof(tsReal);
 	const size_t sof_impl = sizeof(struct tsDeBoorNetImpl);
 	const size_t sof_points_vec = fixed_num_points * dim * sof_real;
-	const size_t sof_net = sof_impl * sof_points_vec;
+	const size_t sof_net = sof_impl + sof_points_vec;
 
-	net->pImpl = (struct tsDeBoorNetImpl *) malloc(sof_net);
+	/* Nets are derived from spline (cf. tsAllocator). */
+	net->pImpl = (struct tsDeBoorNetImpl *) ts_int_allocate(
+		&spline->pImpl->allocator, sof_net);
 	if (!net->pImpl)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 
+	net->pImpl->allocator = spline->pImpl->allocator;
 	net->pImpl->u = 0.f;
 	net->pImpl->k = 0;
 	net->pImpl->s = 0;
@@ -670,7 +1620,7 @@ tsError ts_int_deboornet_new(const tsBSpline *spline, tsDeBoorNet *net,
 void ts_deboornet_free(tsDeBoorNet *net)
 {
 	if (net->pImpl)
-		free(net->pImpl);
+		ts_int_deallocate(net->pImpl->allocator, net->pImpl);
 	ts_int_deboornet_init(net);
 }
 
@@ -682,7 +1632,8 @@ tsError ts_deboornet_copy(const tsDeBoorNet *src, tsDeBoorNet *dest,
 		TS_RETURN_SUCCESS(status)
 	ts_int_deboornet_init(dest);
 	size = ts_int_deboornet_sof_state(src);
-	dest->pImpl = (struct tsDeBoorNetImpl *) malloc(size);
+	dest->pImpl = (struct tsDeBoorNetImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
 	if (!dest->pImpl)
 		TS_RETURN_0(status, TS_MALLOC, "out of memory")
 	memcpy(dest->pImpl, src->pImpl, size);
@@ -697,615 +1648,5286 @@ void ts_deboornet_move(tsDeBoorNet *src, tsDeBoorNet *dest)
 	ts_int_deboornet_init(src);
 }
 
+/* ------------------------------------------------------------------------- */
 
+tsEvalPlan ts_evalplan_init()
+{
+	tsEvalPlan plan;
+	ts_int_evalplan_init(&plan);
+	return plan;
+}
 
-/******************************************************************************
-*                                                                             *
-* :: Interpolation and Approximation Functions                                *
-*                                                                             *
-******************************************************************************/
-tsError ts_int_thomas_algorithm(const tsReal *a, const tsReal *b,
-	const tsReal *c, size_t num, size_t dim, tsReal *d, tsStatus *status)
+tsError ts_evalplan_copy(const tsEvalPlan *src, tsEvalPlan *dest,
+	tsStatus *status)
 {
-	size_t i, j, k, l;
-	tsReal m, *cc = NULL;
-	tsError err;
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_evalplan_init(dest);
+	size = ts_int_evalplan_sof_state(src);
+	dest->pImpl = (struct tsEvalPlanImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
 
-	if (dim == 0) {
-		TS_RETURN_0(status, TS_DIM_ZERO,
-			"unsupported dimension: 0")
-	}
-	if (num <= 1) {
-		TS_RETURN_1(status, TS_NUM_POINTS,
-			"num(points) (%lu) <= 1", (unsigned long) num)
-	}
-	cc = (tsReal *) malloc(num * sizeof(tsReal));
-	if (!cc) TS_RETURN_0(status, TS_MALLOC, "out of memory")
+void ts_evalplan_move(tsEvalPlan *src, tsEvalPlan *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_evalplan_init(src);
+}
 
-	TS_TRY(try, err, status)
-		/* Forward sweep. */
-		if (fabs(b[0]) <= fabs(c[0])) {
-			TS_THROW_2(try, err, status, TS_NO_RESULT,
-				"error: |%f| <= |%f|", b[0], c[0])
-		}
-		/* |b[i]| > |c[i]| implies that |b[i]| > 0. Thus, the following
-		 * statements cannot evaluate to division by zero.*/
-		cc[0] = c[0] / b[0];
-		for (i = 0; i < dim; i++)
-			d[i] = d[i] / b[0];
-		for (i = 1; i < num; i++) {
-			if (fabs(b[i]) <= fabs(a[i]) + fabs(c[i])) {
-				TS_THROW_3(try, err, status, TS_NO_RESULT,
-					"error: |%f| <= |%f| + |%f|",
-					b[i], a[i], c[i])
-			}
-			/* |a[i]| < |b[i]| and cc[i - 1] < 1. Therefore, the
-			 * following statement cannot evaluate to division by
-			 * zero. */
-			m = 1.f / (b[i] - a[i] * cc[i - 1]);
-			/* |b[i]| > |a[i]| + |c[i]| implies that there must be
-			 * an eps > 0 such that |b[i]| = |a[i]| + |c[i]| + eps.
-			 * Even if |a[i]| is 0 (by which the result of the
-			 * following statement becomes maximum), |c[i]| is less
-			 * than |b[i]| by an amount of eps. By substituting the
-			 * previous and the following statements (under the
-			 * assumption that |a[i]| is 0), we obtain c[i] / b[i],
-			 * which must be less than 1. */
-			cc[i] = c[i] * m;
-			for (j = 0; j < dim; j++) {
-				k = i * dim + j;
+void ts_evalplan_free(tsEvalPlan *plan)
+{
+	if (plan->pImpl)
+		ts_int_deallocate(plan->pImpl->allocator, plan->pImpl);
+	ts_int_evalplan_init(plan);
+}
+
+/* ------------------------------------------------------------------------- */
+
+tsStreamFitter ts_streamfitter_init()
+{
+	tsStreamFitter fitter;
+	ts_int_streamfitter_init(&fitter);
+	return fitter;
+}
+
+tsError ts_streamfitter_new(size_t dimension, size_t lookahead,
+	tsStreamFitter *fitter, tsStatus *status)
+{
+	const size_t la = lookahead == 0 ? 20 : lookahead;
+	const size_t cap = 2 * la + 1;
+	const size_t sof_fitter = sizeof(struct tsStreamFitterImpl) +
+		(3 * cap * dimension + cap) * sizeof(tsReal);
+
+	ts_int_streamfitter_init(fitter);
+	if (dimension == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	fitter->pImpl = (struct tsStreamFitterImpl *) ts_int_malloc(
+		sof_fitter);
+	if (!fitter->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	fitter->pImpl->allocator = ts_int_allocator;
+	fitter->pImpl->dim = dimension;
+	fitter->pImpl->lookahead = la;
+	fitter->pImpl->n_points = 0;
+	fitter->pImpl->len = 0;
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_streamfitter_copy(const tsStreamFitter *src, tsStreamFitter *dest,
+	tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_streamfitter_init(dest);
+	size = ts_int_streamfitter_sof_state(src);
+	dest->pImpl = (struct tsStreamFitterImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_streamfitter_move(tsStreamFitter *src, tsStreamFitter *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_streamfitter_init(src);
+}
+
+void ts_streamfitter_free(tsStreamFitter *fitter)
+{
+	if (fitter->pImpl)
+		ts_int_deallocate(fitter->pImpl->allocator, fitter->pImpl);
+	ts_int_streamfitter_init(fitter);
+}
+
+/* ------------------------------------------------------------------------- */
+
+tsArcLengthTable ts_arclengthtable_init()
+{
+	tsArcLengthTable table;
+	ts_int_arclengthtable_init(&table);
+	return table;
+}
+
+tsError ts_arclengthtable_copy(const tsArcLengthTable *src,
+	tsArcLengthTable *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_arclengthtable_init(dest);
+	size = ts_int_arclengthtable_sof_state(src);
+	dest->pImpl = (struct tsArcLengthTableImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_arclengthtable_move(tsArcLengthTable *src, tsArcLengthTable *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_arclengthtable_init(src);
+}
+
+void ts_arclengthtable_free(tsArcLengthTable *table)
+{
+	if (table->pImpl)
+		ts_int_deallocate(table->pImpl->allocator, table->pImpl);
+	ts_int_arclengthtable_init(table);
+}
+
+/* ------------------------------------------------------------------------- */
+
+tsProjector ts_projector_init()
+{
+	tsProjector projector;
+	ts_int_projector_init(&projector);
+	return projector;
+}
+
+tsError ts_projector_copy(const tsProjector *src, tsProjector *dest,
+	tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_projector_init(dest);
+	size = ts_int_projector_sof_state(src);
+	dest->pImpl = (struct tsProjectorImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_projector_move(tsProjector *src, tsProjector *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_projector_init(src);
+}
+
+void ts_projector_free(tsProjector *projector)
+{
+	if (projector->pImpl)
+		ts_int_deallocate(projector->pImpl->allocator,
+			projector->pImpl);
+	ts_int_projector_init(projector);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/* Sort key of the splines of ts_bsplinecollection_new. */
+struct tsBSplineCollectionKey
+{
+	size_t deg;
+	size_t dim;
+	size_t n_ctrlp;
+	size_t index;  /**< Index of the spline in the collection. */
+	size_t offset; /**< Offset of the point of the spline. */
+};
+
+/* Returns 1 if the splines of \p a and \p b belong to the same group of a
+ * tsBSplineCollection, 0 otherwise. */
+int ts_int_bsplinecollection_same_group(
+	const struct tsBSplineCollectionKey *a,
+	const struct tsBSplineCollectionKey *b)
+{
+	return a->deg == b->deg && a->dim == b->dim &&
+		a->n_ctrlp == b->n_ctrlp;
+}
+
+/* Orders the keys by group and, within a group, by index. */
+int ts_int_bsplinecollection_compare(const void *x, const void *y)
+{
+	const struct tsBSplineCollectionKey *a =
+		(const struct tsBSplineCollectionKey *) x;
+	const struct tsBSplineCollectionKey *b =
+		(const struct tsBSplineCollectionKey *) y;
+	if (a->deg != b->deg)
+		return a->deg < b->deg ? -1 : 1;
+	if (a->dim != b->dim)
+		return a->dim < b->dim ? -1 : 1;
+	if (a->n_ctrlp != b->n_ctrlp)
+		return a->n_ctrlp < b->n_ctrlp ? -1 : 1;
+	if (a->index != b->index)
+		return a->index < b->index ? -1 : 1;
+	return 0;
+}
+
+/* Returns 1 if the splines of the keys [begin, end) have the same knot
+ * vector, 0 otherwise. */
+int ts_int_bsplinecollection_shared(const tsBSpline *splines,
+	const struct tsBSplineCollectionKey *keys, size_t begin, size_t end)
+{
+	const tsBSpline *first = splines + keys[begin].index;
+	const size_t sof_knots = ts_bspline_sof_knots(first);
+	size_t i;
+	for (i = begin + 1; i < end; i++) {
+		if (memcmp(ts_int_bspline_access_knots(first),
+				ts_int_bspline_access_knots(
+				splines + keys[i].index), sof_knots)) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/* Returns the size (in bytes) of the arrays of a group of \p m splines of
+ * degree \p deg and dimension \p dim with \p n_ctrlp control points. */
+size_t ts_int_bsplinegroup_sof_arrays(size_t deg, size_t dim,
+	size_t n_ctrlp, size_t m, int shared)
+{
+	const size_t n_knots = n_ctrlp + deg + 1;
+	return ts_int_arena_round(2 * m * sizeof(size_t)) +
+		ts_int_arena_round((m * n_ctrlp * dim +
+		(shared ? 1 : m) * n_knots) * sizeof(tsReal));
+}
+
+tsBSplineCollection ts_bsplinecollection_init()
+{
+	tsBSplineCollection collection;
+	ts_int_bsplinecollection_init(&collection);
+	return collection;
+}
+
+tsError ts_bsplinecollection_new(const tsBSpline *splines, size_t num,
+	tsBSplineCollection *collection, tsStatus *status)
+{
+	const tsAllocator alloc = ts_int_allocator_or_global(NULL);
+	struct tsBSplineCollectionKey *keys = NULL;
+	struct tsBSplineCollectionImpl *impl;
+	struct tsBSplineGroup *group;
+	const tsBSpline *spline;
+	const tsReal *src;
+	size_t *indices, *offsets;
+	tsReal *ctrlp, *knots;
+	size_t len_points, n_groups, size, pos, tiles, order, m;
+	size_t b, e, i, j, d;
+	tsError err;
+
+	ts_int_bsplinecollection_init(collection);
+	TS_TRY(try, err, status)
+		if (num > 0) {
+			keys = (struct tsBSplineCollectionKey *) ts_int_malloc(
+				num * sizeof(struct tsBSplineCollectionKey));
+			if (!keys) {
+				TS_THROW_0(try, err, status, TS_MALLOC,
+					"out of memory")
+			}
+		}
+		len_points = 0;
+		for (i = 0; i < num; i++) {
+			keys[i].deg = ts_bspline_degree(splines + i);
+			keys[i].dim = ts_bspline_dimension(splines + i);
+			keys[i].n_ctrlp = ts_bspline_num_control_points(
+				splines + i);
+			keys[i].index = i;
+			keys[i].offset = len_points;
+			len_points += keys[i].dim;
+		}
+		if (num > 0) {
+			qsort(keys, num, sizeof(struct tsBSplineCollectionKey),
+				ts_int_bsplinecollection_compare);
+		}
+
+		/* Determine the layout of the groups. */
+		n_groups = 0;
+		size = 0;
+		for (b = 0; b < num; b = e) {
+			for (e = b + 1; e < num &&
+				ts_int_bsplinecollection_same_group(
+				keys + b, keys + e); e++);
+			n_groups++;
+			size += ts_int_bsplinegroup_sof_arrays(keys[b].deg,
+				keys[b].dim, keys[b].n_ctrlp, e - b,
+				ts_int_bsplinecollection_shared(
+				splines, keys, b, e));
+		}
+		pos = ts_int_arena_round(
+			sizeof(struct tsBSplineCollectionImpl)) +
+			ts_int_arena_round(
+			n_groups * sizeof(struct tsBSplineGroup));
+		size += pos;
+
+		impl = (struct tsBSplineCollectionImpl *) ts_int_allocate(
+			&alloc, size);
+		if (!impl)
+			TS_THROW_0(try, err, status, TS_MALLOC, "out of memory")
+		collection->pImpl = impl;
+		impl->n_splines = num;
+		impl->len_points = len_points;
+		impl->n_groups = n_groups;
+		impl->max_dim = 0;
+		impl->max_order = 0;
+		impl->size = size;
+		impl->allocator = alloc;
+
+		/* Fill the groups. */
+		group = ts_int_bsplinecollection_access_groups(impl);
+		tiles = 0;
+		for (b = 0; b < num; b = e, group++) {
+			for (e = b + 1; e < num &&
+				ts_int_bsplinecollection_same_group(
+				keys + b, keys + e); e++);
+			m = e - b;
+			group->deg = keys[b].deg;
+			group->dim = keys[b].dim;
+			group->n_ctrlp = keys[b].n_ctrlp;
+			group->n_splines = m;
+			group->shared = ts_int_bsplinecollection_shared(
+				splines, keys, b, e);
+			group->first_tile = tiles;
+			group->indices = pos;
+			group->offsets = pos + m * sizeof(size_t);
+			group->ctrlp = pos + ts_int_arena_round(
+				2 * m * sizeof(size_t));
+			group->knots = group->ctrlp +
+				m * group->n_ctrlp * group->dim *
+				sizeof(tsReal);
+			pos += ts_int_bsplinegroup_sof_arrays(group->deg,
+				group->dim, group->n_ctrlp, m, group->shared);
+			tiles += (m + TS_INT_COLLECTION_TILE - 1) /
+				TS_INT_COLLECTION_TILE;
+			order = group->deg + 1;
+			if (group->dim > impl->max_dim)
+				impl->max_dim = group->dim;
+			if (order > impl->max_order)
+				impl->max_order = order;
+
+			indices = (size_t *) ts_int_bsplinecollection_at(
+				impl, group->indices);
+			offsets = (size_t *) ts_int_bsplinecollection_at(
+				impl, group->offsets);
+			ctrlp = (tsReal *) ts_int_bsplinecollection_at(
+				impl, group->ctrlp);
+			knots = (tsReal *) ts_int_bsplinecollection_at(
+				impl, group->knots);
+			for (i = 0; i < m; i++) {
+				spline = splines + keys[b + i].index;
+				indices[i] = keys[b + i].index;
+				offsets[i] = keys[b + i].offset;
+				src = ts_int_bspline_access_ctrlp(spline);
+				for (j = 0; j < group->n_ctrlp; j++) {
+					for (d = 0; d < group->dim; d++) {
+						ctrlp[(j * group->dim + d) *
+							m + i] = src[j *
+							group->dim + d];
+					}
+				}
+				if (!group->shared || i == 0) {
+					memcpy(knots + i * (group->n_ctrlp +
+						order),
+						ts_int_bspline_access_knots(
+						spline),
+						ts_bspline_sof_knots(spline));
+				}
+			}
+		}
+		impl->n_tiles = tiles;
+	TS_CATCH(err)
+		ts_bsplinecollection_free(collection);
+	TS_FINALLY
+		if (keys)
+			ts_int_free(keys);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bsplinecollection_copy(const tsBSplineCollection *src,
+	tsBSplineCollection *dest, tsStatus *status)
+{
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_bsplinecollection_init(dest);
+	dest->pImpl = (struct tsBSplineCollectionImpl *) ts_int_allocate(
+		&src->pImpl->allocator, src->pImpl->size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, src->pImpl->size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_bsplinecollection_move(tsBSplineCollection *src,
+	tsBSplineCollection *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_bsplinecollection_init(src);
+}
+
+void ts_bsplinecollection_free(tsBSplineCollection *collection)
+{
+	if (collection->pImpl)
+		ts_int_deallocate(collection->pImpl->allocator,
+			collection->pImpl);
+	ts_int_bsplinecollection_init(collection);
+}
+
+/* ------------------------------------------------------------------------- */
+
+tsBSplineSurface ts_bsplinesurface_init()
+{
+	tsBSplineSurface surface;
+	ts_int_bsplinesurface_init(&surface);
+	return surface;
+}
+
+tsError ts_bsplinesurface_new(size_t num_control_points_u,
+	size_t num_control_points_v, size_t dimension, size_t degree_u,
+	size_t degree_v, tsBSplineType type, tsBSplineSurface *surface,
+	tsStatus *status)
+{
+	const tsAllocator alloc = ts_int_allocator_or_global(NULL);
+	struct tsBSplineSurfaceImpl impl;
+	tsError err;
+
+	ts_int_bsplinesurface_init(surface);
+
+	if (dimension < 1) {
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	}
+	if (num_control_points_u + degree_u + 1 > TS_MAX_NUM_KNOTS ||
+		num_control_points_v + degree_v + 1 > TS_MAX_NUM_KNOTS) {
+		TS_RETURN_1(status, TS_NUM_KNOTS,
+			"unsupported number of knots: > %i",
+			TS_MAX_NUM_KNOTS)
+	}
+	if (degree_u >= num_control_points_u) {
+		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
+			"degree (%lu) >= num(control_points) (%lu) in u",
+			(unsigned long) degree_u,
+			(unsigned long) num_control_points_u)
+	}
+	if (degree_v >= num_control_points_v) {
+		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
+			"degree (%lu) >= num(control_points) (%lu) in v",
+			(unsigned long) degree_v,
+			(unsigned long) num_control_points_v)
+	}
+
+	impl.deg_u = degree_u;
+	impl.deg_v = degree_v;
+	impl.dim = dimension;
+	impl.n_ctrlp_u = num_control_points_u;
+	impl.n_ctrlp_v = num_control_points_v;
+	impl.allocator = alloc;
+	surface->pImpl = (struct tsBSplineSurfaceImpl *) ts_int_allocate(
+		&alloc, ts_int_bsplinesurface_sof_impl(&impl));
+	if (!surface->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	*surface->pImpl = impl;
+	ts_arr_fill(ts_int_bsplinesurface_access_ctrlp(surface),
+		ts_int_bsplinesurface_len_ctrlp(&impl), 0);
+
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_int_knots_generate(
+			ts_int_bsplinesurface_access_knots_u(surface),
+			ts_bsplinesurface_num_knots_u(surface), degree_u,
+			type, status))
+		TS_CALL(try, err, ts_int_knots_generate(
+			ts_int_bsplinesurface_access_knots_v(surface),
+			ts_bsplinesurface_num_knots_v(surface), degree_v,
+			type, status))
+	TS_CATCH(err)
+		ts_bsplinesurface_free(surface);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bsplinesurface_copy(const tsBSplineSurface *src,
+	tsBSplineSurface *dest, tsStatus *status)
+{
+	size_t size;
+	if (src == dest)
+		TS_RETURN_SUCCESS(status)
+	ts_int_bsplinesurface_init(dest);
+	size = ts_int_bsplinesurface_sof_impl(src->pImpl);
+	dest->pImpl = (struct tsBSplineSurfaceImpl *) ts_int_allocate(
+		&src->pImpl->allocator, size);
+	if (!dest->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(dest->pImpl, src->pImpl, size);
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_bsplinesurface_move(tsBSplineSurface *src, tsBSplineSurface *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_bsplinesurface_init(src);
+}
+
+void ts_bsplinesurface_free(tsBSplineSurface *surface)
+{
+	if (surface->pImpl)
+		ts_int_deallocate(surface->pImpl->allocator, surface->pImpl);
+	ts_int_bsplinesurface_init(surface);
+}
+
+/* ------------------------------------------------------------------------- */
+
+tsArena ts_arena_init()
+{
+	tsArena arena;
+	ts_int_arena_init(&arena);
+	return arena;
+}
+
+tsError ts_arena_new(size_t capacity, tsArena *arena, tsStatus *status)
+{
+	ts_int_arena_init(arena);
+	if (capacity == 0)
+		capacity = TS_INT_ARENA_CAPACITY;
+	arena->pImpl = (struct tsArenaImpl *) malloc(
+		sizeof(struct tsArenaImpl));
+	if (!arena->pImpl)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	arena->pImpl->blocks = ts_int_arena_block_new(capacity, NULL);
+	if (!arena->pImpl->blocks) {
+		free(arena->pImpl);
+		ts_int_arena_init(arena);
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+void ts_arena_move(tsArena *src, tsArena *dest)
+{
+	if (src == dest)
+		return;
+	dest->pImpl = src->pImpl;
+	ts_int_arena_init(src);
+}
+
+void ts_arena_free(tsArena *arena)
+{
+	struct tsArenaBlock *block, *next;
+	if (arena->pImpl) {
+		for (block = arena->pImpl->blocks; block; block = next) {
+			next = block->next;
+			free(block);
+		}
+		free(arena->pImpl);
+	}
+	ts_int_arena_init(arena);
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Interpolation and Approximation Functions                                *
+*                                                                             *
+******************************************************************************/
+tsError ts_int_thomas_algorithm(const tsReal *a, const tsReal *b,
+	const tsReal *c, size_t num, size_t dim, tsReal *d, tsStatus *status)
+{
+	size_t i, j, k, l;
+	tsReal m, *cc = NULL;
+	tsError err;
+
+	if (dim == 0) {
+		TS_RETURN_0(status, TS_DIM_ZERO,
+			"unsupported dimension: 0")
+	}
+	if (num <= 1) {
+		TS_RETURN_1(status, TS_NUM_POINTS,
+			"num(points) (%lu) <= 1", (unsigned long) num)
+	}
+	cc = (tsReal *) ts_int_malloc(num * sizeof(tsReal));
+	if (!cc) TS_RETURN_0(status, TS_MALLOC, "out of memory")
+
+	TS_TRY(try, err, status)
+		/* Forward sweep. */
+		if (fabs(b[0]) <= fabs(c[0])) {
+			TS_THROW_2(try, err, status, TS_NO_RESULT,
+				"error: |%f| <= |%f|", b[0], c[0])
+		}
+		/* |b[i]| > |c[i]| implies that |b[i]| > 0. Thus, the following
+		 * statements cannot evaluate to division by zero.*/
+		cc[0] = c[0] / b[0];
+		for (i = 0; i < dim; i++)
+			d[i] = d[i] / b[0];
+		for (i = 1; i < num; i++) {
+			if (fabs(b[i]) <= fabs(a[i]) + fabs(c[i])) {
+				TS_THROW_3(try, err, status, TS_NO_RESULT,
+					"error: |%f| <= |%f| + |%f|",
+					b[i], a[i], c[i])
+			}
+			/* |a[i]| < |b[i]| and cc[i - 1] < 1. Therefore, the
+			 * following statement cannot evaluate to division by
+			 * zero. */
+			m = 1.f / (b[i] - a[i] * cc[i - 1]);
+			/* |b[i]| > |a[i]| + |c[i]| implies that there must be
+			 * an eps > 0 such that |b[i]| = |a[i]| + |c[i]| + eps.
+			 * Even if |a[i]| is 0 (by which the result of the
+			 * following statement becomes maximum), |c[i]| is less
+			 * than |b[i]| by an amount of eps. By substituting the
+			 * previous and the following statements (under the
+			 * assumption that |a[i]| is 0), we obtain c[i] / b[i],
+			 * which must be less than 1. */
+			cc[i] = c[i] * m;
+			for (j = 0; j < dim; j++) {
+				k = i * dim + j;
 				l = (i-1) * dim + j;
 				d[k] = (d[k] - a[i] * d[l]) * m;
 			}
 		}
 
-		/* Back substitution. */
-		for (i = num-1; i > 0; i--) {
-			for (j = 0; j < dim; j++) {
-				k = (i-1) * dim + j;
-				l = i * dim + j;
-				d[k] -= cc[i-1] * d[l];
-			}
+		/* Back substitution. */
+		for (i = num-1; i > 0; i--) {
+			for (j = 0; j < dim; j++) {
+				k = (i-1) * dim + j;
+				l = i * dim + j;
+				d[k] -= cc[i-1] * d[l];
+			}
+		}
+	TS_FINALLY
+		ts_int_free(cc);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_int_relaxed_uniform_cubic_bspline(const tsReal *points, size_t n,
+	size_t dim, tsBSpline *spline, tsStatus *status)
+{
+	const size_t order = 4;    /**< Order of spline to interpolate. */
+	const tsReal as = 1.f/6.f; /**< The value 'a sixth'. */
+	const tsReal at = 1.f/3.f; /**< The value 'a third'. */
+	const tsReal tt = 2.f/3.f; /**< The value 'two third'. */
+	size_t sof_ctrlp;          /**< Size of a single control point. */
+	const tsReal* b = points;  /**< Array of the b values. */
+	tsReal* s;                 /**< Array of the s values. */
+	size_t i, d;               /**< Used in for loops */
+	size_t j, k, l;            /**< Used as temporary indices. */
+	tsReal *ctrlp; /**< Pointer to the control points of \p _spline_. */
+	tsError err;
+
+	/* input validation */
+	if (dim == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (n <= 1) {
+		TS_RETURN_1(status, TS_NUM_POINTS,
+			"num(points) (%lu) <= 1", (unsigned long) n)
+	}
+	/* in the following n >= 2 applies */
+
+	sof_ctrlp = dim * sizeof(tsReal); /* dim > 0 implies sof_ctrlp > 0 */
+
+	s = NULL;
+	TS_TRY(try, err, status)
+		/* n >= 2 implies n-1 >= 1 implies (n-1)*4 >= 4 */
+		TS_CALL(try, err, ts_bspline_new(
+			(n-1)*4, dim, order-1, TS_BEZIERS, spline, status))
+		ctrlp = ts_int_bspline_access_ctrlp(spline);
+
+		s = (tsReal*) ts_int_malloc(n * sof_ctrlp);
+		if (!s) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+
+		/* set s_0 to b_0 and s_n = b_n */
+		memcpy(s, b, sof_ctrlp);
+		memcpy(s + (n-1)*dim, b + (n-1)*dim, sof_ctrlp);
+
+		/* set s_i = 1/6*b_i + 2/3*b_{i-1} + 1/6*b_{i+1}*/
+		for (i = 1; i < n-1; i++) {
+			for (d = 0; d < dim; d++) {
+				j = (i-1)*dim+d;
+				k = i*dim+d;
+				l = (i+1)*dim+d;
+				s[k] = as * b[j];
+				s[k] += tt * b[k];
+				s[k] += as * b[l];
+			}
+		}
+
+		/* create beziers from b and s */
+		for (i = 0; i < n-1; i++) {
+			for (d = 0; d < dim; d++) {
+				j = i*dim+d;
+				k = i*4*dim+d;
+				l = (i+1)*dim+d;
+				ctrlp[k] = s[j];
+				ctrlp[k+dim] = tt*b[j] + at*b[l];
+				ctrlp[k+2*dim] = at*b[j] + tt*b[l];
+				ctrlp[k+3*dim] = s[l];
+			}
+		}
+	TS_CATCH(err)
+		ts_bspline_free(spline);
+	TS_FINALLY
+		if (s)
+			ts_int_free(s);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_interpolate_cubic_natural(const tsReal *points,
+	size_t num_points, size_t dimension, tsBSpline *spline,
+	tsStatus *status)
+{
+	const size_t sof_ctrlp = dimension * sizeof(tsReal);
+	const size_t len_points = num_points * dimension;
+	const size_t num_int_points = num_points - 2;
+	const size_t len_int_points = num_int_points * dimension;
+	tsReal *thomas, *a, *b, *c, *d;
+	size_t i, j, k, l;
+	tsError err;
+
+	ts_int_bspline_init(spline);
+	if (num_points == 0)
+		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
+	if (num_points == 1) {
+		TS_CALL_ROE(err, ts_bspline_new(
+			4, dimension, 3, TS_CLAMPED, spline, status))
+		for (i = 0; i < ts_bspline_num_control_points(spline); i++) {
+			memcpy(ts_int_bspline_access_ctrlp(spline)
+				+ i * dimension, points, sof_ctrlp);
+		}
+		TS_RETURN_SUCCESS(status)
+	}
+	if (num_points == 2) {
+		return ts_int_relaxed_uniform_cubic_bspline(
+			points, num_points, dimension, spline, status);
+	}
+	/* `num_points` >= 3 */
+	thomas = NULL;
+	TS_TRY(try, err, status)
+		thomas = (tsReal *) ts_int_malloc(
+			3 * num_int_points * sof_ctrlp);
+		if (!thomas) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		/* The system of linear equations is taken from:
+		 *     http://www.bakoma-tex.com/doc/generic/pst-bspline/
+		 *     pst-bspline-doc.pdf */
+		a = c = thomas;
+		ts_arr_fill(a, len_int_points, 1);
+		b = a + len_int_points;
+		ts_arr_fill(b, len_int_points, 4);
+		d = b + len_int_points;
+		/* 6 * S_{i+1} */
+		for (i = 0; i < num_int_points; i++) {
+			for (j = 0; j < dimension; j++) {
+				k = i * dimension + j;
+				l = (i+1) * dimension + j;
+				d[k] = 6 * points[l];
+			}
+		}
+		for (i = 0; i < dimension; i++) {
+			/* 6 * S_{1} - S_{0} */
+			d[i] -= points[i];
+			/* 6 * S_{n-1} - S_{n} */
+			k = len_int_points - (i+1);
+			l = len_points - (i+1);
+			d[k] -= points[l];
+		}
+		/* The Thomas algorithm requires at least two points. Hence,
+		 * `num_int_points` == 1 must be handled separately (let's call
+		 * it "Mini Thomas"). */
+		if (num_int_points == 1) {
+			for (i = 0; i < dimension; i++)
+				d[i] *= (tsReal) 0.25f;
+		} else {
+			TS_CALL(try, err, ts_int_thomas_algorithm(
+				a, b, c, num_int_points, dimension, d,
+				status))
+		}
+		memcpy(thomas, points, sof_ctrlp);
+		memmove(thomas + dimension, d, num_int_points * sof_ctrlp);
+		memcpy(thomas + (num_int_points+1) * dimension,
+			points + (num_points-1) * dimension, sof_ctrlp);
+		TS_CALL(try, err, ts_int_relaxed_uniform_cubic_bspline(
+			thomas, num_points, dimension, spline, status))
+	TS_CATCH(err)
+		ts_bspline_free(spline);
+	TS_FINALLY
+		if (thomas)
+			ts_int_free(thomas);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
+	size_t num_points, size_t dimension, tsReal alpha, const tsReal *first,
+	const tsReal *last, tsReal epsilon, tsBSpline *spline,
+	tsStatus *status)
+{
+	const size_t sof_real = sizeof(tsReal);
+	const size_t sof_ctrlp = dimension * sof_real;
+	const tsReal eps = (tsReal) fabs(epsilon);
+	tsReal *bs_ctrlp; /* Points to the control points of `spline`. */
+	tsReal *cr_ctrlp; /**< The points to interpolate based on `points`. */
+	size_t i, d; /**< Used in for loops. */
+	tsError err; /**< Local error handling. */
+	/* [https://en.wikipedia.org/wiki/
+	 * Centripetal_Catmull%E2%80%93Rom_spline] */
+	tsReal t0, t1, t2, t3; /**< Catmull-Rom knots. */
+	/* [https://stackoverflow.com/questions/30748316/
+	 * catmull-rom-interpolation-on-svg-paths/30826434#30826434] */
+	tsReal c1, c2, d1, d2, m1, m2; /**< Used to calculate derivatives. */
+	tsReal *p0, *p1, *p2, *p3; /**< Processed Catmull-Rom points. */
+
+	ts_int_bspline_init(spline);
+	if (dimension == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (num_points == 0)
+		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
+	if (num_points == 1) {
+		TS_CALL_ROE(err, ts_bspline_new(num_points, dimension,
+			num_points - 1, TS_CLAMPED, spline, status))
+		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
+		memcpy(bs_ctrlp, points, sof_ctrlp);
+		TS_RETURN_SUCCESS(status)
+	}
+	if (alpha < 0.f)
+		alpha = (tsReal) 0.f;
+	if (alpha > 1.f)
+		alpha = (tsReal) 1.f;
+
+	/* Copy `points` to `cr_ctrlp`. Add space for `first` and `last`. */
+	cr_ctrlp = (tsReal *) ts_int_malloc((num_points + 2) * sof_ctrlp);
+	if (!cr_ctrlp)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	memcpy(cr_ctrlp + dimension, points, num_points * sof_ctrlp);
+
+	/* Remove redundant points from `cr_ctrlp`. Update `num_points`. */
+	for (i = 1 /* 0 (`first`) is not assigned yet */;
+			i < num_points /* skip last point (inclusive end) */;
+			i++) {
+		p0 = cr_ctrlp + (i * dimension);
+		p1 = p0 + dimension;
+		if (ts_distance(p0, p1, dimension) <= eps) {
+			/* Are there any other points (after the one that is
+			 * to be removed) that need to be shifted? */
+			if (i < num_points - 1) {
+				memmove(p1, p1 + dimension,
+					(num_points - (i + 1)) * sof_ctrlp);
+			}
+			num_points--;
+			i--;
+		}
+	}
+
+	/* Check if there are still enough points for interpolation. */
+	if (num_points == 1) { /* `num_points` can't be 0 */
+		ts_int_free(cr_ctrlp); /* The point is copied from `points`. */
+		TS_CALL_ROE(err, ts_bspline_new(num_points, dimension,
+			num_points - 1, TS_CLAMPED, spline, status))
+		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
+		memcpy(bs_ctrlp, points, sof_ctrlp);
+		TS_RETURN_SUCCESS(status)
+	}
+
+	/* Add or generate `first` and `last`. Update `num_points`. */
+	p0 = cr_ctrlp + dimension;
+	if (first && ts_distance(first, p0, dimension) > eps) {
+		memcpy(cr_ctrlp, first, sof_ctrlp);
+	} else {
+		p1 = p0 + dimension;
+		for (d = 0; d < dimension; d++)
+			cr_ctrlp[d] = p0[d] + (p0[d] - p1[d]);
+	}
+	p1 = cr_ctrlp + (num_points * dimension);
+	if (last && ts_distance(p1, last, dimension) > eps) {
+		memcpy(cr_ctrlp + ((num_points + 1) * dimension),
+			last, sof_ctrlp);
+	} else {
+		p0 = p1 - dimension;
+		for (d = 0; d < dimension; d++) {
+			cr_ctrlp[((num_points + 1) * dimension) + d] =
+				p1[d] + (p1[d] - p0[d]);
+		}
+	}
+	num_points = num_points + 2;
+
+	/* Transform the sequence of Catmull-Rom splines. */
+	bs_ctrlp = NULL;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_new(
+			(num_points - 3) * 4, dimension, 3,
+			TS_BEZIERS, spline, status))
+		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
+	TS_CATCH(err)
+		ts_int_free(cr_ctrlp);
+	TS_END_TRY_ROE(err)
+	for (i = 0; i < ts_bspline_num_control_points(spline) / 4; i++) {
+		p0 = cr_ctrlp + ((i+0) * dimension);
+		p1 = cr_ctrlp + ((i+1) * dimension);
+		p2 = cr_ctrlp + ((i+2) * dimension);
+		p3 = cr_ctrlp + ((i+3) * dimension);
+
+		t0 = (tsReal) 0.f;
+		t1 = t0 + (tsReal) pow(ts_distance(p0, p1, dimension), alpha);
+		t2 = t1 + (tsReal) pow(ts_distance(p1, p2, dimension), alpha);
+		t3 = t2 + (tsReal) pow(ts_distance(p2, p3, dimension), alpha);
+
+		c1 = (t2-t1) / (t2-t0);
+		c2 = (t1-t0) / (t2-t0);
+		d1 = (t3-t2) / (t3-t1);
+		d2 = (t2-t1) / (t3-t1);
+
+		for (d = 0; d < dimension; d++) {
+			m1 = (t2-t1)*(c1*(p1[d]-p0[d])/(t1-t0)
+				+ c2*(p2[d]-p1[d])/(t2-t1));
+			m2 = (t2-t1)*(d1*(p2[d]-p1[d])/(t2-t1)
+				+ d2*(p3[d]-p2[d])/(t3-t2));
+			bs_ctrlp[((i*4 + 0) * dimension) + d] = p1[d];
+			bs_ctrlp[((i*4 + 1) * dimension) + d] = p1[d] + m1/3;
+			bs_ctrlp[((i*4 + 2) * dimension) + d] = p2[d] - m2/3;
+			bs_ctrlp[((i*4 + 3) * dimension) + d] = p2[d];
+		}
+	}
+	ts_int_free(cr_ctrlp);
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Decomposes the symmetric positive definite band matrix \p a of size
+ * \p n x \p n with bandwidth \p bw (i.e., a(i, j) = 0 for |i - j| > bw)
+ * into L * L^T (Cholesky decomposition). Only the lower band is stored,
+ * row by row, with a(i, j) being located at a[i * (bw+1) + (i-j)]. \p a is
+ * overwritten with L (using the same layout). */
+tsError ts_int_cholesky_banded(tsReal *a, size_t n, size_t bw,
+	tsStatus *status)
+{
+	const size_t w = bw + 1;
+	size_t i, j, k, j0;
+	tsReal sum;
+
+	for (i = 0; i < n; i++) {
+		j0 = i > bw ? i - bw : 0;
+		for (j = j0; j <= i; j++) {
+			sum = a[i*w + (i-j)];
+			for (k = j0; k < j; k++)
+				sum -= a[i*w + (i-k)] * a[j*w + (j-k)];
+			if (i == j) {
+				if (sum <= 0) {
+					TS_RETURN_1(status, TS_NO_RESULT,
+						"matrix is not positive "
+						"definite (row: %lu)",
+						(unsigned long) i)
+				}
+				a[i*w] = (tsReal) sqrt(sum);
+			} else {
+				a[i*w + (i-j)] = sum / a[j*w];
+			}
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Solves L * L^T * x = b, with L being the output of ts_int_cholesky_banded,
+ * for the \p dim right-hand sides stored interleaved in \p b (i.e., b(i, d)
+ * is located at b[i * dim + d]). \p b is overwritten with x. */
+void ts_int_cholesky_banded_solve(const tsReal *l, size_t n, size_t bw,
+	size_t dim, tsReal *b)
+{
+	const size_t w = bw + 1;
+	size_t i, k, d, kn;
+
+	/* Forward substitution (L * y = b). */
+	for (i = 0; i < n; i++) {
+		for (k = i > bw ? i - bw : 0; k < i; k++) {
+			for (d = 0; d < dim; d++)
+				b[i*dim + d] -= l[i*w + (i-k)] * b[k*dim + d];
+		}
+		for (d = 0; d < dim; d++)
+			b[i*dim + d] /= l[i*w];
+	}
+
+	/* Back substitution (L^T * x = y). */
+	for (i = n; i-- > 0;) {
+		kn = i + bw < n ? i + bw + 1 : n;
+		for (k = i + 1; k < kn; k++) {
+			for (d = 0; d < dim; d++)
+				b[i*dim + d] -= l[k*w + (k-i)] * b[k*dim + d];
+		}
+		for (d = 0; d < dim; d++)
+			b[i*dim + d] /= l[i*w];
+	}
+}
+
+tsError ts_bspline_approximate(const tsReal *points, size_t num_points,
+	size_t dimension, size_t num_control_points, size_t degree,
+	tsBSpline *spline, tsStatus *status)
+{
+	const size_t n = num_control_points;
+	const size_t m = num_points;
+	const size_t order = degree + 1;
+	const size_t n_int = n > 2 ? n - 2 : 0; /**< Unknown control points. */
+	const size_t n_knots = n + order;
+	const size_t sof_ctrlp = dimension * sizeof(tsReal);
+	tsReal *buf = NULL, *params, *knots, *band, *basis, *scratch;
+	tsReal *ctrlp, *rhs, *r, min, max, len, span, d, alpha;
+	size_t i, j, k, s, a, b, first, ca, cb;
+	tsError err;
+
+	ts_int_bspline_init(spline);
+	if (dimension == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (n < 2) {
+		TS_RETURN_1(status, TS_NUM_POINTS,
+			"num(control points) (%lu) < 2", (unsigned long) n)
+	}
+	if (m < n) {
+		TS_RETURN_2(status, TS_NUM_POINTS,
+			"num(points) (%lu) < num(control points) (%lu)",
+			(unsigned long) m, (unsigned long) n)
+	}
+
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_new(
+			n, dimension, degree, TS_CLAMPED, spline, status))
+		buf = (tsReal *) ts_int_malloc((m + n_knots + n_int * order +
+			(order + dimension) + 2 * order) * sizeof(tsReal));
+		if (!buf) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		params = buf;
+		knots = params + m;
+		band = knots + n_knots;
+		basis = band + n_int * order;
+		r = basis + order;
+		scratch = r + dimension;
+
+		/* Chord length parametrization. */
+		ts_bspline_domain(spline, &min, &max);
+		params[0] = 0;
+		for (i = 1; i < m; i++) {
+			params[i] = params[i-1] + ts_distance(
+				points + (i-1) * dimension,
+				points + i * dimension, dimension);
+		}
+		len = params[m-1];
+		for (i = 0; i < m; i++) {
+			params[i] = len > 0
+				? min + (params[i] / len) * (max - min)
+				: min + ((tsReal) i / (m-1)) * (max - min);
+		}
+		params[m-1] = max;
+
+		/* Averaging technique ('The NURBS Book', Eq. 9.68 and 9.69)
+		 * which guarantees that every knot span contains at least one
+		 * parameter (Schoenberg-Whitney condition). */
+		for (i = 0; i < order; i++) {
+			knots[i] = min;
+			knots[n_knots - 1 - i] = max;
+		}
+		span = (tsReal) m / (n - degree);
+		for (j = 1; j < n - degree; j++) {
+			d = j * span;
+			i = (size_t) d;
+			alpha = d - (tsReal) i;
+			knots[degree + j] = (1 - alpha) * params[i-1] +
+				alpha * params[i];
+		}
+		TS_CALL(try, err, ts_bspline_set_knots(spline, knots, status))
+
+		/* The first and last point are interpolated. The remaining
+		 * control points minimize the sum of squared distances, that
+		 * is, they solve the normal equations (N^T * N) * P = N^T * R
+		 * ('The NURBS Book', Eq. 9.63 to 9.67). The right-hand side is
+		 * accumulated in the control points to be solved for. */
+		ctrlp = ts_int_bspline_access_ctrlp(spline);
+		memcpy(ctrlp, points, sof_ctrlp);
+		memcpy(ctrlp + (n-1) * dimension, points + (m-1) * dimension,
+			sof_ctrlp);
+		rhs = ctrlp + dimension;
+		ts_arr_fill(rhs, n_int * dimension, 0);
+		ts_arr_fill(band, n_int * order, 0);
+		k = s = 0;
+		for (i = 1; n_int > 0 && i < m - 1; i++) {
+			TS_CALL(try, err, ts_int_bspline_find_knot_from(
+				spline, params[i], &k, &s, status))
+			ts_int_bspline_basis(spline, params[i], k, s, &first,
+				basis, scratch);
+			for (j = 0; j < dimension; j++) {
+				r[j] = points[i * dimension + j];
+				for (a = 0; a < order; a++) {
+					if (first + a == 0) {
+						r[j] -= basis[a] * points[j];
+					} else if (first + a == n - 1) {
+						r[j] -= basis[a] * points[
+							(m-1) * dimension + j];
+					}
+				}
+			}
+			for (a = 0; a < order; a++) {
+				ca = first + a;
+				if (ca == 0 || ca == n - 1)
+					continue;
+				for (j = 0; j < dimension; j++) {
+					rhs[(ca-1) * dimension + j] +=
+						basis[a] * r[j];
+				}
+				for (b = 0; b <= a; b++) {
+					cb = first + b;
+					if (cb == 0)
+						continue;
+					band[(ca-1) * order + (ca-cb)] +=
+						basis[a] * basis[b];
+				}
+			}
+		}
+		if (n_int > 0) {
+			TS_CALL(try, err, ts_int_cholesky_banded(
+				band, n_int, degree, status))
+			ts_int_cholesky_banded_solve(
+				band, n_int, degree, dimension, rhs);
+		}
+	TS_CATCH(err)
+		ts_bspline_free(spline);
+	TS_FINALLY
+		if (buf)
+			ts_int_free(buf);
+	TS_END_TRY_RETURN(err)
+}
+
+/* Appends \p point to the window of \p fitter, which must not be full, and
+ * carries out the forward sweep of the Thomas algorithm for the previous
+ * point (which is an inner point from now on). */
+void ts_int_streamfitter_append(tsStreamFitter *fitter, const tsReal *point)
+{
+	const size_t dim = fitter->pImpl->dim;
+	const size_t len = fitter->pImpl->len;
+	tsReal *points = ts_int_streamfitter_access_points(fitter);
+	tsReal *rhs = ts_int_streamfitter_access_rhs(fitter);
+	tsReal *upper = ts_int_streamfitter_access_upper(fitter);
+	tsReal m;
+	size_t d, prev;
+
+	memcpy(points + len * dim, point, dim * sizeof(tsReal));
+	if (len == 0) {
+		/* The first point of the stream is fixed. */
+		upper[0] = 0;
+		memcpy(rhs, point, dim * sizeof(tsReal));
+		memcpy(ts_int_streamfitter_access_solution(fitter), point,
+			dim * sizeof(tsReal));
+	} else if (len > 1) {
+		/* See ts_int_thomas_algorithm (a = c = 1, b = 4, d = 6 * p). */
+		prev = len - 1;
+		m = 1.f / (4 - upper[prev-1]);
+		upper[prev] = m;
+		for (d = 0; d < dim; d++) {
+			rhs[prev*dim + d] = (6 * points[prev*dim + d] -
+				rhs[(prev-1)*dim + d]) * m;
+		}
+	}
+	fitter->pImpl->len++;
+	fitter->pImpl->n_points++;
+}
+
+/* Carries out the back substitution of the Thomas algorithm, with the last
+ * point of the window being the end point of the spline, and stores the
+ * control points of the first \p num segments of the window in \p out. */
+void ts_int_streamfitter_emit(const tsStreamFitter *fitter, size_t num,
+	tsReal *out)
+{
+	const size_t dim = fitter->pImpl->dim;
+	const size_t len = fitter->pImpl->len;
+	const tsReal *points = ts_int_streamfitter_access_points(fitter);
+	const tsReal *rhs = ts_int_streamfitter_access_rhs(fitter);
+	const tsReal *upper = ts_int_streamfitter_access_upper(fitter);
+	tsReal *x = ts_int_streamfitter_access_solution(fitter);
+	const tsReal at = 1.f/3.f; /**< The value 'a third'. */
+	const tsReal tt = 2.f/3.f; /**< The value 'two third'. */
+	size_t i, d;
+
+	memcpy(x + (len-1) * dim, points + (len-1) * dim,
+		dim * sizeof(tsReal));
+	for (i = len-1; i-- > 1;) {
+		for (d = 0; d < dim; d++) {
+			x[i*dim + d] = rhs[i*dim + d] -
+				upper[i] * x[(i+1)*dim + d];
+		}
+	}
+	for (i = 0; i < num; i++) {
+		for (d = 0; d < dim; d++) {
+			out[(i*4 + 0) * dim + d] = points[i*dim + d];
+			out[(i*4 + 1) * dim + d] = tt * x[i*dim + d] +
+				at * x[(i+1)*dim + d];
+			out[(i*4 + 2) * dim + d] = at * x[i*dim + d] +
+				tt * x[(i+1)*dim + d];
+			out[(i*4 + 3) * dim + d] = points[(i+1)*dim + d];
+		}
+	}
+}
+
+/* Removes the first \p num points from the window of \p fitter. */
+void ts_int_streamfitter_shift(tsStreamFitter *fitter, size_t num)
+{
+	const size_t dim = fitter->pImpl->dim;
+	const size_t len = fitter->pImpl->len - num;
+	const size_t sof_len = len * dim * sizeof(tsReal);
+	tsReal *points = ts_int_streamfitter_access_points(fitter);
+	tsReal *rhs = ts_int_streamfitter_access_rhs(fitter);
+	tsReal *x = ts_int_streamfitter_access_solution(fitter);
+	tsReal *upper = ts_int_streamfitter_access_upper(fitter);
+
+	memmove(points, points + num * dim, sof_len);
+	memmove(rhs, rhs + num * dim, sof_len);
+	memmove(x, x + num * dim, sof_len);
+	memmove(upper, upper + num, len * sizeof(tsReal));
+	fitter->pImpl->len = len;
+}
+
+tsError ts_streamfitter_push(tsStreamFitter *fitter, const tsReal *points,
+	size_t num_points, tsReal **segments, size_t *num_segments,
+	tsStatus *status)
+{
+	const size_t dim = ts_streamfitter_dimension(fitter);
+	const size_t la = fitter->pImpl->lookahead;
+	const size_t cap = ts_int_streamfitter_capacity(fitter);
+	const size_t len = fitter->pImpl->len + num_points;
+	size_t i, num;
+
+	*segments = NULL;
+	*num_segments = 0;
+	/* Each time the window is full, the first 'lookahead' segments are
+	 * finalized and removed from the window. */
+	num = len < cap ? 0 : ((len - cap) / la + 1) * la;
+	if (num > 0) {
+		*segments = (tsReal *) malloc(num * 4 * dim * sizeof(tsReal));
+		if (!*segments)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	for (i = 0; i < num_points; i++) {
+		ts_int_streamfitter_append(fitter, points + i * dim);
+		if (fitter->pImpl->len == cap) {
+			ts_int_streamfitter_emit(fitter, la, *segments +
+				*num_segments * 4 * dim);
+			ts_int_streamfitter_shift(fitter, la);
+			*num_segments += la;
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_streamfitter_finish(tsStreamFitter *fitter, tsReal **segments,
+	size_t *num_segments, tsStatus *status)
+{
+	const size_t dim = ts_streamfitter_dimension(fitter);
+	const size_t len = fitter->pImpl->len;
+	const tsReal *points = ts_int_streamfitter_access_points(fitter);
+	size_t i, num;
+
+	*segments = NULL;
+	*num_segments = 0;
+	num = ts_streamfitter_num_points(fitter) == 1 ? 1
+		: (len > 0 ? len - 1 : 0);
+	if (num > 0) {
+		*segments = (tsReal *) malloc(num * 4 * dim * sizeof(tsReal));
+		if (!*segments)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	if (ts_streamfitter_num_points(fitter) == 1) {
+		for (i = 0; i < 4; i++) {
+			memcpy(*segments + i * dim, points,
+				dim * sizeof(tsReal));
+		}
+	} else if (num > 0) {
+		ts_int_streamfitter_emit(fitter, num, *segments);
+	}
+	*num_segments = num;
+	fitter->pImpl->len = 0;
+	fitter->pImpl->n_points = 0;
+	TS_RETURN_SUCCESS(status)
+}
+
+
+struct tsBSplineSurfaceLoft
+{
+	tsReal *net;         /**< The right-hand sides (solved in place). */
+	const tsReal *band;  /**< The LU decomposition of the band matrix. */
+	size_t n;            /**< Number of rows. */
+	size_t q;            /**< Semi-bandwidth. */
+	size_t len;          /**< Number of values per row. */
+};
+
+/* Solves the columns of block \p index of the lofted control net (cf.
+ * TS_INT_LOFT_COLUMNS) by forward and back substitution. */
+void ts_int_bsplinesurface_loft_task(void *args, size_t index)
+{
+	const struct tsBSplineSurfaceLoft *loft =
+		(const struct tsBSplineSurfaceLoft *) args;
+	const size_t w = 2 * loft->q + 1;
+	const size_t begin = index * TS_INT_LOFT_COLUMNS;
+	const size_t end = begin + TS_INT_LOFT_COLUMNS < loft->len ?
+		begin + TS_INT_LOFT_COLUMNS : loft->len;
+	const tsReal *row;
+	tsReal *x = loft->net;
+	size_t i, j, c, lo, hi;
+
+	for (i = 1; i < loft->n; i++) {
+		row = loft->band + i * w + loft->q - i;
+		lo = i > loft->q ? i - loft->q : 0;
+		for (j = lo; j < i; j++) {
+			for (c = begin; c < end; c++) {
+				x[i * loft->len + c] -=
+					row[j] * x[j * loft->len + c];
+			}
+		}
+	}
+	for (i = loft->n; i-- > 0;) {
+		row = loft->band + i * w + loft->q - i;
+		hi = i + loft->q < loft->n - 1 ? i + loft->q : loft->n - 1;
+		for (j = i + 1; j <= hi; j++) {
+			for (c = begin; c < end; c++) {
+				x[i * loft->len + c] -=
+					row[j] * x[j * loft->len + c];
+			}
+		}
+		for (c = begin; c < end; c++)
+			x[i * loft->len + c] /= row[i];
+	}
+}
+
+tsError ts_bsplinesurface_loft(const tsBSpline *sections, size_t num,
+	size_t degree, const tsExecutor *executor,
+	tsBSplineSurface *surface, tsStatus *status)
+{
+	struct tsBSplineSurfaceLoft loft;
+	tsExecutor fallback;
+	tsBSpline *compatible = NULL;
+	tsReal *buf = NULL, *params, *knots, *band, *values, *scratch;
+	tsReal *net, *row, chord, total, pivot, factor;
+	const tsReal *ctrlp_a, *ctrlp_b;
+	size_t i, j, k, s, q, w, dim, deg, n_ctrlp, n_cols;
+	tsError err;
+
+	ts_int_bsplinesurface_init(surface);
+	if (num < 2) {
+		TS_RETURN_1(status, TS_NUM_POINTS,
+			"num(sections) (%lu) < 2", (unsigned long) num)
+	}
+	q = degree < num - 1 ? degree : num - 1;
+	w = 2 * q + 1;
+	if (!executor) {
+		fallback = ts_executor_default();
+		executor = &fallback;
+	}
+
+	TS_TRY(try, err, status)
+		compatible = (tsBSpline *) ts_int_malloc(
+			num * sizeof(tsBSpline));
+		if (!compatible) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		TS_CALL(try, err, ts_bspline_make_compatible(sections, num,
+			executor, compatible, status))
+		dim = ts_bspline_dimension(compatible);
+		deg = ts_bspline_degree(compatible);
+		n_ctrlp = ts_bspline_num_control_points(compatible);
+
+		buf = (tsReal *) ts_int_malloc((num + (num + q + 1) +
+			num * w + (q + 1) + 3 * (q + 1)) * sizeof(tsReal));
+		if (!buf) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		params = buf;
+		knots = params + num;
+		band = knots + num + q + 1;
+		values = band + num * w;
+		scratch = values + q + 1;
+
+		/* Chord length parameters averaged over the columns of the
+		 * control net (cf. 'The NURBS Book', Eq. 10.8). */
+		ts_arr_fill(params, num, 0);
+		n_cols = 0;
+		for (j = 0; j < n_ctrlp; j++) {
+			total = 0;
+			for (k = 1; k < num; k++) {
+				total += ts_distance(
+					ts_int_bspline_access_ctrlp(
+						compatible + k - 1) + j * dim,
+					ts_int_bspline_access_ctrlp(
+						compatible + k) + j * dim,
+					dim);
+			}
+			if (total < TS_CONTROL_POINT_EPSILON)
+				continue;
+			chord = 0;
+			for (k = 1; k < num; k++) {
+				ctrlp_a = ts_int_bspline_access_ctrlp(
+					compatible + k - 1) + j * dim;
+				ctrlp_b = ts_int_bspline_access_ctrlp(
+					compatible + k) + j * dim;
+				chord += ts_distance(ctrlp_a, ctrlp_b, dim);
+				params[k] += chord / total;
+			}
+			n_cols++;
+		}
+		for (k = 1; k < num - 1; k++) {
+			params[k] = n_cols > 0 ? params[k] / n_cols
+				: (tsReal) k / (num - 1);
+		}
+		params[0] = 0;
+		params[num - 1] = 1;
+
+		/* Knots by averaging (cf. 'The NURBS Book', Eq. 9.8). */
+		ts_arr_fill(knots, q + 1, 0);
+		ts_arr_fill(knots + num, q + 1, 1);
+		for (j = 1; j + q < num; j++) {
+			knots[j + q] = 0;
+			if (q == 0) {
+				knots[j] = (params[j - 1] + params[j]) / 2;
+				continue;
+			}
+			for (k = j; k < j + q; k++)
+				knots[j + q] += params[k];
+			knots[j + q] /= q;
+		}
+
+		/* The collocation matrix is banded with semi-bandwidth q. */
+		ts_arr_fill(band, num * w, 0);
+		for (k = 0; k < num; k++) {
+			TS_CALL(try, err, ts_int_knots_span(knots, q, num,
+				params[k], &s, status))
+			ts_int_knots_basis_derivs(knots, q, params[k], s,
+				values, NULL, scratch);
+			for (i = s - q; i <= s; i++) {
+				factor = values[i + q - s];
+				if (i + q >= k && i <= k + q) {
+					band[k * w + i + q - k] = factor;
+				} else if (factor > TS_CONTROL_POINT_EPSILON) {
+					TS_THROW_0(try, err, status,
+						TS_NO_RESULT,
+						"basis exceeds band")
+				}
+			}
+		}
+
+		/* LU decomposition without pivoting, which is stable since
+		 * the collocation matrix is totally positive. */
+		for (k = 0; k < num; k++) {
+			pivot = band[k * w + q];
+			if (pivot < TS_CONTROL_POINT_EPSILON) {
+				TS_THROW_0(try, err, status, TS_NO_RESULT,
+					"singular collocation matrix")
+			}
+			for (i = k + 1; i < num && i <= k + q; i++) {
+				row = band + i * w + q - i;
+				factor = row[k] / pivot;
+				row[k] = factor;
+				for (j = k + 1; j < num && j <= k + q; j++)
+					row[j] -= factor * (band + k * w + q - k)[j];
+			}
+		}
+
+		TS_CALL(try, err, ts_bsplinesurface_new(num, n_ctrlp, dim,
+			q, deg, TS_CLAMPED, surface, status))
+		memcpy(ts_int_bsplinesurface_access_knots_u(surface), knots,
+			(num + q + 1) * sizeof(tsReal));
+		memcpy(ts_int_bsplinesurface_access_knots_v(surface),
+			ts_int_bspline_access_knots(compatible),
+			ts_bspline_num_knots(compatible) * sizeof(tsReal));
+		net = ts_int_bsplinesurface_access_ctrlp(surface);
+		for (k = 0; k < num; k++) {
+			memcpy(net + k * n_ctrlp * dim,
+				ts_int_bspline_access_ctrlp(compatible + k),
+				n_ctrlp * dim * sizeof(tsReal));
+		}
+
+		loft.net = net;
+		loft.band = band;
+		loft.n = num;
+		loft.q = q;
+		loft.len = n_ctrlp * dim;
+		executor->run(executor->ctx, ts_int_bsplinesurface_loft_task,
+			&loft, (loft.len + TS_INT_LOFT_COLUMNS - 1) /
+			TS_INT_LOFT_COLUMNS);
+	TS_CATCH(err)
+		ts_bsplinesurface_free(surface);
+	TS_FINALLY
+		if (compatible) {
+			for (k = 0; k < num; k++)
+				ts_bspline_free(compatible + k);
+			ts_int_free(compatible);
+		}
+		if (buf)
+			ts_int_free(buf);
+	TS_END_TRY_RETURN(err)
+}
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Query Functions                                                          *
+*                                                                             *
+******************************************************************************/
+tsError ts_int_bspline_check_knot(const tsBSpline *spline, tsReal knot,
+	tsStatus *status)
+{
+	tsReal min, max;
+	ts_bspline_domain(spline, &min, &max);
+	if (knot < min && !ts_knots_equal(knot, min)) {
+		TS_RETURN_2(status, TS_U_UNDEFINED,
+			"knot (%f) < min(domain) (%f)", knot, min)
+	}
+	if (knot > max && !ts_knots_equal(knot, max)) {
+		TS_RETURN_2(status, TS_U_UNDEFINED,
+			"knot (%f) > max(domain) (%f)", knot, max)
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns the multiplicity of \p knot, which is located at \p index of the
+ * knot vector \p knots of a spline of degree \p deg. */
+size_t ts_int_knots_multiplicity(const tsReal *knots, size_t deg,
+	tsReal knot, size_t index)
+{
+	size_t multiplicity;
+
+	/* Knots are sorted. Thus, if \p knot differs from the knot at
+	 * \p index, it differs from all preceding knots as well. */
+	if (!ts_knots_equal(knot, knots[index]))
+		return 0;
+	for (multiplicity = deg + 1; multiplicity > 0 ; multiplicity--) {
+		if (ts_knots_equal(knot, knots[index - (multiplicity-1)]))
+			break;
+	}
+	return multiplicity;
+}
+
+size_t ts_int_bspline_knot_multiplicity(const tsBSpline *spline, tsReal knot,
+	size_t index)
+{
+	return ts_int_knots_multiplicity(ts_int_bspline_access_knots(spline),
+		ts_bspline_degree(spline), knot, index);
+}
+
+/* Stores the index of the span of the knot vector \p knots (with
+ * \p num_knots values) that contains \p knot in \p index. \p knot must be
+ * within the domain of the corresponding spline. */
+void ts_int_knots_find(const tsReal *knots, size_t num_knots, tsReal knot,
+	size_t *index)
+{
+	size_t low, high;
+
+	/* Based on 'The NURBS Book' (Les Piegl and Wayne Tiller). */
+	if (ts_knots_equal(knot, knots[num_knots - 1])) {
+		*index = num_knots - 1;
+	} else {
+		low = 0;
+		high = num_knots - 1;
+		*index = (low+high) / 2;
+		while (knot < knots[*index] || knot >= knots[*index + 1]) {
+			if (knot < knots[*index])
+				high = *index;
+			else
+				low = *index;
+			*index = (low+high) / 2;
+		}
+	}
+
+	/* Handle floating point errors. */
+	while (*index < num_knots - 1 && /* there is a next knot */
+		ts_knots_equal(knot, knots[*index + 1])) {
+		(*index)++;
+	}
+}
+
+tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
+	size_t *index, size_t *multiplicity, tsStatus *status)
+{
+	tsError err;
+	TS_CALL_ROE(err, ts_int_bspline_check_knot(spline, knot, status))
+	ts_int_knots_find(ts_int_bspline_access_knots(spline),
+		ts_bspline_num_knots(spline), knot, index);
+	*multiplicity = ts_int_bspline_knot_multiplicity(spline, knot, *index);
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns 1 if the knot at index \p j does not exceed \p knot with respect to
+ * TS_KNOT_EPSILON, 0 otherwise. As knots are sorted, this predicate holds for
+ * a prefix of the knot vector, and ts_int_bspline_find_knot yields the last
+ * index of this prefix. */
+int ts_int_bspline_knot_not_greater(const tsReal *knots, size_t j,
+	tsReal knot)
+{
+	return knots[j] <= knot || ts_knots_equal(knot, knots[j]);
+}
+
+tsError ts_int_bspline_find_knot_from(const tsBSpline *spline, tsReal knot,
+	size_t *index, size_t *multiplicity, tsStatus *status)
+{
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	size_t low, high, mid, step;
+	tsError err;
+
+	TS_CALL_ROE(err, ts_int_bspline_check_knot(spline, knot, status))
+
+	/* Exponential search starting at \p index, which must have been
+	 * found for a knot less than or equal to \p knot. The number of
+	 * steps is logarithmic in the number of skipped knots, i.e.,
+	 * walking through a sorted sequence of knots is linear in the
+	 * number of knots plus the length of the sequence. */
+	low = *index;
+	step = 1;
+	high = low + step;
+	while (high < num_knots &&
+		ts_int_bspline_knot_not_greater(knots, high, knot)) {
+		low = high;
+		step *= 2;
+		high = low + step;
+	}
+	if (high > num_knots)
+		high = num_knots;
+	while (high - low > 1) {
+		mid = low + (high-low) / 2;
+		if (ts_int_bspline_knot_not_greater(knots, mid, knot))
+			low = mid;
+		else
+			high = mid;
+	}
+	*index = low;
+
+	*multiplicity = ts_int_bspline_knot_multiplicity(spline, knot, *index);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_int_bspline_eval_woa(const tsBSpline *spline, tsReal u,
+	tsDeBoorNet *net, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	tsReal *points = NULL;  /**< Pointer to the points of \p net. */
+
+	size_t k;        /**< Index of \p u. */
+	size_t s;        /**< Multiplicity of \p u. */
+
+	tsReal uk;       /**< The actual used u. */
+	size_t from;     /**< Offset used to copy values. */
+	size_t fst;      /**< First affected control point, inclusive. */
+	size_t lst;      /**< Last affected control point, inclusive. */
+	size_t N;        /**< Number of affected control points. */
+
+	/* The following indices are used to create the DeBoor net. */
+	size_t lidx;     /**< Current left index. */
+	size_t ridx;     /**< Current right index. */
+	size_t tidx;     /**< Current to index. */
+	size_t r, i, d;  /**< Used in for loop. */
+	tsReal ui;       /**< Knot value at index i. */
+	tsReal a, a_hat; /**< Weighting factors of control points. */
+
+	tsError err;
+
+	points = ts_int_deboornet_access_points(net);
+
+	/* 1. Find index k such that u is in between [u_k, u_k+1).
+	 * 2. Setup already known values.
+	 * 3. Decide by multiplicity of u how to calculate point P(u). */
+
+	/* 1. */
+	k = s = 0;
+	TS_CALL_ROE(err, ts_int_bspline_find_knot(
+		spline, u, &k, &s, status))
+
+	/* 2. */
+	uk = knots[k];  /* Ensures that with any precision of  */
+	net->pImpl->u = /* tsReal the knot vector stays valid. */
+		ts_knots_equal(u, uk) ? uk : u;
+	net->pImpl->k = k;
+	net->pImpl->s = s;
+	net->pImpl->h = deg < s ? 0 : deg-s; /* prevent underflow */
+
+	/* 3. (by 1. s <= order)
+	 *
+	 * 3a) Check for s = order.
+	 *     Take the two points k-s and k-s + 1. If one of
+	 *     them doesn't exist, take only the other.
+	 * 3b) Use de boor algorithm to find point P(u). */
+	if (s == order) {
+		/* only one of the two control points exists */
+		if (k == deg || /* only the first */
+		    k == num_knots - 1) { /* only the last */
+			from = k == deg ? 0 : (k-s) * dim;
+			net->pImpl->n_points = 1;
+			memcpy(points, ctrlp + from, sof_ctrlp);
+		} else {
+			from = (k-s) * dim;
+			net->pImpl->n_points = 2;
+			memcpy(points, ctrlp + from, 2 * sof_ctrlp);
+		}
+	} else { /* by 3a) s <= deg (order = deg+1) */
+		fst = k-deg; /* by 1. k >= deg */
+		lst = k-s; /* s <= deg <= k */
+		N = lst-fst + 1; /* lst <= fst implies N >= 1 */
+
+		net->pImpl->n_points = (size_t)(N * (N+1) * 0.5f);
+
+		/* copy initial values to output */
+		memcpy(points, ctrlp + fst*dim, N * sof_ctrlp);
+
+		lidx = 0;
+		ridx = dim;
+		tidx = N*dim; /* N >= 1 implies tidx > 0 */
+		r = 1;
+		for (;r <= ts_deboornet_num_insertions(net); r++) {
+			i = fst + r;
+			for (; i <= lst; i++) {
+				ui = knots[i];
+				a = (ts_deboornet_knot(net) - ui) /
+					(knots[i+deg-r+1] - ui);
+				a_hat = 1.f-a;
+
+				for (d = 0; d < dim; d++) {
+					points[tidx++] =
+						a_hat * points[lidx++] +
+						a     * points[ridx++];
+				}
+			}
+			lidx += dim;
+			ridx += dim;
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* The following kernels calculate
+ *
+ * 	dst = a_hat * left + a * dst
+ *
+ * component-wise. They use the same (non-fused) operations in the same order
+ * as the scalar code so that all kernels yield the same values. */
+void ts_int_blend_2(tsReal *dst, const tsReal *left, tsReal a_hat, tsReal a)
+{
+#if defined(TS_INT_SSE2) && !defined(TINYSPLINE_FLOAT_PRECISION)
+	const __m128d ah = _mm_set1_pd(a_hat);
+	const __m128d aa = _mm_set1_pd(a);
+	_mm_storeu_pd(dst, _mm_add_pd(
+		_mm_mul_pd(ah, _mm_loadu_pd(left)),
+		_mm_mul_pd(aa, _mm_loadu_pd(dst))));
+#elif defined(TS_INT_NEON) && !defined(TINYSPLINE_FLOAT_PRECISION)
+	vst1q_f64(dst, vaddq_f64(
+		vmulq_n_f64(vld1q_f64(left), a_hat),
+		vmulq_n_f64(vld1q_f64(dst), a)));
+#else
+	dst[0] = a_hat * left[0] + a * dst[0];
+	dst[1] = a_hat * left[1] + a * dst[1];
+#endif
+}
+
+void ts_int_blend_4(tsReal *dst, const tsReal *left, tsReal a_hat, tsReal a)
+{
+#if defined(TS_INT_SSE2) && defined(TINYSPLINE_FLOAT_PRECISION)
+	const __m128 ah = _mm_set1_ps(a_hat);
+	const __m128 aa = _mm_set1_ps(a);
+	_mm_storeu_ps(dst, _mm_add_ps(
+		_mm_mul_ps(ah, _mm_loadu_ps(left)),
+		_mm_mul_ps(aa, _mm_loadu_ps(dst))));
+#elif defined(TS_INT_NEON) && defined(TINYSPLINE_FLOAT_PRECISION)
+	vst1q_f32(dst, vaddq_f32(
+		vmulq_n_f32(vld1q_f32(left), a_hat),
+		vmulq_n_f32(vld1q_f32(dst), a)));
+#else
+	ts_int_blend_2(dst, left, a_hat, a);
+	ts_int_blend_2(dst + 2, left + 2, a_hat, a);
+#endif
+}
+
+/* Blends a single point of dimension \p dim. */
+void ts_int_blend_point(tsReal *dst, const tsReal *left, size_t dim,
+	tsReal a_hat, tsReal a)
+{
+	size_t d;
+	switch (dim) {
+	case 2:
+		ts_int_blend_2(dst, left, a_hat, a);
+		break;
+	case 3:
+		ts_int_blend_2(dst, left, a_hat, a);
+		dst[2] = a_hat * left[2] + a * dst[2];
+		break;
+	case 4:
+		ts_int_blend_4(dst, left, a_hat, a);
+		break;
+	default:
+		for (d = 0; d < dim; d++)
+			dst[d] = a_hat * left[d] + a * dst[d];
+	}
+}
+
+/* Blends \p dim rows of TS_INT_LANES values each, where row d stores
+ * component d of TS_INT_LANES points. Lane l is weighted by a_hat[l] and
+ * a[l]. */
+void ts_int_blend_lanes(tsReal *dst, const tsReal *left, size_t dim,
+	const tsReal *a_hat, const tsReal *a)
+{
+	size_t d;
+#if defined(TS_INT_SSE2) && !defined(TINYSPLINE_FLOAT_PRECISION)
+	const __m128d ah0 = _mm_loadu_pd(a_hat);
+	const __m128d ah1 = _mm_loadu_pd(a_hat + 2);
+	const __m128d aa0 = _mm_loadu_pd(a);
+	const __m128d aa1 = _mm_loadu_pd(a + 2);
+	for (d = 0; d < dim; d++, dst += 4, left += 4) {
+		_mm_storeu_pd(dst, _mm_add_pd(
+			_mm_mul_pd(ah0, _mm_loadu_pd(left)),
+			_mm_mul_pd(aa0, _mm_loadu_pd(dst))));
+		_mm_storeu_pd(dst + 2, _mm_add_pd(
+			_mm_mul_pd(ah1, _mm_loadu_pd(left + 2)),
+			_mm_mul_pd(aa1, _mm_loadu_pd(dst + 2))));
+	}
+#elif defined(TS_INT_SSE2) && defined(TINYSPLINE_FLOAT_PRECISION)
+	const __m128 ah0 = _mm_loadu_ps(a_hat);
+	const __m128 ah1 = _mm_loadu_ps(a_hat + 4);
+	const __m128 aa0 = _mm_loadu_ps(a);
+	const __m128 aa1 = _mm_loadu_ps(a + 4);
+	for (d = 0; d < dim; d++, dst += 8, left += 8) {
+		_mm_storeu_ps(dst, _mm_add_ps(
+			_mm_mul_ps(ah0, _mm_loadu_ps(left)),
+			_mm_mul_ps(aa0, _mm_loadu_ps(dst))));
+		_mm_storeu_ps(dst + 4, _mm_add_ps(
+			_mm_mul_ps(ah1, _mm_loadu_ps(left + 4)),
+			_mm_mul_ps(aa1, _mm_loadu_ps(dst + 4))));
+	}
+#elif defined(TS_INT_NEON) && !defined(TINYSPLINE_FLOAT_PRECISION)
+	const float64x2_t ah0 = vld1q_f64(a_hat);
+	const float64x2_t ah1 = vld1q_f64(a_hat + 2);
+	const float64x2_t aa0 = vld1q_f64(a);
+	const float64x2_t aa1 = vld1q_f64(a + 2);
+	for (d = 0; d < dim; d++, dst += 4, left += 4) {
+		vst1q_f64(dst, vaddq_f64(
+			vmulq_f64(ah0, vld1q_f64(left)),
+			vmulq_f64(aa0, vld1q_f64(dst))));
+		vst1q_f64(dst + 2, vaddq_f64(
+			vmulq_f64(ah1, vld1q_f64(left + 2)),
+			vmulq_f64(aa1, vld1q_f64(dst + 2))));
+	}
+#elif defined(TS_INT_NEON) && defined(TINYSPLINE_FLOAT_PRECISION)
+	const float32x4_t ah0 = vld1q_f32(a_hat);
+	const float32x4_t ah1 = vld1q_f32(a_hat + 4);
+	const float32x4_t aa0 = vld1q_f32(a);
+	const float32x4_t aa1 = vld1q_f32(a + 4);
+	for (d = 0; d < dim; d++, dst += 8, left += 8) {
+		vst1q_f32(dst, vaddq_f32(
+			vmulq_f32(ah0, vld1q_f32(left)),
+			vmulq_f32(aa0, vld1q_f32(dst))));
+		vst1q_f32(dst + 4, vaddq_f32(
+			vmulq_f32(ah1, vld1q_f32(left + 4)),
+			vmulq_f32(aa1, vld1q_f32(dst + 4))));
+	}
+#else
+	size_t l;
+	for (d = 0; d < dim; d++, dst += TS_INT_LANES, left += TS_INT_LANES) {
+		for (l = 0; l < TS_INT_LANES; l++)
+			dst[l] = a_hat[l] * left[l] + a[l] * dst[l];
+	}
+#endif
+}
+
+#ifdef TS_INT_AVX
+__attribute__((target("avx")))
+void ts_int_blend_lanes_avx(tsReal *dst, const tsReal *left, size_t dim,
+	const tsReal *a_hat, const tsReal *a)
+{
+	size_t d;
+#ifdef TINYSPLINE_FLOAT_PRECISION
+	const __m256 ah = _mm256_loadu_ps(a_hat);
+	const __m256 aa = _mm256_loadu_ps(a);
+	for (d = 0; d < dim; d++, dst += 8, left += 8) {
+		_mm256_storeu_ps(dst, _mm256_add_ps(
+			_mm256_mul_ps(ah, _mm256_loadu_ps(left)),
+			_mm256_mul_ps(aa, _mm256_loadu_ps(dst))));
+	}
+#else
+	const __m256d ah = _mm256_loadu_pd(a_hat);
+	const __m256d aa = _mm256_loadu_pd(a);
+	for (d = 0; d < dim; d++, dst += 4, left += 4) {
+		_mm256_storeu_pd(dst, _mm256_add_pd(
+			_mm256_mul_pd(ah, _mm256_loadu_pd(left)),
+			_mm256_mul_pd(aa, _mm256_loadu_pd(dst))));
+	}
+#endif
+}
+#endif
+
+/* Returns 1 if the AVX kernels can be used on this machine, 0 otherwise. */
+int ts_int_simd_avx(void)
+{
+#ifdef TS_INT_AVX
+	return __builtin_cpu_supports("avx") ? 1 : 0;
+#else
+	return 0;
+#endif
+}
+
+/* Calculates the values of the basis functions of a spline of degree \p deg
+ * with \p n_ctrlp control points and knot vector \p knots at \p u, which
+ * is located in span \p k with multiplicity \p s (cf.
+ * ts_int_bspline_find_knot). Stores the index of the first control point
+ * affecting \p u in \p first and the weights of the control points
+ * [first, first + order) in \p weights. \p scratch must provide space for
+ * 2 * order values. Like ts_int_bspline_eval_column, the first point is
+ * taken if s == order. Based on 'The NURBS Book' (algorithm A2.2). */
+void ts_int_knots_basis(const tsReal *knots, size_t deg, size_t n_ctrlp,
+	tsReal u, size_t k, size_t s, size_t *first, tsReal *weights,
+	tsReal *scratch)
+{
+	const size_t order = deg + 1;
+	tsReal *left = scratch;
+	tsReal *right = scratch + order;
+	tsReal saved, temp;
+	size_t j, r, offset;
+
+	u = ts_knots_equal(u, knots[k]) ? knots[k] : u;
+
+	if (s == order) {
+		offset = k == deg ? 0 : k-s;
+		*first = offset + order > n_ctrlp ? n_ctrlp - order : offset;
+		ts_arr_fill(weights, order, 0);
+		weights[offset - *first] = 1;
+		return;
+	}
+
+	weights[0] = 1;
+	for (j = 1; j <= deg; j++) {
+		left[j] = u - knots[k+1-j];
+		right[j] = knots[k+j] - u;
+		saved = 0;
+		for (r = 0; r < j; r++) {
+			temp = weights[r] / (right[r+1] + left[j-r]);
+			weights[r] = saved + right[r+1] * temp;
+			saved = left[j-r] * temp;
+		}
+		weights[j] = saved;
+	}
+
+	/* The weights belong to the control points [k-deg, k], which may
+	 * exceed the control points if the knot vector is not clamped. In
+	 * this case, the exceeding weights are 0 (the corresponding control
+	 * points follow k-s) and the window is shifted accordingly. */
+	*first = k-deg;
+	if (*first + order > n_ctrlp) {
+		offset = *first + order - n_ctrlp;
+		*first -= offset;
+		for (j = order; j-- > offset;)
+			weights[j] = weights[j - offset];
+		ts_arr_fill(weights, offset, 0);
+	}
+}
+
+/* Calculates the values of the basis functions of \p spline at \p u (cf.
+ * ts_int_knots_basis). */
+void ts_int_bspline_basis(const tsBSpline *spline, tsReal u, size_t k,
+	size_t s, size_t *first, tsReal *weights, tsReal *scratch)
+{
+	ts_int_knots_basis(ts_int_bspline_access_knots(spline),
+		ts_bspline_degree(spline),
+		ts_bspline_num_control_points(spline), u, k, s, first,
+		weights, scratch);
+}
+
+void ts_int_bspline_eval_column(const tsBSpline *spline, tsReal u, size_t k,
+	size_t s, tsReal *column, tsReal *point)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+
+	tsReal uk;       /**< The actual used u. */
+	size_t fst;      /**< First affected control point, inclusive. */
+	size_t lst;      /**< Last affected control point, inclusive. */
+	size_t N;        /**< Number of affected control points. */
+	size_t r, i, j;
+	tsReal ui;       /**< Knot value at index i. */
+	tsReal a, a_hat; /**< Weighting factors of control points. */
+
+	/* Same snapping and same arithmetic as ts_int_bspline_eval_woa so
+	 * that the points of both functions are bitwise identical. */
+	uk = knots[k];
+	u = ts_knots_equal(u, uk) ? uk : u;
+
+	if (s == order) {
+		/* Discontinuous at u. Take the first point only. */
+		memcpy(point, ctrlp + (k == deg ? 0 : (k-s) * dim),
+			sof_ctrlp);
+		return;
+	}
+
+	fst = k-deg;
+	lst = k-s;
+	N = lst-fst + 1;
+	memcpy(column, ctrlp + fst*dim, N * sof_ctrlp);
+
+	/* The net is calculated in place, column by column. Traversing i
+	 * backwards guarantees that the point at i-1 still holds the value
+	 * of the previous column. */
+	for (r = 1; r <= deg-s; r++) {
+		for (i = lst; i >= fst + r; i--) {
+			ui = knots[i];
+			a = (u - ui) / (knots[i+deg-r+1] - ui);
+			a_hat = 1.f-a;
+			j = (i-fst) * dim;
+			ts_int_blend_point(column + j, column + j - dim,
+				dim, a_hat, a);
+		}
+	}
+	memcpy(point, column + (N-1) * dim, sof_ctrlp);
+}
+
+/* Evaluates the TS_INT_LANES knots \p us, all of which are located in the
+ * span \p k with multiplicity 0, simultaneously. The de Boor net is
+ * calculated in \p work (order * dim * TS_INT_LANES values), where lane l
+ * holds the column of us[l]. Writes the first \p num points to \p points. */
+void ts_int_bspline_eval_lanes(const tsBSpline *spline, const tsReal *us,
+	size_t num, size_t k, int avx, tsReal *work, tsReal *points)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t row = dim * TS_INT_LANES;
+	const size_t fst = k-deg;
+
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+
+	tsReal a[TS_INT_LANES], a_hat[TS_INT_LANES];
+	tsReal ui, span;
+	size_t r, i, j, d, l;
+
+	for (j = 0; j <= deg; j++) {
+		for (d = 0; d < dim; d++) {
+			for (l = 0; l < TS_INT_LANES; l++) {
+				work[j*row + d*TS_INT_LANES + l] =
+					ctrlp[(fst+j)*dim + d];
+			}
+		}
+	}
+
+	for (r = 1; r <= deg; r++) {
+		for (i = k; i >= fst + r; i--) {
+			ui = knots[i];
+			span = knots[i+deg-r+1] - ui;
+			for (l = 0; l < TS_INT_LANES; l++) {
+				a[l] = (us[l] - ui) / span;
+				a_hat[l] = 1.f-a[l];
+			}
+			j = (i-fst) * row;
+#ifdef TS_INT_AVX
+			if (avx) {
+				ts_int_blend_lanes_avx(work + j, work + j - row,
+					dim, a_hat, a);
+				continue;
+			}
+#endif
+			ts_int_blend_lanes(work + j, work + j - row, dim,
+				a_hat, a);
+		}
+	}
+
+	j = deg * row;
+	for (l = 0; l < num; l++) {
+		for (d = 0; d < dim; d++)
+			points[l*dim + d] = work[j + d*TS_INT_LANES + l];
+	}
+	(void) avx;
+}
+
+tsError ts_bspline_eval(const tsBSpline *spline, tsReal u, tsDeBoorNet *net,
+	tsStatus *status)
+{
+	tsError err;
+	ts_int_deboornet_init(net);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_int_deboornet_new(
+			spline, net, status))
+		TS_CALL(try, err, ts_int_bspline_eval_woa(
+			spline, u, net, status))
+	TS_CATCH(err)
+		ts_deboornet_free(net);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_eval_point(const tsBSpline *spline, tsReal u,
+	tsReal *point, tsReal *workspace, tsStatus *status)
+{
+	const size_t len_column = ts_bspline_order(spline) *
+		ts_bspline_dimension(spline);
+	tsReal stack[TS_INT_EVAL_STACK];
+	tsReal *column = workspace;
+	size_t k, s;
+	tsError err;
+
+	TS_CALL_ROE(err, ts_int_bspline_find_knot(spline, u, &k, &s, status))
+	if (!column && len_column <= TS_INT_EVAL_STACK)
+		column = stack;
+	if (!column) {
+		column = (tsReal *) ts_int_malloc(len_column * sizeof(tsReal));
+		if (!column)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	ts_int_bspline_eval_column(spline, u, k, s, column, point);
+	if (column != workspace && column != stack)
+		ts_int_free(column);
+	TS_RETURN_SUCCESS(status)
+}
+
+size_t ts_bspline_len_eval_workspace(const tsBSpline *spline)
+{
+	return ts_bspline_order(spline) * ts_bspline_dimension(spline) *
+		TS_INT_LANES;
+}
+
+tsError ts_bspline_eval_batch(const tsBSpline *spline, const tsReal *us,
+	size_t num, tsReal *points, tsReal *workspace, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const int avx = ts_int_simd_avx();
+	size_t ks[TS_INT_LANES], ss[TS_INT_LANES];
+	tsReal lanes[TS_INT_LANES];
+	size_t i, l, n, k, s, idx;
+	int same_span;
+	tsError err;
+
+	k = s = 0;
+	for (i = 0; i < num; i += n) {
+		n = num - i < TS_INT_LANES ? num - i : TS_INT_LANES;
+		same_span = 1;
+		for (l = 0; l < n; l++) {
+			idx = i + l;
+			if (idx > 0 && us[idx] >= us[idx-1]) {
+				/* Ascending knots: continue at the previous
+				 * span. */
+				TS_CALL_ROE(err, ts_int_bspline_find_knot_from(
+					spline, us[idx], &k, &s, status))
+			} else {
+				TS_CALL_ROE(err, ts_int_bspline_find_knot(
+					spline, us[idx], &k, &s, status))
+			}
+			ks[l] = k;
+			ss[l] = s;
+			same_span = same_span && k == ks[0] && s == 0;
+		}
+
+		if (n > 1 && same_span) {
+			/* Unused lanes replicate the last knot. */
+			for (l = 0; l < TS_INT_LANES; l++)
+				lanes[l] = us[i + (l < n ? l : n - 1)];
+			ts_int_bspline_eval_lanes(spline, lanes, n, k, avx,
+				workspace, points + i * dim);
+		} else {
+			for (l = 0; l < n; l++) {
+				ts_int_bspline_eval_column(spline, us[i + l],
+					ks[l], ss[l], workspace,
+					points + (i + l) * dim);
+			}
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_eval_all(const tsBSpline *spline, const tsReal *us,
+	size_t num, tsReal **points, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_point = dim * sizeof(tsReal);
+	const size_t sof_points = num * sof_point;
+	const size_t sof_workspace =
+		ts_bspline_len_eval_workspace(spline) * sizeof(tsReal);
+	tsReal *workspace = NULL;
+	tsError err;
+	TS_TRY(try, err, status)
+		*points = (tsReal *) malloc(sof_points);
+		workspace = (tsReal *) ts_int_malloc(sof_workspace);
+		if (!*points || !workspace) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		TS_CALL(try, err, ts_bspline_eval_batch(
+			spline, us, num, *points, workspace, status))
+	TS_CATCH(err)
+		if (*points)
+			free(*points);
+		*points = NULL;
+	TS_FINALLY
+		if (workspace)
+			ts_int_free(workspace);
+	TS_END_TRY_RETURN(err)
+}
+
+/* Calculates the first index and the basis function values (cf.
+ * ts_int_bspline_basis) of \p spline for each knot in \p us. \p first and
+ * \p weights must provide space for \p num and num * order values. */
+tsError ts_int_bspline_basis_rows(const tsBSpline *spline, const tsReal *us,
+	size_t num, size_t *first, tsReal *weights, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	tsReal *scratch = NULL;
+	size_t i, k, s;
+	tsError err;
+
+	TS_TRY(try, err, status)
+		scratch = (tsReal *) ts_int_malloc(2 * order * sizeof(tsReal));
+		if (!scratch)
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		k = s = 0;
+		for (i = 0; i < num; i++) {
+			if (i > 0 && us[i] >= us[i-1]) {
+				TS_CALL(try, err, ts_int_bspline_find_knot_from(
+					spline, us[i], &k, &s, status))
+			} else {
+				TS_CALL(try, err, ts_int_bspline_find_knot(
+					spline, us[i], &k, &s, status))
+			}
+			ts_int_bspline_basis(spline, us[i], k, s, first + i,
+				weights + i * order, scratch);
+		}
+	TS_FINALLY
+		if (scratch)
+			ts_int_free(scratch);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_eval_plan(const tsBSpline *spline, const tsReal *us,
+	size_t num, tsEvalPlan *plan, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const size_t sof_plan = sizeof(struct tsEvalPlanImpl) +
+		num * sizeof(size_t) +
+		(n_knots + num * order) * sizeof(tsReal);
+	tsError err;
+
+	ts_int_evalplan_init(plan);
+	TS_TRY(try, err, status)
+		plan->pImpl = (struct tsEvalPlanImpl *) ts_int_allocate(
+			&spline->pImpl->allocator, sof_plan);
+		if (!plan->pImpl)
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		plan->pImpl->allocator = spline->pImpl->allocator;
+		plan->pImpl->deg = ts_bspline_degree(spline);
+		plan->pImpl->n_ctrlp = ts_bspline_num_control_points(spline);
+		plan->pImpl->n_knots = n_knots;
+		plan->pImpl->n_points = num;
+		memcpy(ts_int_evalplan_access_knots(plan),
+			ts_int_bspline_access_knots(spline),
+			ts_bspline_sof_knots(spline));
+		TS_CALL(try, err, ts_int_bspline_basis_rows(
+			spline, us, num, ts_int_evalplan_access_first(plan),
+			ts_int_evalplan_access_weights(plan), status))
+	TS_CATCH(err)
+		ts_evalplan_free(plan);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_basis_banded(const tsBSpline *spline, const tsReal *us,
+	size_t num, size_t **first, tsReal **values, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	tsError err;
+
+	*first = NULL;
+	*values = NULL;
+	TS_TRY(try, err, status)
+		*first = (size_t *) malloc(num * sizeof(size_t));
+		*values = (tsReal *) malloc(num * order * sizeof(tsReal));
+		if (!*first || !*values)
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		TS_CALL(try, err, ts_int_bspline_basis_rows(
+			spline, us, num, *first, *values, status))
+	TS_CATCH(err)
+		free(*first);
+		free(*values);
+		*first = NULL;
+		*values = NULL;
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_basis_csr(const tsBSpline *spline, const tsReal *us,
+	size_t num, size_t **row_ptr, size_t **col_idx, tsReal **values,
+	tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	size_t i, j;
+	tsError err;
+
+	*row_ptr = NULL;
+	*col_idx = NULL;
+	*values = NULL;
+	TS_TRY(try, err, status)
+		*row_ptr = (size_t *) malloc((num + 1) * sizeof(size_t));
+		*col_idx = (size_t *) malloc(num * order * sizeof(size_t));
+		*values = (tsReal *) malloc(num * order * sizeof(tsReal));
+		if (!*row_ptr || !*col_idx || !*values)
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		/* The first indices are buffered in row_ptr. */
+		TS_CALL(try, err, ts_int_bspline_basis_rows(
+			spline, us, num, *row_ptr, *values, status))
+		for (i = 0; i < num; i++) {
+			for (j = 0; j < order; j++)
+				(*col_idx)[i * order + j] = (*row_ptr)[i] + j;
+		}
+		for (i = 0; i <= num; i++)
+			(*row_ptr)[i] = i * order;
+	TS_CATCH(err)
+		free(*row_ptr);
+		free(*col_idx);
+		free(*values);
+		*row_ptr = NULL;
+		*col_idx = NULL;
+		*values = NULL;
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_evalplan_apply(const tsEvalPlan *plan, const tsBSpline *spline,
+	tsReal *points, tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num = ts_evalplan_num_points(plan);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const size_t *first = ts_int_evalplan_access_first(plan);
+	const tsReal *weights = ts_int_evalplan_access_weights(plan);
+	const tsReal *w, *c;
+	tsReal *p;
+	size_t i, j, d;
+
+	if (ts_bspline_degree(spline) != ts_evalplan_degree(plan) ||
+		ts_bspline_num_knots(spline) != plan->pImpl->n_knots) {
+		TS_RETURN_4(status, TS_INCOMPATIBLE,
+			"spline (degree: %lu, knots: %lu) does not match plan "
+			"(degree: %lu, knots: %lu)",
+			(unsigned long) ts_bspline_degree(spline),
+			(unsigned long) ts_bspline_num_knots(spline),
+			(unsigned long) ts_evalplan_degree(plan),
+			(unsigned long) plan->pImpl->n_knots)
+	}
+	if (memcmp(ts_int_bspline_access_knots(spline),
+		ts_int_evalplan_access_knots(plan),
+		ts_bspline_sof_knots(spline))) {
+		TS_RETURN_0(status, TS_INCOMPATIBLE,
+			"knots of spline and plan differ")
+	}
+
+	for (i = 0; i < num; i++) {
+		w = weights + i * order;
+		c = ctrlp + first[i] * dim;
+		p = points + i * dim;
+		for (d = 0; d < dim; d++)
+			p[d] = w[0] * c[d];
+		for (j = 1; j < order; j++) {
+			c += dim;
+			for (d = 0; d < dim; d++)
+				p[d] += w[j] * c[d];
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns the (non-empty) span of the basis functions that are used to
+ * evaluate \p spline at the knot located at index \p k with multiplicity
+ * \p s (cf. ts_int_bspline_find_knot). If the knot is an element of the knot
+ * vector (s > 0), the span left of the knot is used such that the
+ * derivatives are the left-hand side limits, which equal the results of
+ * ts_bspline_derive and ts_bspline_eval, and the point equals the result of
+ * ts_bspline_eval if \p spline is discontinuous at the knot. Likewise, the
+ * last span of the domain is used at the maximum of the domain. Only at the
+ * minimum of the domain, the span right of the knot is used. */
+size_t ts_int_bspline_eval_span(const tsBSpline *spline, size_t k, size_t s)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t num_ctrlp = ts_bspline_num_control_points(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	size_t span = k;
+	if (k >= num_ctrlp || (s > 0 && k >= deg + s)) {
+		span = k >= num_ctrlp ? num_ctrlp - 1 : k - s;
+		while (span > deg && !(knots[span] < knots[span + 1]))
+			span--;
+	}
+	return span < deg ? deg : span;
+}
+
+/* Calculates the values and the first \p n derivatives (n <= deg) of the
+ * 'order' basis functions that are non-zero in span \p k at knot \p u (cf.
+ * The NURBS Book, Algorithm A2.3). Row i of \p ders ('order' values) receives
+ * the i-th derivatives. \p work provides space for 'order * order + 4 *
+ * order' values. */
+void ts_int_bspline_basis_ders(const tsReal *knots, size_t deg, size_t k,
+	tsReal u, size_t n, tsReal *ders, tsReal *work)
+{
+	const size_t order = deg + 1;
+	tsReal *ndu = work;                 /**< Basis and knot differences. */
+	tsReal *left = ndu + order * order; /**< u - knots[k+1-j]. */
+	tsReal *right = left + order;       /**< knots[k+j] - u. */
+	tsReal *a = right + order;          /**< Two rows of coefficients. */
+	tsReal *a1, *a2, *swap;
+	tsReal saved, tmp, d;
+	size_t i, j, r, j1, j2, pi, fac;
+
+	ndu[0] = 1.f;
+	for (j = 1; j <= deg; j++) {
+		left[j] = u - knots[k + 1 - j];
+		right[j] = knots[k + j] - u;
+		saved = 0.f;
+		for (r = 0; r < j; r++) {
+			/* The lower triangle stores the knot differences. */
+			ndu[j * order + r] = right[r + 1] + left[j - r];
+			tmp = ndu[r * order + j - 1] / ndu[j * order + r];
+			/* The upper triangle stores the basis functions. */
+			ndu[r * order + j] = saved + right[r + 1] * tmp;
+			saved = left[j - r] * tmp;
+		}
+		ndu[j * order + j] = saved;
+	}
+	for (j = 0; j <= deg; j++)
+		ders[j] = ndu[j * order + deg];
+
+	for (r = 0; r <= deg; r++) {
+		a1 = a;
+		a2 = a + order;
+		a1[0] = 1.f;
+		for (i = 1; i <= n; i++) {
+			d = 0.f;
+			pi = deg - i;
+			if (r >= i) {
+				a2[0] = a1[0] / ndu[(pi + 1) * order + r - i];
+				d = a2[0] * ndu[(r - i) * order + pi];
+			}
+			j1 = r + 1 >= i ? 1 : i - r;
+			j2 = r <= pi + 1 ? i - 1 : deg - r;
+			for (j = j1; j <= j2; j++) {
+				a2[j] = (a1[j] - a1[j - 1]) /
+					ndu[(pi + 1) * order + r + j - i];
+				d += a2[j] * ndu[(r + j - i) * order + pi];
+			}
+			if (r <= pi) {
+				a2[i] = -a1[i - 1] / ndu[(pi + 1) * order + r];
+				d += a2[i] * ndu[r * order + pi];
+			}
+			ders[i * order + r] = d;
+			swap = a1;
+			a1 = a2;
+			a2 = swap;
+		}
+	}
+
+	fac = deg;
+	for (i = 1; i <= n; i++) {
+		for (j = 0; j <= deg; j++)
+			ders[i * order + j] *= (tsReal) fac;
+		fac *= deg - i;
+	}
+}
+
+/* Evaluates the point and the first \p n derivatives of \p spline at knot
+ * \p u, which is located at index \p k with multiplicity \p s. */
+void ts_int_bspline_eval_derivatives(const tsBSpline *spline, tsReal u,
+	size_t k, size_t s, size_t n, tsReal *points, tsReal *workspace)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num = n < deg ? n : deg;
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const size_t span = ts_int_bspline_eval_span(spline, k, s);
+	tsReal *ders = workspace + order * order + 4 * order;
+	const tsReal *p;
+	size_t i, j, d;
+
+	/* Same snapping as ts_int_bspline_eval_woa. */
+	u = ts_knots_equal(u, knots[k]) ? knots[k] : u;
+	ts_int_bspline_basis_ders(knots, deg, span, u, num, ders, workspace);
+	for (i = 0; i <= num; i++) {
+		ts_arr_fill(points + i * dim, dim, 0.f);
+		for (j = 0; j < order; j++) {
+			p = ctrlp + (span - deg + j) * dim;
+			for (d = 0; d < dim; d++)
+				points[i * dim + d] +=
+					ders[i * order + j] * p[d];
+		}
+	}
+	/* Derivatives of higher order than deg vanish. */
+	if (n > num)
+		ts_arr_fill(points + (num + 1) * dim, (n - num) * dim, 0.f);
+}
+
+size_t ts_bspline_len_eval_derivatives_workspace(const tsBSpline *spline,
+	size_t n)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = deg + 1;
+	return order * (order + 4 + (n < deg ? n : deg) + 1);
+}
+
+/* Evaluates the point and the first \p n derivatives of the rational spline
+ * \p spline at knot \p u, which is located at index \p k with multiplicity
+ * \p s. The derivatives of the homogeneous spline are stored behind the
+ * workspace of ts_int_bspline_eval_derivatives and are projected with the
+ * quotient rule (cf. The NURBS Book, Algorithm A4.2). That is, the weight and
+ * its derivatives never leave the workspace. */
+void ts_int_bspline_eval_rational(const tsBSpline *spline, tsReal u,
+	size_t k, size_t s, size_t n, tsReal *points, tsReal *workspace)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t cdim = dim - 1; /**< Dimension of the points. */
+	tsReal *hom = workspace +
+		ts_bspline_len_eval_derivatives_workspace(spline, n);
+	const tsReal *q;
+	tsReal *p, w;
+	size_t i, j, d, binom;
+
+	ts_int_bspline_eval_derivatives(spline, u, k, s, n, hom, workspace);
+	w = hom[cdim];
+	for (i = 0; i <= n; i++) {
+		p = points + i * cdim;
+		for (d = 0; d < cdim; d++)
+			p[d] = hom[i * dim + d];
+		binom = 1;
+		for (j = 1; j <= i; j++) {
+			binom = binom * (i-j+1) / j;
+			q = points + (i-j) * cdim;
+			for (d = 0; d < cdim; d++) {
+				p[d] -= (tsReal) binom *
+					hom[j * dim + cdim] * q[d];
+			}
+		}
+		for (d = 0; d < cdim; d++)
+			p[d] /= w;
+	}
+}
+
+size_t ts_bspline_len_eval_rational_workspace(const tsBSpline *spline,
+	size_t n)
+{
+	return ts_bspline_len_eval_derivatives_workspace(spline, n) +
+		(n + 1) * ts_bspline_dimension(spline);
+}
+
+/* Implements ts_bspline_eval_derivatives_batch and, if \p rational is not 0,
+ * ts_bspline_eval_rational_batch. */
+tsError ts_int_bspline_eval_derivatives_batch(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, int rational, tsReal *points,
+	tsReal *workspace, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline) - (rational ? 1 : 0);
+	const size_t len_workspace = rational ?
+		ts_bspline_len_eval_rational_workspace(spline, n) :
+		ts_bspline_len_eval_derivatives_workspace(spline, n);
+	tsReal stack[TS_INT_EVAL_STACK];
+	tsReal *work = workspace;
+	size_t i, k = 0, s = 0;
+	tsError err;
+
+	if (!work && len_workspace <= TS_INT_EVAL_STACK)
+		work = stack;
+	if (!work) {
+		work = (tsReal *) ts_int_malloc(len_workspace * sizeof(tsReal));
+		if (!work)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	TS_TRY(try, err, status)
+		for (i = 0; i < num; i++) {
+			if (i > 0 && us[i] >= us[i-1]) {
+				/* Ascending knots: continue at the previous
+				 * span. */
+				TS_CALL(try, err, ts_int_bspline_find_knot_from(
+					spline, us[i], &k, &s, status))
+			} else {
+				TS_CALL(try, err, ts_int_bspline_find_knot(
+					spline, us[i], &k, &s, status))
+			}
+			if (rational) {
+				ts_int_bspline_eval_rational(spline, us[i], k,
+					s, n, points + i * (n + 1) * dim,
+					work);
+			} else {
+				ts_int_bspline_eval_derivatives(spline, us[i],
+					k, s, n, points + i * (n + 1) * dim,
+					work);
+			}
+		}
+	TS_FINALLY
+		if (work != workspace && work != stack)
+			ts_int_free(work);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_eval_derivatives_batch(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, tsReal *points,
+	tsReal *workspace, tsStatus *status)
+{
+	return ts_int_bspline_eval_derivatives_batch(spline, us, num, n, 0,
+		points, workspace, status);
+}
+
+tsError ts_bspline_eval_derivatives(const tsBSpline *spline, tsReal u,
+	size_t n, tsReal *points, tsReal *workspace, tsStatus *status)
+{
+	return ts_bspline_eval_derivatives_batch(spline, &u, 1, n, points,
+		workspace, status);
+}
+
+tsError ts_bspline_eval_rational_batch(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t n, tsReal *points,
+	tsReal *workspace, tsStatus *status)
+{
+	tsError err;
+	TS_CALL_ROE(err, ts_int_bspline_check_rational(spline, status))
+	return ts_int_bspline_eval_derivatives_batch(spline, us, num, n, 1,
+		points, workspace, status);
+}
+
+tsError ts_bspline_eval_rational(const tsBSpline *spline, tsReal u,
+	size_t n, tsReal *points, tsReal *workspace, tsStatus *status)
+{
+	return ts_bspline_eval_rational_batch(spline, &u, 1, n, points,
+		workspace, status);
+}
+
+struct tsEvalAllTask
+{
+	const tsBSpline *spline;
+	const tsReal *us;
+	size_t num;           /**< Number of knots in us. */
+	tsReal *points;
+	tsReal *workspaces;   /**< One workspace per task. */
+	size_t len_workspace; /**< Length of a single workspace. */
+	tsStatus *statuses;   /**< One status per task. */
+};
+
+void ts_int_eval_all_task(void *args, size_t index)
+{
+	struct tsEvalAllTask *task = (struct tsEvalAllTask *) args;
+	const size_t dim = ts_bspline_dimension(task->spline);
+	const size_t begin = index * TS_INT_TASK_SIZE;
+	const size_t num = task->num - begin < TS_INT_TASK_SIZE ?
+		task->num - begin : TS_INT_TASK_SIZE;
+	ts_bspline_eval_batch(task->spline, task->us + begin, num,
+		task->points + begin * dim,
+		task->workspaces + index * task->len_workspace,
+		task->statuses + index);
+}
+
+tsError ts_bspline_eval_all_parallel(const tsBSpline *spline,
+	const tsReal *us, size_t num, const tsExecutor *executor,
+	tsReal **points, tsStatus *status)
+{
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t sof_points = num * dim * sizeof(tsReal);
+	const size_t num_tasks = (num + TS_INT_TASK_SIZE - 1) /
+		TS_INT_TASK_SIZE;
+	const size_t len_workspace = ts_bspline_len_eval_workspace(spline);
+	struct tsEvalAllTask task;
+	tsExecutor fallback;
+	tsReal *workspaces = NULL;
+	tsStatus *statuses = NULL;
+	size_t i;
+	tsError err;
+
+	if (!executor) {
+		fallback = ts_executor_default();
+		executor = &fallback;
+	}
+
+	TS_TRY(try, err, status)
+		*points = (tsReal *) malloc(sof_points);
+		if (!*points) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		if (num_tasks > 0) {
+			workspaces = (tsReal *) ts_int_malloc(
+				num_tasks * len_workspace * sizeof(tsReal));
+			statuses = (tsStatus *) ts_int_malloc(
+				num_tasks * sizeof(tsStatus));
+			if (!workspaces || !statuses) {
+				TS_THROW_0(try, err, status, TS_MALLOC,
+					"out of memory")
+			}
+		}
+
+		task.spline = spline;
+		task.us = us;
+		task.num = num;
+		task.points = *points;
+		task.workspaces = workspaces;
+		task.len_workspace = len_workspace;
+		task.statuses = statuses;
+		executor->run(executor->ctx, ts_int_eval_all_task, &task,
+			num_tasks);
+
+		for (i = 0; i < num_tasks; i++) {
+			if (statuses[i].code != TS_SUCCESS) {
+				TS_THROW_1(try, err, status, statuses[i].code,
+					"%s", statuses[i].message)
+			}
+		}
+	TS_CATCH(err)
+		if (*points)
+			free(*points);
+		*points = NULL;
+	TS_FINALLY
+		if (workspaces)
+			ts_int_free(workspaces);
+		if (statuses)
+			ts_int_free(statuses);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_int_bspline_sample_knots(const tsBSpline *spline, size_t num,
+	tsReal **knots, size_t *actual_num, tsStatus *status)
+{
+	tsReal min, max;
+	size_t i;
+	if (num == 0)
+		num = (ts_bspline_num_control_points(spline) -
+			ts_bspline_degree(spline)) * 30;
+	*actual_num = num;
+	*knots = (tsReal *) ts_int_malloc(num * sizeof(tsReal));
+	if (!*knots)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < num; i++) {
+		(*knots)[i] = max - min;
+		(*knots)[i] *= (tsReal)i / (num - 1);
+		(*knots)[i] += min;
+	}
+	/* Set knots[0] after knots[num - 1] to ensure that
+	 * knots[0] = min if num == 1. */
+	(*knots)[num - 1] = max;
+	(*knots)[0] = min;
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_sample(const tsBSpline *spline, size_t num, tsReal **points,
+	size_t *actual_num, tsStatus *status)
+{
+	tsError err;
+	tsReal *knots;
+	*points = NULL;
+	TS_CALL_ROE(err, ts_int_bspline_sample_knots(
+		spline, num, &knots, actual_num, status))
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval_all(
+			spline, knots, *actual_num, points, status))
+	TS_FINALLY
+		ts_int_free(knots);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_sample_parallel(const tsBSpline *spline, size_t num,
+	const tsExecutor *executor, tsReal **points, size_t *actual_num,
+	tsStatus *status)
+{
+	tsError err;
+	tsReal *knots;
+	*points = NULL;
+	TS_CALL_ROE(err, ts_int_bspline_sample_knots(
+		spline, num, &knots, actual_num, status))
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval_all_parallel(
+			spline, knots, *actual_num, executor, points, status))
+	TS_FINALLY
+		ts_int_free(knots);
+	TS_END_TRY_RETURN(err)
+}
+
+/* Nodes and weights of the 5-point Gauss-Legendre quadrature on [-1, 1]. */
+static const double ts_int_gauss_nodes[5] = {
+	-0.9061798459386640, -0.5384693101056831, 0.0,
+	0.5384693101056831, 0.9061798459386640
+};
+static const double ts_int_gauss_weights[5] = {
+	0.2369268850561891, 0.4786286704993665, 0.5688888888888889,
+	0.4786286704993665, 0.2369268850561891
+};
+
+/* Returns the norm of the polynomial of span \p k of \p deriv (i.e., the
+ * speed of the corresponding spline) at \p u, which may be located at (or
+ * even slightly beyond) the boundaries of the span. Unlike
+ * ts_int_bspline_eval_column, \p u is not snapped to the knots of the span so
+ * that the speed is smooth within the span. \p column must provide space for
+ * order * dim values. */
+tsReal ts_int_arclengthtable_speed(const tsBSpline *deriv, size_t k,
+	tsReal u, tsReal *column)
+{
+	const size_t deg = ts_bspline_degree(deriv);
+	const size_t dim = ts_bspline_dimension(deriv);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(deriv);
+	const tsReal *knots = ts_int_bspline_access_knots(deriv);
+	const size_t fst = k-deg;
+	size_t r, i, j;
+	tsReal ui, a, sq = 0;
+
+	memcpy(column, ctrlp + fst*dim, (deg+1) * dim * sizeof(tsReal));
+	for (r = 1; r <= deg; r++) {
+		for (i = k; i >= fst + r; i--) {
+			ui = knots[i];
+			a = (u - ui) / (knots[i+deg-r+1] - ui);
+			j = (i-fst) * dim;
+			ts_int_blend_point(column + j, column + j - dim,
+				dim, 1.f-a, a);
+		}
+	}
+	for (j = deg*dim; j < (deg+1) * dim; j++)
+		sq += column[j] * column[j];
+	return (tsReal) sqrt(sq);
+}
+
+/* Integrates the speed of span \p k of \p deriv on [a, b] with the 5-point
+ * Gauss-Legendre quadrature. */
+tsReal ts_int_arclengthtable_gauss(const tsBSpline *deriv, size_t k,
+	tsReal a, tsReal b, tsReal *column)
+{
+	tsReal length = 0, u;
+	size_t i;
+	for (i = 0; i < 5; i++) {
+		u = (tsReal) ((a + b) / 2 +
+			ts_int_gauss_nodes[i] * (b - a) / 2);
+		length += (tsReal) ts_int_gauss_weights[i] *
+			ts_int_arclengthtable_speed(deriv, k, u, column);
+	}
+	return length * (b - a) / 2;
+}
+
+/* Interpolates the knot at which the spline has length \p length on the
+ * interval [a, b] of length \p h, where \p speed_a and \p speed_b are the
+ * speeds at a and b, with a cubic Hermite polynomial. As the derivative of
+ * the knot with respect to the length is the reciprocal of the speed, the
+ * slopes are given by the speeds. The slopes are limited to three times the
+ * secant so that the polynomial is monotone (Fritsch-Carlson), which also
+ * handles speeds of 0. */
+tsReal ts_int_arclengthtable_hermite(tsReal a, tsReal b, tsReal h,
+	tsReal speed_a, tsReal speed_b, tsReal length)
+{
+	const tsReal delta = (b - a) / h;
+	const tsReal t = length / h;
+	const tsReal t2 = t * t, t3 = t2 * t;
+	const tsReal m0 = 3 * delta * speed_a > 1 ? 1 / speed_a : 3 * delta;
+	const tsReal m1 = 3 * delta * speed_b > 1 ? 1 / speed_b : 3 * delta;
+	tsReal u = (2*t3 - 3*t2 + 1) * a + (t3 - 2*t2 + t) * h * m0 +
+		(-2*t3 + 3*t2) * b + (t3 - t2) * h * m1;
+	return u < a ? a : (u > b ? b : u);
+}
+
+/* Collects the entries of a tsArcLengthTable while it is being built. Entry
+ * i (i > 0) describes the interval between entry i-1 and i. */
+struct tsArcLengthBuilder
+{
+	const tsBSpline *deriv;
+	tsReal *column;
+	size_t *spans;   /* Span of the derivative of each interval. */
+	tsReal *entries; /* Knot, cumulative length, and start and end speed. */
+	size_t n_entries;
+	size_t cap;
+};
+
+tsError ts_int_arclengthtable_append(struct tsArcLengthBuilder *builder,
+	size_t k, tsReal u, tsReal length, tsReal speed_a, tsReal speed_b,
+	tsStatus *status)
+{
+	tsReal *entries, *entry;
+	size_t *spans;
+	if (builder->n_entries == builder->cap) {
+		entries = (tsReal *) ts_int_realloc(builder->entries,
+			8 * builder->cap * sizeof(tsReal));
+		if (!entries)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		builder->entries = entries;
+		spans = (size_t *) ts_int_realloc(builder->spans,
+			2 * builder->cap * sizeof(size_t));
+		if (!spans)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		builder->spans = spans;
+		builder->cap *= 2;
+	}
+	entry = builder->entries + builder->n_entries * 4;
+	entry[0] = u;
+	entry[1] = length + entry[-3];
+	entry[2] = speed_a;
+	entry[3] = speed_b;
+	builder->spans[builder->n_entries] = k;
+	builder->n_entries++;
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns the distance between \p u and the knot interpolated for
+ * \p length with ts_int_arclengthtable_hermite on [a, b] (of length \p h),
+ * converted into a length using the speed \p speed at \p u. */
+tsReal ts_int_arclengthtable_hermite_error(tsReal a, tsReal b, tsReal h,
+	tsReal speed_a, tsReal speed_b, tsReal length, tsReal u, tsReal speed)
+{
+	return (tsReal) fabs(ts_int_arclengthtable_hermite(
+		a, b, h, speed_a, speed_b, length) - u) * speed;
+}
+
+/* Adaptively integrates the speed of span \p k on [a, b] (whose length has
+ * been estimated with \p whole and whose start and end speed are \p speed_a
+ * and \p speed_b) and appends the resultant intervals to \p builder. An
+ * interval is accepted if the estimates of the interval and its halves
+ * differ by at most \p eps and if the Hermite interpolation of the interval
+ * (cf. ts_int_arclengthtable_hermite) is accurate to \p tol at its midpoint
+ * and quarter points. Unlike \p eps, which is split evenly among the halves
+ * of an interval, \p tol is not split as it bounds a pointwise error. The
+ * quarter points are necessary because the error of the interpolation
+ * vanishes at the midpoint if the speed is symmetric. */
+tsError ts_int_arclengthtable_adapt(struct tsArcLengthBuilder *builder,
+	size_t k, tsReal a, tsReal b, tsReal whole, tsReal speed_a,
+	tsReal speed_b, tsReal eps, tsReal tol, size_t depth, tsStatus *status)
+{
+	const tsBSpline *deriv = builder->deriv;
+	tsReal *column = builder->column;
+	const tsReal m = (a + b) / 2;
+	const tsReal q1 = (a + m) / 2, q3 = (m + b) / 2;
+	tsReal left, right, total, speed_m, err_m, err_q1, err_q3;
+	tsError err;
+
+	left = ts_int_arclengthtable_gauss(deriv, k, a, m, column);
+	right = ts_int_arclengthtable_gauss(deriv, k, m, b, column);
+	total = left + right;
+	speed_m = ts_int_arclengthtable_speed(deriv, k, m, column);
+	/* Intervals whose width is close to the precision of their knots
+	 * cannot be interpolated more accurately. */
+	if (depth == 0 || total <= 0 ||
+		b - a <= 64 * TS_INT_REAL_EPSILON * fabs(b)) {
+		return ts_int_arclengthtable_append(builder, k, b, total,
+			speed_a, speed_b, status);
+	}
+	if (fabs(total - whole) <= eps) {
+		err_m = ts_int_arclengthtable_hermite_error(a, b, total,
+			speed_a, speed_b, left, m, speed_m);
+		err_q1 = ts_int_arclengthtable_hermite_error(a, b, total,
+			speed_a, speed_b,
+			ts_int_arclengthtable_gauss(deriv, k, a, q1, column),
+			q1, ts_int_arclengthtable_speed(deriv, k, q1, column));
+		err_q3 = ts_int_arclengthtable_hermite_error(a, b, total,
+			speed_a, speed_b, left +
+			ts_int_arclengthtable_gauss(deriv, k, m, q3, column),
+			q3, ts_int_arclengthtable_speed(deriv, k, q3, column));
+		if (err_m <= tol && err_q1 <= tol && err_q3 <= tol) {
+			return ts_int_arclengthtable_append(builder, k, b,
+				total, speed_a, speed_b, status);
+		}
+	}
+	TS_CALL_ROE(err, ts_int_arclengthtable_adapt(builder, k, a, m, left,
+		speed_a, speed_m, eps / 2, tol, depth - 1, status))
+	return ts_int_arclengthtable_adapt(builder, k, m, b, right,
+		speed_m, speed_b, eps / 2, tol, depth - 1, status);
+}
+
+tsError ts_bspline_arc_length_table(const tsBSpline *spline, tsReal epsilon,
+	tsArcLengthTable *table, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	const tsReal eps = (tsReal) fabs(epsilon);
+	tsBSpline deriv = ts_bspline_init();
+	struct tsArcLengthBuilder builder;
+	tsReal a, b, whole, tol, speed_a, speed_b;
+	tsReal *us, *lengths, *speeds;
+	size_t i, k, s, n, sof_deriv, sof_table;
+	tsError err;
+
+	ts_int_arclengthtable_init(table);
+	builder.column = NULL;
+	builder.spans = NULL;
+	builder.entries = NULL;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_derive(spline, 1,
+			TS_CONTROL_POINT_EPSILON, &deriv, status))
+		builder.deriv = &deriv;
+		builder.column = (tsReal *) ts_int_malloc(
+			ts_bspline_order(&deriv) *
+			ts_bspline_dimension(&deriv) * sizeof(tsReal));
+		builder.cap = n_ctrlp;
+		builder.spans = (size_t *) ts_int_malloc(
+			builder.cap * sizeof(size_t));
+		builder.entries = (tsReal *) ts_int_malloc(
+			4 * builder.cap * sizeof(tsReal));
+		if (!builder.column || !builder.spans || !builder.entries) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
 		}
+		builder.spans[0] = 0;
+		builder.entries[0] = knots[deg];
+		builder.entries[1] = 0;
+		builder.entries[2] = builder.entries[3] = 0;
+		builder.n_entries = 1;
+
+		/* Integrate each knot span of the domain separately, as the
+		 * speed may be discontinuous at knots. The corresponding span
+		 * of the derivative is determined at the midpoint of the span
+		 * so that its polynomial can be used up to the boundaries.
+		 * Tolerances below the precision of the length of a span
+		 * cannot be met and are thus limited accordingly. */
+		for (i = deg; i < n_ctrlp; i++) {
+			a = knots[i];
+			b = knots[i+1];
+			if (a >= b)
+				continue;
+			TS_CALL(try, err, ts_int_bspline_find_knot(&deriv,
+				(a + b) / 2, &k, &s, status))
+			whole = ts_int_arclengthtable_gauss(
+				&deriv, k, a, b, builder.column);
+			speed_a = ts_int_arclengthtable_speed(
+				&deriv, k, a, builder.column);
+			speed_b = ts_int_arclengthtable_speed(
+				&deriv, k, b, builder.column);
+			tol = whole * 64 * TS_INT_REAL_EPSILON;
+			tol = eps > tol ? eps : tol;
+			TS_CALL(try, err, ts_int_arclengthtable_adapt(
+				&builder, k, a, b, whole, speed_a, speed_b,
+				tol, tol, 20, status))
+		}
+
+		n = builder.n_entries;
+		sof_deriv = ts_int_bspline_sof_state(&deriv);
+		sof_table = sizeof(struct tsArcLengthTableImpl) +
+			n * sizeof(size_t) + sof_deriv +
+			4 * n * sizeof(tsReal);
+		table->pImpl = (struct tsArcLengthTableImpl *)
+			ts_int_allocate(&spline->pImpl->allocator, sof_table);
+		if (!table->pImpl) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		table->pImpl->allocator = spline->pImpl->allocator;
+		table->pImpl->n_entries = n;
+		table->pImpl->sof_deriv = sof_deriv;
+		table->pImpl->epsilon = eps;
+		memcpy(ts_int_arclengthtable_access_spans(table),
+			builder.spans, n * sizeof(size_t));
+		memcpy((char *) ts_int_arclengthtable_access_spans(table) +
+			n * sizeof(size_t), deriv.pImpl, sof_deriv);
+		us = ts_int_arclengthtable_access_knots(table);
+		lengths = ts_int_arclengthtable_access_lengths(table);
+		speeds = ts_int_arclengthtable_access_speeds(table);
+		for (i = 0; i < n; i++) {
+			us[i] = builder.entries[i * 4];
+			lengths[i] = builder.entries[i * 4 + 1];
+			speeds[i * 2] = builder.entries[i * 4 + 2];
+			speeds[i * 2 + 1] = builder.entries[i * 4 + 3];
+		}
+	TS_CATCH(err)
+		ts_arclengthtable_free(table);
 	TS_FINALLY
-		free(cc);
+		ts_bspline_free(&deriv);
+		if (builder.column)
+			ts_int_free(builder.column);
+		if (builder.spans)
+			ts_int_free(builder.spans);
+		if (builder.entries)
+			ts_int_free(builder.entries);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_int_relaxed_uniform_cubic_bspline(const tsReal *points, size_t n,
-	size_t dim, tsBSpline *spline, tsStatus *status)
+/* Returns the knot at which the spline of \p table has length \p length.
+ * \p index is the index of the table entry found for the previous length
+ * (0 if there is none) and is updated accordingly. If \p ascending is true,
+ * the table is searched forward from \p index. The knot is interpolated with
+ * ts_int_arclengthtable_hermite and, if \p deriv is not NULL, refined with a
+ * safeguarded Newton iteration (\p column must provide space for order * dim
+ * values of \p deriv in this case). */
+tsReal ts_int_arclengthtable_knot(const tsArcLengthTable *table,
+	const tsBSpline *deriv, tsReal length, int ascending, size_t *index,
+	tsReal *column)
 {
-	const size_t order = 4;    /**< Order of spline to interpolate. */
-	const tsReal as = 1.f/6.f; /**< The value 'a sixth'. */
-	const tsReal at = 1.f/3.f; /**< The value 'a third'. */
-	const tsReal tt = 2.f/3.f; /**< The value 'two third'. */
-	size_t sof_ctrlp;          /**< Size of a single control point. */
-	const tsReal* b = points;  /**< Array of the b values. */
-	tsReal* s;                 /**< Array of the s values. */
-	size_t i, d;               /**< Used in for loops */
-	size_t j, k, l;            /**< Used as temporary indices. */
-	tsReal *ctrlp; /**< Pointer to the control points of \p _spline_. */
+	const size_t n = ts_arclengthtable_num_entries(table);
+	const tsReal *us = ts_int_arclengthtable_access_knots(table);
+	const tsReal *lengths = ts_int_arclengthtable_access_lengths(table);
+	const tsReal *speeds = ts_int_arclengthtable_access_speeds(table);
+	const tsReal eps = table->pImpl->epsilon;
+	size_t low, high, mid, step, iter, k;
+	tsReal a, b, la, lb, lo, hi, u, next, f, speed;
+
+	if (n == 1 || length <= 0) {
+		*index = 0;
+		return us[0];
+	}
+	if (length >= lengths[n-1]) {
+		*index = n-1;
+		return us[n-1];
+	}
+
+	/* Find the last entry whose length does not exceed \p length. */
+	low = ascending ? *index : 0;
+	step = 1;
+	high = ascending ? low + step : n;
+	while (ascending && high < n && lengths[high] <= length) {
+		low = high;
+		step *= 2;
+		high = low + step;
+	}
+	if (high > n)
+		high = n;
+	while (high - low > 1) {
+		mid = low + (high-low) / 2;
+		if (lengths[mid] <= length)
+			low = mid;
+		else
+			high = mid;
+	}
+	*index = low;
+
+	a = us[low];
+	b = us[low+1];
+	la = lengths[low];
+	lb = lengths[low+1];
+	if (lb <= la)
+		return a;
+	u = ts_int_arclengthtable_hermite(a, b, lb - la, speeds[2*low + 2],
+		speeds[2*low + 3], length - la);
+	if (!deriv)
+		return u;
+
+	/* Safeguarded Newton iteration on f(u) = length(a, u) + la - length,
+	 * whose derivative is the speed at u. */
+	k = ts_int_arclengthtable_access_spans(table)[low+1];
+	lo = a;
+	hi = b;
+	for (iter = 0; iter < 16; iter++) {
+		f = ts_int_arclengthtable_gauss(deriv, k, a, u, column) +
+			la - length;
+		if (fabs(f) <= eps)
+			break;
+		if (f > 0)
+			hi = u;
+		else
+			lo = u;
+		speed = ts_int_arclengthtable_speed(deriv, k, u, column);
+		next = speed > 0 ? u - f / speed : lo;
+		if (next <= lo || next >= hi)
+			next = (lo + hi) / 2;
+		u = next;
+	}
+	return u;
+}
+
+tsError ts_arclengthtable_knots(const tsArcLengthTable *table,
+	const tsReal *lengths, size_t num, tsReal *knots, tsStatus *status)
+{
+	tsBSpline deriv;
+	tsReal *column, length, prev = 0;
+	size_t i, index = 0;
+
+	ts_int_arclengthtable_access_deriv(table, &deriv);
+	column = (tsReal *) ts_int_malloc(ts_bspline_order(&deriv) *
+		ts_bspline_dimension(&deriv) * sizeof(tsReal));
+	if (!column)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	/* \p lengths and \p knots may be the same array. */
+	for (i = 0; i < num; i++) {
+		length = lengths[i];
+		knots[i] = ts_int_arclengthtable_knot(table, &deriv, length,
+			i > 0 && length >= prev, &index, column);
+		prev = length;
+	}
+	ts_int_free(column);
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_sample_arc_length(const tsBSpline *spline,
+	const tsArcLengthTable *table, size_t num, tsReal **points,
+	size_t *actual_num, tsStatus *status)
+{
+	const tsReal length = ts_arclengthtable_length(table);
+	tsReal *knots = NULL;
+	size_t i, index = 0;
 	tsError err;
 
-	/* input validation */
-	if (dim == 0)
-		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
-	if (n <= 1) {
-		TS_RETURN_1(status, TS_NUM_POINTS,
-			"num(points) (%lu) <= 1", (unsigned long) n)
+	*points = NULL;
+	if (num == 0)
+		num = (ts_bspline_num_control_points(spline) -
+			ts_bspline_degree(spline)) * 30;
+	*actual_num = num;
+	knots = (tsReal *) ts_int_malloc(num * sizeof(tsReal));
+	if (!knots)
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	TS_TRY(try, err, status)
+		/* The lengths are ascending. Hence, the table is walked
+		 * forward and the interpolated knots are accurate enough
+		 * (cf. ts_bspline_arc_length_table). */
+		for (i = 0; i < num; i++) {
+			knots[i] = ts_int_arclengthtable_knot(table, NULL,
+				num > 1 ? length * i / (num - 1) : 0, i > 0,
+				&index, NULL);
+		}
+		TS_CALL(try, err, ts_bspline_eval_all(
+			spline, knots, num, points, status))
+	TS_FINALLY
+		ts_int_free(knots);
+	TS_END_TRY_RETURN(err)
+}
+
+/* Returns the squared distance between point \p p and the line segment from
+ * \p a to \p b. */
+tsReal ts_int_distance_segment_sq(const tsReal *p, const tsReal *a,
+	const tsReal *b, size_t dim)
+{
+	tsReal len_sq = 0, t = 0, dist_sq = 0, v;
+	size_t d;
+	for (d = 0; d < dim; d++) {
+		len_sq += (b[d] - a[d]) * (b[d] - a[d]);
+		t += (p[d] - a[d]) * (b[d] - a[d]);
 	}
-	/* in the following n >= 2 applies */
+	t = len_sq > 0 ? t / len_sq : 0;
+	t = t < 0 ? 0 : (t > 1 ? 1 : t);
+	for (d = 0; d < dim; d++) {
+		v = p[d] - (a[d] + t * (b[d] - a[d]));
+		dist_sq += v * v;
+	}
+	return dist_sq;
+}
 
-	sof_ctrlp = dim * sizeof(tsReal); /* dim > 0 implies sof_ctrlp > 0 */
+/* Returns the maximum squared distance between the inner control points of
+ * the Bezier curve \p ctrlp and its chord. Due to the convex hull property,
+ * the curve deviates from its chord by at most this distance. */
+tsReal ts_int_bezier_flatness_sq(const tsReal *ctrlp, size_t deg, size_t dim)
+{
+	tsReal dist_sq, max_sq = 0;
+	size_t j;
+	for (j = 1; j < deg; j++) {
+		dist_sq = ts_int_distance_segment_sq(ctrlp + j * dim, ctrlp,
+			ctrlp + deg * dim, dim);
+		max_sq = dist_sq > max_sq ? dist_sq : max_sq;
+	}
+	return max_sq;
+}
 
-	s = NULL;
+/* Splits the Bezier curve \p ctrlp at its midpoint with the de Casteljau
+ * algorithm and stores the control points of the halves in \p left and
+ * \p right. \p tmp must provide space for (deg + 1) * dim values. \p left
+ * or \p right may be \p ctrlp. */
+void ts_int_bezier_split(const tsReal *ctrlp, size_t deg, size_t dim,
+	tsReal *tmp, tsReal *left, tsReal *right)
+{
+	size_t r, j, d;
+	memcpy(tmp, ctrlp, (deg + 1) * dim * sizeof(tsReal));
+	memcpy(left, tmp, dim * sizeof(tsReal));
+	memcpy(right + deg * dim, tmp + deg * dim, dim * sizeof(tsReal));
+	for (r = 1; r <= deg; r++) {
+		for (j = 0; j + r <= deg; j++) {
+			for (d = 0; d < dim; d++) {
+				tmp[j*dim + d] = (tmp[j*dim + d] +
+					tmp[(j+1)*dim + d]) / 2;
+			}
+		}
+		memcpy(left + r * dim, tmp, dim * sizeof(tsReal));
+		memcpy(right + (deg-r) * dim, tmp + (deg-r) * dim,
+			dim * sizeof(tsReal));
+	}
+}
+
+/* Computes the axis-aligned bounding box (the minimum followed by the
+ * maximum) of the \p num points \p points. */
+void ts_int_bounding_box(const tsReal *points, size_t num, size_t dim,
+	tsReal *box)
+{
+	size_t i, d;
+	memcpy(box, points, dim * sizeof(tsReal));
+	memcpy(box + dim, points, dim * sizeof(tsReal));
+	for (i = 1; i < num; i++) {
+		for (d = 0; d < dim; d++) {
+			box[d] = points[i*dim + d] < box[d] ?
+				points[i*dim + d] : box[d];
+			box[dim + d] = points[i*dim + d] > box[dim + d] ?
+				points[i*dim + d] : box[dim + d];
+		}
+	}
+}
+
+/* Appends \p point to the polyline of ts_bspline_flatten unless it equals
+ * the last point of the polyline (\p last). */
+void ts_int_flatten_emit(const tsReal *point, size_t dim, tsReal *points,
+	size_t max_points, size_t *num_points, tsReal *last)
+{
+	const size_t sof_point = dim * sizeof(tsReal);
+	if (*num_points > 0 &&
+		ts_distance(point, last, dim) <= TS_CONTROL_POINT_EPSILON)
+		return;
+	if (points && *num_points < max_points)
+		memcpy(points + *num_points * dim, point, sof_point);
+	memcpy(last, point, sof_point);
+	(*num_points)++;
+}
+
+tsError ts_bspline_flatten(const tsBSpline *spline, tsReal tolerance,
+	tsReal *points, size_t max_points, size_t *num_points,
+	tsStatus *status)
+{
+	const size_t order = ts_bspline_order(spline);
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t len = order * dim;
+	const size_t max_depth = 24;
+	tsReal tol = (tsReal) fabs(tolerance);
+	tsBSpline beziers = ts_bspline_init();
+	tsReal *ctrlp, *stack = NULL, *seg, *last, *tmp;
+	size_t *depths = NULL;
+	size_t n_segs, i, top;
+	tsError err;
+
+	*num_points = 0;
+	if (tol < TS_CONTROL_POINT_EPSILON)
+		tol = TS_CONTROL_POINT_EPSILON;
 	TS_TRY(try, err, status)
-		/* n >= 2 implies n-1 >= 1 implies (n-1)*4 >= 4 */
-		TS_CALL(try, err, ts_bspline_new(
-			(n-1)*4, dim, order-1, TS_BEZIERS, spline, status))
-		ctrlp = ts_int_bspline_access_ctrlp(spline);
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		ctrlp = ts_int_bspline_access_ctrlp(&beziers);
+		n_segs = ts_bspline_num_control_points(&beziers) / order;
+
+		/* The stack stores the control points of the segments yet to
+		 * be flattened (at most one per level of subdivision) and is
+		 * followed by the last emitted point and scratch space of
+		 * the de Casteljau algorithm. */
+		stack = (tsReal *) ts_int_malloc(
+			((max_depth + 2) * len + dim + len) * sizeof(tsReal));
+		depths = (size_t *) ts_int_malloc(
+			(max_depth + 2) * sizeof(size_t));
+		if (!stack || !depths) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		last = stack + (max_depth + 2) * len;
+		tmp = last + dim;
+
+		for (i = 0; i < n_segs; i++) {
+			/* Gaps between segments are bridged by a line. */
+			ts_int_flatten_emit(ctrlp + i * len, dim, points,
+				max_points, num_points, last);
+			memcpy(stack, ctrlp + i * len, len * sizeof(tsReal));
+			depths[0] = 0;
+			top = 1;
+			while (top > 0) {
+				top--;
+				seg = stack + top * len;
+				if (ts_int_bezier_flatness_sq(seg, deg, dim) <=
+					tol * tol ||
+					depths[top] == max_depth) {
+					ts_int_flatten_emit(seg + deg * dim,
+						dim, points, max_points,
+						num_points, last);
+					continue;
+				}
+				/* The right half replaces the segment and
+				 * the left half is pushed on top, such that
+				 * it is flattened first. */
+				ts_int_bezier_split(seg, deg, dim, tmp,
+					seg + len, seg);
+				depths[top + 1] = ++depths[top];
+				top += 2;
+			}
+		}
+		if (points && *num_points > max_points) {
+			TS_THROW_2(try, err, status, TS_NUM_POINTS,
+				"buffer (%lu) < number of points (%lu)",
+				(unsigned long) max_points,
+				(unsigned long) *num_points)
+		}
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+		if (stack)
+			ts_int_free(stack);
+		if (depths)
+			ts_int_free(depths);
+	TS_END_TRY_RETURN(err)
+}
 
-		s = (tsReal*) malloc(n * sof_ctrlp);
-		if (!s) {
+/* Evaluates the segment with the power basis coefficients \p coeffs (order *
+ * dim values) at \p t and stores the squared distance to \p point in
+ * \p dist_sq, the derivative of the half squared distance in \p f, and the
+ * second derivative of the half squared distance in \p df. */
+void ts_int_projector_eval(const tsReal *coeffs, size_t order, size_t dim,
+	const tsReal *point, tsReal t, tsReal *dist_sq, tsReal *f, tsReal *df)
+{
+	tsReal p, dp, ddp, v;
+	size_t j, d;
+	*dist_sq = *f = *df = 0;
+	for (d = 0; d < dim; d++) {
+		p = coeffs[(order-1) * dim + d];
+		dp = ddp = 0;
+		for (j = order-1; j-- > 0;) {
+			ddp = ddp * t + dp;
+			dp = dp * t + p;
+			p = p * t + coeffs[j * dim + d];
+		}
+		v = p - point[d];
+		*dist_sq += v * v;
+		*f += v * dp;
+		*df += dp * dp + v * 2 * ddp;
+	}
+}
+
+/* Evaluates the segment with the power basis coefficients \p coeffs (order *
+ * dim values) at \p t and stores the resultant point in \p point. */
+void ts_int_projector_point(const tsReal *coeffs, size_t order, size_t dim,
+	tsReal t, tsReal *point)
+{
+	size_t j, d;
+	memcpy(point, coeffs + (order-1) * dim, dim * sizeof(tsReal));
+	for (j = order-1; j-- > 0;) {
+		for (d = 0; d < dim; d++)
+			point[d] = point[d] * t + coeffs[j * dim + d];
+	}
+}
+
+/* Finds the local minimum of the squared distance between \p point and the
+ * segment \p coeffs in [lo, hi] (starting at \p t) with a safeguarded Newton
+ * iteration on the derivative of the squared distance. */
+void ts_int_projector_refine(const tsReal *coeffs, size_t order, size_t dim,
+	const tsReal *point, tsReal lo, tsReal hi, tsReal *t,
+	tsReal *dist_sq)
+{
+	tsReal f, df, next;
+	size_t iter;
+	for (iter = 0; iter < 16; iter++) {
+		ts_int_projector_eval(coeffs, order, dim, point, *t,
+			dist_sq, &f, &df);
+		if (f > 0)
+			hi = *t;
+		else
+			lo = *t;
+		next = df > 0 ? *t - f / df : (lo + hi) / 2;
+		if (next < lo || next > hi)
+			next = (lo + hi) / 2;
+		if (fabs(next - *t) <= 4 * TS_INT_REAL_EPSILON)
+			break;
+		*t = next;
+	}
+	ts_int_projector_eval(coeffs, order, dim, point, *t,
+		dist_sq, &f, &df);
+}
+
+/* Projects \p point onto the segment \p coeffs. The squared distance is
+ * sampled at 2 * order + 1 equidistant parameters and each local minimum of
+ * the samples is refined with ts_int_projector_refine. Stores the parameter
+ * (in [0, 1]) and the squared distance of the closest point in \p t and
+ * \p dist_sq. */
+void ts_int_projector_segment(const tsReal *coeffs, size_t order, size_t dim,
+	const tsReal *point, tsReal *t, tsReal *dist_sq)
+{
+	const size_t m = 2 * order + 1;
+	tsReal d_prev = 0, d_cur = 0, d_next, f, df, s, s_dist;
+	size_t i;
+	*dist_sq = -1;
+	for (i = 0; i <= m; i++) {
+		d_next = 0;
+		if (i < m) {
+			ts_int_projector_eval(coeffs, order, dim, point,
+				(tsReal) i / (m-1), &d_next, &f, &df);
+		}
+		/* Sample i-1 is a local minimum. */
+		if (i > 0 && (i == 1 || d_cur <= d_prev) &&
+			(i == m || d_cur <= d_next)) {
+			s = (tsReal) (i-1) / (m-1);
+			ts_int_projector_refine(coeffs, order, dim, point,
+				i > 1 ? (tsReal) (i-2) / (m-1) : 0,
+				i < m ? (tsReal) i / (m-1) : 1, &s, &s_dist);
+			if (*dist_sq < 0 || s_dist < *dist_sq) {
+				*dist_sq = s_dist;
+				*t = s;
+			}
+		}
+		d_prev = d_cur;
+		d_cur = d_next;
+	}
+}
+
+/* Returns the squared distance between \p point and the box \p box (the
+ * minimum followed by the maximum). */
+tsReal ts_int_projector_box_dist_sq(const tsReal *box, const tsReal *point,
+	size_t dim)
+{
+	tsReal dist_sq = 0, v;
+	size_t d;
+	for (d = 0; d < dim; d++) {
+		v = point[d] < box[d] ? box[d] - point[d] :
+			(point[d] > box[dim + d] ? point[d] - box[dim + d] : 0);
+		dist_sq += v * v;
+	}
+	return dist_sq;
+}
+
+/* Computes the boxes of the subtree \p node, which covers the segments
+ * [lo, hi), from the Bezier control points of the segments. The nodes are
+ * stored in preorder, i.e., the left child of \p node is node + 1 and the
+ * right child is node + 2 * (mid - lo), where mid = lo + (hi - lo) / 2. */
+void ts_int_projector_build(tsProjector *projector, size_t node, size_t lo,
+	size_t hi)
+{
+	const size_t order = projector->pImpl->deg + 1;
+	const size_t dim = projector->pImpl->dim;
+	tsReal *box = ts_int_projector_access_boxes(projector) + node * 2 * dim;
+	const tsReal *left, *right;
+	size_t mid, d;
+
+	if (hi - lo == 1) {
+		ts_int_bounding_box(ts_int_projector_access_ctrlp(projector) +
+			lo * order * dim, order, dim, box);
+		return;
+	}
+	mid = lo + (hi - lo) / 2;
+	ts_int_projector_build(projector, node + 1, lo, mid);
+	ts_int_projector_build(projector, node + 2 * (mid - lo), mid, hi);
+	left = box + 2 * dim;
+	right = box + 2 * (mid - lo) * 2 * dim;
+	for (d = 0; d < dim; d++) {
+		box[d] = left[d] < right[d] ? left[d] : right[d];
+		box[dim + d] = left[dim + d] > right[dim + d] ?
+			left[dim + d] : right[dim + d];
+	}
+}
+
+tsError ts_bspline_projector(const tsBSpline *spline, tsProjector *projector,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	tsBSpline beziers = ts_bspline_init();
+	const tsReal *ctrlp, *knots, *p;
+	tsReal *domains, *coeffs, *a, binom;
+	size_t n_segs, sof_projector, s, i, j, d;
+	tsError err;
+
+	ts_int_projector_init(projector);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		ctrlp = ts_int_bspline_access_ctrlp(&beziers);
+		knots = ts_int_bspline_access_knots(&beziers);
+		n_segs = ts_bspline_num_control_points(&beziers) / order;
+
+		sof_projector = sizeof(struct tsProjectorImpl) +
+			(2 * n_segs + 2 * n_segs * order * dim +
+			(2 * n_segs - 1) * 2 * dim) * sizeof(tsReal);
+		projector->pImpl = (struct tsProjectorImpl *)
+			ts_int_allocate(&spline->pImpl->allocator,
+				sof_projector);
+		if (!projector->pImpl) {
 			TS_THROW_0(try, err, status, TS_MALLOC,
 				"out of memory")
 		}
+		projector->pImpl->allocator = spline->pImpl->allocator;
+		projector->pImpl->deg = deg;
+		projector->pImpl->dim = dim;
+		projector->pImpl->n_segs = n_segs;
+
+		domains = ts_int_projector_access_domains(projector);
+		coeffs = ts_int_projector_access_coeffs(projector);
+		for (s = 0; s < n_segs; s++) {
+			domains[s * 2] = knots[s * order];
+			domains[s * 2 + 1] = knots[(s+1) * order];
+			/* Convert the Bezier control points into the power
+			 * basis: a_j = C(deg, j) * sum_{i <= j} (-1)^(j-i) *
+			 * C(j, i) * P_i. */
+			p = ctrlp + s * order * dim;
+			a = coeffs + s * order * dim;
+			ts_arr_fill(a, order * dim, 0);
+			for (j = 0; j < order; j++) {
+				binom = 1;
+				for (i = j + 1; i-- > 0;) {
+					for (d = 0; d < dim; d++) {
+						a[j*dim + d] += ((j-i) % 2 ?
+							-binom : binom) *
+							p[i*dim + d];
+					}
+					/* C(j, i-1) = C(j, i) * i / (j-i+1) */
+					binom = binom * i / (j - i + 1);
+				}
+				binom = 1;
+				for (i = 0; i < j; i++)
+					binom = binom * (deg - i) / (i + 1);
+				for (d = 0; d < dim; d++)
+					a[j*dim + d] *= binom;
+			}
+		}
+		memcpy(ts_int_projector_access_ctrlp(projector), ctrlp,
+			n_segs * order * dim * sizeof(tsReal));
+		ts_int_projector_build(projector, 0, 0, n_segs);
+	TS_CATCH(err)
+		ts_projector_free(projector);
+	TS_FINALLY
+		ts_bspline_free(&beziers);
+	TS_END_TRY_RETURN(err)
+}
 
-		/* set s_0 to b_0 and s_n = b_n */
-		memcpy(s, b, sof_ctrlp);
-		memcpy(s + (n-1)*dim, b + (n-1)*dim, sof_ctrlp);
+/* Maximum depth of the bounding volume hierarchy of a tsProjector. */
+#define TS_INT_PROJECTOR_MAX_DEPTH 64
 
-		/* set s_i = 1/6*b_i + 2/3*b_{i-1} + 1/6*b_{i+1}*/
-		for (i = 1; i < n-1; i++) {
+void ts_int_projector_project(const tsProjector *projector,
+	const tsReal *point, tsReal *knot, tsReal *closest)
+{
+	const size_t order = projector->pImpl->deg + 1;
+	const size_t dim = projector->pImpl->dim;
+	const tsReal *boxes = ts_int_projector_access_boxes(projector);
+	const tsReal *coeffs = ts_int_projector_access_coeffs(projector);
+	const tsReal *domains = ts_int_projector_access_domains(projector);
+	/* Node, lo, and hi of the subtrees yet to be visited. */
+	size_t stack[3 * (TS_INT_PROJECTOR_MAX_DEPTH + 1)];
+	tsReal bounds[TS_INT_PROJECTOR_MAX_DEPTH + 1];
+	size_t top = 1, node, lo, hi, mid, left, right, seg = 0;
+	tsReal best = -1, t = 0, best_t = 0, dist_sq, lb_left, lb_right;
+
+	stack[0] = 0;
+	stack[1] = 0;
+	stack[2] = projector->pImpl->n_segs;
+	bounds[0] = 0;
+	while (top > 0) {
+		top--;
+		if (best >= 0 && bounds[top] >= best)
+			continue;
+		node = stack[top * 3];
+		lo = stack[top * 3 + 1];
+		hi = stack[top * 3 + 2];
+		if (hi - lo == 1) {
+			ts_int_projector_segment(coeffs + lo * order * dim,
+				order, dim, point, &t, &dist_sq);
+			if (best < 0 || dist_sq < best) {
+				best = dist_sq;
+				best_t = t;
+				seg = lo;
+			}
+			continue;
+		}
+		/* Visit the closer child first, i.e., push it last. */
+		mid = lo + (hi - lo) / 2;
+		left = node + 1;
+		right = node + 2 * (mid - lo);
+		lb_left = ts_int_projector_box_dist_sq(
+			boxes + left * 2 * dim, point, dim);
+		lb_right = ts_int_projector_box_dist_sq(
+			boxes + right * 2 * dim, point, dim);
+		if (lb_left <= lb_right) {
+			stack[top * 3] = right;
+			stack[top * 3 + 1] = mid;
+			stack[top * 3 + 2] = hi;
+			bounds[top++] = lb_right;
+			stack[top * 3] = left;
+			stack[top * 3 + 1] = lo;
+			stack[top * 3 + 2] = mid;
+			bounds[top++] = lb_left;
+		} else {
+			stack[top * 3] = left;
+			stack[top * 3 + 1] = lo;
+			stack[top * 3 + 2] = mid;
+			bounds[top++] = lb_left;
+			stack[top * 3] = right;
+			stack[top * 3 + 1] = mid;
+			stack[top * 3 + 2] = hi;
+			bounds[top++] = lb_right;
+		}
+	}
+	*knot = domains[seg * 2] + best_t *
+		(domains[seg * 2 + 1] - domains[seg * 2]);
+	if (closest) {
+		ts_int_projector_point(coeffs + seg * order * dim, order, dim,
+			best_t, closest);
+	}
+}
+
+tsError ts_projector_project(const tsProjector *projector,
+	const tsReal *point, tsReal *knot, tsReal *closest, tsStatus *status)
+{
+	ts_int_projector_project(projector, point, knot, closest);
+	TS_RETURN_SUCCESS(status)
+}
+
+struct tsProjectAllTask
+{
+	const tsProjector *projector;
+	const tsReal *points;
+	size_t num;      /**< Number of points in points. */
+	tsReal *knots;
+	tsReal *closest; /**< May be NULL. */
+};
+
+void ts_int_project_all_task(void *args, size_t index)
+{
+	struct tsProjectAllTask *task = (struct tsProjectAllTask *) args;
+	const size_t dim = task->projector->pImpl->dim;
+	const size_t begin = index * TS_INT_TASK_SIZE;
+	const size_t end = task->num - begin < TS_INT_TASK_SIZE ?
+		task->num : begin + TS_INT_TASK_SIZE;
+	size_t i;
+	for (i = begin; i < end; i++) {
+		ts_int_projector_project(task->projector,
+			task->points + i * dim, task->knots + i,
+			task->closest ? task->closest + i * dim : NULL);
+	}
+}
+
+tsError ts_projector_project_all(const tsProjector *projector,
+	const tsReal *points, size_t num, const tsExecutor *executor,
+	tsReal *knots, tsReal *closest, tsStatus *status)
+{
+	const size_t num_tasks = (num + TS_INT_TASK_SIZE - 1) /
+		TS_INT_TASK_SIZE;
+	struct tsProjectAllTask task;
+	tsExecutor fallback;
+
+	if (!executor) {
+		fallback = ts_executor_default();
+		executor = &fallback;
+	}
+	task.projector = projector;
+	task.points = points;
+	task.num = num;
+	task.knots = knots;
+	task.closest = closest;
+	executor->run(executor->ctx, ts_int_project_all_task, &task,
+		num_tasks);
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Locates \p knot in the knot vector \p knots (with \p num_knots values)
+ * of a spline of degree \p deg (cf. ts_int_bspline_find_knot). \p spline is
+ * the index of the spline in its collection and is used in error messages
+ * only. */
+tsError ts_int_knots_locate(const tsReal *knots, size_t num_knots,
+	size_t deg, tsReal knot, size_t spline, size_t *index,
+	size_t *multiplicity, tsStatus *status)
+{
+	const tsReal min = knots[deg];
+	const tsReal max = knots[num_knots - deg - 1];
+	if (knot < min && !ts_knots_equal(knot, min)) {
+		TS_RETURN_3(status, TS_U_UNDEFINED,
+			"knot (%f) < min(domain) (%f) of spline %lu",
+			knot, min, (unsigned long) spline)
+	}
+	if (knot > max && !ts_knots_equal(knot, max)) {
+		TS_RETURN_3(status, TS_U_UNDEFINED,
+			"knot (%f) > max(domain) (%f) of spline %lu",
+			knot, max, (unsigned long) spline)
+	}
+	ts_int_knots_find(knots, num_knots, knot, index);
+	*multiplicity = ts_int_knots_multiplicity(knots, deg, knot, *index);
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Locates the knots \p lanes of \p num splines (cf. ts_int_knots_locate)
+ * whose knot vectors (with \p num_knots values each) are stored at \p knots
+ * with a distance of \p stride, and stores the span of each knot in \p span.
+ * \p indices contains the index of the splines in their collection. Knots
+ * are sorted. Thus, the span of a knot is given by the number of knots that
+ * do not exceed it (cf. ts_int_bspline_knot_not_greater), which, for short
+ * knot vectors, is computed for all splines at once. */
+tsError ts_int_knots_locate_lanes(const tsReal *knots, size_t stride,
+	size_t num_knots, size_t deg, const size_t *indices,
+	const tsReal *lanes, size_t num, size_t *span, tsStatus *status)
+{
+	const tsReal *kn;
+	int undefined = 0;
+	size_t t, j, s;
+	tsError err;
+
+	for (t = 0; t < num; t++) {
+		kn = knots + t * stride;
+		undefined |= kn[deg] - lanes[t] >= TS_KNOT_EPSILON ||
+			lanes[t] - kn[num_knots - deg - 1] >= TS_KNOT_EPSILON;
+	}
+	if (undefined) {
+		/* Find the first spline that is not defined. */
+		for (t = 0; t < num; t++) {
+			TS_CALL_ROE(err, ts_int_knots_locate(
+				knots + t * stride, num_knots, deg, lanes[t],
+				indices[t], span + t, &s, status))
+		}
+	}
+
+	if (num_knots > TS_INT_COLLECTION_SCAN) {
+		for (t = 0; t < num; t++) {
+			ts_int_knots_find(knots + t * stride, num_knots,
+				lanes[t], span + t);
+		}
+	} else {
+		/* The first knot never exceeds a knot of the domain. */
+		for (t = 0; t < num; t++)
+			span[t] = 0;
+		for (j = 1; j < num_knots; j++) {
+			for (t = 0; t < num; t++) {
+				span[t] += knots[t * stride + j] - lanes[t] <
+					TS_KNOT_EPSILON;
+			}
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns the length of the workspace of a single task of
+ * ts_bsplinecollection_eval (cf. ts_int_bsplinegroup_eval_tile). */
+size_t ts_int_bsplinecollection_len_workspace(
+	const struct tsBSplineCollectionImpl *impl)
+{
+	return TS_INT_COLLECTION_TILE * (impl->max_dim +
+		3 * impl->max_order + 2) + 3 * impl->max_order;
+}
+
+/* Evaluates the splines [begin, begin + num) of \p group at the knots
+ * \p us (indexed by the index of the splines in the collection) or, if
+ * \p us is NULL, at \p u. The points are stored in \p points (at the
+ * offsets of the splines). The computations are arranged as loops over the
+ * splines of the tile, which operate on contiguous arrays and thus are
+ * vectorized by the compiler. In particular, the basis functions are
+ * computed for all splines at once (in lockstep, cf. ts_int_knots_basis).
+ * If all splines share their knot vector and are evaluated at the same knot,
+ * the basis functions are computed only once. */
+tsError ts_int_bsplinegroup_eval_tile(
+	const struct tsBSplineCollectionImpl *impl,
+	const struct tsBSplineGroup *group, size_t begin, size_t num,
+	const tsReal *us, tsReal u, tsReal *points, tsReal *workspace,
+	tsStatus *status)
+{
+	const size_t T = TS_INT_COLLECTION_TILE;
+	const size_t deg = group->deg;
+	const size_t order = deg + 1;
+	const size_t dim = group->dim;
+	const size_t n_ctrlp = group->n_ctrlp;
+	const size_t n_knots = n_ctrlp + order;
+	const size_t m = group->n_splines;
+	const size_t stride = group->shared ? 0 : n_knots;
+	const size_t *indices = (const size_t *) ts_int_bsplinecollection_at(
+		impl, group->indices) + begin;
+	const size_t *offsets = (const size_t *) ts_int_bsplinecollection_at(
+		impl, group->offsets) + begin;
+	const tsReal *ctrlp = (const tsReal *) ts_int_bsplinecollection_at(
+		impl, group->ctrlp) + begin;
+	const tsReal *knots = (const tsReal *) ts_int_bsplinecollection_at(
+		impl, group->knots) + begin * stride;
+
+	tsReal *acc = workspace;                /* dim * T */
+	tsReal *weights = acc + dim * T;        /* order * T */
+	tsReal *left = weights + order * T;     /* order * T */
+	tsReal *right = left + order * T;       /* order * T */
+	tsReal *lanes = right + order * T;      /* T */
+	tsReal *saved = lanes + T;              /* T */
+	tsReal *scratch = saved + T;            /* 3 * order */
+	size_t span[TS_INT_COLLECTION_TILE];
+	size_t first[TS_INT_COLLECTION_TILE];
+	char special[TS_INT_COLLECTION_TILE];
+
+	const tsReal *kn, *row;
+	tsReal temp;
+	size_t t, j, r, d, mult;
+	tsError err;
+
+	for (d = 0; d < dim; d++)
+		ts_arr_fill(acc + d * T, num, 0);
+
+	if (!us && group->shared) {
+		TS_CALL_ROE(err, ts_int_knots_locate(knots, n_knots, deg, u,
+			indices[0], span, &mult, status))
+		ts_int_knots_basis(knots, deg, n_ctrlp, u, span[0], mult,
+			first, scratch, scratch + order);
+		for (j = 0; j < order; j++) {
 			for (d = 0; d < dim; d++) {
-				j = (i-1)*dim+d;
-				k = i*dim+d;
-				l = (i+1)*dim+d;
-				s[k] = as * b[j];
-				s[k] += tt * b[k];
-				s[k] += as * b[l];
+				row = ctrlp + ((first[0] + j) * dim + d) * m;
+				for (t = 0; t < num; t++)
+					acc[d * T + t] += scratch[j] * row[t];
 			}
 		}
+	} else {
+		for (t = 0; t < num; t++)
+			lanes[t] = us ? us[indices[t]] : u;
+		TS_CALL_ROE(err, ts_int_knots_locate_lanes(knots, stride,
+			n_knots, deg, indices, lanes, num, span, status))
+		for (t = 0; t < num; t++) {
+			kn = knots + t * stride;
+			lanes[t] = ts_knots_equal(lanes[t], kn[span[t]]) ?
+				kn[span[t]] : lanes[t];
+			/* Discontinuities (multiplicity equals order) and
+			 * windows exceeding the control points are rare and
+			 * handled by ts_int_knots_basis (see below). In the
+			 * meantime, these lanes use a valid dummy span. */
+			special[t] = (char) (span[t] >= n_ctrlp ||
+				(ts_knots_equal(lanes[t], kn[span[t]]) &&
+				ts_knots_equal(lanes[t], kn[span[t] - deg])));
+			first[t] = special[t] ? 0 : span[t] - deg;
+		}
+
+		/* Algorithm A2.2 of 'The NURBS Book' for all lanes. */
+		for (t = 0; t < num; t++)
+			weights[t] = 1;
+		for (j = 1; j <= deg; j++) {
+			for (t = 0; t < num; t++) {
+				kn = knots + t * stride + first[t];
+				left[j * T + t] = lanes[t] - kn[deg + 1 - j];
+				right[j * T + t] = kn[deg + j] - lanes[t];
+				saved[t] = 0;
+			}
+			for (r = 0; r < j; r++) {
+				for (t = 0; t < num; t++) {
+					temp = weights[r * T + t] /
+						(right[(r+1) * T + t] +
+						left[(j-r) * T + t]);
+					weights[r * T + t] = saved[t] +
+						right[(r+1) * T + t] * temp;
+					saved[t] = left[(j-r) * T + t] * temp;
+				}
+			}
+			for (t = 0; t < num; t++)
+				weights[j * T + t] = saved[t];
+		}
+
+		for (t = 0; t < num; t++) {
+			if (!special[t])
+				continue;
+			kn = knots + t * stride;
+			mult = ts_int_knots_multiplicity(kn, deg, lanes[t],
+				span[t]);
+			ts_int_knots_basis(kn, deg, n_ctrlp, lanes[t], span[t],
+				mult, first + t, scratch, scratch + order);
+			for (j = 0; j < order; j++)
+				weights[j * T + t] = scratch[j];
+		}
 
-		/* create beziers from b and s */
-		for (i = 0; i < n-1; i++) {
+		for (j = 0; j < order; j++) {
 			for (d = 0; d < dim; d++) {
-				j = i*dim+d;
-				k = i*4*dim+d;
-				l = (i+1)*dim+d;
-				ctrlp[k] = s[j];
-				ctrlp[k+dim] = tt*b[j] + at*b[l];
-				ctrlp[k+2*dim] = at*b[j] + tt*b[l];
-				ctrlp[k+3*dim] = s[l];
+				for (t = 0; t < num; t++) {
+					acc[d * T + t] += weights[j * T + t] *
+						ctrlp[((first[t] + j) * dim +
+						d) * m + t];
+				}
 			}
 		}
-	TS_CATCH(err)
-		ts_bspline_free(spline);
-	TS_FINALLY
-		if (s)
-			free(s);
-	TS_END_TRY_RETURN(err)
+	}
+
+	for (t = 0; t < num; t++) {
+		for (d = 0; d < dim; d++)
+			points[offsets[t] + d] = acc[d * T + t];
+	}
+	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_interpolate_cubic_natural(const tsReal *points,
-	size_t num_points, size_t dimension, tsBSpline *spline,
-	tsStatus *status)
+struct tsBSplineCollectionTask
 {
-	const size_t sof_ctrlp = dimension * sizeof(tsReal);
-	const size_t len_points = num_points * dimension;
-	const size_t num_int_points = num_points - 2;
-	const size_t len_int_points = num_int_points * dimension;
-	tsReal *thomas, *a, *b, *c, *d;
-	size_t i, j, k, l;
+	const struct tsBSplineCollectionImpl *impl;
+	const tsReal *us;     /**< NULL if all splines are evaluated at u. */
+	tsReal u;
+	tsReal *points;
+	tsReal *workspaces;   /**< One workspace per task. */
+	size_t len_workspace; /**< Length of a single workspace. */
+	tsStatus *statuses;   /**< One status per task. */
+};
+
+void ts_int_bsplinecollection_task(void *args, size_t index)
+{
+	struct tsBSplineCollectionTask *task =
+		(struct tsBSplineCollectionTask *) args;
+	const struct tsBSplineGroup *groups =
+		ts_int_bsplinecollection_access_groups(task->impl);
+	size_t low = 0, high = task->impl->n_groups, mid, begin, num;
+
+	/* Find the group of the tile. */
+	while (high - low > 1) {
+		mid = low + (high-low) / 2;
+		if (groups[mid].first_tile <= index)
+			low = mid;
+		else
+			high = mid;
+	}
+	begin = (index - groups[low].first_tile) * TS_INT_COLLECTION_TILE;
+	num = groups[low].n_splines - begin < TS_INT_COLLECTION_TILE ?
+		groups[low].n_splines - begin : TS_INT_COLLECTION_TILE;
+	ts_int_bsplinegroup_eval_tile(task->impl, groups + low, begin, num,
+		task->us, task->u, task->points,
+		task->workspaces + index * task->len_workspace,
+		task->statuses + index);
+}
+
+tsError ts_int_bsplinecollection_eval(const tsBSplineCollection *collection,
+	const tsReal *us, tsReal u, const tsExecutor *executor,
+	tsReal *points, tsStatus *status)
+{
+	const struct tsBSplineCollectionImpl *impl = collection->pImpl;
+	const size_t num_tasks = impl->n_tiles;
+	const size_t len_workspace =
+		ts_int_bsplinecollection_len_workspace(impl);
+	struct tsBSplineCollectionTask task;
+	tsExecutor fallback;
+	tsReal *workspaces = NULL;
+	tsStatus *statuses;
+	size_t i;
 	tsError err;
 
-	ts_int_bspline_init(spline);
-	if (num_points == 0)
-		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
-	if (num_points == 1) {
-		TS_CALL_ROE(err, ts_bspline_new(
-			4, dimension, 3, TS_CLAMPED, spline, status))
-		for (i = 0; i < ts_bspline_num_control_points(spline); i++) {
-			memcpy(ts_int_bspline_access_ctrlp(spline)
-				+ i * dimension, points, sof_ctrlp);
-		}
+	if (num_tasks == 0)
 		TS_RETURN_SUCCESS(status)
+	if (!executor) {
+		fallback = ts_executor_default();
+		executor = &fallback;
 	}
-	if (num_points == 2) {
-		return ts_int_relaxed_uniform_cubic_bspline(
-			points, num_points, dimension, spline, status);
-	}
-	/* `num_points` >= 3 */
-	thomas = NULL;
+
 	TS_TRY(try, err, status)
-		thomas = (tsReal *) malloc(3 * num_int_points * sof_ctrlp);
-		if (!thomas) {
+		/* A single allocation keeps the overhead per call low. */
+		workspaces = (tsReal *) ts_int_malloc(num_tasks *
+			(len_workspace * sizeof(tsReal) + sizeof(tsStatus)));
+		if (!workspaces) {
 			TS_THROW_0(try, err, status, TS_MALLOC,
 				"out of memory")
 		}
-		/* The system of linear equations is taken from:
-		 *     http://www.bakoma-tex.com/doc/generic/pst-bspline/
-		 *     pst-bspline-doc.pdf */
-		a = c = thomas;
-		ts_arr_fill(a, len_int_points, 1);
-		b = a + len_int_points;
-		ts_arr_fill(b, len_int_points, 4);
-		d = b + len_int_points;
-		/* 6 * S_{i+1} */
-		for (i = 0; i < num_int_points; i++) {
-			for (j = 0; j < dimension; j++) {
-				k = i * dimension + j;
-				l = (i+1) * dimension + j;
-				d[k] = 6 * points[l];
+		statuses = (tsStatus *) (workspaces +
+			num_tasks * len_workspace);
+
+		task.impl = impl;
+		task.us = us;
+		task.u = u;
+		task.points = points;
+		task.workspaces = workspaces;
+		task.len_workspace = len_workspace;
+		task.statuses = statuses;
+		executor->run(executor->ctx, ts_int_bsplinecollection_task,
+			&task, num_tasks);
+
+		for (i = 0; i < num_tasks; i++) {
+			if (statuses[i].code != TS_SUCCESS) {
+				TS_THROW_1(try, err, status, statuses[i].code,
+					"%s", statuses[i].message)
 			}
 		}
-		for (i = 0; i < dimension; i++) {
-			/* 6 * S_{1} - S_{0} */
-			d[i] -= points[i];
-			/* 6 * S_{n-1} - S_{n} */
-			k = len_int_points - (i+1);
-			l = len_points - (i+1);
-			d[k] -= points[l];
-		}
-		/* The Thomas algorithm requires at least two points. Hence,
-		 * `num_int_points` == 1 must be handled separately (let's call
-		 * it "Mini Thomas"). */
-		if (num_int_points == 1) {
-			for (i = 0; i < dimension; i++)
-				d[i] *= (tsReal) 0.25f;
-		} else {
-			TS_CALL(try, err, ts_int_thomas_algorithm(
-				a, b, c, num_int_points, dimension, d,
-				status))
-		}
-		memcpy(thomas, points, sof_ctrlp);
-		memmove(thomas + dimension, d, num_int_points * sof_ctrlp);
-		memcpy(thomas + (num_int_points+1) * dimension,
-			points + (num_points-1) * dimension, sof_ctrlp);
-		TS_CALL(try, err, ts_int_relaxed_uniform_cubic_bspline(
-			thomas, num_points, dimension, spline, status))
-	TS_CATCH(err)
-		ts_bspline_free(spline);
 	TS_FINALLY
-		if (thomas)
-			free(thomas);
+		if (workspaces)
+			ts_int_free(workspaces);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_interpolate_catmull_rom(const tsReal *points,
-	size_t num_points, size_t dimension, tsReal alpha, const tsReal *first,
-	const tsReal *last, tsReal epsilon, tsBSpline *spline,
+tsError ts_bsplinecollection_eval(const tsBSplineCollection *collection,
+	const tsReal *us, const tsExecutor *executor, tsReal *points,
 	tsStatus *status)
 {
-	const size_t sof_real = sizeof(tsReal);
-	const size_t sof_ctrlp = dimension * sof_real;
-	const tsReal eps = (tsReal) fabs(epsilon);
-	tsReal *bs_ctrlp; /* Points to the control points of `spline`. */
-	tsReal *cr_ctrlp; /**< The points to interpolate based on `points`. */
-	size_t i, d; /**< Used in for loops. */
-	tsError err; /**< Local error handling. */
-	/* [https://en.wikipedia.org/wiki/
-	 * Centripetal_Catmull%E2%80%93Rom_spline] */
-	tsReal t0, t1, t2, t3; /**< Catmull-Rom knots. */
-	/* [https://stackoverflow.com/questions/30748316/
-	 * catmull-rom-interpolation-on-svg-paths/30826434#30826434] */
-	tsReal c1, c2, d1, d2, m1, m2; /**< Used to calculate derivatives. */
-	tsReal *p0, *p1, *p2, *p3; /**< Processed Catmull-Rom points. */
+	return ts_int_bsplinecollection_eval(collection, us, 0, executor,
+		points, status);
+}
 
-	ts_int_bspline_init(spline);
-	if (dimension == 0)
-		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
-	if (num_points == 0)
-		TS_RETURN_0(status, TS_NUM_POINTS, "num(points) == 0")
-	if (num_points == 1) {
-		TS_CALL_ROE(err, ts_bspline_new(num_points, dimension,
-			num_points - 1, TS_CLAMPED, spline, status))
-		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
-		memcpy(bs_ctrlp, points, sof_ctrlp);
-		TS_RETURN_SUCCESS(status)
-	}
-	if (alpha < 0.f)
-		alpha = (tsReal) 0.f;
-	if (alpha > 1.f)
-		alpha = (tsReal) 1.f;
+tsError ts_bsplinecollection_eval_at(const tsBSplineCollection *collection,
+	tsReal u, const tsExecutor *executor, tsReal *points,
+	tsStatus *status)
+{
+	return ts_int_bsplinecollection_eval(collection, NULL, u, executor,
+		points, status);
+}
 
-	/* Copy `points` to `cr_ctrlp`. Add space for `first` and `last`. */
-	cr_ctrlp = (tsReal *) malloc((num_points + 2) * sof_ctrlp);
-	if (!cr_ctrlp)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-	memcpy(cr_ctrlp + dimension, points, num_points * sof_ctrlp);
+/* Locates \p u in the knot vector \p knots of a spline of degree \p deg with
+ * \p n_ctrlp control points and stores the index of its span in \p k.
+ * Unlike ts_int_knots_find, the span is never empty, i.e., knots[k] <
+ * knots[k+1] and k is in [deg, n_ctrlp). At discontinuities and at the end
+ * of the domain, the span to the left of \p u is taken (cf.
+ * ts_int_knots_basis). */
+tsError ts_int_knots_span(const tsReal *knots, size_t deg, size_t n_ctrlp,
+	tsReal u, size_t *k, tsStatus *status)
+{
+	const tsReal min = knots[deg];
+	const tsReal max = knots[n_ctrlp];
+	size_t s;
+	if (u < min && !ts_knots_equal(u, min)) {
+		TS_RETURN_2(status, TS_U_UNDEFINED,
+			"knot (%f) < min(domain) (%f)", u, min)
+	}
+	if (u > max && !ts_knots_equal(u, max)) {
+		TS_RETURN_2(status, TS_U_UNDEFINED,
+			"knot (%f) > max(domain) (%f)", u, max)
+	}
+	ts_int_knots_find(knots, n_ctrlp + deg + 1, u, k);
+	s = ts_int_knots_multiplicity(knots, deg, u, *k);
+	if ((*k >= n_ctrlp || s == deg + 1) && *k >= deg + s)
+		*k -= s;
+	TS_RETURN_SUCCESS(status)
+}
 
-	/* Remove redundant points from `cr_ctrlp`. Update `num_points`. */
-	for (i = 1 /* 0 (`first`) is not assigned yet */;
-			i < num_points /* skip last point (inclusive end) */;
-			i++) {
-		p0 = cr_ctrlp + (i * dimension);
-		p1 = p0 + dimension;
-		if (ts_distance(p0, p1, dimension) <= eps) {
-			/* Are there any other points (after the one that is
-			 * to be removed) that need to be shifted? */
-			if (i < num_points - 1) {
-				memmove(p1, p1 + dimension,
-					(num_points - (i + 1)) * sof_ctrlp);
-			}
-			num_points--;
-			i--;
+/* Calculates the values (\p values) and the first derivatives (\p derivs)
+ * of the basis functions of a spline of degree \p deg with knot vector
+ * \p knots at \p u, which is located in the non-empty span \p k (cf.
+ * ts_int_knots_span). The basis functions belong to the control points
+ * [k-deg, k]. \p derivs may be NULL. \p scratch must provide space for
+ * 3 * order values. Based on 'The NURBS Book' (algorithms A2.2 and A2.3). */
+void ts_int_knots_basis_derivs(const tsReal *knots, size_t deg, tsReal u,
+	size_t k, tsReal *values, tsReal *derivs, tsReal *scratch)
+{
+	const size_t order = deg + 1;
+	tsReal *left = scratch;
+	tsReal *right = scratch + order;
+	tsReal *lower = scratch + 2 * order;
+	tsReal saved, temp;
+	size_t j, r;
+
+	values[0] = 1;
+	for (j = 1; j <= deg; j++) {
+		/* The basis functions of degree deg-1. */
+		if (j == deg)
+			memcpy(lower, values, deg * sizeof(tsReal));
+		left[j] = u - knots[k+1-j];
+		right[j] = knots[k+j] - u;
+		saved = 0;
+		for (r = 0; r < j; r++) {
+			temp = values[r] / (right[r+1] + left[j-r]);
+			values[r] = saved + right[r+1] * temp;
+			saved = left[j-r] * temp;
 		}
+		values[j] = saved;
 	}
+	if (!derivs)
+		return;
 
-	/* Check if there are still enough points for interpolation. */
-	if (num_points == 1) { /* `num_points` can't be 0 */
-		free(cr_ctrlp); /* The point is copied from `points`. */
-		TS_CALL_ROE(err, ts_bspline_new(num_points, dimension,
-			num_points - 1, TS_CLAMPED, spline, status))
-		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
-		memcpy(bs_ctrlp, points, sof_ctrlp);
-		TS_RETURN_SUCCESS(status)
+	/* N'_{i,p} = p * (N_{i,p-1} / (u_{i+p} - u_i) -
+	 *                 N_{i+1,p-1} / (u_{i+p+1} - u_{i+1}))
+	 * The denominators enclose span k and are therefore positive. */
+	for (r = 0; r <= deg; r++) {
+		temp = 0;
+		if (r > 0)
+			temp += lower[r-1] / (knots[k+r] - knots[k-deg+r]);
+		if (r < deg)
+			temp -= lower[r] / (knots[k+r+1] - knots[k-deg+r+1]);
+		derivs[r] = deg * temp;
 	}
+}
 
-	/* Add or generate `first` and `last`. Update `num_points`. */
-	p0 = cr_ctrlp + dimension;
-	if (first && ts_distance(first, p0, dimension) > eps) {
-		memcpy(cr_ctrlp, first, sof_ctrlp);
-	} else {
-		p1 = p0 + dimension;
-		for (d = 0; d < dimension; d++)
-			cr_ctrlp[d] = p0[d] + (p0[d] - p1[d]);
+struct tsBSplineSurfaceGrid
+{
+	const tsBSplineSurface *surface;
+	size_t num_u;
+	size_t num_v;
+	const size_t *first_u; /**< First control point of each u. */
+	const size_t *first_v; /**< First control point of each v. */
+	const tsReal *basis_u; /**< Values (and derivatives) of each u. */
+	const tsReal *basis_v; /**< Values (and derivatives) of each v. */
+	tsReal *points;
+	tsReal *normals;       /**< NULL if normals are not calculated. */
+	tsReal *workspaces;    /**< One workspace per task. */
+};
+
+/* Evaluates row \p i of a grid (cf. ts_bsplinesurface_eval_grid). First, the
+ * control points of the iso-curve at u_i are calculated from the rows of the
+ * control net (and, if required, the control points of its derivative with
+ * respect to u). Then, the iso-curve is evaluated at all v. \p row must
+ * provide space for 2 * num_control_points_v * dim values. */
+void ts_int_bsplinesurface_eval_row(const struct tsBSplineSurfaceGrid *grid,
+	size_t i, tsReal *row)
+{
+	const struct tsBSplineSurfaceImpl *impl = grid->surface->pImpl;
+	const size_t dim = impl->dim;
+	const size_t order_u = impl->deg_u + 1;
+	const size_t order_v = impl->deg_v + 1;
+	const size_t len_row = impl->n_ctrlp_v * dim;
+	const int derive = grid->normals != NULL;
+	const size_t stride_u = derive ? 2 * order_u : order_u;
+	const size_t stride_v = derive ? 2 * order_v : order_v;
+	const tsReal *nu = grid->basis_u + i * stride_u;
+	const tsReal *net = ts_int_bsplinesurface_access_ctrlp(grid->surface)
+		+ grid->first_u[i] * len_row;
+	tsReal *row_u = row + len_row;
+	const tsReal *nv, *src;
+	tsReal *point, *normal, su[3], sv[3], len;
+	size_t a, b, j, l, d;
+
+	ts_arr_fill(row, derive ? 2 * len_row : len_row, 0);
+	for (a = 0; a < order_u; a++) {
+		src = net + a * len_row;
+		for (l = 0; l < len_row; l++)
+			row[l] += nu[a] * src[l];
+		if (derive) {
+			for (l = 0; l < len_row; l++)
+				row_u[l] += nu[order_u + a] * src[l];
+		}
 	}
-	p1 = cr_ctrlp + (num_points * dimension);
-	if (last && ts_distance(p1, last, dimension) > eps) {
-		memcpy(cr_ctrlp + ((num_points + 1) * dimension),
-			last, sof_ctrlp);
-	} else {
-		p0 = p1 - dimension;
-		for (d = 0; d < dimension; d++) {
-			cr_ctrlp[((num_points + 1) * dimension) + d] =
-				p1[d] + (p1[d] - p0[d]);
+
+	for (j = 0; j < grid->num_v; j++) {
+		nv = grid->basis_v + j * stride_v;
+		src = row + grid->first_v[j] * dim;
+		point = grid->points + (i * grid->num_v + j) * dim;
+		for (d = 0; d < dim; d++) {
+			point[d] = 0;
+			for (b = 0; b < order_v; b++)
+				point[d] += nv[b] * src[b * dim + d];
+		}
+		if (!derive)
+			continue;
+		/* Normals require dim == 3. */
+		for (d = 0; d < 3; d++) {
+			su[d] = sv[d] = 0;
+			for (b = 0; b < order_v; b++) {
+				su[d] += nv[b] * src[len_row + b * 3 + d];
+				sv[d] += nv[order_v + b] * src[b * 3 + d];
+			}
+		}
+		normal = grid->normals + (i * grid->num_v + j) * 3;
+		normal[0] = su[1] * sv[2] - su[2] * sv[1];
+		normal[1] = su[2] * sv[0] - su[0] * sv[2];
+		normal[2] = su[0] * sv[1] - su[1] * sv[0];
+		len = (tsReal) sqrt(normal[0] * normal[0] +
+			normal[1] * normal[1] + normal[2] * normal[2]);
+		if (len > 0) {
+			for (d = 0; d < 3; d++)
+				normal[d] /= len;
 		}
 	}
-	num_points = num_points + 2;
+}
+
+void ts_int_bsplinesurface_task(void *args, size_t index)
+{
+	const struct tsBSplineSurfaceGrid *grid =
+		(const struct tsBSplineSurfaceGrid *) args;
+	const size_t begin = index * TS_INT_SURFACE_ROWS;
+	const size_t end = begin + TS_INT_SURFACE_ROWS < grid->num_u ?
+		begin + TS_INT_SURFACE_ROWS : grid->num_u;
+	tsReal *row = grid->workspaces + index * 2 *
+		ts_bsplinesurface_num_control_points_v(grid->surface) *
+		ts_bsplinesurface_dimension(grid->surface);
+	size_t i;
+	for (i = begin; i < end; i++)
+		ts_int_bsplinesurface_eval_row(grid, i, row);
+}
+
+tsError ts_bsplinesurface_eval_grid(const tsBSplineSurface *surface,
+	const tsReal *us, size_t num_u, const tsReal *vs, size_t num_v,
+	const tsExecutor *executor, tsReal *points, tsReal *normals,
+	tsStatus *status)
+{
+	const struct tsBSplineSurfaceImpl *impl = surface->pImpl;
+	const size_t order_u = impl->deg_u + 1;
+	const size_t order_v = impl->deg_v + 1;
+	const size_t stride_u = normals ? 2 * order_u : order_u;
+	const size_t stride_v = normals ? 2 * order_v : order_v;
+	const size_t num_tasks = (num_u + TS_INT_SURFACE_ROWS - 1) /
+		TS_INT_SURFACE_ROWS;
+	const size_t len_scratch = 3 * (order_u > order_v ? order_u : order_v);
+	struct tsBSplineSurfaceGrid grid;
+	tsExecutor fallback;
+	size_t *first = NULL;
+	tsReal *basis_u, *basis_v, *scratch;
+	size_t i, k;
+	tsError err;
+
+	if (normals && impl->dim != 3) {
+		TS_RETURN_1(status, TS_DIM_ZERO,
+			"normals require dimension 3 (got %lu)",
+			(unsigned long) impl->dim)
+	}
+	if (num_u == 0 || num_v == 0)
+		TS_RETURN_SUCCESS(status)
+	if (!executor) {
+		fallback = ts_executor_default();
+		executor = &fallback;
+	}
 
-	/* Transform the sequence of Catmull-Rom splines. */
-	bs_ctrlp = NULL;
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_new(
-			(num_points - 3) * 4, dimension, 3,
-			TS_BEZIERS, spline, status))
-		bs_ctrlp = ts_int_bspline_access_ctrlp(spline);
-	TS_CATCH(err)
-		free(cr_ctrlp);
-	TS_END_TRY_ROE(err)
-	for (i = 0; i < ts_bspline_num_control_points(spline) / 4; i++) {
-		p0 = cr_ctrlp + ((i+0) * dimension);
-		p1 = cr_ctrlp + ((i+1) * dimension);
-		p2 = cr_ctrlp + ((i+2) * dimension);
-		p3 = cr_ctrlp + ((i+3) * dimension);
+		/* A single allocation keeps the overhead per call low. */
+		first = (size_t *) ts_int_malloc(
+			(num_u + num_v) * sizeof(size_t) +
+			(num_u * stride_u + num_v * stride_v + len_scratch +
+			num_tasks * 2 * impl->n_ctrlp_v * impl->dim) *
+			sizeof(tsReal));
+		if (!first) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		basis_u = (tsReal *) (first + num_u + num_v);
+		basis_v = basis_u + num_u * stride_u;
+		scratch = basis_v + num_v * stride_v;
+
+		/* The basis functions of each knot are calculated only
+		 * once and are shared by all rows (columns). */
+		for (i = 0; i < num_u; i++) {
+			TS_CALL(try, err, ts_int_knots_span(
+				ts_int_bsplinesurface_access_knots_u(surface),
+				impl->deg_u, impl->n_ctrlp_u, us[i], &k,
+				status))
+			first[i] = k - impl->deg_u;
+			ts_int_knots_basis_derivs(
+				ts_int_bsplinesurface_access_knots_u(surface),
+				impl->deg_u, us[i], k, basis_u + i * stride_u,
+				normals ? basis_u + i * stride_u + order_u
+				: NULL, scratch);
+		}
+		for (i = 0; i < num_v; i++) {
+			TS_CALL(try, err, ts_int_knots_span(
+				ts_int_bsplinesurface_access_knots_v(surface),
+				impl->deg_v, impl->n_ctrlp_v, vs[i], &k,
+				status))
+			first[num_u + i] = k - impl->deg_v;
+			ts_int_knots_basis_derivs(
+				ts_int_bsplinesurface_access_knots_v(surface),
+				impl->deg_v, vs[i], k, basis_v + i * stride_v,
+				normals ? basis_v + i * stride_v + order_v
+				: NULL, scratch);
+		}
 
-		t0 = (tsReal) 0.f;
-		t1 = t0 + (tsReal) pow(ts_distance(p0, p1, dimension), alpha);
-		t2 = t1 + (tsReal) pow(ts_distance(p1, p2, dimension), alpha);
-		t3 = t2 + (tsReal) pow(ts_distance(p2, p3, dimension), alpha);
+		grid.surface = surface;
+		grid.num_u = num_u;
+		grid.num_v = num_v;
+		grid.first_u = first;
+		grid.first_v = first + num_u;
+		grid.basis_u = basis_u;
+		grid.basis_v = basis_v;
+		grid.points = points;
+		grid.normals = normals;
+		grid.workspaces = scratch + len_scratch;
+		executor->run(executor->ctx, ts_int_bsplinesurface_task,
+			&grid, num_tasks);
+	TS_FINALLY
+		if (first)
+			ts_int_free(first);
+	TS_END_TRY_RETURN(err)
+}
 
-		c1 = (t2-t1) / (t2-t0);
-		c2 = (t1-t0) / (t2-t0);
-		d1 = (t3-t2) / (t3-t1);
-		d2 = (t2-t1) / (t3-t1);
+tsError ts_bsplinesurface_eval(const tsBSplineSurface *surface, tsReal u,
+	tsReal v, tsReal *point, tsReal *normal, tsStatus *status)
+{
+	return ts_bsplinesurface_eval_grid(surface, &u, 1, &v, 1, NULL,
+		point, normal, status);
+}
 
-		for (d = 0; d < dimension; d++) {
-			m1 = (t2-t1)*(c1*(p1[d]-p0[d])/(t1-t0)
-				+ c2*(p2[d]-p1[d])/(t2-t1));
-			m2 = (t2-t1)*(d1*(p2[d]-p1[d])/(t2-t1)
-				+ d2*(p3[d]-p2[d])/(t3-t2));
-			bs_ctrlp[((i*4 + 0) * dimension) + d] = p1[d];
-			bs_ctrlp[((i*4 + 1) * dimension) + d] = p1[d] + m1/3;
-			bs_ctrlp[((i*4 + 2) * dimension) + d] = p2[d] - m2/3;
-			bs_ctrlp[((i*4 + 3) * dimension) + d] = p2[d];
+/* Evaluates the segment with the power basis coefficients \p coeffs (order *
+ * dim values) at \p t and stores the resultant point and its first and
+ * second derivative in \p point, \p deriv, and \p deriv2. */
+void ts_int_power_eval(const tsReal *coeffs, size_t order, size_t dim,
+	tsReal t, tsReal *point, tsReal *deriv, tsReal *deriv2)
+{
+	size_t j, d;
+	for (d = 0; d < dim; d++) {
+		point[d] = coeffs[(order-1) * dim + d];
+		deriv[d] = deriv2[d] = 0;
+		for (j = order-1; j-- > 0;) {
+			deriv2[d] = deriv2[d] * t + deriv[d];
+			deriv[d] = deriv[d] * t + point[d];
+			point[d] = point[d] * t + coeffs[j * dim + d];
+		}
+		deriv2[d] *= 2;
+	}
+}
+
+/* Computes the parameters \p s and \p t (in [0, 1]) of the closest points of
+ * the line segments p0-p1 and q0-q1. */
+void ts_int_segments_closest(const tsReal *p0, const tsReal *p1,
+	const tsReal *q0, const tsReal *q1, size_t dim, tsReal *s, tsReal *t)
+{
+	tsReal a = 0, b = 0, c = 0, e = 0, f = 0, denom, u, v, w;
+	size_t d;
+	for (d = 0; d < dim; d++) {
+		u = p1[d] - p0[d];
+		v = q1[d] - q0[d];
+		w = p0[d] - q0[d];
+		a += u * u;
+		b += u * v;
+		c += u * w;
+		e += v * v;
+		f += v * w;
+	}
+	denom = a * e - b * b;
+	*s = denom > 0 ? (b * f - c * e) / denom : 0;
+	*s = *s < 0 ? 0 : (*s > 1 ? 1 : *s);
+	*t = e > 0 ? (b * *s + f) / e : 0;
+	if (*t < 0) {
+		*t = 0;
+		*s = a > 0 ? -c / a : 0;
+	} else if (*t > 1) {
+		*t = 1;
+		*s = a > 0 ? (b - c) / a : 0;
+	}
+	*s = *s < 0 ? 0 : (*s > 1 ? 1 : *s);
+}
+
+/* Returns whether the bounding boxes of the control points of two Bezier
+ * curves, enlarged by \p eps, overlap. */
+int ts_int_beziers_overlap(const tsReal *a, size_t order_a, const tsReal *b,
+	size_t order_b, size_t dim, tsReal eps)
+{
+	tsReal min_a, max_a, min_b, max_b;
+	size_t i, d;
+	for (d = 0; d < dim; d++) {
+		min_a = max_a = a[d];
+		for (i = 1; i < order_a; i++) {
+			min_a = a[i*dim + d] < min_a ? a[i*dim + d] : min_a;
+			max_a = a[i*dim + d] > max_a ? a[i*dim + d] : max_a;
 		}
+		min_b = max_b = b[d];
+		for (i = 1; i < order_b; i++) {
+			min_b = b[i*dim + d] < min_b ? b[i*dim + d] : min_b;
+			max_b = b[i*dim + d] > max_b ? b[i*dim + d] : max_b;
+		}
+		if (min_a > max_b + eps || min_b > max_a + eps)
+			return 0;
 	}
-	free(cr_ctrlp);
-	TS_RETURN_SUCCESS(status)
+	return 1;
 }
 
+/* Maximum number of subdivisions of ts_int_intersect_curves and
+ * ts_int_intersect_plane. */
+#define TS_INT_INTERSECT_MAX_DEPTH 48
 
+/* Stores the state of an intersection query. */
+struct tsIntersector
+{
+	const tsProjector *a; /**< First curve. */
+	const tsProjector *b; /**< Second curve (NULL for planes). */
+	const tsReal *origin; /**< Point of the plane. */
+	const tsReal *normal; /**< Unit normal of the plane. */
+	size_t seg_a;         /**< Current segment of a. */
+	size_t seg_b;         /**< Current segment of b. */
+	size_t dim;
+	tsReal eps;
+	tsReal *work;      /**< Subdivided pieces of each level and scratch. */
+	size_t len_piece;  /**< Maximum number of values of a piece. */
+	tsReal *hits;      /**< Pairs of knots. */
+	size_t n_hits;
+	size_t cap;
+};
 
-/******************************************************************************
-*                                                                             *
-* :: Query Functions                                                          *
-*                                                                             *
-******************************************************************************/
-tsError ts_int_bspline_find_knot(const tsBSpline *spline, tsReal knot,
-	size_t *index, size_t *multiplicity, tsStatus *status)
+tsError ts_int_intersector_new(struct tsIntersector *ctx,
+	const tsProjector *a, const tsProjector *b, tsReal eps,
+	tsStatus *status)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t num_knots = ts_bspline_num_knots(spline);
-	const tsReal *knots = ts_int_bspline_access_knots(spline);
-	tsReal min, max;
-	size_t low, high;
+	const size_t order_a = a->pImpl->deg + 1;
+	const size_t order_b = b ? b->pImpl->deg + 1 : 0;
+	ctx->a = a;
+	ctx->b = b;
+	ctx->origin = ctx->normal = NULL;
+	ctx->dim = a->pImpl->dim;
+	ctx->eps = eps;
+	ctx->len_piece = (order_a > order_b ? order_a : order_b) * ctx->dim;
+	ctx->n_hits = 0;
+	ctx->cap = 16;
+	/* Two pieces per level, the scratch of ts_int_bezier_split, the
+	 * input piece of ts_int_intersect_plane, and a point and its first
+	 * and second derivative for each curve. */
+	ctx->work = (tsReal *) ts_int_malloc(
+		((TS_INT_INTERSECT_MAX_DEPTH * 2 + 2) * ctx->len_piece +
+		6 * ctx->dim) * sizeof(tsReal));
+	ctx->hits = (tsReal *) malloc(2 * ctx->cap * sizeof(tsReal));
+	if (!ctx->work || !ctx->hits) {
+		if (ctx->work)
+			ts_int_free(ctx->work);
+		if (ctx->hits)
+			free(ctx->hits);
+		ctx->work = ctx->hits = NULL;
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	TS_RETURN_SUCCESS(status)
+}
 
-	ts_bspline_domain(spline, &min, &max);
-	if (knot < min && !ts_knots_equal(knot, min)) {
-		TS_RETURN_2(status, TS_U_UNDEFINED,
-			"knot (%f) < min(domain) (%f)", knot, min)
+void ts_int_intersector_free(struct tsIntersector *ctx)
+{
+	if (ctx->work)
+		ts_int_free(ctx->work);
+	if (ctx->hits)
+		free(ctx->hits);
+	ctx->work = ctx->hits = NULL;
+}
+
+/* Appends the hit at the parameters \p s and \p t (in [0, 1]) of the
+ * current segments to \p ctx, mapped to the domains of the segments. */
+tsError ts_int_intersector_append(struct tsIntersector *ctx, tsReal s,
+	tsReal t, tsStatus *status)
+{
+	const tsReal *dom_a = ts_int_projector_access_domains(ctx->a) +
+		ctx->seg_a * 2;
+	const tsReal *dom_b;
+	tsReal *hits;
+	if (ctx->n_hits == ctx->cap) {
+		hits = (tsReal *) realloc(ctx->hits,
+			4 * ctx->cap * sizeof(tsReal));
+		if (!hits)
+			TS_RETURN_0(status, TS_MALLOC, "out of memory")
+		ctx->hits = hits;
+		ctx->cap *= 2;
 	}
-	if (knot > max && !ts_knots_equal(knot, max)) {
-		TS_RETURN_2(status, TS_U_UNDEFINED,
-			"knot (%f) > max(domain) (%f)", knot, max)
+	ctx->hits[ctx->n_hits * 2] = dom_a[0] + s * (dom_a[1] - dom_a[0]);
+	if (ctx->b) {
+		dom_b = ts_int_projector_access_domains(ctx->b) +
+			ctx->seg_b * 2;
+		t = dom_b[0] + t * (dom_b[1] - dom_b[0]);
 	}
+	ctx->hits[ctx->n_hits * 2 + 1] = t;
+	ctx->n_hits++;
+	TS_RETURN_SUCCESS(status)
+}
 
-	/* Based on 'The NURBS Book' (Les Piegl and Wayne Tiller). */
-	if (ts_knots_equal(knot, knots[num_knots - 1])) {
-		*index = num_knots - 1;
-	} else {
-		low = 0;
-		high = num_knots - 1;
-		*index = (low+high) / 2;
-		while (knot < knots[*index] || knot >= knots[*index + 1]) {
-			if (knot < knots[*index])
-				high = *index;
-			else
-				low = *index;
-			*index = (low+high) / 2;
+/* Returns the distance between the current segments of \p ctx at the
+ * parameters \p s and \p t. If \p polish is true, \p s and \p t are moved to
+ * the closest points of the segments near \p s and \p t beforehand with a
+ * damped Gauss-Newton iteration. The iteration converges to tangential
+ * contacts as well. */
+tsReal ts_int_intersect_curves_polish(struct tsIntersector *ctx, tsReal *s,
+	tsReal *t, int polish)
+{
+	const size_t dim = ctx->dim;
+	const size_t order_a = ctx->a->pImpl->deg + 1;
+	const size_t order_b = ctx->b->pImpl->deg + 1;
+	const tsReal *ca = ts_int_projector_access_coeffs(ctx->a) +
+		ctx->seg_a * order_a * dim;
+	const tsReal *cb = ts_int_projector_access_coeffs(ctx->b) +
+		ctx->seg_b * order_b * dim;
+	tsReal *pa = ctx->work + (TS_INT_INTERSECT_MAX_DEPTH * 2 + 2) *
+		ctx->len_piece;
+	tsReal *da = pa + dim, *dda = da + dim;
+	tsReal *pb = dda + dim, *db = pb + dim, *ddb = db + dim;
+	tsReal m11, m12, m22, g1, g2, r, lambda, det, ds, dt, dist_sq;
+	size_t iter, d;
+
+	for (iter = 0; iter < 32; iter++) {
+		ts_int_power_eval(ca, order_a, dim, *s, pa, da, dda);
+		ts_int_power_eval(cb, order_b, dim, *t, pb, db, ddb);
+		if (!polish)
+			break;
+		m11 = m12 = m22 = g1 = g2 = 0;
+		for (d = 0; d < dim; d++) {
+			r = pa[d] - pb[d];
+			m11 += da[d] * da[d];
+			m12 -= da[d] * db[d];
+			m22 += db[d] * db[d];
+			g1 += da[d] * r;
+			g2 -= db[d] * r;
+		}
+		lambda = (m11 + m22) * 1e-9f + TS_INT_REAL_EPSILON;
+		det = (m11 + lambda) * (m22 + lambda) - m12 * m12;
+		if (det <= 0)
+			break;
+		ds = -((m22 + lambda) * g1 - m12 * g2) / det;
+		dt = -((m11 + lambda) * g2 - m12 * g1) / det;
+		ds = *s + ds < 0 ? -*s : (*s + ds > 1 ? 1 - *s : ds);
+		dt = *t + dt < 0 ? -*t : (*t + dt > 1 ? 1 - *t : dt);
+		*s += ds;
+		*t += dt;
+		if (fabs(ds) + fabs(dt) <= 4 * TS_INT_REAL_EPSILON) {
+			polish = 0;
+			iter--;
 		}
 	}
+	ts_int_power_eval(ca, order_a, dim, *s, pa, da, dda);
+	ts_int_power_eval(cb, order_b, dim, *t, pb, db, ddb);
+	dist_sq = 0;
+	for (d = 0; d < dim; d++)
+		dist_sq += (pa[d] - pb[d]) * (pa[d] - pb[d]);
+	return (tsReal) sqrt(dist_sq);
+}
 
-	/* Handle floating point errors. */
-	while (*index < num_knots - 1 && /* there is a next knot */
-		ts_knots_equal(knot, knots[*index + 1])) {
-		(*index)++;
+/* Intersects the piece \p a (covering [a0, a1] of the current segment of
+ * the first curve) with the piece \p b (covering [b0, b1] of the current
+ * segment of the second curve). Pieces whose control points are farther
+ * apart than eps cannot intersect (convex hull property). Otherwise, the
+ * less flat piece is split until both pieces are flat (within eps / 4). The
+ * closest points of the chords of flat pieces are then polished with
+ * ts_int_intersect_curves_polish. */
+tsError ts_int_intersect_curves(struct tsIntersector *ctx, const tsReal *a,
+	tsReal a0, tsReal a1, const tsReal *b, tsReal b0, tsReal b1,
+	size_t depth, tsStatus *status)
+{
+	const size_t dim = ctx->dim;
+	const size_t deg_a = ctx->a->pImpl->deg;
+	const size_t deg_b = ctx->b->pImpl->deg;
+	const tsReal tol = ctx->eps / 4;
+	tsReal *left = ctx->work + depth * 2 * ctx->len_piece;
+	tsReal *right = left + ctx->len_piece;
+	tsReal *tmp = ctx->work + TS_INT_INTERSECT_MAX_DEPTH * 2 *
+		ctx->len_piece;
+	tsReal flat_a, flat_b, s, t, s0, t0;
+	tsError err;
+
+	if (!ts_int_beziers_overlap(a, deg_a + 1, b, deg_b + 1, dim,
+		ctx->eps))
+		TS_RETURN_SUCCESS(status)
+	flat_a = ts_int_bezier_flatness_sq(a, deg_a, dim);
+	flat_b = ts_int_bezier_flatness_sq(b, deg_b, dim);
+	if ((flat_a <= tol * tol && flat_b <= tol * tol) ||
+		depth == TS_INT_INTERSECT_MAX_DEPTH) {
+		ts_int_segments_closest(a, a + deg_a * dim, b,
+			b + deg_b * dim, dim, &s, &t);
+		s0 = s = a0 + s * (a1 - a0);
+		t0 = t = b0 + t * (b1 - b0);
+		if (ts_int_intersect_curves_polish(ctx, &s, &t, 1) <=
+			ctx->eps)
+			return ts_int_intersector_append(ctx, s, t, status);
+		if (ts_int_intersect_curves_polish(ctx, &s0, &t0, 0) <=
+			ctx->eps)
+			return ts_int_intersector_append(ctx, s0, t0, status);
+		TS_RETURN_SUCCESS(status)
 	}
+	if (flat_a >= flat_b) {
+		ts_int_bezier_split(a, deg_a, dim, tmp, left, right);
+		TS_CALL_ROE(err, ts_int_intersect_curves(ctx, left, a0,
+			(a0 + a1) / 2, b, b0, b1, depth + 1, status))
+		return ts_int_intersect_curves(ctx, right, (a0 + a1) / 2, a1,
+			b, b0, b1, depth + 1, status);
+	}
+	ts_int_bezier_split(b, deg_b, dim, tmp, left, right);
+	TS_CALL_ROE(err, ts_int_intersect_curves(ctx, a, a0, a1, left, b0,
+		(b0 + b1) / 2, depth + 1, status))
+	return ts_int_intersect_curves(ctx, a, a0, a1, right, (b0 + b1) / 2,
+		b1, depth + 1, status);
+}
 
-	/* Calculate knot's multiplicity. */
-	for (*multiplicity = deg + 1; *multiplicity > 0 ; (*multiplicity)--) {
-		if (ts_knots_equal(knot, knots[*index - (*multiplicity-1)]))
-			break;
+/* Returns whether the boxes \p a and \p b, enlarged by \p eps, overlap. */
+int ts_int_boxes_overlap(const tsReal *a, const tsReal *b, size_t dim,
+	tsReal eps)
+{
+	size_t d;
+	for (d = 0; d < dim; d++) {
+		if (a[d] > b[dim + d] + eps || b[d] > a[dim + d] + eps)
+			return 0;
 	}
+	return 1;
+}
+
+/* Intersects the curves of \p ctx by traversing their hierarchies
+ * simultaneously. Pairs of subtrees whose boxes do not overlap are
+ * skipped; the remaining pairs of segments are intersected with
+ * ts_int_intersect_curves. */
+tsError ts_int_intersect_projectors(struct tsIntersector *ctx,
+	tsStatus *status)
+{
+	const size_t dim = ctx->dim;
+	const size_t len_a = (ctx->a->pImpl->deg + 1) * dim;
+	const size_t len_b = (ctx->b->pImpl->deg + 1) * dim;
+	const tsReal *boxes_a = ts_int_projector_access_boxes(ctx->a);
+	const tsReal *boxes_b = ts_int_projector_access_boxes(ctx->b);
+	const tsReal *ctrlp_a = ts_int_projector_access_ctrlp(ctx->a);
+	const tsReal *ctrlp_b = ts_int_projector_access_ctrlp(ctx->b);
+	/* Node, lo, and hi of both subtrees of the pairs yet to be
+	 * visited. */
+	size_t stack[6 * (2 * TS_INT_PROJECTOR_MAX_DEPTH + 1)];
+	size_t top = 1, *e, na, la, ha, nb, lb, hb, mid;
+	tsError err;
 
+	stack[0] = stack[1] = 0;
+	stack[2] = ctx->a->pImpl->n_segs;
+	stack[3] = stack[4] = 0;
+	stack[5] = ctx->b->pImpl->n_segs;
+	while (top > 0) {
+		e = stack + --top * 6;
+		na = e[0]; la = e[1]; ha = e[2];
+		nb = e[3]; lb = e[4]; hb = e[5];
+		if (!ts_int_boxes_overlap(boxes_a + na * 2 * dim,
+			boxes_b + nb * 2 * dim, dim, ctx->eps))
+			continue;
+		if (ha - la == 1 && hb - lb == 1) {
+			ctx->seg_a = la;
+			ctx->seg_b = lb;
+			TS_CALL_ROE(err, ts_int_intersect_curves(ctx,
+				ctrlp_a + la * len_a, 0, 1,
+				ctrlp_b + lb * len_b, 0, 1, 0, status))
+			continue;
+		}
+		/* Descend into the larger subtree. */
+		if (ha - la >= hb - lb) {
+			mid = la + (ha - la) / 2;
+			e[0] = na + 2 * (mid - la); e[1] = mid;
+			e = stack + ++top * 6;
+			e[0] = na + 1; e[1] = la; e[2] = mid;
+			e[3] = nb; e[4] = lb; e[5] = hb;
+		} else {
+			mid = lb + (hb - lb) / 2;
+			e[3] = nb + 2 * (mid - lb); e[4] = mid;
+			e = stack + ++top * 6;
+			e[0] = na; e[1] = la; e[2] = ha;
+			e[3] = nb + 1; e[4] = lb; e[5] = mid;
+		}
+		top++;
+	}
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_int_bspline_eval_woa(const tsBSpline *spline, tsReal u,
-	tsDeBoorNet *net, tsStatus *status)
+int ts_int_hits_cmp(const void *x, const void *y)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t order = ts_bspline_order(spline);
-	const size_t dim = ts_bspline_dimension(spline);
-	const size_t num_knots = ts_bspline_num_knots(spline);
-	const size_t sof_ctrlp = dim * sizeof(tsReal);
+	const tsReal *a = (const tsReal *) x;
+	const tsReal *b = (const tsReal *) y;
+	if (a[0] < b[0]) return -1;
+	if (a[0] > b[0]) return 1;
+	if (a[1] < b[1]) return -1;
+	if (a[1] > b[1]) return 1;
+	return 0;
+}
 
-	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
-	const tsReal *knots = ts_int_bspline_access_knots(spline);
-	tsReal *points = NULL;  /**< Pointer to the points of \p net. */
+/* Returns the parameter (in [0, 1]) of \p u in the segment of \p projector
+ * that contains \p u and stores the index of the segment in \p seg. */
+tsReal ts_int_projector_locate(const tsProjector *projector, tsReal u,
+	size_t *seg)
+{
+	const tsReal *domains = ts_int_projector_access_domains(projector);
+	size_t lo = 0, hi = projector->pImpl->n_segs, mid;
+	tsReal t;
+	while (hi - lo > 1) {
+		mid = lo + (hi - lo) / 2;
+		if (u < domains[mid * 2])
+			hi = mid;
+		else
+			lo = mid;
+	}
+	*seg = lo;
+	t = (u - domains[lo * 2]) / (domains[lo * 2 + 1] - domains[lo * 2]);
+	return t < 0 ? 0 : (t > 1 ? 1 : t);
+}
 
-	size_t k;        /**< Index of \p u. */
-	size_t s;        /**< Multiplicity of \p u. */
+/* Returns the distance between the curves (or the curve and the plane) of
+ * \p ctx at the knots \p hit. */
+tsReal ts_int_intersector_distance(struct tsIntersector *ctx,
+	const tsReal *hit)
+{
+	const size_t dim = ctx->dim;
+	tsReal *pa = ctx->work + (TS_INT_INTERSECT_MAX_DEPTH * 2 + 2) *
+		ctx->len_piece;
+	tsReal *pb = pa + dim, t, dist = 0;
+	size_t seg, d, order = ctx->a->pImpl->deg + 1;
+
+	t = ts_int_projector_locate(ctx->a, hit[0], &seg);
+	ts_int_projector_point(ts_int_projector_access_coeffs(ctx->a) +
+		seg * order * dim, order, dim, t, pa);
+	if (!ctx->b) {
+		for (d = 0; d < dim; d++)
+			dist += (pa[d] - ctx->origin[d]) * ctx->normal[d];
+		return (tsReal) fabs(dist);
+	}
+	order = ctx->b->pImpl->deg + 1;
+	t = ts_int_projector_locate(ctx->b, hit[1], &seg);
+	ts_int_projector_point(ts_int_projector_access_coeffs(ctx->b) +
+		seg * order * dim, order, dim, t, pb);
+	return ts_distance(pa, pb, dim);
+}
 
-	tsReal uk;       /**< The actual used u. */
-	size_t from;     /**< Offset used to copy values. */
-	size_t fst;      /**< First affected control point, inclusive. */
-	size_t lst;      /**< Last affected control point, inclusive. */
-	size_t N;        /**< Number of affected control points. */
+/* Sorts the hits of \p ctx and removes duplicates. Hits at the boundaries of
+ * adjacent segments and hits of adjacent pieces of tangential contacts are
+ * found several times. Since the knots of tangential contacts are less
+ * accurate than those of crossings (roughly the square root of the
+ * precision), a hit is considered a duplicate of the previous one if their
+ * knots are equal (cf. ts_knots_equal) or if the curves are within eps at
+ * the knots halfway between them. In the latter case, the knots closest to
+ * the contact are kept. */
+void ts_int_intersector_unique(struct tsIntersector *ctx)
+{
+	tsReal *hits = ctx->hits, mid[2], dist, dist_cur, dist_mid;
+	size_t i, n = 0;
+	qsort(hits, ctx->n_hits, 2 * sizeof(tsReal), ts_int_hits_cmp);
+	for (i = 0; i < ctx->n_hits; i++) {
+		if (n > 0) {
+			if (ts_knots_equal(hits[i*2], hits[(n-1)*2]) &&
+				ts_knots_equal(hits[i*2 + 1],
+					hits[(n-1)*2 + 1]))
+				continue;
+			mid[0] = (hits[i*2] + hits[(n-1)*2]) / 2;
+			mid[1] = (hits[i*2 + 1] + hits[(n-1)*2 + 1]) / 2;
+			dist_mid = ts_int_intersector_distance(ctx, mid);
+			if (dist_mid <= ctx->eps) {
+				dist = ts_int_intersector_distance(ctx,
+					hits + (n-1)*2);
+				dist_cur = ts_int_intersector_distance(ctx,
+					hits + i*2);
+				if (dist_cur < dist) {
+					dist = dist_cur;
+					hits[(n-1)*2] = hits[i*2];
+					hits[(n-1)*2 + 1] = hits[i*2 + 1];
+				}
+				if (dist_mid < dist) {
+					hits[(n-1)*2] = mid[0];
+					hits[(n-1)*2 + 1] = mid[1];
+				}
+				continue;
+			}
+		}
+		hits[n*2] = hits[i*2];
+		hits[n*2 + 1] = hits[i*2 + 1];
+		n++;
+	}
+	ctx->n_hits = n;
+}
 
-	/* The following indices are used to create the DeBoor net. */
-	size_t lidx;     /**< Current left index. */
-	size_t ridx;     /**< Current right index. */
-	size_t tidx;     /**< Current to index. */
-	size_t r, i, d;  /**< Used in for loop. */
-	tsReal ui;       /**< Knot value at index i. */
-	tsReal a, a_hat; /**< Weighting factors of control points. */
+/* Moves the hits of \p ctx to \p knots (NULL if there are no hits). */
+void ts_int_intersector_result(struct tsIntersector *ctx, tsReal **knots,
+	size_t *num)
+{
+	*num = ctx->n_hits;
+	if (ctx->n_hits == 0) {
+		*knots = NULL;
+		free(ctx->hits);
+	} else {
+		*knots = ctx->hits;
+	}
+	ctx->hits = NULL;
+}
 
+tsError ts_bspline_intersect_curves(const tsBSpline *a, const tsBSpline *b,
+	tsReal epsilon, tsReal **knots, size_t *num, tsStatus *status)
+{
+	tsProjector pa = ts_projector_init(), pb = ts_projector_init();
+	struct tsIntersector ctx;
 	tsError err;
 
-	points = ts_int_deboornet_access_points(net);
-
-	/* 1. Find index k such that u is in between [u_k, u_k+1).
-	 * 2. Setup already known values.
-	 * 3. Decide by multiplicity of u how to calculate point P(u). */
-
-	/* 1. */
-	k = s = 0;
-	TS_CALL_ROE(err, ts_int_bspline_find_knot(
-		spline, u, &k, &s, status))
+	*knots = NULL;
+	*num = 0;
+	ctx.work = ctx.hits = NULL;
+	if (ts_bspline_dimension(a) != ts_bspline_dimension(b)) {
+		TS_RETURN_2(status, TS_INCOMPATIBLE,
+			"dimension of a (%lu) != dimension of b (%lu)",
+			(unsigned long) ts_bspline_dimension(a),
+			(unsigned long) ts_bspline_dimension(b))
+	}
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_projector(a, &pa, status))
+		TS_CALL(try, err, ts_bspline_projector(b, &pb, status))
+		TS_CALL(try, err, ts_int_intersector_new(&ctx, &pa, &pb,
+			(tsReal) fabs(epsilon), status))
+		TS_CALL(try, err, ts_int_intersect_projectors(&ctx, status))
+		ts_int_intersector_unique(&ctx);
+		ts_int_intersector_result(&ctx, knots, num);
+	TS_FINALLY
+		ts_projector_free(&pa);
+		ts_projector_free(&pb);
+		ts_int_intersector_free(&ctx);
+	TS_END_TRY_RETURN(err)
+}
 
-	/* 2. */
-	uk = knots[k];  /* Ensures that with any precision of  */
-	net->pImpl->u = /* tsReal the knot vector stays valid. */
-		ts_knots_equal(u, uk) ? uk : u;
-	net->pImpl->k = k;
-	net->pImpl->s = s;
-	net->pImpl->h = deg < s ? 0 : deg-s; /* prevent underflow */
+/* Stores the signed distances between the control points of the piece \p a
+ * of the first curve of \p ctx and the plane of \p ctx in \p dists. */
+void ts_int_plane_distances(const struct tsIntersector *ctx, const tsReal *a,
+	size_t order, tsReal *dists)
+{
+	size_t i, d;
+	for (i = 0; i < order; i++) {
+		dists[i] = 0;
+		for (d = 0; d < ctx->dim; d++) {
+			dists[i] += (a[i * ctx->dim + d] - ctx->origin[d]) *
+				ctx->normal[d];
+		}
+	}
+}
 
-	/* 3. (by 1. s <= order)
-	 *
-	 * 3a) Check for s = order.
-	 *     Take the two points k-s and k-s + 1. If one of
-	 *     them doesn't exist, take only the other.
-	 * 3b) Use de boor algorithm to find point P(u). */
-	if (s == order) {
-		/* only one of the two control points exists */
-		if (k == deg || /* only the first */
-		    k == num_knots - 1) { /* only the last */
-			from = k == deg ? 0 : (k-s) * dim;
-			net->pImpl->n_points = 1;
-			memcpy(points, ctrlp + from, sof_ctrlp);
+/* Returns the signed distance between the current segment of \p ctx at
+ * \p t and the plane of \p ctx. If \p polish is true, \p t is moved to the
+ * closest root of the distance (Newton on the distance) or, if \p crossing
+ * is false, to the closest extremum of the distance (Newton on the
+ * derivative of the distance) beforehand. The latter handles tangential
+ * contacts. */
+tsReal ts_int_intersect_plane_polish(struct tsIntersector *ctx, tsReal *t,
+	int crossing, int polish)
+{
+	const size_t dim = ctx->dim;
+	const size_t order = ctx->a->pImpl->deg + 1;
+	const tsReal *coeffs = ts_int_projector_access_coeffs(ctx->a) +
+		ctx->seg_a * order * dim;
+	tsReal *p = ctx->work + (TS_INT_INTERSECT_MAX_DEPTH * 2 + 2) *
+		ctx->len_piece;
+	tsReal *dp = p + dim, *ddp = dp + dim;
+	tsReal f, df, ddf, step;
+	size_t iter, d;
+
+	for (iter = 0; iter < 32 && polish; iter++) {
+		ts_int_power_eval(coeffs, order, dim, *t, p, dp, ddp);
+		f = df = ddf = 0;
+		for (d = 0; d < dim; d++) {
+			f += (p[d] - ctx->origin[d]) * ctx->normal[d];
+			df += dp[d] * ctx->normal[d];
+			ddf += ddp[d] * ctx->normal[d];
+		}
+		if (crossing) {
+			if (fabs(df) <= TS_INT_REAL_EPSILON)
+				break;
+			step = f / df;
 		} else {
-			from = (k-s) * dim;
-			net->pImpl->n_points = 2;
-			memcpy(points, ctrlp + from, 2 * sof_ctrlp);
+			if (fabs(ddf) <= TS_INT_REAL_EPSILON)
+				break;
+			step = df / ddf;
 		}
-	} else { /* by 3a) s <= deg (order = deg+1) */
-		fst = k-deg; /* by 1. k >= deg */
-		lst = k-s; /* s <= deg <= k */
-		N = lst-fst + 1; /* lst <= fst implies N >= 1 */
-
-		net->pImpl->n_points = (size_t)(N * (N+1) * 0.5f);
-
-		/* copy initial values to output */
-		memcpy(points, ctrlp + fst*dim, N * sof_ctrlp);
+		step = *t - step < 0 ? *t : (*t - step > 1 ? *t - 1 : step);
+		*t -= step;
+		if (fabs(step) <= 4 * TS_INT_REAL_EPSILON)
+			break;
+	}
+	ts_int_power_eval(coeffs, order, dim, *t, p, dp, ddp);
+	f = 0;
+	for (d = 0; d < dim; d++)
+		f += (p[d] - ctx->origin[d]) * ctx->normal[d];
+	return f;
+}
 
-		lidx = 0;
-		ridx = dim;
-		tidx = N*dim; /* N >= 1 implies tidx > 0 */
-		r = 1;
-		for (;r <= ts_deboornet_num_insertions(net); r++) {
-			i = fst + r;
-			for (; i <= lst; i++) {
-				ui = knots[i];
-				a = (ts_deboornet_knot(net) - ui) /
-					(knots[i+deg-r+1] - ui);
-				a_hat = 1.f-a;
+/* Intersects the piece \p dists (the signed distances of the control points
+ * of a piece covering [t0, t1] of the current segment) with the plane of
+ * \p ctx. Pieces whose distances are all greater than eps (or all less than
+ * -eps) cannot intersect (convex hull property). Otherwise, the piece is
+ * split until it is flat (within eps / 4). The root of the chord of a flat
+ * piece (or, if there is none, the endpoint closer to the plane) is then
+ * polished with ts_int_intersect_plane_polish. */
+tsError ts_int_intersect_plane(struct tsIntersector *ctx,
+	const tsReal *dists, tsReal t0, tsReal t1, size_t depth,
+	tsStatus *status)
+{
+	const size_t deg = ctx->a->pImpl->deg;
+	const tsReal eps = ctx->eps;
+	tsReal *left = ctx->work + depth * 2 * ctx->len_piece;
+	tsReal *right = left + ctx->len_piece;
+	tsReal *tmp = ctx->work + TS_INT_INTERSECT_MAX_DEPTH * 2 *
+		ctx->len_piece;
+	tsReal min = dists[0], max = dists[0], flat = 0, v, t, t_0;
+	int crossing;
+	size_t i;
+	tsError err;
 
-				for (d = 0; d < dim; d++) {
-					points[tidx++] =
-						a_hat * points[lidx++] +
-						a     * points[ridx++];
-				}
-			}
-			lidx += dim;
-			ridx += dim;
+	for (i = 1; i <= deg; i++) {
+		min = dists[i] < min ? dists[i] : min;
+		max = dists[i] > max ? dists[i] : max;
+		v = (tsReal) fabs(dists[i] - (dists[0] + (dists[deg] -
+			dists[0]) * i / deg));
+		flat = v > flat ? v : flat;
+	}
+	if (min > eps || max < -eps)
+		TS_RETURN_SUCCESS(status)
+	if (flat <= eps / 4 || depth == TS_INT_INTERSECT_MAX_DEPTH) {
+		crossing = (dists[0] <= 0 && dists[deg] >= 0) ||
+			(dists[0] >= 0 && dists[deg] <= 0);
+		if (crossing) {
+			t = dists[0] - dists[deg];
+			t = fabs(t) > 0 ? dists[0] / t : (tsReal) 0.5;
+		} else {
+			t = fabs(dists[0]) < fabs(dists[deg]) ? 0 : 1;
 		}
+		t_0 = t = t0 + t * (t1 - t0);
+		if (fabs(ts_int_intersect_plane_polish(ctx, &t, crossing, 1))
+			<= eps)
+			return ts_int_intersector_append(ctx, t, 0, status);
+		if (fabs(ts_int_intersect_plane_polish(ctx, &t_0, crossing,
+			0)) <= eps)
+			return ts_int_intersector_append(ctx, t_0, 0, status);
+		TS_RETURN_SUCCESS(status)
 	}
-	TS_RETURN_SUCCESS(status)
+	ts_int_bezier_split(dists, deg, 1, tmp, left, right);
+	TS_CALL_ROE(err, ts_int_intersect_plane(ctx, left, t0, (t0 + t1) / 2,
+		depth + 1, status))
+	return ts_int_intersect_plane(ctx, right, (t0 + t1) / 2, t1,
+		depth + 1, status);
 }
 
-tsError ts_bspline_eval(const tsBSpline *spline, tsReal u, tsDeBoorNet *net,
-	tsStatus *status)
+tsError ts_bspline_intersect_plane(const tsBSpline *spline,
+	const tsReal *point, const tsReal *normal, tsReal epsilon,
+	tsReal **knots, size_t *num, tsStatus *status)
 {
+	const size_t dim = ts_bspline_dimension(spline);
+	tsProjector pa = ts_projector_init();
+	struct tsIntersector ctx;
+	tsReal *unit = NULL, *boxes, *dists, len = 0, center, extent;
+	size_t i, node, lo, hi, mid, top, d, order;
+	size_t stack[3 * (TS_INT_PROJECTOR_MAX_DEPTH + 1)];
 	tsError err;
-	ts_int_deboornet_init(net);
+
+	*knots = NULL;
+	*num = 0;
+	ctx.work = ctx.hits = NULL;
+	for (d = 0; d < dim; d++)
+		len += normal[d] * normal[d];
+	if (len <= 0)
+		TS_RETURN_0(status, TS_NO_RESULT, "normal has length 0")
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_int_deboornet_new(
-			spline, net, status))
-		TS_CALL(try, err, ts_int_bspline_eval_woa(
-			spline, u, net, status))
-	TS_CATCH(err)
-		ts_deboornet_free(net);
+		unit = (tsReal *) ts_int_malloc(dim * sizeof(tsReal));
+		if (!unit) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		for (d = 0; d < dim; d++)
+			unit[d] = normal[d] / (tsReal) sqrt(len);
+		TS_CALL(try, err, ts_bspline_projector(spline, &pa, status))
+		TS_CALL(try, err, ts_int_intersector_new(&ctx, &pa, NULL,
+			(tsReal) fabs(epsilon), status))
+		ctx.origin = point;
+		ctx.normal = unit;
+		order = pa.pImpl->deg + 1;
+		boxes = ts_int_projector_access_boxes(&pa);
+		/* Input piece of ts_int_intersect_plane (cf.
+		 * ts_int_intersector_new). */
+		dists = ctx.work + (TS_INT_INTERSECT_MAX_DEPTH * 2 + 1) *
+			ctx.len_piece;
+
+		stack[0] = stack[1] = 0;
+		stack[2] = pa.pImpl->n_segs;
+		top = 1;
+		while (top > 0) {
+			top--;
+			node = stack[top * 3];
+			lo = stack[top * 3 + 1];
+			hi = stack[top * 3 + 2];
+			/* Signed distance of the center of the box and the
+			 * extent of the box along the normal. */
+			center = extent = 0;
+			for (d = 0; d < dim; d++) {
+				center += ((boxes[node*2*dim + d] +
+					boxes[node*2*dim + dim + d]) / 2 -
+					point[d]) * unit[d];
+				extent += (boxes[node*2*dim + dim + d] -
+					boxes[node*2*dim + d]) / 2 *
+					(tsReal) fabs(unit[d]);
+			}
+			if (fabs(center) > extent + ctx.eps)
+				continue;
+			if (hi - lo == 1) {
+				ctx.seg_a = lo;
+				ts_int_plane_distances(&ctx,
+					ts_int_projector_access_ctrlp(&pa) +
+					lo * order * dim, order, dists);
+				TS_CALL(try, err, ts_int_intersect_plane(
+					&ctx, dists, 0, 1, 0, status))
+				continue;
+			}
+			mid = lo + (hi - lo) / 2;
+			stack[top * 3] = node + 2 * (mid - lo);
+			stack[top * 3 + 1] = mid;
+			stack[top * 3 + 2] = hi;
+			top++;
+			stack[top * 3] = node + 1;
+			stack[top * 3 + 1] = lo;
+			stack[top * 3 + 2] = mid;
+			top++;
+		}
+		/* Only the first knot of each hit is relevant. */
+		ts_int_intersector_unique(&ctx);
+		for (i = 0; i < ctx.n_hits; i++)
+			ctx.hits[i] = ctx.hits[i * 2];
+		ts_int_intersector_result(&ctx, knots, num);
+	TS_FINALLY
+		ts_projector_free(&pa);
+		ts_int_intersector_free(&ctx);
+		if (unit)
+			ts_int_free(unit);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_eval_all(const tsBSpline *spline, const tsReal *us,
-	size_t num, tsReal **points, tsStatus *status)
+tsError ts_bspline_intersect_ray(const tsBSpline *spline,
+	const tsReal *origin, const tsReal *direction, tsReal epsilon,
+	tsReal **knots, size_t *num, tsStatus *status)
 {
 	const size_t dim = ts_bspline_dimension(spline);
-	const size_t sof_point = dim * sizeof(tsReal);
-	const size_t sof_points = num * sof_point;
-	tsDeBoorNet net = ts_deboornet_init();
-	tsReal *result;
-	size_t i;
+	const tsReal eps = (tsReal) fabs(epsilon);
+	tsBSpline ray = ts_bspline_init();
+	tsReal *ctrlp = NULL, *box = NULL, *segment, ray_knots[4];
+	tsReal len = 0, t_min = 0, t_max = 0, t1, t2;
+	int inside = 1, bounded = 0;
+	size_t d;
 	tsError err;
+
+	*knots = NULL;
+	*num = 0;
+	for (d = 0; d < dim; d++)
+		len += direction[d] * direction[d];
+	if (len <= 0)
+		TS_RETURN_0(status, TS_NO_RESULT, "direction has length 0")
 	TS_TRY(try, err, status)
-		*points = (tsReal *) malloc(sof_points);
-		if (!*points) {
+		/* Clip the ray to the bounding box of the control points of
+		 * the spline (slab method), which yields a line segment. */
+		TS_CALL(try, err, ts_bspline_control_points(
+			spline, &ctrlp, status))
+		box = (tsReal *) ts_int_malloc(4 * dim * sizeof(tsReal));
+		if (!box) {
 			TS_THROW_0(try, err, status, TS_MALLOC,
 				"out of memory")
 		}
-		TS_CALL(try, err, ts_int_deboornet_new(
-			spline,&net, status))
-		for (i = 0; i < num; i++) {
-			TS_CALL(try, err, ts_int_bspline_eval_woa(
-				spline, us[i], &net, status))
-			result = ts_int_deboornet_access_result(&net);
-			memcpy((*points) + i * dim, result, sof_point);
+		ts_int_bounding_box(ctrlp, ts_bspline_num_control_points(
+			spline), dim, box);
+		for (d = 0; d < dim && inside; d++) {
+			if (fabs(direction[d]) <= 0) {
+				inside = origin[d] >= box[d] - eps &&
+					origin[d] <= box[dim + d] + eps;
+				continue;
+			}
+			t1 = (box[d] - eps - origin[d]) / direction[d];
+			t2 = (box[dim + d] + eps - origin[d]) / direction[d];
+			if (t1 > t2) {
+				len = t1; t1 = t2; t2 = len;
+			}
+			t_min = t1 > t_min ? t1 : t_min;
+			t_max = !bounded || t2 < t_max ? t2 : t_max;
+			bounded = 1;
+			inside = t_min <= t_max;
+		}
+		/* The ray touches a corner of the box. */
+		if (inside && !(t_max > t_min))
+			t_max = t_min + 1;
+		if (inside) {
+			TS_CALL(try, err, ts_bspline_new(2, dim, 1,
+				TS_CLAMPED, &ray, status))
+			segment = box + 2 * dim;
+			for (d = 0; d < dim; d++) {
+				segment[d] = origin[d] + t_min * direction[d];
+				segment[dim + d] = origin[d] +
+					t_max * direction[d];
+			}
+			TS_CALL(try, err, ts_bspline_set_control_points(
+				&ray, segment, status))
+			ray_knots[0] = ray_knots[1] = t_min;
+			ray_knots[2] = ray_knots[3] = t_max;
+			TS_CALL(try, err, ts_bspline_set_knots(
+				&ray, ray_knots, status))
+			TS_CALL(try, err, ts_bspline_intersect_curves(
+				spline, &ray, eps, knots, num, status))
 		}
-	TS_CATCH(err)
-		if (*points)
-			free(*points);
-		*points = NULL;
 	TS_FINALLY
-		ts_deboornet_free(&net);
+		ts_bspline_free(&ray);
+		if (ctrlp)
+			free(ctrlp);
+		if (box)
+			ts_int_free(box);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_sample(const tsBSpline *spline, size_t num, tsReal **points,
-	size_t *actual_num, tsStatus *status)
+/* Bounding box (along the first dimension) of a spline passed to
+ * ts_bspline_intersect_all. */
+struct tsIntersectAllEntry
+{
+	tsReal min;
+	size_t index;
+};
+
+int ts_int_intersect_all_cmp(const void *x, const void *y)
+{
+	const struct tsIntersectAllEntry *a =
+		(const struct tsIntersectAllEntry *) x;
+	const struct tsIntersectAllEntry *b =
+		(const struct tsIntersectAllEntry *) y;
+	if (a->min < b->min) return -1;
+	if (a->min > b->min) return 1;
+	return a->index < b->index ? -1 : (a->index > b->index ? 1 : 0);
+}
+
+tsError ts_bspline_intersect_all(const tsBSpline *splines, size_t num,
+	tsReal epsilon, size_t **indices, tsReal **knots, size_t *num_hits,
+	tsStatus *status)
 {
+	const size_t dim = num > 0 ? ts_bspline_dimension(splines) : 0;
+	const tsReal eps = (tsReal) fabs(epsilon);
+	tsProjector *projectors = NULL;
+	struct tsIntersectAllEntry *entries = NULL;
+	struct tsIntersector ctx;
+	size_t *idx = NULL, *tmp_idx, cap = 0, n = 0, i, j, k, a, b;
+	tsReal *kts = NULL, *tmp_kts, *box_a, *box_b;
 	tsError err;
-	tsReal *knots;
-	tsReal min, max;
-	size_t i;
-	if (num == 0)
-		num = (ts_bspline_num_control_points(spline) -
-			ts_bspline_degree(spline)) * 30;
-	*actual_num = num;
-	knots = (tsReal *) malloc(num * sizeof(tsReal));
-	if (!knots) {
-		*points = NULL;
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
-	}
-	ts_bspline_domain(spline, &min, &max);
-	for (i = 0; i < num; i++) {
-		knots[i] = max - min;
-		knots[i] *= (tsReal)i / (num - 1);
-		knots[i] += min;
+
+	*indices = NULL;
+	*knots = NULL;
+	*num_hits = 0;
+	ctx.work = ctx.hits = NULL;
+	for (i = 1; i < num; i++) {
+		if (ts_bspline_dimension(splines + i) != dim) {
+			TS_RETURN_3(status, TS_INCOMPATIBLE,
+				"dimension of spline %lu (%lu) != "
+				"dimension of spline 0 (%lu)",
+				(unsigned long) i,
+				(unsigned long) ts_bspline_dimension(
+					splines + i),
+				(unsigned long) dim)
+		}
 	}
-	/* Set knots[0] after knots[num - 1] to ensure that
-	 * knots[0] = min if num == 1. */
-	knots[num - 1] = max;
-	knots[0] = min;
+	if (num < 2)
+		TS_RETURN_SUCCESS(status)
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_eval_all(
-			spline, knots, num, points, status))
+		projectors = (tsProjector *) ts_int_malloc(num *
+			sizeof(tsProjector));
+		if (projectors) {
+			for (i = 0; i < num; i++)
+				projectors[i] = ts_projector_init();
+		}
+		entries = (struct tsIntersectAllEntry *) ts_int_malloc(num *
+			sizeof(struct tsIntersectAllEntry));
+		if (!projectors || !entries) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		for (i = 0; i < num; i++) {
+			TS_CALL(try, err, ts_bspline_projector(splines + i,
+				projectors + i, status))
+			entries[i].min = ts_int_projector_access_boxes(
+				projectors + i)[0];
+			entries[i].index = i;
+		}
+
+		/* Sweep and prune along the first dimension. */
+		qsort(entries, num, sizeof(struct tsIntersectAllEntry),
+			ts_int_intersect_all_cmp);
+		for (i = 0; i < num; i++) {
+			box_a = ts_int_projector_access_boxes(
+				projectors + entries[i].index);
+			for (j = i + 1; j < num; j++) {
+				if (entries[j].min > box_a[dim] + eps)
+					break;
+				box_b = ts_int_projector_access_boxes(
+					projectors + entries[j].index);
+				if (!ts_int_boxes_overlap(box_a, box_b, dim,
+					eps))
+					continue;
+				a = entries[i].index < entries[j].index ?
+					entries[i].index : entries[j].index;
+				b = entries[i].index < entries[j].index ?
+					entries[j].index : entries[i].index;
+				TS_CALL(try, err, ts_int_intersector_new(&ctx,
+					projectors + a, projectors + b, eps,
+					status))
+				TS_CALL(try, err, ts_int_intersect_projectors(
+					&ctx, status))
+				ts_int_intersector_unique(&ctx);
+				if (n + ctx.n_hits > cap) {
+					cap = 2 * (n + ctx.n_hits);
+					tmp_idx = (size_t *) realloc(idx,
+						2 * cap * sizeof(size_t));
+					if (tmp_idx)
+						idx = tmp_idx;
+					tmp_kts = (tsReal *) realloc(kts,
+						2 * cap * sizeof(tsReal));
+					if (tmp_kts)
+						kts = tmp_kts;
+					if (!tmp_idx || !tmp_kts) {
+						TS_THROW_0(try, err, status,
+							TS_MALLOC,
+							"out of memory")
+					}
+				}
+				for (k = 0; k < ctx.n_hits; k++, n++) {
+					idx[n * 2] = a;
+					idx[n * 2 + 1] = b;
+					kts[n * 2] = ctx.hits[k * 2];
+					kts[n * 2 + 1] = ctx.hits[k * 2 + 1];
+				}
+				ts_int_intersector_free(&ctx);
+			}
+		}
+		if (n > 0) {
+			*indices = idx;
+			*knots = kts;
+			*num_hits = n;
+			idx = NULL;
+			kts = NULL;
+		}
 	TS_FINALLY
-		free(knots);
+		if (projectors) {
+			for (i = 0; i < num; i++)
+				ts_projector_free(projectors + i);
+			ts_int_free(projectors);
+		}
+		if (entries)
+			ts_int_free(entries);
+		if (idx)
+			free(idx);
+		if (kts)
+			free(kts);
+		ts_int_intersector_free(&ctx);
 	TS_END_TRY_RETURN(err)
 }
 
@@ -1374,44 +6996,52 @@ void ts_bspline_domain(const tsBSpline *spline, tsReal *min, tsReal *max)
 		[ts_bspline_num_knots(spline) - ts_bspline_order(spline)];
 }
 
+void ts_bsplinesurface_domain(const tsBSplineSurface *surface,
+	tsReal *min_u, tsReal *max_u, tsReal *min_v, tsReal *max_v)
+{
+	const struct tsBSplineSurfaceImpl *impl = surface->pImpl;
+	*min_u = ts_int_bsplinesurface_access_knots_u(surface)[impl->deg_u];
+	*max_u = ts_int_bsplinesurface_access_knots_u(surface)
+		[impl->n_ctrlp_u];
+	*min_v = ts_int_bsplinesurface_access_knots_v(surface)[impl->deg_v];
+	*max_v = ts_int_bsplinesurface_access_knots_v(surface)
+		[impl->n_ctrlp_v];
+}
+
 tsError ts_bspline_is_closed(const tsBSpline *spline, tsReal epsilon,
 	int *closed, tsStatus *status)
 {
 	const size_t deg = ts_bspline_degree(spline);
 	const size_t dim = ts_bspline_dimension(spline);
-	tsBSpline derivative;
-	tsReal min, max;
-	tsDeBoorNet first, last;
+	const size_t n = deg > 0 ? deg - 1 : 0;
+	const size_t len_points = (n + 1) * dim;
+	tsReal *points = NULL;
+	tsReal us[2];
 	size_t i;
 	tsError err;
 
-	ts_int_bspline_init(&derivative);
-	ts_int_deboornet_init(&first);
-	ts_int_deboornet_init(&last);
-
+	*closed = 0;
 	TS_TRY(try, err, status)
-		for (i = 0; i < deg; i++) {
-			TS_CALL(try, err, ts_bspline_derive(
-				spline, i, -1.f, &derivative, status))
-			ts_bspline_domain(&derivative, &min, &max);
-			TS_CALL(try, err, ts_bspline_eval(
-				&derivative, min, &first, status))
-			TS_CALL(try, err, ts_bspline_eval(
-				&derivative, max, &last, status))
-			*closed = ts_distance(
-				ts_int_deboornet_access_result(&first),
-				ts_int_deboornet_access_result(&last),
+		/* The derivatives at both ends are evaluated in a single
+		 * pass each (cf. ts_bspline_eval_derivatives). */
+		points = (tsReal *) ts_int_malloc(
+			2 * len_points * sizeof(tsReal));
+		if (!points) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		ts_bspline_domain(spline, &us[0], &us[1]);
+		TS_CALL(try, err, ts_bspline_eval_derivatives_batch(
+			spline, us, 2, n, points, NULL, status))
+		*closed = 1;
+		for (i = 0; i <= n && *closed; i++) {
+			*closed = ts_distance(points + i * dim,
+				points + len_points + i * dim,
 				dim) <= epsilon ? 1 : 0;
-			ts_bspline_free(&derivative);
-			ts_deboornet_free(&first);
-			ts_deboornet_free(&last);
-			if (!*closed)
-				TS_RETURN_SUCCESS(status)
 		}
 	TS_FINALLY
-		ts_bspline_free(&derivative);
-		ts_deboornet_free(&first);
-		ts_deboornet_free(&last);
+		if (points)
+			ts_int_free(points);
 	TS_END_TRY_RETURN(err)
 }
 
@@ -1451,8 +7081,9 @@ tsError ts_int_bspline_resize(const tsBSpline *spline, int n, int back,
 		return ts_bspline_copy(spline, _resized_, status);
 
 	INIT_OUT_BSPLINE(spline, _resized_)
-	TS_CALL_ROE(err, ts_bspline_new(
-		nnum_ctrlp, dim, deg, TS_OPENED, &tmp, status))
+	TS_CALL_ROE(err, ts_bspline_new_with_allocator(
+		nnum_ctrlp, dim, deg, TS_OPENED, &spline->pImpl->allocator,
+		&tmp, status))
 	to_ctrlp = ts_int_bspline_access_ctrlp(&tmp);
 	to_knots = ts_int_bspline_access_knots(&tmp);
 
@@ -1554,8 +7185,9 @@ tsError ts_bspline_derive(const tsBSpline *spline, size_t n, tsReal epsilon,
 			num_knots -= 2;
 			knots     += 1;
 		}
-		TS_CALL(try, err, ts_bspline_new(
-			num_ctrlp, dim, deg, TS_OPENED, &swap, status))
+		TS_CALL(try, err, ts_bspline_new_with_allocator(
+			num_ctrlp, dim, deg, TS_OPENED,
+			&spline->pImpl->allocator, &swap, status))
 		memcpy(ts_int_bspline_access_ctrlp(&swap), ctrlp,
 			num_ctrlp * sof_ctrlp);
 		memcpy(ts_int_bspline_access_knots(&swap), knots,
@@ -1672,163 +7304,1163 @@ tsError ts_int_bspline_insert_knot(const tsBSpline *spline,
 	 * =>  -(int)(N-n+1) <= -1. */
 	stride = -(int)(N-n+1) * (int)dim;
 
-	for (i = 0; i < n; i++) {                                      /* c) */
-		memcpy(to, from, sof_ctrlp);
-		from += stride;
-		stride -= (int)dim;
-		to += dim;
+	for (i = 0; i < n; i++) {                                      /* c) */
+		memcpy(to, from, sof_ctrlp);
+		from += stride;
+		stride -= (int)dim;
+		to += dim;
+	}
+	/* copy knots */
+	to = knots_result + k+1;
+	for (i = 0; i < n; i++) {                                      /* d) */
+		*to = knot;
+		to++;
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+tsError ts_bspline_insert_knot(const tsBSpline *spline, tsReal u, size_t num,
+	tsBSpline *result, size_t* k, tsStatus *status)
+{
+	tsDeBoorNet net;
+	tsError err;
+	INIT_OUT_BSPLINE(spline, result)
+	ts_int_deboornet_init(&net);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
+		TS_CALL(try, err, ts_int_bspline_insert_knot(
+			spline, &net, num, result, status))
+		ts_deboornet_free(&net);
+		TS_CALL(try, err, ts_bspline_eval(result, u, &net, status))
+		*k = ts_deboornet_index(&net);
+	TS_CATCH(err)
+		*k = 0;
+	TS_FINALLY
+		ts_deboornet_free(&net);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_insert_knots(const tsBSpline *spline, const tsReal *knots,
+	size_t num, tsBSpline *result, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num_ctrlp = ts_bspline_num_control_points(spline);
+	const size_t num_knots = ts_bspline_num_knots(spline);
+	const tsReal *P = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *U = ts_int_bspline_access_knots(spline);
+	const size_t sof_ctrlp = dim * sizeof(tsReal);
+
+	tsReal *X = NULL; /**< The knots to insert (snapped). */
+	tsReal *Q;        /**< The control points of the result. */
+	tsReal *V;        /**< The knots of the result. */
+	size_t a, b;      /**< Spans of the first and last knot to insert. */
+	size_t i, j, k, l, d, mult, ind;
+	tsReal alpha;
+
+	tsBSpline tmp = ts_bspline_init();
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, result)
+	if (num == 0)
+		return ts_bspline_copy(spline, result, status);
+
+	TS_TRY(try, err, status)
+		/* Validate the knots to insert and snap them to the knots of
+		 * spline and to the previous knot to insert (cf.
+		 * ts_int_bspline_eval_woa). */
+		X = (tsReal *) ts_int_malloc(num * sizeof(tsReal));
+		if (!X)
+			TS_THROW_0(try, err, status, TS_MALLOC, "out of memory")
+		for (j = 0, k = deg; j < num; j++) {
+			if (j > 0 && knots[j] < knots[j-1]) {
+				TS_THROW_2(try, err, status, TS_KNOTS_DECR,
+					"knots[%lu] < knots[%lu]",
+					(unsigned long) j,
+					(unsigned long) (j-1))
+			}
+			if ((knots[j] < U[deg] &&
+				!ts_knots_equal(knots[j], U[deg])) ||
+				(knots[j] > U[num_ctrlp] &&
+				!ts_knots_equal(knots[j], U[num_ctrlp]))) {
+				TS_THROW_3(try, err, status, TS_U_UNDEFINED,
+					"knot (%f) not in domain [%f, %f]",
+					knots[j], U[deg], U[num_ctrlp])
+			}
+			/* The knots are sorted, so the search for the knot
+			 * that is closest from below continues at k. */
+			while (k < num_ctrlp && U[k+1] <= knots[j])
+				k++;
+			if (ts_knots_equal(knots[j], U[k]))
+				X[j] = U[k];
+			else if (k + 1 < num_knots &&
+				ts_knots_equal(knots[j], U[k+1]))
+				X[j] = U[k+1];
+			else if (j > 0 && ts_knots_equal(knots[j], X[j-1]))
+				X[j] = X[j-1];
+			else
+				X[j] = knots[j];
+			X[j] = X[j] < U[deg] ? U[deg] :
+				(X[j] > U[num_ctrlp] ? U[num_ctrlp] : X[j]);
+		}
+		/* Check the multiplicities of the result. */
+		for (j = 0, i = 0; j < num; j = k) {
+			k = j + 1;
+			while (k < num && !(X[k] > X[j]))
+				k++;
+			while (i < num_knots && U[i] < X[j])
+				i++;
+			mult = 0;
+			while (i + mult < num_knots && !(U[i + mult] > X[j]))
+				mult++;
+			if (mult + (k - j) > order) {
+				TS_THROW_4(try, err, status, TS_MULTIPLICITY,
+					"multiplicity(%f) (%lu) + %lu > order "
+					"(%lu)", X[j], (unsigned long) mult,
+					(unsigned long) (k - j),
+					(unsigned long) order)
+			}
+		}
+
+		TS_CALL(try, err, ts_bspline_new_with_allocator(
+			num_ctrlp + num, dim, deg, TS_OPENED,
+			&spline->pImpl->allocator, &tmp, status))
+		Q = ts_int_bspline_access_ctrlp(&tmp);
+		V = ts_int_bspline_access_knots(&tmp);
+
+		/* Knot refinement (cf. The NURBS Book, Algorithm A5.4). a and
+		 * b are the spans of the first and last knot to insert such
+		 * that U[a] <= X[0] < U[a+1] and U[b-1] <= X[num-1] < U[b]
+		 * (or the last span if X[num-1] is the maximum of the
+		 * domain). */
+		a = deg;
+		while (a < num_ctrlp - 1 && U[a+1] <= X[0])
+			a++;
+		b = a;
+		while (b < num_ctrlp - 1 && U[b+1] <= X[num-1])
+			b++;
+		b++;
+		memcpy(Q, P, (a - deg + 1) * sof_ctrlp);
+		memcpy(Q + (b - 1 + num) * dim, P + (b - 1) * dim,
+			(num_ctrlp - b + 1) * sof_ctrlp);
+		memcpy(V, U, (a + 1) * sizeof(tsReal));
+		memcpy(V + b + deg + num, U + b + deg,
+			(num_knots - b - deg) * sizeof(tsReal));
+		i = b + deg - 1;
+		k = b + deg + num - 1;
+		for (j = num; j-- > 0;) {
+			while (X[j] <= U[i] && i > a) {
+				memcpy(Q + (k - order) * dim,
+					P + (i - order) * dim, sof_ctrlp);
+				V[k] = U[i];
+				k--;
+				i--;
+			}
+			memcpy(Q + (k - order) * dim, Q + (k - deg) * dim,
+				sof_ctrlp);
+			for (l = 1; l <= deg; l++) {
+				ind = k - deg + l;
+				alpha = V[k + l] - X[j];
+				if (fabs(alpha) > 0) {
+					alpha /= V[k + l] - U[i - deg + l];
+					for (d = 0; d < dim; d++) {
+						Q[(ind-1)*dim + d] = alpha *
+							Q[(ind-1)*dim + d] +
+							(1 - alpha) *
+							Q[ind*dim + d];
+					}
+				} else {
+					memcpy(Q + (ind - 1) * dim,
+						Q + ind * dim, sof_ctrlp);
+				}
+			}
+			V[k] = X[j];
+			k--;
+		}
+
+		if (spline == result)
+			ts_bspline_free(result);
+		ts_bspline_move(&tmp, result);
+	TS_FINALLY
+		ts_bspline_free(&tmp);
+		if (X)
+			ts_int_free(X);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_split(const tsBSpline *spline, tsReal u, tsBSpline *split,
+	size_t* k, tsStatus *status)
+{
+	tsDeBoorNet net;
+	tsError err;
+	INIT_OUT_BSPLINE(spline, split)
+	ts_int_deboornet_init(&net);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
+		if (ts_deboornet_multiplicity(&net)
+				== ts_bspline_order(spline)) {
+			TS_CALL(try, err, ts_bspline_copy(
+				spline, split, status))
+			*k = ts_deboornet_index(&net);
+		} else {
+			TS_CALL(try, err, ts_int_bspline_insert_knot(
+				spline, &net,
+				ts_deboornet_num_insertions(&net) + 1, split,
+				status))
+			*k = ts_deboornet_index(&net) +
+				ts_deboornet_num_insertions(&net) + 1;
+		}
+	TS_CATCH(err)
+		*k = 0;
+	TS_FINALLY
+		ts_deboornet_free(&net);
+	TS_END_TRY_RETURN(err)
+}
+
+tsError ts_bspline_tension(const tsBSpline *spline, tsReal tension,
+	tsBSpline *out, tsStatus *status)
+{
+	const tsReal s  = 1.f - tension; /**< The straightening factor. */
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t N = ts_bspline_num_control_points(spline);
+	const tsReal* p0 = ts_int_bspline_access_ctrlp(spline);
+	const tsReal* pn_1 = p0 + (N-1)*dim;
+
+	tsReal *ctrlp; /**< Pointer to the control points of \p out. */
+	size_t i, d; /**< Used in for loops. */
+	tsError err;
+
+	TS_CALL_ROE(err, ts_bspline_copy(spline, out, status))
+	ctrlp = ts_int_bspline_access_ctrlp(out);
+
+	for (i = 0; i < N; i++) {
+		for (d = 0; d < dim; d++) {
+			ctrlp[i*dim + d] *= tension;
+			ctrlp[i*dim + d] += s * (p0[d] + ((tsReal)i / (N-1)) *
+				(pn_1[d] - p0[d]));
+		}
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Converts the control points \p ctrlp (order * dim values) of the span
+ * [t[deg-1], t[deg]) with the local knots \p t (2 * deg values) into the
+ * control points of the Bezier curve of the span. The left and right knots
+ * of the span are inserted until they have multiplicity deg (Boehm's
+ * algorithm applied to the local knots only), which requires O(deg^2)
+ * operations. */
+void ts_int_span_to_bezier(const tsReal *t, size_t deg, size_t dim,
+	tsReal *ctrlp)
+{
+	const tsReal a = t[deg-1];
+	const tsReal b = t[deg];
+	tsReal alpha;
+	size_t r, i, d;
+	/* Left knot. */
+	for (r = 1; r < deg; r++) {
+		for (i = 0; i + r < deg; i++) {
+			alpha = (a - t[i+r-1]) / (t[i+deg] - t[i+r-1]);
+			for (d = 0; d < dim; d++) {
+				ctrlp[i*dim + d] += alpha *
+					(ctrlp[(i+1)*dim + d] -
+					 ctrlp[i*dim + d]);
+			}
+		}
+	}
+	/* Right knot. */
+	for (r = 1; r < deg; r++) {
+		for (i = deg; i > r; i--) {
+			alpha = (t[deg+i-r] - b) / (t[deg+i-r] - a);
+			for (d = 0; d < dim; d++) {
+				ctrlp[i*dim + d] += alpha *
+					(ctrlp[(i-1)*dim + d] -
+					 ctrlp[i*dim + d]);
+			}
+		}
+	}
+}
+
+tsError ts_bspline_to_beziers(const tsBSpline *spline, tsBSpline *beziers,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t num_ctrlp = ts_bspline_num_control_points(spline);
+	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
+	const tsReal *knots = ts_int_bspline_access_knots(spline);
+
+	size_t n_segs = 0; /**< Number of Bezier segments. */
+	size_t k;          /**< Index of the current span. */
+	size_t s, i;       /**< Used in for loops. */
+
+	tsBSpline tmp;         /**< Temporarily stores the result. */
+	tsReal *ctrlp_beziers; /**< Pointer to the control points of tmp. */
+	tsReal *knots_beziers; /**< Pointer to the knots of tmp. */
+
+	tsError err;
+
+	INIT_OUT_BSPLINE(spline, beziers)
+	/* Each span of the domain [knots[deg], knots[num_ctrlp]] that is
+	 * not empty yields a segment. Spans that are shorter than
+	 * TS_KNOT_EPSILON are considered empty. */
+	for (k = deg; k < num_ctrlp; k++) {
+		if (!ts_knots_equal(knots[k], knots[k+1]))
+			n_segs++;
+	}
+	if (n_segs == 0) {
+		TS_RETURN_1(status, TS_U_UNDEFINED,
+			"spline has an empty domain (%f)", knots[deg])
+	}
+	TS_CALL_ROE(err, ts_bspline_new_with_allocator(
+		n_segs * order, dim, deg, TS_BEZIERS,
+		&spline->pImpl->allocator, &tmp, status))
+	ctrlp_beziers = ts_int_bspline_access_ctrlp(&tmp);
+	knots_beziers = ts_int_bspline_access_knots(&tmp);
+
+	/* Convert the spans in place within the output. */
+	for (k = deg, s = 0; k < num_ctrlp; k++) {
+		if (ts_knots_equal(knots[k], knots[k+1]))
+			continue;
+		memcpy(ctrlp_beziers + s * order * dim,
+			ctrlp + (k-deg) * dim, order * dim * sizeof(tsReal));
+		if (deg > 0) {
+			ts_int_span_to_bezier(knots + k-deg+1, deg, dim,
+				ctrlp_beziers + s * order * dim);
+		}
+		for (i = 0; i < order; i++)
+			knots_beziers[s * order + i] = knots[k];
+		s++;
+	}
+	for (i = 0; i < order; i++)
+		knots_beziers[n_segs * order + i] = knots[num_ctrlp];
+
+	if (spline == beziers)
+		ts_bspline_free(beziers);
+	ts_bspline_move(&tmp, beziers);
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns the binomial coefficient of \p n and \p k. */
+tsReal ts_int_binomial(size_t n, size_t k)
+{
+	tsReal binom = 1;
+	size_t i;
+	for (i = 1; i <= k; i++)
+		binom = binom * (n - k + i) / i;
+	return binom;
+}
+
+/* Elevates the degree of the Bezier curve \p ctrlp (deg + 1 points of
+ * dimension \p dim) by \p t and stores the deg + t + 1 control points of the
+ * elevated curve in \p elevated (cf. 'The NURBS Book', Eq. 5.36). */
+void ts_int_bezier_elevate(const tsReal *ctrlp, size_t deg, size_t dim,
+	size_t t, tsReal *elevated)
+{
+	tsReal coeff;
+	size_t i, j, d, lo, hi;
+	for (i = 0; i <= deg + t; i++) {
+		for (d = 0; d < dim; d++)
+			elevated[i*dim + d] = 0;
+		lo = i > t ? i - t : 0;
+		hi = i < deg ? i : deg;
+		for (j = lo; j <= hi; j++) {
+			coeff = ts_int_binomial(deg, j) *
+				ts_int_binomial(t, i-j) /
+				ts_int_binomial(deg + t, i);
+			for (d = 0; d < dim; d++)
+				elevated[i*dim + d] += coeff * ctrlp[j*dim + d];
+		}
+	}
+}
+
+/* Reduces the degree of the Bezier curve \p ctrlp (deg + 1 points of
+ * dimension \p dim, deg > 0) by one and stores the deg control points of the
+ * reduced curve in \p reduced. The first half of the control points is
+ * calculated from the left and the second half from the right (cf. 'The
+ * NURBS Book', Eqs. 5.41-5.45), i.e., the end points are preserved unless
+ * deg == 1. */
+void ts_int_bezier_reduce(const tsReal *ctrlp, size_t deg, size_t dim,
+	tsReal *reduced)
+{
+	const size_t r = (deg - 1) / 2;
+	tsReal alpha, right;
+	size_t i, d;
+
+	for (d = 0; d < dim; d++)
+		reduced[d] = ctrlp[d];
+	for (i = 1; i <= r; i++) {
+		alpha = (tsReal) i / deg;
+		for (d = 0; d < dim; d++) {
+			reduced[i*dim + d] = (ctrlp[i*dim + d] -
+				alpha * reduced[(i-1)*dim + d]) / (1 - alpha);
+		}
+	}
+	if (deg - 1 > r) {
+		for (d = 0; d < dim; d++)
+			reduced[(deg-1)*dim + d] = ctrlp[deg*dim + d];
+	}
+	for (i = deg - 1; i-- > r + 1;) {
+		alpha = (tsReal) (i + 1) / deg;
+		for (d = 0; d < dim; d++) {
+			reduced[i*dim + d] = (ctrlp[(i+1)*dim + d] -
+				(1 - alpha) * reduced[(i+1)*dim + d]) / alpha;
+		}
+	}
+	if (deg % 2 == 1) {
+		/* The middle control point is the mean of its left and right
+		 * solution. */
+		alpha = (tsReal) (r + 1) / deg;
+		for (d = 0; d < dim; d++) {
+			right = r == deg - 1 ? ctrlp[deg*dim + d] :
+				(ctrlp[(r+1)*dim + d] - (1 - alpha) *
+				reduced[(r+1)*dim + d]) / alpha;
+			reduced[r*dim + d] = (reduced[r*dim + d] + right) / 2;
+		}
+	}
+}
+
+struct tsBSplineDegreeTask
+{
+	const tsReal *from;  /**< The Bezier segments of degree deg. */
+	tsReal *to;          /**< The Bezier segments of degree target. */
+	size_t deg;
+	size_t target;
+	size_t dim;
+	size_t n_segs;
+	tsReal *scratch;     /**< 3 * (deg + 1) * dim values per block. */
+	tsReal *errors;      /**< One error bound per block. */
+};
+
+/* Elevates or reduces the Bezier segments of block \p index (cf.
+ * TS_INT_DEGREE_SEGMENTS). The error bound of a reduced segment is the
+ * maximum distance between its control points, elevated back to the original
+ * degree, and the original control points (convex hull property). */
+void ts_int_bspline_degree_task(void *args, size_t index)
+{
+	struct tsBSplineDegreeTask *task = (struct tsBSplineDegreeTask *) args;
+	const size_t dim = task->dim;
+	const size_t order = task->deg + 1;
+	const size_t t_order = task->target + 1;
+	const size_t begin = index * TS_INT_DEGREE_SEGMENTS;
+	const size_t end = begin + TS_INT_DEGREE_SEGMENTS < task->n_segs ?
+		begin + TS_INT_DEGREE_SEGMENTS : task->n_segs;
+	const tsReal *from;
+	tsReal *to, *a, *b, *c, *swap, dist, error = 0;
+	size_t i, deg;
+
+	for (i = begin; i < end; i++) {
+		from = task->from + i * order * dim;
+		to = task->to + i * t_order * dim;
+		if (task->target >= task->deg) {
+			ts_int_bezier_elevate(from, task->deg, dim,
+				task->target - task->deg, to);
+			continue;
+		}
+		a = task->scratch + index * 3 * order * dim;
+		b = a + order * dim;
+		c = b + order * dim;
+		memcpy(a, from, order * dim * sizeof(tsReal));
+		for (deg = task->deg; deg > task->target; deg--) {
+			ts_int_bezier_reduce(a, deg, dim, b);
+			swap = a;
+			a = b;
+			b = swap;
+		}
+		memcpy(to, a, t_order * dim * sizeof(tsReal));
+		ts_int_bezier_elevate(a, task->target, dim,
+			task->deg - task->target, c);
+		for (deg = 0; deg < order; deg++) {
+			dist = ts_distance(from + deg * dim, c + deg * dim,
+				dim);
+			if (dist > error)
+				error = dist;
+		}
+	}
+	task->errors[index] = error;
+}
+
+/* Removes the knot at index \p r, which is the last index of a knot with
+ * multiplicity \p s, as often as possible (at most \p num <= \p s times) from
+ * the knot vector \p knots and the control points \p ctrlp of a spline of
+ * degree \p deg and dimension \p dim (cf. 'The NURBS Book', algorithm A5.8).
+ * Only the first \p n_knots knots and \p n_ctrlp control points are accessed
+ * and shifted, which must include the knots up to index r + deg and the
+ * control points up to index r. The error bound of each removal is
+ * subtracted from \p budget, which must not become negative. If \p budget is
+ * NULL, the removals are known to be exact and the error bounds are not
+ * checked. \p temp must provide space for 2 * (deg + 1) * dim values.
+ * Returns the number of removals, i.e., the number by which both prefixes
+ * shrink. */
+size_t ts_int_knots_remove(tsReal *knots, size_t n_knots, tsReal *ctrlp,
+	size_t n_ctrlp, size_t deg, size_t dim, size_t r, size_t s,
+	size_t num, tsReal *budget, tsReal *temp)
+{
+	const size_t order = deg + 1;
+	const size_t sof_p = dim * sizeof(tsReal);
+	const tsReal u = knots[r];
+	size_t first = r - deg, last = r - s, off, i, j, ii, jj, t, k, d;
+	tsReal alfi, alfj, diff, dist;
+
+	for (t = 0; t < num; t++) {
+		off = first - 1;
+		memcpy(temp, ctrlp + off * dim, sof_p);
+		memcpy(temp + (last + 1 - off) * dim,
+			ctrlp + (last + 1) * dim, sof_p);
+		i = first;
+		j = last;
+		ii = 1;
+		jj = last - off;
+		while (j > i + t) {
+			alfi = (u - knots[i]) / (knots[i+order+t] - knots[i]);
+			alfj = (u - knots[j-t]) / (knots[j+order] - knots[j-t]);
+			for (d = 0; d < dim; d++) {
+				temp[ii*dim + d] = (ctrlp[i*dim + d] -
+					(1 - alfi) * temp[(ii-1)*dim + d]) /
+					alfi;
+				temp[jj*dim + d] = (ctrlp[j*dim + d] -
+					alfj * temp[(jj+1)*dim + d]) /
+					(1 - alfj);
+			}
+			i++; ii++;
+			j--; jj--;
+		}
+		if (budget) {
+			if (j < i + t) {
+				dist = ts_distance(temp + (ii-1) * dim,
+					temp + (jj+1) * dim, dim);
+			} else {
+				alfi = (u - knots[i]) /
+					(knots[i+order+t] - knots[i]);
+				dist = 0;
+				for (d = 0; d < dim; d++) {
+					diff = ctrlp[i*dim + d] - (alfi *
+						temp[(ii+t+1)*dim + d] +
+						(1 - alfi) *
+						temp[(ii-1)*dim + d]);
+					dist += diff * diff;
+				}
+				dist = (tsReal) sqrt((double) dist);
+			}
+			if (dist > *budget)
+				break;
+			*budget -= dist;
+		}
+
+		/* Save the new control points. */
+		i = first;
+		j = last;
+		while (j > i + t) {
+			memcpy(ctrlp + i * dim, temp + (i - off) * dim, sof_p);
+			memcpy(ctrlp + j * dim, temp + (j - off) * dim, sof_p);
+			i++;
+			j--;
+		}
+		first--;
+		last++;
+	}
+	if (t == 0)
+		return 0;
+
+	for (k = r + 1; k < n_knots; k++)
+		knots[k - t] = knots[k];
+	/* The control points [j, i] are overwritten. */
+	j = i = (2 * r - s - deg) / 2;
+	for (k = 1; k < t; k++) {
+		if (k % 2 == 1)
+			i++;
+		else
+			j--;
+	}
+	for (k = i + 1; k < n_ctrlp; k++, j++)
+		memcpy(ctrlp + j * dim, ctrlp + k * dim, sof_p);
+	return t;
+}
+
+/* Visits each distinct inner knot of the knot vector \p knots (\p n_knots
+ * values) of a spline of degree \p deg and dimension \p dim with control
+ * points \p ctrlp (\p n_ctrlp points) once from left to right and removes it
+ * with ts_int_knots_remove. If \p num is not NULL, the i-th distinct inner
+ * knot is removed at most num[i] times, otherwise as often as possible.
+ * \p budget is passed to ts_int_knots_remove. The control points and knots
+ * are compacted from left to right: the first wc control points and wk knots
+ * are processed, the remaining ones follow after a gap (the number of
+ * removals so far). Since a removal affects only the control points and
+ * knots close to the removed knot, the prefixes are extended just as far as
+ * needed and no element is moved more than twice. Knots whose multiplicity
+ * exceeds deg + 1 (rejected by ts_int_knots_check) are skipped. \p temp must
+ * provide space for 2 * (deg + 1) * dim values. Returns the number of
+ * removals. */
+size_t ts_int_knots_simplify(tsReal *knots, size_t n_knots, tsReal *ctrlp,
+	size_t n_ctrlp, size_t deg, size_t dim, const size_t *num,
+	tsReal *budget, tsReal *temp)
+{
+	const size_t order = deg + 1;
+	const tsReal min = knots[deg];
+	const tsReal max = knots[n_ctrlp];
+	size_t k, r, s, t, wc = 0, wk = 0, gap = 0, need_c, need_k;
+
+	k = order;
+	while (k < n_ctrlp) {
+		need_c = k + order < n_ctrlp ? k + order : n_ctrlp;
+		need_k = k + 2 * order < n_knots ? k + 2 * order : n_knots;
+		for (; gap > 0 && wc < need_c; wc++) {
+			memcpy(ctrlp + wc * dim, ctrlp + (wc + gap) * dim,
+				dim * sizeof(tsReal));
+		}
+		for (; gap > 0 && wk < need_k; wk++)
+			knots[wk] = knots[wk + gap];
+		if (wc < need_c)
+			wc = need_c;
+		if (wk < need_k)
+			wk = need_k;
+		if (ts_knots_equal(knots[k], max))
+			break;
+		for (s = 1; k + s < wk &&
+			ts_knots_equal(knots[k], knots[k + s]); s++);
+		r = k + s - 1;
+		if (ts_knots_equal(knots[k], min)) {
+			k = r + 1;
+			continue;
+		}
+		if (s > order) {
+			/* Would overrun temp (see above). */
+			if (num)
+				num++;
+			k = r + 1;
+			continue;
+		}
+		t = ts_int_knots_remove(knots, wk, ctrlp, wc, deg, dim, r, s,
+			num ? (*num < s ? *num : s) : s, budget, temp);
+		if (num)
+			num++;
+		wc -= t;
+		wk -= t;
+		gap += t;
+		n_ctrlp -= t;
+		n_knots -= t;
+		k = r - t + 1;
 	}
-	/* copy knots */
-	to = knots_result + k+1;
-	for (i = 0; i < n; i++) {                                      /* d) */
-		*to = knot;
-		to++;
+	for (; gap > 0 && wc < n_ctrlp; wc++) {
+		memcpy(ctrlp + wc * dim, ctrlp + (wc + gap) * dim,
+			dim * sizeof(tsReal));
 	}
-	TS_RETURN_SUCCESS(status)
+	for (; gap > 0 && wk < n_knots; wk++)
+		knots[wk] = knots[wk + gap];
+	return gap;
 }
 
-tsError ts_bspline_insert_knot(const tsBSpline *spline, tsReal u, size_t num,
-	tsBSpline *result, size_t* k, tsStatus *status)
+/* Changes the degree of \p spline to \p target and stores the result in
+ * \p result. \p spline is decomposed into Bezier segments (cf.
+ * ts_bspline_to_beziers), which are elevated or reduced by separate tasks
+ * scheduled by \p executor. Afterwards, the segments are merged again by
+ * removing the knots between them (cf. ts_int_knots_simplify). If the degree
+ * is elevated by t, each inner knot of multiplicity m gets multiplicity
+ * m + t, i.e., the continuity of \p spline is preserved (cf. 'The NURBS
+ * Book', algorithm A5.9). If the degree is reduced, adjacent segments whose
+ * junction points are within TS_CONTROL_POINT_EPSILON are joined. If
+ * \p tolerance is not negative and the error bound of a reduced segment
+ * exceeds \p tolerance, TS_NO_RESULT is returned. */
+tsError ts_int_bspline_change_degree(const tsBSpline *spline, size_t target,
+	tsReal tolerance, const tsExecutor *executor, tsBSpline *result,
+	tsStatus *status)
 {
-	tsDeBoorNet net;
+	struct tsBSplineDegreeTask task;
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t n_knots = ts_bspline_num_knots(spline);
+	const size_t t_order = target + 1;
+	const tsReal *knots, *b_knots;
+	tsExecutor fallback;
+	tsBSpline beziers, tmp;
+	tsReal *buf = NULL, *to_knots, *temp, error = 0;
+	size_t *num = NULL, order, n_segs, n_blocks, n_ctrlp, i, j, m;
 	tsError err;
+
 	INIT_OUT_BSPLINE(spline, result)
-	ts_int_deboornet_init(&net);
+	ts_int_bspline_init(&beziers);
+	ts_int_bspline_init(&tmp);
+	if (!executor) {
+		fallback = ts_executor_default();
+		executor = &fallback;
+	}
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
-		TS_CALL(try, err, ts_int_bspline_insert_knot(
-			spline, &net, num, result, status))
-		ts_deboornet_free(&net);
-		TS_CALL(try, err, ts_bspline_eval(result, u, &net, status))
-		*k = ts_deboornet_index(&net);
+		TS_CALL(try, err, ts_bspline_to_beziers(
+			spline, &beziers, status))
+		order = ts_bspline_order(&beziers);
+		n_segs = ts_bspline_num_control_points(&beziers) / order;
+		n_blocks = (n_segs + TS_INT_DEGREE_SEGMENTS - 1) /
+			TS_INT_DEGREE_SEGMENTS;
+		n_ctrlp = n_segs * t_order;
+		buf = (tsReal *) ts_int_malloc((n_blocks + n_ctrlp * dim +
+			n_ctrlp + t_order + 2 * t_order * dim +
+			(target < order - 1 ? n_blocks * 3 * order * dim : 0))
+			* sizeof(tsReal));
+		num = (size_t *) ts_int_malloc(n_segs * sizeof(size_t));
+		if (!buf || !num) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		task.from = ts_int_bspline_access_ctrlp(&beziers);
+		task.errors = buf;
+		task.to = buf + n_blocks;
+		to_knots = task.to + n_ctrlp * dim;
+		temp = to_knots + n_ctrlp + t_order;
+		task.scratch = temp + 2 * t_order * dim;
+		task.deg = order - 1;
+		task.target = target;
+		task.dim = dim;
+		task.n_segs = n_segs;
+		executor->run(executor->ctx, ts_int_bspline_degree_task,
+			&task, n_blocks);
+		for (i = 0; i < n_blocks; i++) {
+			if (task.errors[i] > error)
+				error = task.errors[i];
+		}
+		if (tolerance >= 0 && error > tolerance) {
+			TS_THROW_2(try, err, status, TS_NO_RESULT,
+				"error bound (%f) > tolerance (%f)",
+				error, tolerance)
+		}
+
+		/* The segments form a spline whose inner knots have full
+		 * multiplicity. Determine how often each inner knot (the
+		 * first knot of segment i + 1) is removed. */
+		knots = ts_int_bspline_access_knots(spline);
+		b_knots = ts_int_bspline_access_knots(&beziers);
+		for (i = 0; i < n_segs; i++) {
+			for (j = 0; j < t_order; j++)
+				to_knots[i * t_order + j] = b_knots[i * order];
+		}
+		for (j = 0; j < t_order; j++)
+			to_knots[n_ctrlp + j] = b_knots[n_segs * order];
+		for (i = 0, j = 0; i + 1 < n_segs; i++) {
+			if (target < order - 1) {
+				num[i] = ts_distance(
+					task.to + ((i + 1) * t_order - 1) * dim,
+					task.to + (i + 1) * t_order * dim, dim)
+					<= TS_CONTROL_POINT_EPSILON ? 1 : 0;
+				continue;
+			}
+			/* Multiplicity of the knot in \p spline. */
+			while (j < n_knots && !ts_knots_equal(knots[j],
+					b_knots[(i + 1) * order]) &&
+					knots[j] < b_knots[(i + 1) * order])
+				j++;
+			for (m = 0; j < n_knots && ts_knots_equal(knots[j],
+					b_knots[(i + 1) * order]); j++)
+				m++;
+			num[i] = m < order ? order - m : 0;
+		}
+		n_ctrlp -= ts_int_knots_simplify(to_knots, n_ctrlp + t_order,
+			task.to, n_ctrlp, target, dim, num, NULL, temp);
+
+		TS_CALL(try, err, ts_bspline_new_with_allocator(
+			n_ctrlp, dim, target, TS_CLAMPED,
+			&spline->pImpl->allocator, &tmp, status))
+		memcpy(ts_int_bspline_access_ctrlp(&tmp), task.to,
+			n_ctrlp * dim * sizeof(tsReal));
+		memcpy(ts_int_bspline_access_knots(&tmp), to_knots,
+			(n_ctrlp + t_order) * sizeof(tsReal));
+		if (spline == result)
+			ts_bspline_free(result);
+		ts_bspline_move(&tmp, result);
 	TS_CATCH(err)
-		*k = 0;
+		ts_bspline_free(&tmp);
 	TS_FINALLY
-		ts_deboornet_free(&net);
+		ts_bspline_free(&beziers);
+		if (buf)
+			ts_int_free(buf);
+		if (num)
+			ts_int_free(num);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_split(const tsBSpline *spline, tsReal u, tsBSpline *split,
-	size_t* k, tsStatus *status)
+tsError ts_bspline_elevate_degree(const tsBSpline *spline, size_t amount,
+	const tsExecutor *executor, tsBSpline *elevated, tsStatus *status)
 {
-	tsDeBoorNet net;
+	if (amount == 0)
+		return ts_bspline_copy(spline, elevated, status);
+	return ts_int_bspline_change_degree(spline,
+		ts_bspline_degree(spline) + amount, -1, executor, elevated,
+		status);
+}
+
+tsError ts_bspline_reduce_degree(const tsBSpline *spline, size_t amount,
+	tsReal tolerance, const tsExecutor *executor, tsBSpline *reduced,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	if (amount > deg) {
+		INIT_OUT_BSPLINE(spline, reduced)
+		TS_RETURN_2(status, TS_NO_RESULT,
+			"amount (%lu) > degree (%lu)",
+			(unsigned long) amount, (unsigned long) deg)
+	}
+	if (amount == 0)
+		return ts_bspline_copy(spline, reduced, status);
+	return ts_int_bspline_change_degree(spline, deg - amount,
+		(tsReal) fabs(tolerance), executor, reduced, status);
+}
+
+tsError ts_bspline_remove_knots(const tsBSpline *spline, tsReal tolerance,
+	tsBSpline *result, tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	const size_t len_ctrlp = ts_bspline_len_control_points(spline);
+	size_t n_ctrlp = ts_bspline_num_control_points(spline);
+	size_t n_knots = ts_bspline_num_knots(spline);
+	size_t removed;
+	tsBSpline tmp;
+	tsReal *buf = NULL, *ctrlp, *knots, *temp, budget;
 	tsError err;
-	INIT_OUT_BSPLINE(spline, split)
-	ts_int_deboornet_init(&net);
+
+	INIT_OUT_BSPLINE(spline, result)
+	ts_int_bspline_init(&tmp);
 	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_eval(spline, u, &net, status))
-		if (ts_deboornet_multiplicity(&net)
-				== ts_bspline_order(spline)) {
-			TS_CALL(try, err, ts_bspline_copy(
-				spline, split, status))
-			*k = ts_deboornet_index(&net);
-		} else {
-			TS_CALL(try, err, ts_int_bspline_insert_knot(
-				spline, &net,
-				ts_deboornet_num_insertions(&net) + 1, split,
-				status))
-			*k = ts_deboornet_index(&net) +
-				ts_deboornet_num_insertions(&net) + 1;
+		buf = (tsReal *) ts_int_malloc((len_ctrlp + n_knots +
+			2 * order * dim) * sizeof(tsReal));
+		if (!buf) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
 		}
-	TS_CATCH(err)
-		*k = 0;
+		ctrlp = buf;
+		knots = ctrlp + len_ctrlp;
+		temp = knots + n_knots;
+		memcpy(ctrlp, ts_int_bspline_access_ctrlp(spline),
+			len_ctrlp * sizeof(tsReal));
+		memcpy(knots, ts_int_bspline_access_knots(spline),
+			n_knots * sizeof(tsReal));
+
+		budget = (tsReal) fabs(tolerance);
+		removed = ts_int_knots_simplify(knots, n_knots, ctrlp,
+			n_ctrlp, deg, dim, NULL, &budget, temp);
+		n_ctrlp -= removed;
+		n_knots -= removed;
+
+		TS_CALL(try, err, ts_bspline_new_with_allocator(
+			n_ctrlp, dim, deg, TS_OPENED,
+			&spline->pImpl->allocator, &tmp, status))
+		memcpy(ts_int_bspline_access_ctrlp(&tmp), ctrlp,
+			n_ctrlp * dim * sizeof(tsReal));
+		memcpy(ts_int_bspline_access_knots(&tmp), knots,
+			n_knots * sizeof(tsReal));
+		if (spline == result)
+			ts_bspline_free(result);
+		ts_bspline_move(&tmp, result);
 	TS_FINALLY
-		ts_deboornet_free(&net);
+		if (buf)
+			ts_int_free(buf);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_bspline_tension(const tsBSpline *spline, tsReal tension,
-	tsBSpline *out, tsStatus *status)
+/* Runs the tasks of an executor sequentially in the calling thread. Used for
+ * nested parallel functions. */
+void ts_int_executor_run_sequential(void *ctx, tsTask task, void *args,
+	size_t num)
 {
-	const tsReal s  = 1.f - tension; /**< The straightening factor. */
-	const size_t dim = ts_bspline_dimension(spline);
-	const size_t N = ts_bspline_num_control_points(spline);
-	const tsReal* p0 = ts_int_bspline_access_ctrlp(spline);
-	const tsReal* pn_1 = p0 + (N-1)*dim;
+	size_t i;
+	(void) ctx;
+	for (i = 0; i < num; i++)
+		task(args, i);
+}
 
-	tsReal *ctrlp; /**< Pointer to the control points of \p out. */
-	size_t i, d; /**< Used in for loops. */
+/* Clamps the knot vector of \p spline and stores the result in \p result.
+ * That is, the ends of the domain are inserted until their multiplicity is
+ * equal to the order of \p spline, and the knots outside of the domain (as
+ * well as the control points that do not affect the domain) are dropped.
+ * The shape of \p spline is preserved. */
+tsError ts_int_bspline_clamp(const tsBSpline *spline, tsBSpline *result,
+	tsStatus *status)
+{
+	const size_t deg = ts_bspline_degree(spline);
+	const size_t order = ts_bspline_order(spline);
+	const size_t dim = ts_bspline_dimension(spline);
+	size_t k, mult, first, last, n_ctrlp;
+	tsBSpline tmp, out;
+	const tsReal *knots;
+	tsReal min, max;
 	tsError err;
 
-	TS_CALL_ROE(err, ts_bspline_copy(spline, out, status))
-	ctrlp = ts_int_bspline_access_ctrlp(out);
+	INIT_OUT_BSPLINE(spline, result)
+	ts_int_bspline_init(&tmp);
+	ts_int_bspline_init(&out);
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_bspline_copy(spline, &tmp, status))
+		ts_bspline_domain(&tmp, &min, &max);
+		TS_CALL(try, err, ts_int_bspline_find_knot(
+			&tmp, min, &k, &mult, status))
+		if (mult < order) {
+			TS_CALL(try, err, ts_bspline_insert_knot(&tmp, min,
+				order - mult, &tmp, &k, status))
+		}
+		TS_CALL(try, err, ts_int_bspline_find_knot(
+			&tmp, max, &k, &mult, status))
+		if (mult < order) {
+			TS_CALL(try, err, ts_bspline_insert_knot(&tmp, max,
+				order - mult, &tmp, &k, status))
+		}
 
-	for (i = 0; i < N; i++) {
-		for (d = 0; d < dim; d++) {
-			ctrlp[i*dim + d] *= tension;
-			ctrlp[i*dim + d] += s * (p0[d] + ((tsReal)i / (N-1)) *
-				(pn_1[d] - p0[d]));
+		knots = ts_int_bspline_access_knots(&tmp);
+		for (first = 0; !ts_knots_equal(knots[first], min); first++);
+		last = ts_bspline_num_knots(&tmp) - 1;
+		for (; !ts_knots_equal(knots[last], max); last--);
+		n_ctrlp = last - first + 1 - order;
+		TS_CALL(try, err, ts_bspline_new_with_allocator(
+			n_ctrlp, dim, deg, TS_CLAMPED,
+			&spline->pImpl->allocator, &out, status))
+		memcpy(ts_int_bspline_access_ctrlp(&out),
+			ts_int_bspline_access_ctrlp(&tmp) + first * dim,
+			n_ctrlp * dim * sizeof(tsReal));
+		memcpy(ts_int_bspline_access_knots(&out), knots + first,
+			(n_ctrlp + order) * sizeof(tsReal));
+		if (spline == result)
+			ts_bspline_free(result);
+		ts_bspline_move(&out, result);
+	TS_CATCH(err)
+		ts_bspline_free(&out);
+	TS_FINALLY
+		ts_bspline_free(&tmp);
+	TS_END_TRY_RETURN(err)
+}
+
+/* Merges the sorted knots \p a (\p num_a values) and \p b (\p num_b values)
+ * into \p merged such that the multiplicity of each knot of \p merged is the
+ * maximum of its multiplicities in \p a and \p b. Knots are compared with
+ * ts_knots_equal. Returns the number of knots of \p merged, which must
+ * provide space for \p num_a + \p num_b values. */
+size_t ts_int_knots_union(const tsReal *a, size_t num_a, const tsReal *b,
+	size_t num_b, tsReal *merged)
+{
+	size_t i = 0, j = 0, ma, mb, num = 0;
+	while (i < num_a || j < num_b) {
+		ma = mb = 0;
+		if (j == num_b || (i < num_a && a[i] < b[j] &&
+				!ts_knots_equal(a[i], b[j]))) {
+			while (i + ma < num_a && ts_knots_equal(a[i], a[i+ma]))
+				ma++;
+		} else if (i == num_a || !ts_knots_equal(a[i], b[j])) {
+			while (j + mb < num_b && ts_knots_equal(b[j], b[j+mb]))
+				mb++;
+		} else {
+			while (i + ma < num_a && ts_knots_equal(a[i], a[i+ma]))
+				ma++;
+			while (j + mb < num_b && ts_knots_equal(b[j], b[j+mb]))
+				mb++;
 		}
+		ts_arr_fill(merged + num, ma > mb ? ma : mb,
+			ma > 0 ? a[i] : b[j]);
+		num += ma > mb ? ma : mb;
+		i += ma;
+		j += mb;
 	}
-	TS_RETURN_SUCCESS(status)
+	return num;
 }
 
-tsError ts_bspline_to_beziers(const tsBSpline *spline, tsBSpline *beziers,
-	tsStatus *status)
+/* Stores the knots of \p merged that are missing in \p knots (with respect
+ * to their multiplicity, cf. ts_int_knots_union) in \p missing and returns
+ * their number. */
+size_t ts_int_knots_difference(const tsReal *merged, size_t num_merged,
+	const tsReal *knots, size_t num_knots, tsReal *missing)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t order = ts_bspline_order(spline);
+	size_t i = 0, j = 0, num = 0;
+	while (i < num_merged) {
+		if (j < num_knots && ts_knots_equal(merged[i], knots[j])) {
+			j++;
+		} else {
+			missing[num++] = merged[i];
+		}
+		i++;
+	}
+	return num;
+}
 
-	int resize;    /**< Number of control points to add/remove. */
-	size_t k;      /**< Index of the split knot value. */
-	tsReal u_min;  /**< Minimum of the knot values. */
-	tsReal u_max;  /**< Maximum of the knot values. */
+struct tsBSplineCompatibleTask
+{
+	const tsBSpline *splines;
+	tsBSpline *results;
+	size_t deg;             /**< The common degree. */
+	const tsReal *merged;   /**< The merged inner knots. */
+	size_t num_merged;
+	tsReal *missing;        /**< num_merged values per spline. */
+	tsStatus *statuses;     /**< One status per spline. */
+};
+
+/* Elevates spline \p index to the common degree, clamps it, and maps its
+ * domain to [0, 1]. */
+void ts_int_bspline_compatible_prepare(void *args, size_t index)
+{
+	struct tsBSplineCompatibleTask *task =
+		(struct tsBSplineCompatibleTask *) args;
+	const tsBSpline *spline = task->splines + index;
+	tsBSpline *result = task->results + index;
+	tsStatus *status = task->statuses + index;
+	tsExecutor sequential;
+	tsReal *knots, min, max;
+	size_t i, n_knots, order;
+	tsError err;
 
-	tsBSpline tmp;    /**< Temporarily stores the result. */
-	tsReal *knots;    /**< Pointer to the knots of tmp. */
-	size_t num_knots; /**< Number of knots in tmp. */
+	sequential.run = ts_int_executor_run_sequential;
+	sequential.ctx = NULL;
+	TS_TRY(try, err, status)
+		ts_bspline_domain(spline, &min, &max);
+		if (max - min < TS_KNOT_EPSILON) {
+			TS_THROW_2(try, err, status, TS_U_UNDEFINED,
+				"spline %lu has an empty domain (%f)",
+				(unsigned long) index, min)
+		}
+		TS_CALL(try, err, ts_bspline_elevate_degree(spline,
+			task->deg - ts_bspline_degree(spline), &sequential,
+			result, status))
+		TS_CALL(try, err, ts_int_bspline_clamp(
+			result, result, status))
+		knots = ts_int_bspline_access_knots(result);
+		n_knots = ts_bspline_num_knots(result);
+		order = ts_bspline_order(result);
+		for (i = 0; i < n_knots; i++)
+			knots[i] = (knots[i] - min) / (max - min);
+		ts_arr_fill(knots, order, 0);
+		ts_arr_fill(knots + n_knots - order, order, 1);
+	TS_CATCH(err)
+		ts_bspline_free(result);
+	TS_END_TRY
+}
 
+/* Inserts the merged knots that are missing in spline \p index. */
+void ts_int_bspline_compatible_refine(void *args, size_t index)
+{
+	struct tsBSplineCompatibleTask *task =
+		(struct tsBSplineCompatibleTask *) args;
+	tsBSpline *result = task->results + index;
+	tsStatus *status = task->statuses + index;
+	const size_t order = ts_bspline_order(result);
+	const size_t n_knots = ts_bspline_num_knots(result);
+	tsReal *missing = task->missing + index * task->num_merged;
+	size_t num;
 	tsError err;
 
-	INIT_OUT_BSPLINE(spline, beziers)
-	TS_CALL_ROE(err, ts_bspline_copy(spline, &tmp, status))
-	knots = ts_int_bspline_access_knots(&tmp);
-	num_knots = ts_bspline_num_knots(&tmp);
+	TS_TRY(try, err, status)
+		num = ts_int_knots_difference(task->merged, task->num_merged,
+			ts_int_bspline_access_knots(result) + order,
+			n_knots - 2 * order, missing);
+		if (num > 0) {
+			TS_CALL(try, err, ts_bspline_insert_knots(result,
+				missing, num, result, status))
+		}
+		/* Remove rounding errors. */
+		memcpy(ts_int_bspline_access_knots(result) + order,
+			task->merged, task->num_merged * sizeof(tsReal));
+	TS_CATCH(err)
+		ts_bspline_free(result);
+	TS_END_TRY
+}
+
+tsError ts_bspline_make_compatible(const tsBSpline *splines, size_t num,
+	const tsExecutor *executor, tsBSpline *results, tsStatus *status)
+{
+	struct tsBSplineCompatibleTask task;
+	tsExecutor fallback;
+	tsStatus *statuses = NULL;
+	tsReal *buf = NULL, *merged, *tmp, *inner;
+	size_t i, deg = 0, len = 0, num_merged, n_inner, order;
+	tsError err;
+
+	for (i = 0; i < num; i++)
+		ts_int_bspline_init(results + i);
+	if (num == 0)
+		TS_RETURN_SUCCESS(status)
+	for (i = 1; i < num; i++) {
+		if (ts_bspline_dimension(splines + i) !=
+				ts_bspline_dimension(splines)) {
+			TS_RETURN_3(status, TS_INCOMPATIBLE,
+				"dimension of spline %lu (%lu) != %lu",
+				(unsigned long) i, (unsigned long)
+				ts_bspline_dimension(splines + i),
+				(unsigned long) ts_bspline_dimension(splines))
+		}
+	}
+	for (i = 0; i < num; i++) {
+		if (ts_bspline_degree(splines + i) > deg)
+			deg = ts_bspline_degree(splines + i);
+	}
+	if (!executor) {
+		fallback = ts_executor_default();
+		/* The tasks allocate memory with the global allocator and the
+		 * allocators of the splines. Custom allocators (e.g., arenas)
+		 * are not necessarily thread-safe. */
+		for (i = 0; i <= num; i++) {
+			if (!ts_int_allocator_is_default(i < num ?
+					&splines[i].pImpl->allocator :
+					&ts_int_allocator)) {
+				fallback.run = ts_int_executor_run_sequential;
+				fallback.ctx = NULL;
+			}
+		}
+		executor = &fallback;
+	}
 
 	TS_TRY(try, err, status)
-		/* DO NOT FORGET TO UPDATE knots AND num_knots AFTER EACH
-		 * TRANSFORMATION OF tmp! */
-
-		/* Fix first control point if necessary. */
-		u_min = knots[deg];
-		if (!ts_knots_equal(knots[0], u_min)) {
-			TS_CALL(try, err, ts_bspline_split(
-				&tmp, u_min, &tmp, &k, status))
-			resize = (int)(-1*deg + (deg*2 - k));
-			TS_CALL(try, err, ts_int_bspline_resize(
-				&tmp, resize, 0, &tmp, status))
-			knots = ts_int_bspline_access_knots(&tmp);
-			num_knots = ts_bspline_num_knots(&tmp);
-		}
-
-		/* Fix last control point if necessary. */
-		u_max = knots[num_knots - order];
-		if (!ts_knots_equal(knots[num_knots - 1], u_max)) {
-			TS_CALL(try, err, ts_bspline_split(
-				&tmp, u_max, &tmp, &k, status))
-			num_knots = ts_bspline_num_knots(&tmp);
-			resize = (int)(-1*deg + (k - (num_knots - order)));
-			TS_CALL(try, err, ts_int_bspline_resize(
-				&tmp, resize, 1, &tmp, status))
-			knots = ts_int_bspline_access_knots(&tmp);
-			num_knots = ts_bspline_num_knots(&tmp);
-		}
-
-		/* Split internal knots. */
-		k = order;
-		while (k < num_knots - order) {
-			TS_CALL(try, err, ts_bspline_split(
-				&tmp, knots[k], &tmp, &k, status))
-			knots = ts_int_bspline_access_knots(&tmp);
-			num_knots = ts_bspline_num_knots(&tmp);
-			k++;
-		}
-
-		if (spline == beziers)
-			ts_bspline_free(beziers);
-		ts_bspline_move(&tmp, beziers);
+		statuses = (tsStatus *) ts_int_malloc(num * sizeof(tsStatus));
+		if (!statuses) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		task.splines = splines;
+		task.results = results;
+		task.deg = deg;
+		task.statuses = statuses;
+		executor->run(executor->ctx, ts_int_bspline_compatible_prepare,
+			&task, num);
+		for (i = 0; i < num; i++) {
+			if (statuses[i].code != TS_SUCCESS) {
+				TS_THROW_1(try, err, status, statuses[i].code,
+					"%s", statuses[i].message)
+			}
+		}
+
+		/* Merge the inner knots of all splines. */
+		order = deg + 1;
+		for (i = 0; i < num; i++)
+			len += ts_bspline_num_knots(results + i) - 2 * order;
+		buf = (tsReal *) ts_int_malloc((2 * len + num * len + 1) *
+			sizeof(tsReal));
+		if (!buf) {
+			TS_THROW_0(try, err, status, TS_MALLOC,
+				"out of memory")
+		}
+		merged = buf;
+		tmp = merged + len;
+		num_merged = 0;
+		for (i = 0; i < num; i++) {
+			inner = ts_int_bspline_access_knots(results + i);
+			inner += order;
+			n_inner = ts_bspline_num_knots(results + i) - 2 * order;
+			num_merged = ts_int_knots_union(merged, num_merged,
+				inner, n_inner, tmp);
+			memcpy(merged, tmp, num_merged * sizeof(tsReal));
+		}
+
+		task.merged = merged;
+		task.num_merged = num_merged;
+		task.missing = tmp + len;
+		executor->run(executor->ctx, ts_int_bspline_compatible_refine,
+			&task, num);
+		for (i = 0; i < num; i++) {
+			if (statuses[i].code != TS_SUCCESS) {
+				TS_THROW_1(try, err, status, statuses[i].code,
+					"%s", statuses[i].message)
+			}
+		}
+	TS_CATCH(err)
+		for (i = 0; i < num; i++)
+			ts_bspline_free(results + i);
 	TS_FINALLY
-		ts_bspline_free(&tmp);
+		if (statuses)
+			ts_int_free(statuses);
+		if (buf)
+			ts_int_free(buf);
 	TS_END_TRY_RETURN(err)
 }
 
@@ -1839,303 +8471,972 @@ tsError ts_bspline_to_beziers(const tsBSpline *spline, tsBSpline *beziers,
 * :: Serialization and Persistence Functions                                  *
 *                                                                             *
 ******************************************************************************/
-tsError ts_int_bspline_to_json(const tsBSpline * spline, JSON_Value **value,
+/* Returns whether \p val can be stored as JSON number. */
+int ts_int_json_finite(tsReal val)
+{
+	return (double) val >= -DBL_MAX && (double) val <= DBL_MAX;
+}
+
+/* Formats \p val with the least number of significant digits that parse
+ * back to \p val and stores the result in \p buf (which must provide space
+ * for at least 32 characters). Every value with up to TS_INT_REAL_DIG
+ * significant digits is printed as is (%g strips trailing zeros). Only the
+ * remaining values are tried with more digits. Returns the length of the
+ * result. */
+size_t ts_int_json_format(tsReal val, char *buf)
+{
+	int prec;
+	tsReal parsed;
+	for (prec = TS_INT_REAL_DIG; prec < TS_INT_REAL_DIG_MAX; prec++) {
+		sprintf(buf, "%.*g", prec, (double) val);
+		parsed = (tsReal) strtod(buf, NULL);
+		if (!(parsed < val) && !(parsed > val))
+			return strlen(buf);
+	}
+	sprintf(buf, "%.*g", TS_INT_REAL_DIG_MAX, (double) val);
+	return strlen(buf);
+}
+
+/* Appends \p len characters of \p str to the output of \p writer. */
+void ts_int_json_write(struct tsJsonWriter *writer, const char *str,
+	size_t len)
+{
+	char *buf;
+	size_t cap;
+	if (writer->failed)
+		return;
+	if (writer->file) {
+		if (fwrite(str, 1, len, writer->file) != len)
+			writer->failed = 1;
+		return;
+	}
+	if (writer->len + len + 1 > writer->cap) {
+		cap = writer->cap > 0 ? writer->cap : 256;
+		while (writer->len + len + 1 > cap)
+			cap *= 2;
+		/* The buffer is returned to the caller and, thus, must be
+		 * allocated with malloc (cf. tsAllocator). */
+		buf = (char *) realloc(writer->buf, cap);
+		if (!buf) {
+			writer->failed = 1;
+			return;
+		}
+		writer->buf = buf;
+		writer->cap = cap;
+	}
+	memcpy(writer->buf + writer->len, str, len);
+	writer->len += len;
+	writer->buf[writer->len] = '\0';
+}
+
+tsError ts_int_json_write_reals(struct tsJsonWriter *writer,
+	const char *name, const tsReal *reals, size_t num, tsStatus *status)
+{
+	char buf[32];
+	size_t i;
+	ts_int_json_write(writer, "    \"", 5);
+	ts_int_json_write(writer, name, strlen(name));
+	ts_int_json_write(writer, "\": [", 4);
+	for (i = 0; i < num; i++) {
+		if (!ts_int_json_finite(reals[i])) {
+			TS_RETURN_2(status, TS_IO_ERROR,
+				"%s: value at index %lu is not finite",
+				name, (unsigned long) i)
+		}
+		ts_int_json_write(writer, i > 0 ? ",\n        " :
+			"\n        ", i > 0 ? 10 : 9);
+		ts_int_json_write(writer, buf, ts_int_json_format(
+			reals[i], buf));
+	}
+	ts_int_json_write(writer, "\n    ]", 6);
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Writes \p spline as JSON object to \p writer. The layout is compatible with
+ * former versions of TinySpline, which used parson to pretty print JSON. */
+tsError ts_int_bspline_write_json(const tsBSpline *spline,
+	struct tsJsonWriter *writer, tsStatus *status)
+{
+	char buf[64];
+	tsError err;
+
+	sprintf(buf, "{\n    \"degree\": %lu,\n",
+		(unsigned long) ts_bspline_degree(spline));
+	ts_int_json_write(writer, buf, strlen(buf));
+	sprintf(buf, "    \"dimension\": %lu,\n",
+		(unsigned long) ts_bspline_dimension(spline));
+	ts_int_json_write(writer, buf, strlen(buf));
+	TS_CALL_ROE(err, ts_int_json_write_reals(writer, "control_points",
+		ts_int_bspline_access_ctrlp(spline),
+		ts_bspline_len_control_points(spline), status))
+	ts_int_json_write(writer, ",\n", 2);
+	TS_CALL_ROE(err, ts_int_json_write_reals(writer, "knots",
+		ts_int_bspline_access_knots(spline),
+		ts_bspline_num_knots(spline), status))
+	ts_int_json_write(writer, "\n}", 2);
+	if (writer->failed) {
+		if (writer->file)
+			TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	}
+	TS_RETURN_SUCCESS(status)
+}
+
+/* Returns the next character of \p reader without consuming it, or EOF. */
+int ts_int_json_peek(struct tsJsonReader *reader)
+{
+	if (!reader->file) {
+		return reader->str[reader->pos] ?
+			(unsigned char) reader->str[reader->pos] : EOF;
+	}
+	if (reader->pos == reader->len) {
+		reader->len = fread(reader->buf, 1, sizeof(reader->buf),
+			reader->file);
+		reader->pos = 0;
+	}
+	return reader->pos < reader->len ?
+		(unsigned char) reader->buf[reader->pos] : EOF;
+}
+
+/* Consumes and returns the next character of \p reader, or EOF. */
+int ts_int_json_next(struct tsJsonReader *reader)
+{
+	const int c = ts_int_json_peek(reader);
+	if (c != EOF)
+		reader->pos++;
+	return c;
+}
+
+/* Skips white space and returns the next character (without consuming it). */
+int ts_int_json_skip_ws(struct tsJsonReader *reader)
+{
+	int c = ts_int_json_peek(reader);
+	while (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+		reader->pos++;
+		c = ts_int_json_peek(reader);
+	}
+	return c;
+}
+
+/* Skips white space and consumes \p expected. Returns 0 if the next
+ * character is not \p expected. */
+int ts_int_json_consume(struct tsJsonReader *reader, int expected)
+{
+	if (ts_int_json_skip_ws(reader) != expected)
+		return 0;
+	reader->pos++;
+	return 1;
+}
+
+/* Reads a string and stores (at most \p len - 1 characters of) it in \p str.
+ * Escape sequences are kept as is. Returns 0 on error. */
+int ts_int_json_string(struct tsJsonReader *reader, char *str, size_t len)
+{
+	size_t i = 0;
+	int c;
+	if (!ts_int_json_consume(reader, '"'))
+		return 0;
+	for (c = ts_int_json_next(reader); c != '"';
+			c = ts_int_json_next(reader)) {
+		if (c == EOF)
+			return 0;
+		if (c == '\\' && ts_int_json_next(reader) == EOF)
+			return 0;
+		if (str && i + 1 < len)
+			str[i++] = (char) c;
+	}
+	if (str)
+		str[i] = '\0';
+	return 1;
+}
+
+/* Reads a number and stores it in \p val. Returns 0 if the next value is
+ * not a number or if it is not finite (e.g., 1e999). */
+int ts_int_json_number(struct tsJsonReader *reader, double *val)
+{
+	char buf[64], *end;
+	size_t len = 0;
+	int c = ts_int_json_skip_ws(reader);
+	if (c != '-' && (c < '0' || c > '9'))
+		return 0;
+	while ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+			c == 'e' || c == 'E') {
+		if (len + 1 == sizeof(buf))
+			return 0;
+		buf[len++] = (char) c;
+		reader->pos++;
+		c = ts_int_json_peek(reader);
+	}
+	buf[len] = '\0';
+	*val = strtod(buf, &end);
+	return end == buf + len && *val >= -DBL_MAX && *val <= DBL_MAX;
+}
+
+/* Consumes \p literal (e.g., "true"). Returns 0 if the next characters do
+ * not match \p literal. */
+int ts_int_json_literal(struct tsJsonReader *reader, const char *literal)
+{
+	for (; *literal; literal++) {
+		if (ts_int_json_peek(reader) != *literal)
+			return 0;
+		reader->pos++;
+	}
+	return 1;
+}
+
+/* Skips the next value (of an unknown key). Returns 0 on error. */
+int ts_int_json_skip(struct tsJsonReader *reader, size_t depth)
+{
+	int c = ts_int_json_skip_ws(reader);
+	int close = c == '{' ? '}' : ']';
+	double val;
+	if (c == '"')
+		return ts_int_json_string(reader, NULL, 0);
+	if (c == '{' || c == '[') {
+		if (depth >= TS_INT_JSON_DEPTH)
+			return 0;
+		reader->pos++;
+		if (ts_int_json_skip_ws(reader) == close) {
+			reader->pos++;
+			return 1;
+		}
+		do {
+			if (close == '}' && (!ts_int_json_string(
+					reader, NULL, 0) ||
+					!ts_int_json_consume(reader, ':')))
+				return 0;
+			if (!ts_int_json_skip(reader, depth + 1))
+				return 0;
+			c = ts_int_json_skip_ws(reader);
+			reader->pos++;
+		} while (c == ',');
+		return c == close;
+	}
+	if (c == 't')
+		return ts_int_json_literal(reader, "true");
+	if (c == 'f')
+		return ts_int_json_literal(reader, "false");
+	if (c == 'n')
+		return ts_int_json_literal(reader, "null");
+	return ts_int_json_number(reader, &val);
+}
+
+/* Reads an array of numbers and appends its values to the control points of
+ * \p impl, which is grown (with the global allocator) as needed. */
+tsError ts_int_json_read_reals(struct tsJsonReader *reader, const char *name,
+	struct tsBSplineImpl **impl, size_t *cap, size_t *len,
 	tsStatus *status)
 {
-	const size_t deg = ts_bspline_degree(spline);
-	const size_t dim = ts_bspline_dimension(spline);
-	const size_t len_ctrlp = ts_bspline_len_control_points(spline);
-	const size_t len_knots = ts_bspline_num_knots(spline);
-	const tsReal *ctrlp = ts_int_bspline_access_ctrlp(spline);
-	const tsReal *knots = ts_int_bspline_access_knots(spline);
+	struct tsBSplineImpl *grown;
+	tsReal *reals;
+	double val;
+	size_t i = 0;
+	int c;
+
+	if (!ts_int_json_consume(reader, '[')) {
+		TS_RETURN_1(status, TS_PARSE_ERROR, "%s is not an array",
+			name)
+	}
+	if (ts_int_json_skip_ws(reader) == ']') {
+		reader->pos++;
+		TS_RETURN_SUCCESS(status)
+	}
+	do {
+		if (!ts_int_json_number(reader, &val) ||
+				!ts_int_json_finite((tsReal) val)) {
+			TS_RETURN_2(status, TS_PARSE_ERROR,
+				"%s: value at index %lu is not a finite number",
+				name, (unsigned long) i)
+		}
+		if (*len == *cap) {
+			*cap = *cap > 0 ? *cap * 2 : 256;
+			grown = (struct tsBSplineImpl *) ts_int_realloc(*impl,
+				sizeof(struct tsBSplineImpl) +
+				*cap * sizeof(tsReal));
+			if (!grown)
+				TS_RETURN_0(status, TS_MALLOC, "out of memory")
+			*impl = grown;
+		}
+		reals = (tsReal *) (& (*impl)[1]);
+		reals[(*len)++] = (tsReal) val;
+		i++;
+		c = ts_int_json_skip_ws(reader);
+		reader->pos++;
+	} while (c == ',');
+	if (c != ']')
+		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
+	TS_RETURN_SUCCESS(status)
+}
 
-	size_t i; /**< Used in loops */
+/* Parses a JSON object (cf. ts_int_bspline_write_json) from \p reader in a
+ * single pass. The control points and knots are read straight into the impl
+ * of \p spline. The order of the keys does not matter and unknown keys are
+ * skipped. */
+tsError ts_int_bspline_read_json(struct tsJsonReader *reader,
+	tsBSpline *spline, tsStatus *status)
+{
+	struct tsBSplineImpl *impl = NULL;
+	size_t cap = 0, len = 0; /**< Number of reals in impl. */
+	size_t ctrlp_at = 0, len_ctrlp = 0, knots_at = 0, num_knots = 0;
+	int has_deg = 0, has_dim = 0, has_ctrlp = 0, has_knots = 0;
+	double deg_value = 0, dim_value = 0;
+	size_t deg, dim, num_ctrlp;
+	tsReal *reals, *tmp = NULL;
+	char key[32];
+	int c;
 	tsError err;
 
-	JSON_Value  *ctrlp_value;
-	JSON_Value  *knots_value;
-	JSON_Object *spline_object;
-	JSON_Array  *ctrlp_array;
-	JSON_Array  *knots_array;
-
-	*value = ctrlp_value = knots_value = NULL;
-	TS_TRY(values, err, status)
-		/* Init memory. */
-		*value = json_value_init_object();
-		if (!*value) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+	ts_int_bspline_init(spline);
+	TS_TRY(try, err, status)
+		if (!ts_int_json_consume(reader, '{')) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"invalid json input")
 		}
-		ctrlp_value = json_value_init_array();
-		if (!ctrlp_value) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		c = ts_int_json_skip_ws(reader);
+		if (c == '}')
+			reader->pos++;
+		while (c != '}') {
+			if (!ts_int_json_string(reader, key, sizeof(key)) ||
+				!ts_int_json_consume(reader, ':')) {
+				TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+					"invalid json input")
+			}
+			if (!strcmp(key, "degree") && !has_deg) {
+				if (!ts_int_json_number(reader, &deg_value)) {
+					TS_THROW_0(try, err, status,
+						TS_PARSE_ERROR,
+						"degree is not a number")
+				}
+				if (deg_value < -0.01f) {
+					TS_THROW_1(try, err, status,
+						TS_PARSE_ERROR,
+						"degree (%f) < 0", deg_value)
+				}
+				has_deg = 1;
+			} else if (!strcmp(key, "dimension") && !has_dim) {
+				if (!ts_int_json_number(reader, &dim_value)) {
+					TS_THROW_0(try, err, status,
+						TS_PARSE_ERROR,
+						"dimension is not a number")
+				}
+				if (dim_value < 0.99f) {
+					TS_THROW_1(try, err, status,
+						TS_PARSE_ERROR,
+						"dimension (%f) < 1",
+						dim_value)
+				}
+				has_dim = 1;
+			} else if (!strcmp(key, "control_points") &&
+					!has_ctrlp) {
+				ctrlp_at = len;
+				TS_CALL(try, err, ts_int_json_read_reals(
+					reader, key, &impl, &cap, &len,
+					status))
+				len_ctrlp = len - ctrlp_at;
+				has_ctrlp = 1;
+			} else if (!strcmp(key, "knots") && !has_knots) {
+				knots_at = len;
+				TS_CALL(try, err, ts_int_json_read_reals(
+					reader, key, &impl, &cap, &len,
+					status))
+				num_knots = len - knots_at;
+				has_knots = 1;
+			} else if (!ts_int_json_skip(reader, 0)) {
+				TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+					"invalid json input")
+			}
+			c = ts_int_json_skip_ws(reader);
+			reader->pos++;
+			if (c != ',' && c != '}') {
+				TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+					"invalid json input")
+			}
 		}
-		knots_value = json_value_init_array();
-		if (!knots_value) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		if (ts_int_json_skip_ws(reader) != EOF) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"invalid json input")
 		}
 
-		/* Although the following functions cannot fail, that is, they
-		 * won't return NULL or JSONFailure, we nevertheless handle
-		 * unexpected return values. */
-
-		/* Init output. */
-		spline_object = json_value_get_object(*value);
-		if (!spline_object) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		/* Validate the values. */
+		if (!has_deg) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"degree is not a number")
 		}
-
-		/* Set degree and dimension. */
-		if (JSONSuccess != json_object_set_number(
-				spline_object, "degree", (double) deg)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		if (!has_dim) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"dimension is not a number")
 		}
-		if (JSONSuccess != json_object_set_number(
-				spline_object, "dimension", (double) dim)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		if (!has_ctrlp) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"control_points is not an array")
 		}
-
-		/* Set control points. */
-		if (JSONSuccess != json_object_set_value(spline_object,
-				"control_points", ctrlp_value)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		if (dim_value > (double) len_ctrlp) {
+			TS_THROW_2(try, err, status, TS_PARSE_ERROR,
+				"len(control_points) (%lu) %% dimension (%f) "
+				"!= 0", (unsigned long) len_ctrlp, dim_value)
 		}
-		ctrlp_array = json_array(ctrlp_value);
-		if (!ctrlp_array) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		dim = (size_t) dim_value;
+		if (len_ctrlp % dim != 0) {
+			TS_THROW_2(try, err, status, TS_PARSE_ERROR,
+				"len(control_points) (%lu) %% dimension (%lu) "
+				"!= 0", (unsigned long) len_ctrlp,
+				(unsigned long) dim)
 		}
-		for (i = 0; i < len_ctrlp; i++) {
-			if (JSONSuccess != json_array_append_number(
-					ctrlp_array, (double) ctrlp[i])) {
-				TS_THROW_0(values, err, status, TS_MALLOC,
-					"out of memory")
-			}
+		if (!has_knots) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"knots is not an array")
 		}
-
-		/* Set knots. */
-		if (JSONSuccess != json_object_set_value(
-				spline_object, "knots", knots_value)) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		num_ctrlp = len_ctrlp / dim;
+		if (deg_value + (double) num_ctrlp + 1 > TS_MAX_NUM_KNOTS) {
+			TS_THROW_1(try, err, status, TS_NUM_KNOTS,
+				"unsupported number of knots: > %i",
+				TS_MAX_NUM_KNOTS)
 		}
-		knots_array = json_array(knots_value);
-		if (!knots_array) {
-			TS_THROW_0(values, err, status, TS_MALLOC,
-				"out of memory")
+		deg = (size_t) deg_value;
+		if (deg >= num_ctrlp) {
+			TS_THROW_2(try, err, status, TS_DEG_GE_NCTRLP,
+				"degree (%lu) >= num(control_points) (%lu)",
+				(unsigned long) deg, (unsigned long) num_ctrlp)
+		}
+		if (num_knots != num_ctrlp + deg + 1) {
+			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
+				"unexpected num(knots): (%lu) != (%lu)",
+				(unsigned long) num_knots,
+				(unsigned long) (num_ctrlp + deg + 1))
 		}
-		for (i = 0; i < len_knots; i++) {
-			if (JSONSuccess != json_array_append_number(
-					knots_array, (double) knots[i])) {
-				TS_THROW_0(values, err, status, TS_MALLOC,
+
+		/* The knots must be stored behind the control points. */
+		reals = (tsReal *) (&impl[1]);
+		if (knots_at < ctrlp_at) {
+			tmp = (tsReal *) ts_int_malloc(
+				num_knots * sizeof(tsReal));
+			if (!tmp) {
+				TS_THROW_0(try, err, status, TS_MALLOC,
 					"out of memory")
 			}
+			memcpy(tmp, reals + knots_at,
+				num_knots * sizeof(tsReal));
+			memmove(reals, reals + ctrlp_at,
+				len_ctrlp * sizeof(tsReal));
+			memcpy(reals + len_ctrlp, tmp,
+				num_knots * sizeof(tsReal));
 		}
+		impl->deg = deg;
+		impl->dim = dim;
+		impl->n_ctrlp = num_ctrlp;
+		impl->n_knots = num_knots;
+		/* impl has been allocated with ts_int_realloc. */
+		impl->allocator = ts_int_allocator_or_global(NULL);
+		spline->pImpl = impl;
+		impl = NULL;
+		TS_CALL(try, err, ts_bspline_set_knots(spline,
+			ts_int_bspline_access_knots(spline), status))
+	TS_FINALLY
+		ts_int_free(impl);
+		ts_int_free(tmp);
 	TS_CATCH(err)
-		if (*value)
-			json_value_free(*value);
-		if (ctrlp_value && !json_value_get_parent(ctrlp_value))
-			json_value_free(ctrlp_value);
-		if (knots_value && !json_value_get_parent(knots_value))
-			json_value_free(knots_value);
-		*value = NULL;
+		ts_bspline_free(spline);
 	TS_END_TRY_RETURN(err)
 }
 
-tsError ts_int_bspline_parse_json(const JSON_Value *spline_value,
-	tsBSpline *_spline_, tsStatus *status)
+tsError ts_bspline_to_json(const tsBSpline *spline, char **json,
+	tsStatus *status)
 {
-	size_t deg, dim, len_ctrlp, num_knots;
-	tsReal *ctrlp, *knots;
+	struct tsJsonWriter writer;
+	tsError err;
+	memset(&writer, 0, sizeof(writer));
+	*json = NULL;
+	TS_TRY(try, err, status)
+		TS_CALL(try, err, ts_int_bspline_write_json(
+			spline, &writer, status))
+		*json = writer.buf;
+	TS_CATCH(err)
+		free(writer.buf);
+	TS_END_TRY_RETURN(err)
+}
 
-	JSON_Object *spline_object;
-	JSON_Value *deg_value;
-	JSON_Value *dim_value;
-	JSON_Value *ctrlp_value;
-	JSON_Array *ctrlp_array;
-	JSON_Value *knots_value;
-	JSON_Array *knots_array;
-	JSON_Value *real_value;
-	size_t i;
+tsError ts_bspline_parse_json(const char *json, tsBSpline *spline,
+	tsStatus *status)
+{
+	struct tsJsonReader reader;
+	reader.file = NULL;
+	reader.str = json;
+	reader.pos = reader.len = 0;
+	return ts_int_bspline_read_json(&reader, spline, status);
+}
+
+tsError ts_bspline_write_json(const tsBSpline *spline, FILE *file,
+	tsStatus *status)
+{
+	struct tsJsonWriter writer;
+	memset(&writer, 0, sizeof(writer));
+	writer.file = file;
+	return ts_int_bspline_write_json(spline, &writer, status);
+}
+
+tsError ts_bspline_read_json(FILE *file, tsBSpline *spline,
+	tsStatus *status)
+{
+	struct tsJsonReader reader;
+	reader.file = file;
+	reader.str = NULL;
+	reader.pos = reader.len = 0;
+	return ts_int_bspline_read_json(&reader, spline, status);
+}
+
+tsError ts_bspline_save(const tsBSpline *spline, const char *path,
+	tsStatus *status)
+{
 	tsError err;
+	FILE *file = fopen(path, "w");
+	if (!file)
+		TS_RETURN_0(status, TS_IO_ERROR, "unable to open file")
+	err = ts_bspline_write_json(spline, file, status);
+	if (fclose(file) != 0 && !err)
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	return err;
+}
 
-	ts_int_bspline_init(_spline_);
+tsError ts_bspline_load(const char *path, tsBSpline *spline, tsStatus *status)
+{
+	tsError err;
+	FILE *file;
+	ts_int_bspline_init(spline);
+	file = fopen(path, "r");
+	if (!file)
+		TS_RETURN_0(status, TS_IO_ERROR, "unable to open file")
+	err = ts_bspline_read_json(file, spline, status);
+	fclose(file);
+	return err;
+}
 
-	/* Read spline object. */
-	if (json_value_get_type(spline_value) != JSONObject)
-		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
-	spline_object = json_value_get_object(spline_value);
-	if (!spline_object)
-		TS_RETURN_0(status, TS_PARSE_ERROR, "invalid json input")
+/* Allocates \p size bytes (with the global allocator) preceded by a
+ * tsMappedHeader. Splines that have been mapped with ts_bspline_map_binary
+ * use this allocator so that derived objects and copies are allocated on
+ * the heap, whereas the mapped spline itself is unmapped when freed. */
+void * ts_int_mapped_allocate(void *ctx, size_t size)
+{
+	const size_t off = ts_int_arena_round(sizeof(struct tsMappedHeader));
+	struct tsMappedHeader *header;
+	(void) ctx;
+	header = (struct tsMappedHeader *) ts_int_malloc(off + size);
+	if (!header)
+		return NULL;
+	header->base = NULL;
+	header->len = 0;
+	return (char *) header + off;
+}
 
-	/* Read degree. */
-	deg_value = json_object_get_value(spline_object, "degree");
-	if (json_value_get_type(deg_value) != JSONNumber)
-		TS_RETURN_0(status, TS_PARSE_ERROR, "degree is not a number")
-	if (json_value_get_number(deg_value) < -0.01f) {
-		TS_RETURN_1(status, TS_PARSE_ERROR, "degree (%f) < 0",
-			json_value_get_number(deg_value))
-	}
-	deg = (size_t) json_value_get_number(deg_value);
-
-	/* Read dimension. */
-	dim_value = json_object_get_value(spline_object, "dimension");
-	if (json_value_get_type(dim_value) != JSONNumber) {
-		TS_RETURN_0(status, TS_PARSE_ERROR,
-			"dimension is not a number")
-	}
-	if (json_value_get_number(dim_value) < 0.99f) {
-		TS_RETURN_1(status, TS_PARSE_ERROR, "dimension (%f) < 1",
-			json_value_get_number(deg_value))
-	}
-	dim = (size_t) json_value_get_number(dim_value);
-
-	/* Read length of control point vector. */
-	ctrlp_value = json_object_get_value(spline_object, "control_points");
-	if (json_value_get_type(ctrlp_value) != JSONArray) {
-		TS_RETURN_0(status, TS_PARSE_ERROR,
-			"control_points is not an array")
-	}
-	ctrlp_array = json_value_get_array(ctrlp_value);
-	len_ctrlp = json_array_get_count(ctrlp_array);
-	if (len_ctrlp % dim != 0) {
-		TS_RETURN_2(status, TS_PARSE_ERROR,
-			"len(control_points) (%lu) %% dimension (%lu) != 0",
-			(unsigned long) len_ctrlp, (unsigned long) dim)
-	}
+void ts_int_mapped_deallocate(void *ctx, void *ptr)
+{
+	const size_t off = ts_int_arena_round(sizeof(struct tsMappedHeader));
+	struct tsMappedHeader *header;
+	(void) ctx;
+	if (!ptr)
+		return;
+	header = (struct tsMappedHeader *) ((char *) ptr - off);
+	if (header->len == 0)
+		ts_int_free(header);
+#ifdef TINYSPLINE_HAVE_MMAP
+	else
+		munmap(header->base, header->len);
+#endif
+}
 
-	/* Read number of knots. */
-	knots_value = json_object_get_value(spline_object, "knots");
-	if (json_value_get_type(knots_value) != JSONArray) {
-		TS_RETURN_0(status, TS_PARSE_ERROR,
-			"knots is not an array")
+void * ts_int_mapped_reallocate(void *ctx, void *ptr, size_t size)
+{
+	const size_t off = ts_int_arena_round(sizeof(struct tsMappedHeader));
+	struct tsMappedHeader *header;
+	size_t avail;
+	void *copy;
+	if (!ptr)
+		return ts_int_mapped_allocate(ctx, size);
+	header = (struct tsMappedHeader *) ((char *) ptr - off);
+	if (header->len == 0) {
+		header = (struct tsMappedHeader *) ts_int_realloc(
+			header, off + size);
+		return header ? (char *) header + off : NULL;
 	}
-	knots_array = json_value_get_array(knots_value);
-	num_knots = json_array_get_count(knots_array);
+	/* Move a mapped object to the heap. */
+	copy = ts_int_mapped_allocate(ctx, size);
+	if (!copy)
+		return NULL;
+	avail = header->len - (size_t) ((char *) ptr - (char *) header->base);
+	memcpy(copy, ptr, size < avail ? size : avail);
+	ts_int_mapped_deallocate(ctx, ptr);
+	return copy;
+}
 
-	/* Create spline. */
-	TS_TRY(try, err, status)
-		TS_CALL(try, err, ts_bspline_new(len_ctrlp/dim,
-				dim, deg, TS_CLAMPED, _spline_, status))
-		if (num_knots != ts_bspline_num_knots(_spline_))
-			TS_THROW_2(try, err, status, TS_NUM_KNOTS,
-				"unexpected num(knots): (%lu) != (%lu)",
-				(unsigned long) num_knots,
-				(unsigned long) ts_bspline_num_knots(_spline_))
-
-		/* Set control points. */
-		ctrlp = ts_int_bspline_access_ctrlp(_spline_);
-		for (i = 0; i < len_ctrlp; i++) {
-			real_value = json_array_get_value(ctrlp_array, i);
-			if (json_value_get_type(real_value) != JSONNumber)
-				TS_THROW_1(try, err, status, TS_PARSE_ERROR,
-					"control_points: value at index %lu is not a number",
-					(unsigned long) i)
-			ctrlp[i] = (tsReal) json_value_get_number(real_value);
-		}
-		TS_CALL(try, err, ts_bspline_set_control_points(
-			_spline_, ctrlp, status))
-
-		/* Set knots. */
-		knots = ts_int_bspline_access_knots(_spline_);
-		for (i = 0; i < num_knots; i++) {
-			real_value = json_array_get_value(knots_array, i);
-			if (json_value_get_type(real_value) != JSONNumber)
-			TS_THROW_1(try, err, status, TS_PARSE_ERROR,
-				"knots: value at index %lu is not a number",
-				(unsigned long) i)
-			knots[i] = (tsReal) json_value_get_number(real_value);
+/* Updates the Adler-32 checksum \p adler with \p len bytes of \p data. The
+ * initial value of a checksum is 1. */
+unsigned long ts_int_adler32(unsigned long adler, const unsigned char *data,
+	size_t len)
+{
+	unsigned long a = adler & 0xffff, b = (adler >> 16) & 0xffff;
+	size_t n;
+	while (len > 0) {
+		/* Largest n such that b does not overflow 32 bits. */
+		n = len < 5552 ? len : 5552;
+		len -= n;
+		while (n--) {
+			a += *data++;
+			b += a;
 		}
-		TS_CALL(try, err, ts_bspline_set_knots(
-			_spline_, knots, status))
-	TS_CATCH(err)
-		ts_bspline_free(_spline_);
-	TS_END_TRY_RETURN(err)
+		a %= 65521;
+		b %= 65521;
+	}
+	return (b << 16) | a;
 }
 
-tsError ts_bspline_to_json(const tsBSpline *spline, char **json,
-	tsStatus *status)
+int ts_int_binary_endianness(void)
 {
-	tsError err;
-	JSON_Value *value = NULL;
-	*json = NULL;
-	TS_CALL_ROE(err, ts_int_bspline_to_json(spline, &value, status))
-	*json = json_serialize_to_string_pretty(value);
-	json_value_free(value);
-	if (!*json)
-		TS_RETURN_0(status, TS_MALLOC, "out of memory")
+	const unsigned int one = 1;
+	return *((const unsigned char *) &one) ?
+		TS_INT_BINARY_LITTLE : TS_INT_BINARY_BIG;
+}
+
+/* Writes \p val as little endian integer of \p len bytes to \p buf. */
+void ts_int_binary_put(unsigned char *buf, size_t len, size_t val)
+{
+	size_t i;
+	for (i = 0; i < len; i++) {
+		buf[i] = (unsigned char) (val & 0xff);
+		val >>= 8;
+	}
+}
+
+/* Reads a little endian integer of \p len bytes from \p buf. Returns 0 if
+ * the integer does not fit into a size_t. */
+int ts_int_binary_get(const unsigned char *buf, size_t len, size_t *val)
+{
+	size_t i = len;
+	*val = 0;
+	while (i-- > 0) {
+		if (*val > ((size_t) -1 >> 8))
+			return 0;
+		*val = (*val << 8) | buf[i];
+	}
+	return 1;
+}
+
+/* Returns the number of bytes of the data described by \p header. */
+size_t ts_int_binary_sof_data(const struct tsBinaryHeader *header)
+{
+	return (header->n_ctrlp * header->dim + header->n_knots) *
+		header->sof_real;
+}
+
+tsError ts_int_binary_parse_header(const unsigned char *buf,
+	struct tsBinaryHeader *header, tsStatus *status)
+{
+	size_t version, checksum;
+	if (memcmp(buf, TS_INT_BINARY_MAGIC, 4) != 0)
+		TS_RETURN_0(status, TS_PARSE_ERROR, "not a binary spline")
+	version = buf[4];
+	if (version != TS_INT_BINARY_VERSION) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported version: %lu", (unsigned long) version)
+	}
+	header->endianness = buf[5];
+	if (header->endianness != TS_INT_BINARY_LITTLE &&
+		header->endianness != TS_INT_BINARY_BIG) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported byte order: %d", header->endianness)
+	}
+	header->sof_real = buf[6];
+	if (header->sof_real != sizeof(float) &&
+		header->sof_real != sizeof(double)) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported size of reals: %lu",
+			(unsigned long) header->sof_real)
+	}
+	if (!ts_int_binary_get(buf + 8, 8, &header->offset) ||
+		!ts_int_binary_get(buf + 16, 8, &header->deg) ||
+		!ts_int_binary_get(buf + 24, 8, &header->dim) ||
+		!ts_int_binary_get(buf + 32, 8, &header->n_ctrlp) ||
+		!ts_int_binary_get(buf + 40, 8, &header->n_knots) ||
+		!ts_int_binary_get(buf + 48, 4, &checksum)) {
+		TS_RETURN_0(status, TS_PARSE_ERROR, "header value overflow")
+	}
+	header->checksum = (unsigned long) checksum;
+	if (header->offset < TS_INT_BINARY_HEADER) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"invalid data offset: %lu",
+			(unsigned long) header->offset)
+	}
+	/* Bound the sizes before they are summed up or used as divisors. */
+	if (header->deg > TS_MAX_NUM_KNOTS ||
+		header->n_ctrlp > TS_MAX_NUM_KNOTS ||
+		header->n_knots > TS_MAX_NUM_KNOTS) {
+		TS_RETURN_3(status, TS_PARSE_ERROR,
+			"unsupported size: degree (%lu), "
+			"num(control_points) (%lu), num(knots) (%lu)",
+			(unsigned long) header->deg,
+			(unsigned long) header->n_ctrlp,
+			(unsigned long) header->n_knots)
+	}
+	if (header->dim == 0)
+		TS_RETURN_0(status, TS_DIM_ZERO, "unsupported dimension: 0")
+	if (header->deg >= header->n_ctrlp) {
+		TS_RETURN_2(status, TS_DEG_GE_NCTRLP,
+			"degree (%lu) >= num(control_points) (%lu)",
+			(unsigned long) header->deg,
+			(unsigned long) header->n_ctrlp)
+	}
+	if (header->n_knots != header->n_ctrlp + header->deg + 1) {
+		TS_RETURN_1(status, TS_NUM_KNOTS,
+			"unexpected num(knots): %lu",
+			(unsigned long) header->n_knots)
+	}
+	/* n_ctrlp <= TS_MAX_NUM_KNOTS (see above). */
+	if (header->dim > ((size_t) -1 - TS_INT_BINARY_DATA) /
+			header->sof_real / (header->n_ctrlp + 1)) {
+		TS_RETURN_1(status, TS_PARSE_ERROR,
+			"unsupported dimension: %lu",
+			(unsigned long) header->dim)
+	}
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_parse_json(const char *json, tsBSpline *spline,
-	tsStatus *status)
+/* Converts \p num reals of \p header stored in \p src to tsReal. */
+void ts_int_binary_convert(const struct tsBinaryHeader *header,
+	const unsigned char *src, size_t num, tsReal *dest)
 {
-	tsError err;
-	JSON_Value *value = NULL;
-	ts_int_bspline_init(spline);
-	TS_TRY(try, err, status)
-		value = json_parse_string(json);
-		if (!value) {
-			TS_RETURN_0(status, TS_PARSE_ERROR,
-				"invalid json input")
+	const int swap = header->endianness != ts_int_binary_endianness();
+	const size_t sof_real = header->sof_real;
+	unsigned char bytes[sizeof(double)];
+	float f;
+	double d;
+	size_t i, j;
+	for (i = 0; i < num; i++) {
+		for (j = 0; j < sof_real; j++) {
+			bytes[j] = swap ? src[i * sof_real + sof_real - 1 - j]
+				: src[i * sof_real + j];
 		}
-		TS_CALL(try, err, ts_int_bspline_parse_json(
-			value, spline, status))
-	TS_FINALLY
-		if (value)
-			json_value_free(value);
-	TS_END_TRY_RETURN(err)
+		if (sof_real == sizeof(float)) {
+			memcpy(&f, bytes, sizeof(float));
+			dest[i] = (tsReal) f;
+		} else {
+			memcpy(&d, bytes, sizeof(double));
+			dest[i] = (tsReal) d;
+		}
+	}
 }
 
-tsError ts_bspline_save(const tsBSpline *spline, const char *path,
+tsError ts_bspline_save_binary(const tsBSpline *spline, const char *path,
 	tsStatus *status)
 {
-	tsError err;
-	JSON_Status json_status;
-	JSON_Value *value = NULL;
-	TS_CALL_ROE(err, ts_int_bspline_to_json(spline, &value, status))
-	json_status = json_serialize_to_file_pretty(value, path);
-	json_value_free(value);
-	if (json_status != JSONSuccess)
+	/* Control points and knots are stored consecutively. */
+	const unsigned char *data = (const unsigned char *)
+		ts_int_bspline_access_ctrlp(spline);
+	const size_t sof_data = ts_bspline_sof_control_points(spline) +
+		ts_bspline_sof_knots(spline);
+	unsigned char header[TS_INT_BINARY_DATA];
+	unsigned long checksum;
+	FILE *file;
+
+	memset(header, 0, sizeof(header));
+	memcpy(header, TS_INT_BINARY_MAGIC, 4);
+	header[4] = TS_INT_BINARY_VERSION;
+	header[5] = (unsigned char) ts_int_binary_endianness();
+	header[6] = (unsigned char) sizeof(tsReal);
+	ts_int_binary_put(header + 8, 8, TS_INT_BINARY_DATA);
+	ts_int_binary_put(header + 16, 8, ts_bspline_degree(spline));
+	ts_int_binary_put(header + 24, 8, ts_bspline_dimension(spline));
+	ts_int_binary_put(header + 32, 8,
+		ts_bspline_num_control_points(spline));
+	ts_int_binary_put(header + 40, 8, ts_bspline_num_knots(spline));
+	checksum = ts_int_adler32(1, data, sof_data);
+	ts_int_binary_put(header + 48, 4, (size_t) checksum);
+
+	file = fopen(path, "wb");
+	if (!file)
+		TS_RETURN_0(status, TS_IO_ERROR, "unable to open file")
+	if (fwrite(header, 1, sizeof(header), file) != sizeof(header) ||
+		fwrite(data, 1, sof_data, file) != sof_data) {
+		fclose(file);
+		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
+	}
+	if (fclose(file) != 0)
 		TS_RETURN_0(status, TS_IO_ERROR, "unexpected io error")
 	TS_RETURN_SUCCESS(status)
 }
 
-tsError ts_bspline_load(const char *path, tsBSpline *spline, tsStatus *status)
+tsError ts_bspline_load_binary(const char *path, tsBSpline *spline,
+	tsStatus *status)
 {
-	tsError err;
+	struct tsBinaryHeader header;
+	unsigned char buf[TS_INT_BINARY_HEADER];
+	unsigned char *chunk = NULL;
+	unsigned long checksum = 1;
+	size_t sof_data, len_data, num, len, i;
+	tsReal *data;
 	FILE *file = NULL;
-	JSON_Value *value = NULL;
+	tsError err;
+
 	ts_int_bspline_init(spline);
 	TS_TRY(try, err, status)
-		file = fopen(path, "r");
+		file = fopen(path, "rb");
 		if (!file) {
 			TS_THROW_0(try, err, status, TS_IO_ERROR,
 				"unable to open file")
 		}
-		value = json_parse_file(path);
-		if (!value) {
-			TS_RETURN_0(status, TS_PARSE_ERROR,
-				"invalid json input")
+		if (fread(buf, 1, sizeof(buf), file) != sizeof(buf)) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"not a binary spline")
+		}
+		TS_CALL(try, err, ts_int_binary_parse_header(
+			buf, &header, status))
+		if (fseek(file, (long) header.offset, SEEK_SET) != 0) {
+			TS_THROW_0(try, err, status, TS_IO_ERROR,
+				"unexpected io error")
+		}
+		TS_CALL(try, err, ts_bspline_new(
+			header.n_ctrlp, header.dim, header.deg, TS_CLAMPED,
+			spline, status))
+		data = ts_int_bspline_access_ctrlp(spline);
+		sof_data = ts_int_binary_sof_data(&header);
+		len_data = sof_data / header.sof_real;
+
+		if (header.endianness == ts_int_binary_endianness() &&
+			header.sof_real == sizeof(tsReal)) {
+			/* Native layout: read directly into the spline. */
+			if (fread(data, 1, sof_data, file) != sof_data) {
+				TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+					"unexpected end of file")
+			}
+			checksum = ts_int_adler32(checksum,
+				(const unsigned char *) data, sof_data);
+		} else {
+			/* Foreign layout: convert chunk by chunk. */
+			num = 4096;
+			chunk = (unsigned char *) ts_int_malloc(
+				num * header.sof_real);
+			if (!chunk) {
+				TS_THROW_0(try, err, status, TS_MALLOC,
+					"out of memory")
+			}
+			for (i = 0; i < len_data; i += len) {
+				len = len_data - i < num ? len_data - i : num;
+				if (fread(chunk, header.sof_real, len, file)
+						!= len) {
+					TS_THROW_0(try, err, status,
+						TS_PARSE_ERROR,
+						"unexpected end of file")
+				}
+				checksum = ts_int_adler32(checksum, chunk,
+					len * header.sof_real);
+				ts_int_binary_convert(&header, chunk, len,
+					data + i);
+			}
 		}
-		TS_CALL(try, err, ts_int_bspline_parse_json(
-			value, spline, status))
+		if (checksum != header.checksum) {
+			TS_THROW_0(try, err, status, TS_PARSE_ERROR,
+				"checksum mismatch")
+		}
+		TS_CALL(try, err, ts_bspline_set_knots(spline,
+			ts_int_bspline_access_knots(spline), status))
 	TS_FINALLY
 		if (file)
 			fclose(file);
-		if (value)
-			json_value_free(value);
+		ts_int_free(chunk);
 	TS_CATCH(err)
 		ts_bspline_free(spline);
 	TS_END_TRY_RETURN(err)
 }
 
+tsError ts_bspline_map_binary(const char *path, int verify,
+	tsBSpline *spline, tsStatus *status)
+{
+#ifdef TINYSPLINE_HAVE_MMAP
+	const size_t sof_impl = sizeof(struct tsBSplineImpl);
+	const size_t off = ts_int_arena_round(sizeof(struct tsMappedHeader));
+	struct tsBinaryHeader header;
+	struct tsMappedHeader *mapped;
+	struct tsBSplineImpl *impl;
+	unsigned char *base = NULL;
+	struct stat info;
+	size_t len = 0;
+	int fd;
+	tsError err;
+
+	ts_int_bspline_init(spline);
+	fd = open(path, O_RDONLY);
+	if (fd < 0)
+		TS_RETURN_0(status, TS_IO_ERROR, "unable to open file")
+	if (fstat(fd, &info) == 0 && info.st_size >= TS_INT_BINARY_HEADER) {
+		len = (size_t) info.st_size;
+		/* Private mappings are copy-on-write. Thus, the spline can be
+		 * modified without changing the file. */
+		base = (unsigned char *) mmap(NULL, len,
+			PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (base == (unsigned char *) MAP_FAILED)
+			base = NULL;
+	}
+	close(fd);
+	if (!base)
+		return ts_bspline_load_binary(path, spline, status);
+
+	TS_TRY(parse, err, status)
+		TS_CALL(parse, err, ts_int_binary_parse_header(
+			base, &header, status))
+		if (header.offset > len ||
+			len - header.offset < ts_int_binary_sof_data(&header)) {
+			TS_THROW_0(parse, err, status, TS_PARSE_ERROR,
+				"unexpected end of file")
+		}
+	TS_CATCH(err)
+		munmap(base, len);
+	TS_END_TRY_ROE(err)
+
+	/* The data can be used in place only if it is stored in the native
+	 * layout and there is enough space in front of it to store the impl
+	 * of the spline. Otherwise, fall back to copying. */
+	if (header.endianness != ts_int_binary_endianness() ||
+		header.sof_real != sizeof(tsReal) ||
+		header.offset < sof_impl + off + TS_INT_BINARY_HEADER ||
+		(header.offset - sof_impl - off) % TS_INT_ARENA_ALIGN != 0 ||
+		header.offset % sizeof(tsReal) != 0) {
+		munmap(base, len);
+		return ts_bspline_load_binary(path, spline, status);
+	}
+
+	if (verify && ts_int_adler32(1, base + header.offset,
+			ts_int_binary_sof_data(&header)) != header.checksum) {
+		munmap(base, len);
+		TS_RETURN_0(status, TS_PARSE_ERROR, "checksum mismatch")
+	}
+
+	/* The header of the file has been parsed and can be overwritten. */
+	mapped = (struct tsMappedHeader *)
+		(base + header.offset - sof_impl - off);
+	mapped->base = base;
+	mapped->len = len;
+	impl = (struct tsBSplineImpl *) (base + header.offset - sof_impl);
+	impl->deg = header.deg;
+	impl->dim = header.dim;
+	impl->n_ctrlp = header.n_ctrlp;
+	impl->n_knots = header.n_knots;
+	impl->allocator.allocate = ts_int_mapped_allocate;
+	impl->allocator.reallocate = ts_int_mapped_reallocate;
+	impl->allocator.deallocate = ts_int_mapped_deallocate;
+	impl->allocator.ctx = NULL;
+	spline->pImpl = impl;
+
+	if (verify) {
+		TS_TRY(check, err, status)
+			TS_CALL(check, err, ts_bspline_set_knots(spline,
+				ts_int_bspline_access_knots(spline), status))
+		TS_CATCH(err)
+			ts_bspline_free(spline);
+		TS_END_TRY_ROE(err)
+	}
+	TS_RETURN_SUCCESS(status)
+#else
+	(void) verify;
+	return ts_bspline_load_binary(path, spline, status);
+#endif
+}
 
 
 /******************************************************************************
@@ -2164,6 +9465,308 @@ tsReal ts_distance(const tsReal *x, const tsReal *y, size_t dimension)
 	return (tsReal) sqrt(sum);
 }
 
+#ifdef TINYSPLINE_HAVE_PTHREAD
+/* The worker threads of ts_executor_default. The threads are started when
+ * the executor is used for the first time and wait for jobs until the
+ * process exits. At most one job is processed at a time. */
+struct tsThreadPool
+{
+	pthread_mutex_t mutex;    /**< Guards all fields below. */
+	pthread_cond_t start;     /**< Signals a new job to the workers. */
+	pthread_cond_t done;      /**< Signals the last active worker. */
+	size_t num_workers;       /**< Number of started threads. */
+	unsigned long generation; /**< Incremented for each job. */
+	int busy;                 /**< Whether a job is being processed. */
+	size_t active;            /**< Number of threads processing the job. */
+	tsTask task;
+	void *args;
+	size_t num;               /**< Number of tasks. */
+	size_t next;              /**< Index of the next pending task. */
+	size_t chunk;             /**< Number of tasks claimed at once. */
+};
+
+static struct tsThreadPool ts_int_thread_pool;
+static pthread_once_t ts_int_thread_pool_once = PTHREAD_ONCE_INIT;
+
+/* Processes chunks of pending tasks of the current job of \p pool until no
+ * task is left. The mutex of \p pool must be locked when calling this
+ * function and is locked on return, but not while running tasks. */
+void ts_int_thread_pool_process(struct tsThreadPool *pool)
+{
+	size_t begin, end;
+	while (pool->next < pool->num) {
+		begin = pool->next;
+		end = pool->num - begin > pool->chunk ?
+			begin + pool->chunk : pool->num;
+		pool->next = end;
+		pthread_mutex_unlock(&pool->mutex);
+		for (; begin < end; begin++)
+			pool->task(pool->args, begin);
+		pthread_mutex_lock(&pool->mutex);
+	}
+}
+
+void *ts_int_thread_pool_worker(void *arg)
+{
+	struct tsThreadPool *pool = (struct tsThreadPool *) arg;
+	unsigned long generation = 0;
+	pthread_mutex_lock(&pool->mutex);
+	for (;;) {
+		while (generation == pool->generation)
+			pthread_cond_wait(&pool->start, &pool->mutex);
+		generation = pool->generation;
+		pool->active++;
+		ts_int_thread_pool_process(pool);
+		if (--pool->active == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	return NULL;
+}
+
+size_t ts_int_num_processors(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	const long num = sysconf(_SC_NPROCESSORS_ONLN);
+	return num > 1 ? (size_t) num : 1;
+#else
+	return 1;
+#endif
+}
+
+/* Starts one detached worker thread per online processor except for the
+ * calling thread. If the synchronization primitives cannot be initialized,
+ * no thread is started and all jobs are run sequentially. */
+void ts_int_thread_pool_init(void)
+{
+	struct tsThreadPool *pool = &ts_int_thread_pool;
+	const size_t num_threads = ts_int_num_processors();
+	pthread_attr_t attr;
+	pthread_t thread;
+	size_t i;
+
+	pool->num_workers = 0;
+	pool->generation = 0;
+	pool->busy = 0;
+	pool->active = 0;
+	pool->num = pool->next = 0;
+	if (num_threads < 2)
+		return;
+	if (pthread_mutex_init(&pool->mutex, NULL))
+		return;
+	if (pthread_cond_init(&pool->start, NULL)) {
+		pthread_mutex_destroy(&pool->mutex);
+		return;
+	}
+	if (pthread_cond_init(&pool->done, NULL)) {
+		pthread_cond_destroy(&pool->start);
+		pthread_mutex_destroy(&pool->mutex);
+		return;
+	}
+	if (pthread_attr_init(&attr))
+		return;
+	pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+	for (i = 0; i < num_threads - 1; i++) {
+		if (!pthread_create(&thread, &attr, ts_int_thread_pool_worker,
+				pool)) {
+			pool->num_workers++;
+		}
+	}
+	pthread_attr_destroy(&attr);
+}
+#endif
+
+void ts_int_executor_run(void *ctx, tsTask task, void *args, size_t num)
+{
+	size_t i;
+#ifdef TINYSPLINE_HAVE_PTHREAD
+	struct tsThreadPool *pool = &ts_int_thread_pool;
+
+	if (num > 1 && !pthread_once(&ts_int_thread_pool_once,
+			ts_int_thread_pool_init) && pool->num_workers > 0) {
+		pthread_mutex_lock(&pool->mutex);
+		/* Jobs submitted while the pool is busy (e.g., by a task of
+		 * the current job or by another thread) are run sequentially
+		 * in the calling thread. */
+		if (!pool->busy) {
+			pool->busy = 1;
+			pool->task = task;
+			pool->args = args;
+			pool->num = num;
+			pool->next = 0;
+			/* About four chunks per thread balance the load
+			 * while keeping the contention of the mutex low. */
+			pool->chunk = num / (4 * (pool->num_workers + 1));
+			if (pool->chunk == 0)
+				pool->chunk = 1;
+			pool->generation++;
+			pthread_cond_broadcast(&pool->start);
+			/* The calling thread is a worker as well. */
+			pool->active++;
+			ts_int_thread_pool_process(pool);
+			pool->active--;
+			while (pool->active > 0)
+				pthread_cond_wait(&pool->done, &pool->mutex);
+			pool->busy = 0;
+			pthread_mutex_unlock(&pool->mutex);
+			return;
+		}
+		pthread_mutex_unlock(&pool->mutex);
+	}
+#endif
+	(void) ctx;
+	for (i = 0; i < num; i++)
+		task(args, i);
+}
+
+tsExecutor ts_executor_default(void)
+{
+	tsExecutor executor;
+	executor.run = ts_int_executor_run;
+	executor.ctx = NULL;
+	return executor;
+}
+
+tsAllocator ts_allocator_default(void)
+{
+	tsAllocator allocator;
+	allocator.allocate = ts_int_default_allocate;
+	allocator.reallocate = ts_int_default_reallocate;
+	allocator.deallocate = ts_int_default_deallocate;
+	allocator.ctx = NULL;
+	return allocator;
+}
+
+tsAllocator ts_allocator_global(void)
+{
+	return ts_int_allocator;
+}
+
+void ts_allocator_set_global(const tsAllocator *allocator)
+{
+	ts_int_allocator = allocator ? *allocator : ts_allocator_default();
+}
+
+/* Allocates a chunk of \p size bytes from the arena \p ctx. Each chunk is
+ * preceded by a header of TS_INT_ARENA_ALIGN bytes that stores the size of
+ * the chunk (including the header). If the most recent block is exhausted, a
+ * new block is allocated whose capacity is (at least) twice as large. */
+void * ts_int_arena_allocate(void *ctx, size_t size)
+{
+	struct tsArenaImpl *impl = (struct tsArenaImpl *) ctx;
+	struct tsArenaBlock *block = impl->blocks;
+	size_t need, capacity;
+	char *chunk;
+
+	if (size > (size_t) -1 - 2 * TS_INT_ARENA_ALIGN)
+		return NULL;
+	need = TS_INT_ARENA_ALIGN + ts_int_arena_round(size);
+	if (block->capacity - block->used < need) {
+		capacity = block->capacity * 2;
+		if (capacity < need)
+			capacity = need;
+		block = ts_int_arena_block_new(capacity, impl->blocks);
+		if (!block)
+			return NULL;
+		impl->blocks = block;
+	}
+	chunk = ts_int_arena_block_data(block) + block->used;
+	*((size_t *) chunk) = need;
+	block->used += need;
+	return chunk + TS_INT_ARENA_ALIGN;
+}
+
+/* Resizes the chunk \p ptr of the arena \p ctx. The most recent chunk is
+ * resized in place if possible. */
+void * ts_int_arena_reallocate(void *ctx, void *ptr, size_t size)
+{
+	struct tsArenaBlock *block = ((struct tsArenaImpl *) ctx)->blocks;
+	char *chunk, *top;
+	size_t need, old;
+	void *result;
+
+	if (!ptr)
+		return ts_int_arena_allocate(ctx, size);
+	if (size > (size_t) -1 - 2 * TS_INT_ARENA_ALIGN)
+		return NULL;
+	chunk = (char *) ptr - TS_INT_ARENA_ALIGN;
+	old = *((size_t *) chunk);
+	need = TS_INT_ARENA_ALIGN + ts_int_arena_round(size);
+	if (need <= old)
+		return ptr;
+	top = ts_int_arena_block_data(block) + block->used;
+	if (chunk + old == top &&
+		block->capacity - block->used >= need - old) {
+		block->used += need - old;
+		*((size_t *) chunk) = need;
+		return ptr;
+	}
+	result = ts_int_arena_allocate(ctx, size);
+	if (result)
+		memcpy(result, ptr, old - TS_INT_ARENA_ALIGN);
+	return result;
+}
+
+/* Releases the chunk \p ptr of the arena \p ctx. Only the most recent chunk
+ * can be reclaimed. All other chunks are released on reset. */
+void ts_int_arena_deallocate(void *ctx, void *ptr)
+{
+	struct tsArenaBlock *block = ((struct tsArenaImpl *) ctx)->blocks;
+	char *chunk = (char *) ptr - TS_INT_ARENA_ALIGN;
+	const size_t size = *((size_t *) chunk);
+	if (chunk + size == ts_int_arena_block_data(block) + block->used)
+		block->used -= size;
+}
+
+tsAllocator ts_arena_allocator(const tsArena *arena)
+{
+	tsAllocator allocator;
+	allocator.allocate = ts_int_arena_allocate;
+	allocator.reallocate = ts_int_arena_reallocate;
+	allocator.deallocate = ts_int_arena_deallocate;
+	allocator.ctx = arena->pImpl;
+	return allocator;
+}
+
+void ts_arena_reset(tsArena *arena)
+{
+	struct tsArenaImpl *impl = arena->pImpl;
+	struct tsArenaBlock *block, *next, *merged;
+	size_t capacity = 0;
+	if (impl->blocks->next) {
+		for (block = impl->blocks; block; block = block->next)
+			capacity += block->capacity;
+		merged = ts_int_arena_block_new(capacity, NULL);
+		if (merged) {
+			for (block = impl->blocks; block; block = next) {
+				next = block->next;
+				free(block);
+			}
+			impl->blocks = merged;
+		}
+	}
+	/* If merging failed, the blocks are kept as they are. */
+	for (block = impl->blocks; block; block = block->next)
+		block->used = 0;
+}
+
+size_t ts_arena_used(const tsArena *arena)
+{
+	const struct tsArenaBlock *block;
+	size_t used = 0;
+	for (block = arena->pImpl->blocks; block; block = block->next)
+		used += block->used;
+	return used;
+}
+
+size_t ts_arena_capacity(const tsArena *arena)
+{
+	const struct tsArenaBlock *block;
+	size_t capacity = 0;
+	for (block = arena->pImpl->blocks; block; block = block->next)
+		capacity += block->capacity;
+	return capacity;
+}
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
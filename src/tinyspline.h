@@ -4,6 +4,7 @@
 #define TINYSPLINE_H
 
 #include <stddef.h>
+#include <stdio.h>
 
 #ifdef _MSC_VER
 #define TINYSPLINE_SHARED_EXPORT __declspec(dllexport)
@@ -211,7 +212,10 @@ typedef enum {
 	TS_NO_RESULT = -14,
 
 	/* Unexpected number of points. */
-	TS_NUM_POINTS = -15
+	TS_NUM_POINTS = -15,
+
+	/* Entities do not match (e.g., a plan and a spline). */
+	TS_INCOMPATIBLE = -16
 } tsError;
 
 /**
@@ -422,7 +426,14 @@ typedef enum
  *
  *     [x_0*w_0, y_0*w_0, w_0, x_1*w_1, y_1*w_1, w_1, ...]
  *
- * where 'w_i' is the weight of the i'th control point.
+ * where 'w_i' is the weight of the i'th control point. The control points of
+ * NURBS can be accessed in Cartesian coordinates with
+ * ts_bspline_rational_control_points and
+ * ts_bspline_set_rational_control_points. Functions that evaluate or
+ * transform a spline operate on the homogeneous coordinates. Thus, the
+ * points of, for example, ts_bspline_eval must be divided by their weight.
+ * ts_bspline_eval_rational, on the other hand, evaluates NURBS (and their
+ * derivatives) in Cartesian coordinates.
  */
 typedef struct
 {
@@ -492,6 +503,203 @@ typedef struct
 	struct tsDeBoorNetImpl *pImpl; /**< The actual implementation. */
 } tsDeBoorNet;
 
+/**
+ * Stores the basis functions of a spline evaluated at a fixed sequence of
+ * knots. A plan depends on the degree and the knot vector of a spline only
+ * (i.e., it is independent of the control points). For each knot u, the plan
+ * stores the index i of the first control point affecting u as well as the
+ * 'order' weights (basis function values) of the control points [i, i+order).
+ * Evaluating a spline with a plan (ts_evalplan_apply) is thus a sparse
+ * matrix-vector product which is well suited for splines whose control points
+ * change frequently while the knots remain unchanged (e.g., animations).
+ */
+typedef struct
+{
+	struct tsEvalPlanImpl *pImpl; /**< The actual implementation. */
+} tsEvalPlan;
+
+/**
+ * Interpolates a stream of points with a sequence of cubic bezier curves.
+ * Points are pushed in chunks (ts_streamfitter_push), each of which yields
+ * the segments that have been finalized in the meantime. The resultant
+ * segments are equal to the segments of ts_bspline_interpolate_cubic_natural
+ * applied to all points up to a (tiny) error caused by the limited look-ahead
+ * of the fitter: the system of linear equations of the natural cubic spline
+ * is solved with the Thomas algorithm whose forward sweep is causal, while
+ * the back substitution of a segment is carried out from the most recent
+ * point as soon as 'lookahead' further points are available. The influence
+ * of the omitted points decays by a factor of about 0.27 per point, i.e., a
+ * look-ahead of 20 points yields an error of about 1e-11 (relative to the
+ * magnitude of the points). A fitter stores at most 2 * lookahead + 1 points
+ * and the runtime of pushing a point is constant (amortized).
+ */
+typedef struct
+{
+	struct tsStreamFitterImpl *pImpl; /**< The actual implementation. */
+} tsStreamFitter;
+
+/**
+ * Maps arc lengths of a spline to knots (and vice versa), which is required
+ * for moving along a spline at constant speed. The table is created by
+ * integrating the speed (the norm of the first derivative) of a spline with
+ * an adaptive Gauss-Legendre quadrature, separately for each knot span. Each
+ * entry of the table stores a knot and the length of the spline up to this
+ * knot as well as the speed at this knot. A length is mapped to a knot by
+ * searching the enclosing entries (which takes O(log n) steps or, for
+ * ascending lengths, amortized constant time) and interpolating the knot of
+ * these entries with a cubic Hermite polynomial, whose slopes are given by
+ * the speeds. The interpolated knot can be refined with a few Newton steps.
+ * As the table stores the first derivative of the spline, it can be used
+ * independently of the spline.
+ */
+typedef struct
+{
+	struct tsArcLengthTableImpl *pImpl; /**< The actual implementation. */
+} tsArcLengthTable;
+
+/**
+ * Finds the points on a spline that are closest to query points (i.e.,
+ * projects query points onto a spline). A projector stores the Bezier
+ * segments of a spline (cf. ts_bspline_to_beziers) in the power basis along
+ * with a bounding volume hierarchy of axis-aligned boxes that enclose the
+ * control points of the segments. A query descends the hierarchy (closest
+ * box first) and skips all subtrees whose boxes are farther away than the
+ * closest point found so far. The closest point of a segment is found by
+ * sampling the segment and refining each local minimum of the samples with a
+ * safeguarded Newton iteration. Thus, a query takes O(log n) steps for most
+ * query points. As a projector stores the segments of the spline, it can be
+ * used independently of the spline. Queries do not modify a projector and
+ * can therefore run concurrently.
+ */
+typedef struct
+{
+	struct tsProjectorImpl *pImpl; /**< The actual implementation. */
+} tsProjector;
+
+/**
+ * Packs many splines into a single block of memory for evaluating all of them
+ * at once (cf. ts_bsplinecollection_eval and ts_bsplinecollection_eval_at).
+ * The splines of a collection are grouped by degree, dimension, and number of
+ * control points. The control points of a group are stored as structure of
+ * arrays, i.e., the values of the i-th control point of all splines of a
+ * group are contiguous. Thus, a group is evaluated with loops over its
+ * splines, which are vectorized by the compiler, and the groups are split
+ * into tiles that are evaluated in parallel. If all splines of a group have
+ * the same knot vector, it is stored only once. A collection is a snapshot
+ * of its splines, i.e., it can be used independently of them. Evaluations do
+ * not modify a collection and can therefore run concurrently.
+ */
+typedef struct
+{
+	/** The actual implementation. */
+	struct tsBSplineCollectionImpl *pImpl;
+} tsBSplineCollection;
+
+/**
+ * Represents a tensor product B-spline surface. A surface has a degree, a
+ * number of control points, and a knot vector in each parametric direction
+ * (u and v) as well as a net of num_control_points_u *
+ * num_control_points_v control points. The control net is stored row by
+ * row, i.e., the control point (i, j), where i is the index in u direction
+ * and j is the index in v direction, is located at:
+ *
+ *     ctrlp[(i * num_control_points_v + j) * dimension]
+ *
+ * Thus, each row of the control net is the control polygon of a spline in v
+ * direction. A surface is evaluated at a grid of knots with
+ * ts_bsplinesurface_eval_grid, which calculates the control points of the
+ * iso-curve of each u only once and reuses them for all v.
+ */
+typedef struct
+{
+	struct tsBSplineSurfaceImpl *pImpl; /**< The actual implementation. */
+} tsBSplineSurface;
+
+/**
+ * A task that can be scheduled by a tsExecutor. Parallel functions split their
+ * work into a number of independent tasks and pass a function of this type to
+ * tsExecutor::run. The function processes the task with index \p index using
+ * the (shared) arguments \p args.
+ */
+typedef void (*tsTask)(void *args, size_t index);
+
+/**
+ * Schedules the tasks of parallel functions (e.g., ts_bspline_eval_all_parallel)
+ * and allows to plug in any thread pool or scheduler. The function 'run' must
+ * call 'task(args, i)' exactly once for each 'i' in [0, num) and must not
+ * return until all calls have finished. The calls may run concurrently and in
+ * arbitrary order. The field 'ctx' is passed to 'run' as is. For example:
+ *
+ *     void run(void *ctx, tsTask task, void *args, size_t num)
+ *     {
+ *         size_t i;
+ *         #pragma omp parallel for schedule(dynamic)
+ *         for (i = 0; i < num; i++)
+ *             task(args, i);
+ *     }
+ *
+ * See ts_executor_default for an executor based on POSIX threads.
+ */
+typedef struct
+{
+	void (*run)(void *ctx, tsTask task, void *args, size_t num);
+	void *ctx; /**< User defined context passed to run. */
+} tsExecutor;
+
+/**
+ * Allocates, resizes, and releases the memory of TinySpline. The functions
+ * have the same semantics as malloc, realloc, and free, except that they
+ * receive the field 'ctx' as first argument. 'deallocate' is never called
+ * with NULL.
+ *
+ * All objects (splines, nets, plans, tables, ...) and temporary buffers are
+ * allocated with the global allocator (cf. ts_allocator_set_global), unless
+ * stated otherwise. An object remembers the allocator it has been allocated
+ * with and is released with this allocator, even if the global allocator has
+ * been changed in the meantime. Copies of an object and objects derived from
+ * a spline (for example, the nets of ts_bspline_eval and the results of
+ * transformations such as ts_bspline_insert_knot) are allocated with the
+ * allocator of the source object. Hence, the allocator can be selected per
+ * call by creating the input spline with ts_bspline_new_with_allocator or
+ * ts_bspline_copy_with_allocator. Arrays that are returned to the caller
+ * (for example, the control points of ts_bspline_control_points or the
+ * points of ts_bspline_sample) are always allocated with malloc and must be
+ * released with free.
+ *
+ * The tasks of some parallel functions (cf. tsExecutor) allocate memory,
+ * i.e., the allocators involved may be called concurrently by multiple
+ * threads and must be thread-safe if the executor runs tasks in parallel.
+ * This applies to ts_bspline_make_compatible and thus
+ * ts_bsplinesurface_loft. If these functions are called without executor
+ * (NULL) and the global allocator or the allocator of one of the input
+ * splines is not the default allocator (cf. ts_allocator_default), their
+ * tasks are run sequentially in the calling thread.
+ */
+typedef struct
+{
+	void *(*allocate)(void *ctx, size_t size);
+	void *(*reallocate)(void *ctx, void *ptr, size_t size);
+	void (*deallocate)(void *ctx, void *ptr);
+	void *ctx; /**< User defined context passed to the functions. */
+} tsAllocator;
+
+/**
+ * A bump allocator (cf. ts_arena_allocator) for short-lived objects. An
+ * arena hands out consecutive chunks of a preallocated block of memory.
+ * Releasing a chunk reclaims its memory only if it is the most recent
+ * allocation. Instead, all chunks are released at once by resetting the
+ * arena (ts_arena_reset), for example, at the end of a frame. Allocations
+ * that do not fit into the block are served from additional blocks, which
+ * are merged into a single block on reset. Thus, once an arena has grown to
+ * the size required by a frame, subsequent frames do not allocate any system
+ * memory. Arenas are not thread-safe and must not be shared among threads,
+ * including the tasks of a parallel function (cf. tsAllocator).
+ */
+typedef struct
+{
+	struct tsArenaImpl *pImpl; /**< The actual implementation. */
+} tsArena;
+
 
 
 /******************************************************************************
@@ -510,7 +718,9 @@ typedef struct
 size_t TINYSPLINE_API ts_bspline_degree(const tsBSpline *spline);
 
 /**
- * Sets the degree of \p spline.
+ * Sets the degree of \p spline. The control points and knots are kept as
+ * is, i.e., the shape of \p spline changes (cf. ts_bspline_elevate_degree
+ * and ts_bspline_reduce_degree).
  *
  * @param[out] spline
  * 	The spline whose degree is set.
@@ -699,6 +909,57 @@ tsError TINYSPLINE_API ts_bspline_set_control_points(tsBSpline *spline,
 tsError TINYSPLINE_API ts_bspline_set_control_point_at(tsBSpline *spline,
 	size_t index, const tsReal *ctrlp, tsStatus *status);
 
+/**
+ * Interprets \p spline as NURBS (cf. tsBSpline) and returns a deep copy of
+ * its control points in Cartesian coordinates (i.e., divided by their
+ * weight) and a deep copy of its weights. \p ctrlp receives
+ * ts_bspline_num_control_points(spline) points with
+ * ts_bspline_dimension(spline) - 1 values each, \p weights receives
+ * ts_bspline_num_control_points(spline) values.
+ *
+ * @param[in] spline
+ * 	The spline whose control points and weights are read.
+ * @param[out] ctrlp
+ * 	The output array of the Cartesian control points.
+ * @param[out] weights
+ * 	The output array of the weights.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If the dimension of \p spline is less than 2.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_rational_control_points(
+	const tsBSpline *spline, tsReal **ctrlp, tsReal **weights,
+	tsStatus *status);
+
+/**
+ * Interprets \p spline as NURBS (cf. tsBSpline) and sets its control points
+ * from the Cartesian control points \p ctrlp (with
+ * ts_bspline_dimension(spline) - 1 values each) and the corresponding
+ * \p weights, i.e., stores the homogeneous control points
+ * (w_i * x_i, w_i * y_i, ..., w_i). Weights must be positive.
+ *
+ * @param[out] spline
+ * 	The spline whose control points are set.
+ * @param[in] ctrlp
+ * 	The Cartesian control points to be set.
+ * @param[in] weights
+ * 	The weights of the control points.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If the dimension of \p spline is less than 2.
+ */
+tsError TINYSPLINE_API ts_bspline_set_rational_control_points(
+	tsBSpline *spline, const tsReal *ctrlp, const tsReal *weights,
+	tsStatus *status);
+
 /**
  * Returns the number of knots of \p spline.
  *
@@ -981,379 +1242,2344 @@ size_t TINYSPLINE_API ts_deboornet_sof_result(const tsDeBoorNet *net);
 tsError TINYSPLINE_API ts_deboornet_result(const tsDeBoorNet *net,
 	tsReal **result, tsStatus *status);
 
+/* ------------------------------------------------------------------------- */
 
+/**
+ * Returns the number of knots (and thus points) of \p plan.
+ *
+ * @param[in] plan
+ * 	The plan whose number of knots is read.
+ * @return
+ * 	The number of knots of \p plan.
+ */
+size_t TINYSPLINE_API ts_evalplan_num_points(const tsEvalPlan *plan);
 
-/******************************************************************************
-*                                                                             *
-* :: Constructors, Destructors, Copy, and Move Functions                      *
-*                                                                             *
-******************************************************************************/
 /**
- * Creates a new spline whose data points to NULL.
- * 
+ * Returns the degree of the spline \p plan was created for.
+ *
+ * @param[in] plan
+ * 	The plan whose degree is read.
  * @return
- * 	A new spline whose data points to NULL.
+ * 	The degree of the spline \p plan was created for.
  */
-tsBSpline TINYSPLINE_API ts_bspline_init();
+size_t TINYSPLINE_API ts_evalplan_degree(const tsEvalPlan *plan);
 
 /**
- * Creates a new spline and stores the result in \p spline.
+ * Returns the number of control points of the spline \p plan was created
+ * for.
  *
- * @param[in] num_control_points
- * 	The number of control points of \p spline.
- * @param[in] dimension
- * 	The dimension of each control point of \p spline.
- * @param[in] degree
- * 	The degree of \p spline.
- * @param[in] type
- * 	How to setup the knot vector of \p spline.
- * @param[out] spline
- * 	The output spline.
- * @param[out] status
- * 	The status of this function. May be NULL.
- * @return TS_SUCCESS
- * 	On success.
- * @return TS_DIM_ZERO
- * 	If \p dimension == 0.
- * @return TS_DEG_GE_NCTRLP
- * 	If \p degree >= \p num_control_points.
- * @return TS_NUM_KNOTS
- * 	If \p type == ::TS_BEZIERS and
- * 	(\p num_control_points % \p degree + 1) != 0.
- * @return TS_MALLOC
- * 	If allocating memory failed.
+ * @param[in] plan
+ * 	The plan whose number of control points is read.
+ * @return
+ * 	The number of control points of the spline \p plan was created for.
  */
-tsError TINYSPLINE_API ts_bspline_new(size_t num_control_points,
-	size_t dimension, size_t degree, tsBSplineType type, tsBSpline *spline,
-	tsStatus *status);
+size_t TINYSPLINE_API ts_evalplan_num_control_points(const tsEvalPlan *plan);
+
+/* ------------------------------------------------------------------------- */
 
 /**
- * Creates a new spline with given control points (varargs) and stores the
- * result in \p spline. As all splines have at least one control point (with
- * minimum dimensionality one), the first component of the first control point
- * has a named parameter. Note that, by design of varargs in C, the last named
- * parameter must not be float. Thus, \p first is of type double instead of
- * tsReal.
+ * Returns the dimensionality of the points of \p fitter.
  *
- * @param[in] num_control_points
- * 	The number of control points of \p spline.
- * @param[in] dimension
- * 	The dimension of each control point of \p spline.
- * @param[in] degree
- * 	The degree of \p spline.
- * @param[in] type
- * 	How to setup the knot vector of \p spline.
- * @param[out] spline
- * 	The output spline.
- * @param[out] status
- * 	The status of this function. May be NULL.
- * @param[in] first
- * 	The first component of the first control point to be set.
- * @param[in] ...
- * 	The remaining components (control points).
- * @return TS_SUCCESS
- * 	On success.
- * @return TS_DIM_ZERO
- * 	If \p dimension == 0.
- * @return TS_DEG_GE_NCTRLP
- * 	If \p degree >= \p num_control_points.
- * @return TS_NUM_KNOTS
- * 	If \p type == ::TS_BEZIERS and
- * 	(\p num_control_points % \p degree + 1) != 0.
- * @return TS_MALLOC
- * 	If allocating memory failed.
+ * @param[in] fitter
+ * 	The fitter whose dimension is read.
+ * @return
+ * 	The dimensionality of the points of \p fitter.
  */
-tsError TINYSPLINE_API ts_bspline_new_with_control_points(
-	size_t num_control_points, size_t dimension, size_t degree,
-	tsBSplineType type, tsBSpline *spline, tsStatus *status,
-	double first, ...);
+size_t TINYSPLINE_API ts_streamfitter_dimension(const tsStreamFitter *fitter);
 
 /**
- * Creates a deep copy of \p src and stores the copied values in \p dest. Does
- * nothing, if \p src == \p dest.
+ * Returns the number of points pushed to \p fitter since it has been created
+ * or finished (cf. ts_streamfitter_finish).
  *
- * @param[in] src
- * 	The spline to deep copy.
- * @param[out] dest
- * 	The output spline.
- * @param[out] status
- * 	The status of this function. May be NULL.
- * @return TS_SUCCESS
- * 	On success.
- * @return TS_MALLOC
- * 	If allocating memory failed.
+ * @param[in] fitter
+ * 	The fitter whose number of points is read.
+ * @return
+ * 	The number of points pushed to \p fitter.
  */
-tsError TINYSPLINE_API ts_bspline_copy(const tsBSpline *src, tsBSpline *dest,
-	tsStatus *status);
+size_t TINYSPLINE_API ts_streamfitter_num_points(
+	const tsStreamFitter *fitter);
+
+/* ------------------------------------------------------------------------- */
 
 /**
- * Moves the ownership of the data of \p src to \p dest. After calling this
- * function, the data of \p src points to NULL. Does not free the data of
- * \p dest. Does nothing, if \p src == \p dest.
- * 
- * @param[out] src
- * 	The spline whose values are moved to \p dest.
- * @param[out] dest
- * 	The spline that receives the values of \p src.
+ * Returns the number of entries of \p table.
+ *
+ * @param[in] table
+ * 	The table whose number of entries is read.
+ * @return
+ * 	The number of entries of \p table.
  */
-void TINYSPLINE_API ts_bspline_move(tsBSpline *src, tsBSpline *dest);
+size_t TINYSPLINE_API ts_arclengthtable_num_entries(
+	const tsArcLengthTable *table);
 
 /**
- * Frees the data of \p spline. After calling this function, the data of
- * \p spline points to NULL.
- * 
- * @param[out] spline
- * 	The spline to free.
+ * Returns the total length of the spline \p table has been created for.
+ *
+ * @param[in] table
+ * 	The table whose length is read.
+ * @return
+ * 	The total length of the spline \p table has been created for.
  */
-void TINYSPLINE_API ts_bspline_free(tsBSpline *spline);
+tsReal TINYSPLINE_API ts_arclengthtable_length(const tsArcLengthTable *table);
 
 /* ------------------------------------------------------------------------- */
 
 /**
- * Creates a new net whose data points to NULL.
- * 
+ * Returns the dimension of the query points of \p projector.
+ *
+ * @param[in] projector
+ * 	The projector whose dimension is read.
  * @return
- * 	A new net whose data points to NULL.
+ * 	The dimension of the query points of \p projector.
  */
-tsDeBoorNet TINYSPLINE_API ts_deboornet_init();
+size_t TINYSPLINE_API ts_projector_dimension(const tsProjector *projector);
 
 /**
- * Creates a deep copy of \p src and stores the copied values in \p dest. Does
- * nothing, if \p src == \p dest.
+ * Returns the number of Bezier segments of \p projector.
  *
- * @param[in] src
- * 	The net to deep copy.
- * @param[out] dest
- * 	The output net.
- * @param[out] status
- * 	The status of this function. May be NULL.
- * @return TS_SUCCESS
- * 	On success.
- * @return TS_MALLOC
- * 	If allocating memory failed.
+ * @param[in] projector
+ * 	The projector whose number of segments is read.
+ * @return
+ * 	The number of Bezier segments of \p projector.
  */
-tsError TINYSPLINE_API ts_deboornet_copy(const tsDeBoorNet *src,
-	tsDeBoorNet *dest, tsStatus *status);
+size_t TINYSPLINE_API ts_projector_num_segments(
+	const tsProjector *projector);
+
+/* ------------------------------------------------------------------------- */
 
 /**
- * Moves the ownership of the data of \p src to \p dest. After calling this
- * function, the data of \p src points to NULL. Does not free the data of
- * \p dest. Does nothing, if \p src == \p dest.
- * 
- * @param[out] src
- * 	The net whose values are moved to \p dest.
- * @param[out] dest
- * 	The net that receives the values of \p src.
+ * Returns the number of splines of \p collection.
+ *
+ * @param[in] collection
+ * 	The collection whose number of splines is read.
+ * @return
+ * 	The number of splines of \p collection.
  */
-void TINYSPLINE_API ts_deboornet_move(tsDeBoorNet *src, tsDeBoorNet *dest);
+size_t TINYSPLINE_API ts_bsplinecollection_num_splines(
+	const tsBSplineCollection *collection);
 
 /**
- * Frees the data of \p net. After calling this function, the data of \p net
- * points to NULL.
- * 
- * @param[out] net
- * 	The net to free.
+ * Returns the number of groups of \p collection, i.e., the number of distinct
+ * combinations of degree, dimension, and number of control points of its
+ * splines.
+ *
+ * @param[in] collection
+ * 	The collection whose number of groups is read.
+ * @return
+ * 	The number of groups of \p collection.
  */
-void TINYSPLINE_API ts_deboornet_free(tsDeBoorNet *net);
+size_t TINYSPLINE_API ts_bsplinecollection_num_groups(
+	const tsBSplineCollection *collection);
 
+/**
+ * Returns the number of values of the points of an evaluation of
+ * \p collection, i.e., the sum of the dimensions of its splines.
+ *
+ * @param[in] collection
+ * 	The collection whose length of points is read.
+ * @return
+ * 	The number of values of the points of an evaluation of \p collection.
+ */
+size_t TINYSPLINE_API ts_bsplinecollection_len_points(
+	const tsBSplineCollection *collection);
 
+/* ------------------------------------------------------------------------- */
 
-/******************************************************************************
-*                                                                             *
-* :: Interpolation and Approximation Functions                                *
-*                                                                             *
-******************************************************************************/
 /**
- * Interpolates a cubic spline with natural end conditions. For more details
- * see:
- * 
- *     https://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
+ * Returns the degree of \p surface in u direction.
+ *
+ * @param[in] surface
+ * 	The surface whose degree is read.
+ * @return
+ * 	The degree of \p surface in u direction.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_degree_u(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the degree of \p surface in v direction.
+ *
+ * @param[in] surface
+ * 	The surface whose degree is read.
+ * @return
+ * 	The degree of \p surface in v direction.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_degree_v(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the dimension of \p surface.
+ *
+ * @param[in] surface
+ * 	The surface whose dimension is read.
+ * @return
+ * 	The dimension of \p surface (>= 1).
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_dimension(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the number of control points of \p surface in u direction, i.e.,
+ * the number of rows of its control net.
+ *
+ * @param[in] surface
+ * 	The surface whose number of control points is read.
+ * @return
+ * 	The number of control points of \p surface in u direction.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_num_control_points_u(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the number of control points of \p surface in v direction, i.e.,
+ * the number of columns of its control net.
+ *
+ * @param[in] surface
+ * 	The surface whose number of control points is read.
+ * @return
+ * 	The number of control points of \p surface in v direction.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_num_control_points_v(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the length of the control net of \p surface, i.e.,
+ * num_control_points_u * num_control_points_v * dimension.
+ *
+ * @param[in] surface
+ * 	The surface whose length of the control net is read.
+ * @return
+ * 	The length of the control net of \p surface.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_len_control_points(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the number of knots of \p surface in u direction.
+ *
+ * @param[in] surface
+ * 	The surface whose number of knots is read.
+ * @return
+ * 	The number of knots of \p surface in u direction.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_num_knots_u(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns the number of knots of \p surface in v direction.
+ *
+ * @param[in] surface
+ * 	The surface whose number of knots is read.
+ * @return
+ * 	The number of knots of \p surface in v direction.
+ */
+size_t TINYSPLINE_API ts_bsplinesurface_num_knots_v(
+	const tsBSplineSurface *surface);
+
+/**
+ * Returns a deep copy of the control net of \p surface (cf.
+ * tsBSplineSurface).
+ *
+ * @param[in] surface
+ * 	The surface whose control net is read.
+ * @param[out] ctrlp
+ * 	The output array.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_control_points(
+	const tsBSplineSurface *surface, tsReal **ctrlp, tsStatus *status);
+
+/**
+ * Sets the control net of \p surface (cf. tsBSplineSurface). Creates a deep
+ * copy of \p ctrlp.
+ *
+ * @pre
+ * 	\p ctrlp has length ts_bsplinesurface_len_control_points.
+ * @param[out] surface
+ * 	The surface whose control net is set.
+ * @param[in] ctrlp
+ * 	The values to deep copy.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_set_control_points(
+	tsBSplineSurface *surface, const tsReal *ctrlp, tsStatus *status);
+
+/**
+ * Returns a deep copy of the knot vector of \p surface in u direction.
+ *
+ * @param[in] surface
+ * 	The surface whose knot vector is read.
+ * @param[out] knots
+ * 	The output array.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_knots_u(
+	const tsBSplineSurface *surface, tsReal **knots, tsStatus *status);
+
+/**
+ * Returns a deep copy of the knot vector of \p surface in v direction.
+ *
+ * @param[in] surface
+ * 	The surface whose knot vector is read.
+ * @param[out] knots
+ * 	The output array.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_knots_v(
+	const tsBSplineSurface *surface, tsReal **knots, tsStatus *status);
+
+/**
+ * Sets the knot vector of \p surface in u direction (cf.
+ * ts_bspline_set_knots).
+ *
+ * @pre
+ * 	\p knots has length ts_bsplinesurface_num_knots_u.
+ * @param[out] surface
+ * 	The surface whose knot vector is set.
+ * @param[in] knots
+ * 	The knot vector to deep copy.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity > order.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_set_knots_u(
+	tsBSplineSurface *surface, const tsReal *knots, tsStatus *status);
+
+/**
+ * Sets the knot vector of \p surface in v direction (cf.
+ * ts_bspline_set_knots).
+ *
+ * @pre
+ * 	\p knots has length ts_bsplinesurface_num_knots_v.
+ * @param[out] surface
+ * 	The surface whose knot vector is set.
+ * @param[in] knots
+ * 	The knot vector to deep copy.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity > order.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_set_knots_v(
+	tsBSplineSurface *surface, const tsReal *knots, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Constructors, Destructors, Copy, and Move Functions                      *
+*                                                                             *
+******************************************************************************/
+/**
+ * Creates a new spline whose data points to NULL.
+ * 
+ * @return
+ * 	A new spline whose data points to NULL.
+ */
+tsBSpline TINYSPLINE_API ts_bspline_init();
+
+/**
+ * Creates a new spline and stores the result in \p spline.
+ *
+ * @param[in] num_control_points
+ * 	The number of control points of \p spline.
+ * @param[in] dimension
+ * 	The dimension of each control point of \p spline.
+ * @param[in] degree
+ * 	The degree of \p spline.
+ * @param[in] type
+ * 	How to setup the knot vector of \p spline.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension == 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If \p degree >= \p num_control_points.
+ * @return TS_NUM_KNOTS
+ * 	If \p type == ::TS_BEZIERS and
+ * 	(\p num_control_points % \p degree + 1) != 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_new(size_t num_control_points,
+	size_t dimension, size_t degree, tsBSplineType type, tsBSpline *spline,
+	tsStatus *status);
+
+/**
+ * Creates a new spline whose data is allocated with \p allocator (cf.
+ * tsAllocator) and stores the result in \p spline. If \p allocator is NULL,
+ * the global allocator is used (which is equivalent to ts_bspline_new).
+ *
+ * @param[in] num_control_points
+ * 	The number of control points of \p spline.
+ * @param[in] dimension
+ * 	The dimension of each control point of \p spline.
+ * @param[in] degree
+ * 	The degree of \p spline.
+ * @param[in] type
+ * 	How to setup the knot vector of \p spline.
+ * @param[in] allocator
+ * 	The allocator of \p spline. May be NULL.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension == 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If \p degree >= \p num_control_points.
+ * @return TS_NUM_KNOTS
+ * 	If \p type == ::TS_BEZIERS and
+ * 	(\p num_control_points % \p degree + 1) != 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_new_with_allocator(
+	size_t num_control_points, size_t dimension, size_t degree,
+	tsBSplineType type, const tsAllocator *allocator, tsBSpline *spline,
+	tsStatus *status);
+
+/**
+ * Creates a new spline with given control points (varargs) and stores the
+ * result in \p spline. As all splines have at least one control point (with
+ * minimum dimensionality one), the first component of the first control point
+ * has a named parameter. Note that, by design of varargs in C, the last named
+ * parameter must not be float. Thus, \p first is of type double instead of
+ * tsReal.
+ *
+ * @param[in] num_control_points
+ * 	The number of control points of \p spline.
+ * @param[in] dimension
+ * 	The dimension of each control point of \p spline.
+ * @param[in] degree
+ * 	The degree of \p spline.
+ * @param[in] type
+ * 	How to setup the knot vector of \p spline.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @param[in] first
+ * 	The first component of the first control point to be set.
+ * @param[in] ...
+ * 	The remaining components (control points).
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension == 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If \p degree >= \p num_control_points.
+ * @return TS_NUM_KNOTS
+ * 	If \p type == ::TS_BEZIERS and
+ * 	(\p num_control_points % \p degree + 1) != 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_new_with_control_points(
+	size_t num_control_points, size_t dimension, size_t degree,
+	tsBSplineType type, tsBSpline *spline, tsStatus *status,
+	double first, ...);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest. The copy is allocated with the allocator of
+ * \p src (cf. tsAllocator).
+ *
+ * @param[in] src
+ * 	The spline to deep copy.
+ * @param[out] dest
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_copy(const tsBSpline *src, tsBSpline *dest,
+	tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src whose data is allocated with \p allocator
+ * (cf. tsAllocator) and stores the copied values in \p dest. If \p allocator
+ * is NULL, the global allocator is used. This function can be used to move a
+ * spline out of an arena (cf. tsArena) before resetting it. If \p src ==
+ * \p dest, the data of \p src is reallocated with \p allocator.
+ *
+ * @param[in] src
+ * 	The spline to deep copy.
+ * @param[in] allocator
+ * 	The allocator of \p dest. May be NULL.
+ * @param[out] dest
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_copy_with_allocator(const tsBSpline *src,
+	const tsAllocator *allocator, tsBSpline *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ * 
+ * @param[out] src
+ * 	The spline whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The spline that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_bspline_move(tsBSpline *src, tsBSpline *dest);
+
+/**
+ * Frees the data of \p spline. After calling this function, the data of
+ * \p spline points to NULL.
+ * 
+ * @param[out] spline
+ * 	The spline to free.
+ */
+void TINYSPLINE_API ts_bspline_free(tsBSpline *spline);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new net whose data points to NULL.
+ * 
+ * @return
+ * 	A new net whose data points to NULL.
+ */
+tsDeBoorNet TINYSPLINE_API ts_deboornet_init();
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest. Does
+ * nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The net to deep copy.
+ * @param[out] dest
+ * 	The output net.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_deboornet_copy(const tsDeBoorNet *src,
+	tsDeBoorNet *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ * 
+ * @param[out] src
+ * 	The net whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The net that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_deboornet_move(tsDeBoorNet *src, tsDeBoorNet *dest);
+
+/**
+ * Frees the data of \p net. After calling this function, the data of \p net
+ * points to NULL.
+ * 
+ * @param[out] net
+ * 	The net to free.
+ */
+void TINYSPLINE_API ts_deboornet_free(tsDeBoorNet *net);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new plan whose data points to NULL.
+ *
+ * @return
+ * 	A new plan whose data points to NULL.
+ */
+tsEvalPlan TINYSPLINE_API ts_evalplan_init();
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The plan to deep copy.
+ * @param[out] dest
+ * 	The output plan.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_evalplan_copy(const tsEvalPlan *src,
+	tsEvalPlan *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The plan whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The plan that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_evalplan_move(tsEvalPlan *src, tsEvalPlan *dest);
+
+/**
+ * Frees the data of \p plan. After calling this function, the data of
+ * \p plan points to NULL.
+ *
+ * @param[out] plan
+ * 	The plan to free.
+ */
+void TINYSPLINE_API ts_evalplan_free(tsEvalPlan *plan);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new fitter whose data points to NULL.
+ *
+ * @return
+ * 	A new fitter whose data points to NULL.
+ */
+tsStreamFitter TINYSPLINE_API ts_streamfitter_init();
+
+/**
+ * Creates a new fitter (cf. tsStreamFitter) for points of dimensionality
+ * \p dimension. The segments of the resultant spline are finalized as soon
+ * as \p lookahead points follow them. If \p lookahead is 0, a default value
+ * of 20 is used.
+ *
+ * @param[in] dimension
+ * 	The dimensionality of the points.
+ * @param[in] lookahead
+ * 	The number of points required to finalize a segment.
+ * @param[out] fitter
+ * 	The output fitter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension is 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_streamfitter_new(size_t dimension, size_t lookahead,
+	tsStreamFitter *fitter, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The fitter to deep copy.
+ * @param[out] dest
+ * 	The output fitter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_streamfitter_copy(const tsStreamFitter *src,
+	tsStreamFitter *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The fitter whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The fitter that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_streamfitter_move(tsStreamFitter *src,
+	tsStreamFitter *dest);
+
+/**
+ * Frees the data of \p fitter. After calling this function, the data of
+ * \p fitter points to NULL.
+ *
+ * @param[out] fitter
+ * 	The fitter to free.
+ */
+void TINYSPLINE_API ts_streamfitter_free(tsStreamFitter *fitter);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new table whose data points to NULL.
+ *
+ * @return
+ * 	A new table whose data points to NULL.
+ */
+tsArcLengthTable TINYSPLINE_API ts_arclengthtable_init();
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The table to deep copy.
+ * @param[out] dest
+ * 	The output table.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arclengthtable_copy(const tsArcLengthTable *src,
+	tsArcLengthTable *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The table whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The table that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_arclengthtable_move(tsArcLengthTable *src,
+	tsArcLengthTable *dest);
+
+/**
+ * Frees the data of \p table. After calling this function, the data of
+ * \p table points to NULL.
+ *
+ * @param[out] table
+ * 	The table to free.
+ */
+void TINYSPLINE_API ts_arclengthtable_free(tsArcLengthTable *table);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new projector whose data points to NULL.
+ *
+ * @return
+ * 	A new projector whose data points to NULL.
+ */
+tsProjector TINYSPLINE_API ts_projector_init();
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The projector to deep copy.
+ * @param[out] dest
+ * 	The output projector.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_projector_copy(const tsProjector *src,
+	tsProjector *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The projector whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The projector that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_projector_move(tsProjector *src, tsProjector *dest);
+
+/**
+ * Frees the data of \p projector. After calling this function, the data of
+ * \p projector points to NULL.
+ *
+ * @param[out] projector
+ * 	The projector to free.
+ */
+void TINYSPLINE_API ts_projector_free(tsProjector *projector);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new collection whose data points to NULL.
+ *
+ * @return
+ * 	A new collection whose data points to NULL.
+ */
+tsBSplineCollection TINYSPLINE_API ts_bsplinecollection_init();
+
+/**
+ * Creates a collection (cf. tsBSplineCollection) of the splines \p splines.
+ * The control points and knots of \p splines are copied, i.e., subsequent
+ * modifications of \p splines do not affect \p collection.
+ *
+ * @param[in] splines
+ * 	The splines to pack.
+ * @param[in] num
+ * 	The number of splines in \p splines.
+ * @param[out] collection
+ * 	The output collection.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinecollection_new(const tsBSpline *splines,
+	size_t num, tsBSplineCollection *collection, tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The collection to deep copy.
+ * @param[out] dest
+ * 	The output collection.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinecollection_copy(
+	const tsBSplineCollection *src, tsBSplineCollection *dest,
+	tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The collection whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The collection that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_bsplinecollection_move(tsBSplineCollection *src,
+	tsBSplineCollection *dest);
+
+/**
+ * Frees the data of \p collection. After calling this function, the data of
+ * \p collection points to NULL.
+ *
+ * @param[out] collection
+ * 	The collection to free.
+ */
+void TINYSPLINE_API ts_bsplinecollection_free(
+	tsBSplineCollection *collection);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new surface whose data points to NULL.
+ *
+ * @return
+ * 	A new surface whose data points to NULL.
+ */
+tsBSplineSurface TINYSPLINE_API ts_bsplinesurface_init();
+
+/**
+ * Creates a surface (cf. tsBSplineSurface) with the given number of control
+ * points, dimension, and degrees. The knot vectors of both directions are
+ * set up according to \p type (cf. ts_bspline_new). The values of the
+ * control net are set to 0.
+ *
+ * @param[in] num_control_points_u
+ * 	The number of control points in u direction.
+ * @param[in] num_control_points_v
+ * 	The number of control points in v direction.
+ * @param[in] dimension
+ * 	The dimension of the control points.
+ * @param[in] degree_u
+ * 	The degree in u direction.
+ * @param[in] degree_v
+ * 	The degree in v direction.
+ * @param[in] type
+ * 	How to setup the knot vectors.
+ * @param[out] surface
+ * 	The output surface.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension == 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If a degree >= the corresponding number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If \p type == TS_BEZIERS and a number of control points is not a
+ * 	multiple of the corresponding order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_new(size_t num_control_points_u,
+	size_t num_control_points_v, size_t dimension, size_t degree_u,
+	size_t degree_v, tsBSplineType type, tsBSplineSurface *surface,
+	tsStatus *status);
+
+/**
+ * Creates a deep copy of \p src and stores the copied values in \p dest.
+ * Does nothing, if \p src == \p dest.
+ *
+ * @param[in] src
+ * 	The surface to deep copy.
+ * @param[out] dest
+ * 	The output surface.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_copy(const tsBSplineSurface *src,
+	tsBSplineSurface *dest, tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest.
+ *
+ * @param[out] src
+ * 	The surface whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The surface that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_bsplinesurface_move(tsBSplineSurface *src,
+	tsBSplineSurface *dest);
+
+/**
+ * Frees the data of \p surface. After calling this function, the data of
+ * \p surface points to NULL.
+ *
+ * @param[out] surface
+ * 	The surface to free.
+ */
+void TINYSPLINE_API ts_bsplinesurface_free(tsBSplineSurface *surface);
+
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Creates a new arena whose data points to NULL.
+ *
+ * @return
+ * 	A new arena whose data points to NULL.
+ */
+tsArena TINYSPLINE_API ts_arena_init();
+
+/**
+ * Creates a new arena (cf. tsArena) with an initial block of \p capacity
+ * bytes. If \p capacity is 0, a default value of 64 KiB is used. The memory
+ * of an arena is allocated with malloc.
+ *
+ * @param[in] capacity
+ * 	The initial capacity of \p arena in bytes.
+ * @param[out] arena
+ * 	The output arena.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arena_new(size_t capacity, tsArena *arena,
+	tsStatus *status);
+
+/**
+ * Moves the ownership of the data of \p src to \p dest. After calling this
+ * function, the data of \p src points to NULL. Does not free the data of
+ * \p dest. Does nothing, if \p src == \p dest. Allocators obtained from
+ * \p src (cf. ts_arena_allocator) remain valid.
+ *
+ * @param[out] src
+ * 	The arena whose values are moved to \p dest.
+ * @param[out] dest
+ * 	The arena that receives the values of \p src.
+ */
+void TINYSPLINE_API ts_arena_move(tsArena *src, tsArena *dest);
+
+/**
+ * Frees the data of \p arena, including all chunks allocated from
+ * \p arena. After calling this function, the data of \p arena points to
+ * NULL.
+ *
+ * @param[out] arena
+ * 	The arena to free.
+ */
+void TINYSPLINE_API ts_arena_free(tsArena *arena);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Interpolation and Approximation Functions                                *
+*                                                                             *
+******************************************************************************/
+/**
+ * Interpolates a cubic spline with natural end conditions. For more details
+ * see:
+ * 
+ *     https://en.wikipedia.org/wiki/Tridiagonal_matrix_algorithm
  *     http://www.math.ucla.edu/~baker/149.1.02w/handouts/dd_splines.pdf
  *     http://www.bakoma-tex.com/doc/generic/pst-bspline/pst-bspline-doc.pdf
  *
- * The resultant spline is a sequence of bezier curves connecting each point
- * in \p points. Each bezier curve is of degree 3 with dimensionality
- * \p dimension. The total number of control points is:
+ * The resultant spline is a sequence of bezier curves connecting each point
+ * in \p points. Each bezier curve is of degree 3 with dimensionality
+ * \p dimension. The total number of control points is:
+ *
+ *     min(1, \p num_points - 1) * 4
+ *
+ * Note: \p num_points is the number of points in \p points and not the length
+ * of \p points. For instance, the following point vector has
+ * \p num_points = 4 and \p dimension = 2:
+ * 
+ *     [x0, y0, x1, y1, x2, y2, x3, y3]
+ *
+ * @param[in] points
+ * 	The points to interpolate.
+ * @param[in] num_points
+ * 	The number of points in \p points.
+ * @param[in] dimension
+ * 	The dimension of each control point in \p spline.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension is 0.
+ * @return TS_NUM_POINTS
+ * 	If \p num_points is 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_interpolate_cubic_natural(
+	const tsReal *points, size_t num_points, size_t dimension,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Interpolates a piecewise cubic spline by translating the given catmull-rom
+ * control points into a sequence of bezier curves. In order to avoid division
+ * by zero, successive control points with distance less than or equal to
+ * \p epsilon are filtered out. If the resultant sequence contains only a
+ * single point, a spline of degree 0 (a point) is created. Optionally, the
+ * first and last control point can be specified (\p first and \p last).
+ *
+ * @param[in] points
+ * 	The points to interpolate.
+ * @param[in] num_points
+ * 	The number of points in \p points.
+ * @param[in] dimension
+ * 	The dimensionality of the points.
+ * @param[in] alpha
+ * 	The knot parameterization: 0 => uniform, 0.5 => centripetal,
+ * 	1 => chordal. The input value is automatically trimmed to the [0, 1]
+ * 	interval.
+ * @param[in] first
+ * 	The first control point of the catmull-rom sequence. If NULL, an
+ * 	appropriate point is generated based on the first two points in
+ * 	\p points. If the distance between \p first and the first control point
+ * 	in \p points is less than or equals to \p epsilon, \p first is treated
+ * 	as NULL. This is necessary to avoid division by zero.
+ * @param[in] last
+ * 	The last control point of the catmull-rom sequence. If NULL, an
+ * 	appropriate point is generated based on the last two points in
+ * 	\p points. If the distance between \p last and the last control point
+ * 	in \p points is less than or equals to \p epsilon, \p last is treated
+ * 	as NULL. This is necessary to avoid division by zero.
+ * @param[in] epsilon
+ * 	The maximum distance between points with "same" coordinates. That is,
+ * 	if the distance between neighboring points is less than or equal to
+ * 	\p epsilon, they are considered equal. For the sake of fail-safeness,
+ * 	the sign is removed with fabs. It is advisable to pass a value greater
+ * 	than zero, however, it is not necessary.
+ * @param[out] spline
+ * 	The interpolated spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension is 0.
+ * @return TS_NUM_POINTS
+ * 	If \p num_points is 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_interpolate_catmull_rom(const tsReal *points,
+	size_t num_points, size_t dimension, tsReal alpha, const tsReal *first,
+	const tsReal *last, tsReal epsilon, tsBSpline *spline,
+	tsStatus *status);
+
+/**
+ * Approximates \p points with a clamped spline of degree \p degree that has
+ * \p num_control_points control points. Unlike the interpolation functions,
+ * the size of the resultant spline does not depend on the number of points,
+ * which makes this function suitable for compressing large point clouds.
+ *
+ * The points are parametrized by chord length and the knots are chosen such
+ * that each knot span contains at least one parameter (cf. 'The NURBS Book',
+ * Section 9.4.1). The first and last control point are equal to the first
+ * and last point in \p points. The remaining control points minimize the sum
+ * of squared distances between the points and the spline evaluated at their
+ * parameters. The corresponding normal equations form a symmetric band
+ * matrix with bandwidth \p degree, which is solved with a banded Cholesky
+ * decomposition. Thus, the runtime is linear in \p num_points and
+ * \p num_control_points.
+ *
+ * If \p num_points is equal to \p num_control_points, the points are
+ * interpolated.
+ *
+ * @param[in] points
+ * 	The points to approximate.
+ * @param[in] num_points
+ * 	The number of points in \p points.
+ * @param[in] dimension
+ * 	The dimensionality of the points.
+ * @param[in] num_control_points
+ * 	The number of control points of \p spline.
+ * @param[in] degree
+ * 	The degree of \p spline.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p dimension is 0.
+ * @return TS_NUM_POINTS
+ * 	If \p num_control_points < 2 or \p num_points < \p num_control_points.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If \p degree >= \p num_control_points.
+ * @return TS_MULTIPLICITY
+ * 	If too many points coincide such that the multiplicity of a knot
+ * 	exceeds the order of \p spline.
+ * @return TS_NO_RESULT
+ * 	If the normal equations are singular (e.g., because of coinciding
+ * 	points).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_approximate(const tsReal *points,
+	size_t num_points, size_t dimension, size_t num_control_points,
+	size_t degree, tsBSpline *spline, tsStatus *status);
+
+/**
+ * Pushes \p num_points points to \p fitter and stores the control points of
+ * the segments (cubic bezier curves) that have been finalized thereby in
+ * \p segments. The number of segments is stored in \p num_segments, that
+ * is, \p segments has num_segments * 4 * ts_streamfitter_dimension(fitter)
+ * values. If no segment has been finalized, \p segments is set to NULL and
+ * \p num_segments is set to 0. The segments of successive calls connect to
+ * each other and form a spline of type TS_BEZIERS, which can be created with
+ * ts_bspline_new and ts_bspline_set_control_points.
+ *
+ * On error, \p fitter is not modified, \p segments is set to NULL, and
+ * \p num_segments is set to 0.
+ *
+ * @param[in, out] fitter
+ * 	The fitter to push the points to.
+ * @param[in] points
+ * 	The points to push.
+ * @param[in] num_points
+ * 	The number of points in \p points.
+ * @param[out] segments
+ * 	The control points of the finalized segments.
+ * @param[out] num_segments
+ * 	The number of finalized segments.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_streamfitter_push(tsStreamFitter *fitter,
+	const tsReal *points, size_t num_points, tsReal **segments,
+	size_t *num_segments, tsStatus *status);
+
+/**
+ * Finalizes the remaining segments of \p fitter (i.e., the most recent point
+ * is treated as end point of a natural cubic spline) and stores their control
+ * points in \p segments (cf. ts_streamfitter_push). If only a single point
+ * has been pushed, a single segment whose control points are equal to this
+ * point is created (cf. ts_bspline_interpolate_cubic_natural). Afterwards,
+ * \p fitter is reset and can be used to fit a new stream of points.
+ *
+ * On error, \p fitter is not modified, \p segments is set to NULL, and
+ * \p num_segments is set to 0.
+ *
+ * @param[in, out] fitter
+ * 	The fitter to finish.
+ * @param[out] segments
+ * 	The control points of the remaining segments.
+ * @param[out] num_segments
+ * 	The number of remaining segments.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_streamfitter_finish(tsStreamFitter *fitter,
+	tsReal **segments, size_t *num_segments, tsStatus *status);
+
+/**
+ * Creates a surface that interpolates the curves \p sections (skinning).
+ * The sections are made compatible first (cf. ts_bspline_make_compatible)
+ * so that they form the rows of the control net of an interpolation problem
+ * in u direction, i.e., section k is the iso-curve of \p surface at u = u_k
+ * and the domain of each section is mapped to [0, 1] in v direction. The
+ * parameters u_k are the chord lengths between the control points of
+ * adjacent sections averaged over all columns of the control net, and the
+ * knots in u direction are calculated by averaging (cf. 'The NURBS Book',
+ * Section 10.3). The resulting collocation matrix is banded and totally
+ * positive and is decomposed without pivoting only once. The columns of the
+ * control net are then solved in blocks by separate tasks scheduled by
+ * \p executor. If \p executor is NULL, ts_executor_default is used.
+ *
+ * The degree of \p surface in u direction is min(\p degree, \p num - 1),
+ * its degree in v direction is the maximum degree of \p sections.
+ *
+ * @param[in] sections
+ * 	The section curves (e.g., the aerofoils of a wing from root to tip).
+ * @param[in] num
+ * 	The number of splines in \p sections.
+ * @param[in] degree
+ * 	The degree of \p surface in u direction.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] surface
+ * 	The output surface.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NUM_POINTS
+ * 	If \p num < 2.
+ * @return TS_INCOMPATIBLE
+ * 	If the dimensions of \p sections differ.
+ * @return TS_U_UNDEFINED
+ * 	If the domain of a section is empty.
+ * @return TS_NO_RESULT
+ * 	If the collocation matrix is singular (e.g., because of coinciding
+ * 	sections).
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_loft(const tsBSpline *sections,
+	size_t num, size_t degree, const tsExecutor *executor,
+	tsBSplineSurface *surface, tsStatus *status);
+
+
+
+/******************************************************************************
+*                                                                             *
+* :: Query Functions                                                          *
+*                                                                             *
+******************************************************************************/
+/**
+ * Evaluates \p spline at knot \p u and stores the result (cf. tsDeBoorNet) in
+ * \p net.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[out] net
+ * 	The output parameter
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval(const tsBSpline *spline, tsReal u,
+	tsDeBoorNet *net, tsStatus *status);
+
+/**
+ * Evaluates \p spline at knot \p u and stores the resultant point in
+ * \p point, which must provide space for at least
+ * ts_bspline_dimension(spline) values. Like ts_bspline_eval_all, only the
+ * first point of the evaluation result is taken if \p spline is
+ * discontinuous at \p u. The point is equal to the result of
+ * ts_bspline_eval.
+ *
+ * Unlike ts_bspline_eval, this function does not create a tsDeBoorNet.
+ * Instead, only the current column of the net is kept in \p workspace,
+ * which must provide space for at least ts_bspline_order(spline) *
+ * ts_bspline_dimension(spline) values (a workspace of
+ * ts_bspline_len_eval_workspace(spline) values is sufficient as well). If
+ * \p workspace is NULL, a workspace on the stack is used for splines whose
+ * order times dimension does not exceed 64, and a temporary workspace is
+ * allocated otherwise. Thus, evaluating a single point does not allocate any
+ * memory for common splines and for all splines if \p workspace is given.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[out] point
+ * 	The output buffer. If this function fails, the values of \p point
+ * 	are undefined.
+ * @param[in] workspace
+ * 	The scratch memory used for evaluation. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If \p workspace is NULL and allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_point(const tsBSpline *spline,
+	tsReal u, tsReal *point, tsReal *workspace, tsStatus *status);
+
+/**
+ * Evaluates \p spline at knots \p us and stores the resultant points in
+ * \p points. If \p us contains one or more knots where \p spline is
+ * discontinuous at, only the first point of the corresponding evaluation
+ * result is taken. After calling this function \p points contains exactly
+ * \p num * ts_bspline_dimension(spline) values.
+ *
+ * This function allocates \p points as well as a workspace of
+ * ts_bspline_len_eval_workspace(spline) values and passes both to
+ * ts_bspline_eval_batch. Use ts_bspline_eval_batch directly if you need to
+ * evaluate a multitude of knots without any memory allocation.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_all(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal **points, tsStatus *status);
+
+/**
+ * Returns the number of values (tsReal) required by the workspace of
+ * ts_bspline_eval_batch. The workspace is large enough to evaluate several
+ * knots simultaneously, that is, the returned value is a multiple of:
+ *
+ * 	ts_bspline_order(spline) * ts_bspline_dimension(spline)
+ *
+ * @param[in] spline
+ * 	The spline whose workspace length is calculated.
+ * @return
+ * 	The number of values required by the workspace of
+ * 	ts_bspline_eval_batch.
+ */
+size_t TINYSPLINE_API ts_bspline_len_eval_workspace(const tsBSpline *spline);
+
+/**
+ * Evaluates \p spline at knots \p us and stores the resultant points in
+ * \p points, which must provide space for at least
+ * \p num * ts_bspline_dimension(spline) values. Like ts_bspline_eval_all, only
+ * the first point of the evaluation result is taken if \p spline is
+ * discontinuous at a knot.
+ *
+ * Unlike ts_bspline_eval_all, this function does not allocate any memory.
+ * Instead of creating a complete tsDeBoorNet for each knot, only the current
+ * column of the net is kept in \p workspace, which must provide space for at
+ * least ts_bspline_len_eval_workspace(spline) values. Thus, the same output
+ * buffer and workspace can be reused for an arbitrary number of calls.
+ *
+ * Points of dimension 2, 3, and 4 are calculated with specialized SIMD
+ * kernels (SSE2 or NEON, depending on the target platform). Furthermore,
+ * consecutive knots located in the same knot span are evaluated
+ * simultaneously, one knot per SIMD lane (using AVX if supported by the
+ * CPU at runtime). All kernels perform the same floating point operations
+ * in the same order. Hence, the points are equal to the results of
+ * ts_bspline_eval (within TS_CONTROL_POINT_EPSILON, if the compiler contracts
+ * the operations of the scalar code). Define TINYSPLINE_DISABLE_SIMD when
+ * compiling TinySpline to disable the SIMD kernels.
+ *
+ * Knots in \p us may be given in any order. However, if a knot is greater
+ * than or equal to its predecessor, the knot span of the predecessor is
+ * walked forward (exponentially) instead of searching the whole knot vector.
+ * Thus, evaluating an ascending sequence of m knots (as generated by
+ * ts_bspline_sample) takes O(n + m) knot lookups in total, where n is the
+ * number of knots of \p spline, rather than O(m log n).
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] points
+ * 	The output buffer. If this function fails, the values of \p points
+ * 	are undefined.
+ * @param[in] workspace
+ * 	The scratch memory used for evaluation.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_batch(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsReal *points, tsReal *workspace,
+	tsStatus *status);
+
+/**
+ * Returns the number of values (tsReal) required by the workspace of
+ * ts_bspline_eval_derivatives and ts_bspline_eval_derivatives_batch when
+ * evaluating the first \p n derivatives of \p spline.
+ *
+ * @param[in] spline
+ * 	The spline whose workspace length is calculated.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @return
+ * 	The number of values required by the workspace of
+ * 	ts_bspline_eval_derivatives.
+ */
+size_t TINYSPLINE_API ts_bspline_len_eval_derivatives_workspace(
+	const tsBSpline *spline, size_t n);
+
+/**
+ * Evaluates \p spline and its first \p n derivatives at knot \p u in a
+ * single pass and stores the results in \p points, which must provide space
+ * for at least (\p n + 1) * ts_bspline_dimension(spline) values. The first
+ * ts_bspline_dimension(spline) values of \p points receive the point at
+ * \p u, the next ts_bspline_dimension(spline) values the first derivative,
+ * and so on. Derivatives of higher order than ts_bspline_degree(spline) are
+ * zero.
+ *
+ * Unlike calling ts_bspline_derive and ts_bspline_eval for each derivative,
+ * this function neither creates derivative splines nor tsDeBoorNet
+ * instances. Instead, the derivatives of the basis functions are calculated
+ * directly (cf. The NURBS Book, Algorithm A2.3) and combined with the
+ * control points of \p spline. Like ts_bspline_eval_point, only the first
+ * point of the evaluation result (i.e., the left-hand side limit) is taken
+ * if \p spline is discontinuous at \p u. Likewise, if \p u is an inner knot
+ * of \p spline, the derivatives are the left-hand side limits (regardless of
+ * the multiplicity of \p u), i.e., they equal the results of
+ * ts_bspline_derive and ts_bspline_eval. In contrast to ts_bspline_derive,
+ * discontinuities are not reported as error.
+ *
+ * \p workspace must provide space for at least
+ * ts_bspline_len_eval_derivatives_workspace(spline, n) values. If
+ * \p workspace is NULL, a workspace on the stack is used for small splines
+ * and a temporary workspace is allocated otherwise.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] points
+ * 	The output buffer. If this function fails, the values of \p points
+ * 	are undefined.
+ * @param[in] workspace
+ * 	The scratch memory used for evaluation. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If \p workspace is NULL and allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_derivatives(const tsBSpline *spline,
+	tsReal u, size_t n, tsReal *points, tsReal *workspace,
+	tsStatus *status);
+
+/**
+ * Evaluates \p spline and its first \p n derivatives at knots \p us (cf.
+ * ts_bspline_eval_derivatives). \p points must provide space for at least
+ * \p num * (\p n + 1) * ts_bspline_dimension(spline) values, where the
+ * results of each knot are stored consecutively. Like ts_bspline_eval_batch,
+ * ascending knots are looked up by walking the knot span of the predecessor
+ * forward.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] points
+ * 	The output buffer. If this function fails, the values of \p points
+ * 	are undefined.
+ * @param[in] workspace
+ * 	The scratch memory used for evaluation. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If \p workspace is NULL and allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_derivatives_batch(
+	const tsBSpline *spline, const tsReal *us, size_t num, size_t n,
+	tsReal *points, tsReal *workspace, tsStatus *status);
+
+/**
+ * Returns the number of values (tsReal) required by the workspace of
+ * ts_bspline_eval_rational and ts_bspline_eval_rational_batch when
+ * evaluating the first \p n derivatives of \p spline.
+ *
+ * @param[in] spline
+ * 	The spline whose workspace length is calculated.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @return
+ * 	The number of values required by the workspace of
+ * 	ts_bspline_eval_rational.
+ */
+size_t TINYSPLINE_API ts_bspline_len_eval_rational_workspace(
+	const tsBSpline *spline, size_t n);
+
+/**
+ * Interprets \p spline as NURBS (cf. tsBSpline) and evaluates it and its
+ * first \p n derivatives at knot \p u in Cartesian coordinates. \p points
+ * must provide space for at least (\p n + 1) * (ts_bspline_dimension(spline)
+ * - 1) values, which receive the point at \p u, the first derivative, and
+ * so on (cf. ts_bspline_eval_derivatives). The homogeneous point and its
+ * derivatives are calculated in \p workspace and divided by the weight right
+ * away. The derivatives are obtained from the derivatives of the homogeneous
+ * coordinates with the quotient rule (cf. The NURBS Book, Algorithm A4.2).
+ * Note that ts_bspline_derive, in contrast, derives the homogeneous
+ * coordinates and therefore does not yield the derivatives of NURBS.
+ *
+ * \p workspace must provide space for at least
+ * ts_bspline_len_eval_rational_workspace(spline, n) values. If
+ * \p workspace is NULL, a workspace on the stack is used for small splines
+ * and a temporary workspace is allocated otherwise.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] u
+ * 	The knot to evaluate \p spline at.
+ * @param[in] n
+ * 	The number of derivatives to evaluate (0 evaluates the point only).
+ * @param[out] points
+ * 	The output buffer. If this function fails, the values of \p points
+ * 	are undefined.
+ * @param[in] workspace
+ * 	The scratch memory used for evaluation. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If the dimension of \p spline is less than 2.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at knot value \p u.
+ * @return TS_MALLOC
+ * 	If \p workspace is NULL and allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_rational(const tsBSpline *spline,
+	tsReal u, size_t n, tsReal *points, tsReal *workspace,
+	tsStatus *status);
+
+/**
+ * Evaluates the NURBS \p spline and its first \p n derivatives at knots
+ * \p us (cf. ts_bspline_eval_rational). \p points must provide space for at
+ * least \p num * (\p n + 1) * (ts_bspline_dimension(spline) - 1) values,
+ * where the results of each knot are stored consecutively.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[in] n
+ * 	The number of derivatives to evaluate.
+ * @param[out] points
+ * 	The output buffer. If this function fails, the values of \p points
+ * 	are undefined.
+ * @param[in] workspace
+ * 	The scratch memory used for evaluation. May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If the dimension of \p spline is less than 2.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If \p workspace is NULL and allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_rational_batch(
+	const tsBSpline *spline, const tsReal *us, size_t num, size_t n,
+	tsReal *points, tsReal *workspace, tsStatus *status);
+
+/**
+ * Generates a sequence of \p num different knots (The knots are equally
+ * distributed between the minimum and the maximum of the domain of \p spline),
+ * passes this sequence to ts_bspline_eval_all, and stores the resultant points
+ * in \p points. If \p num is 0, the following default is taken as fallback:
+ *
+ * 	num = (ts_bspline_num_control_points(spline) -
+ * 		ts_bspline_degree(spline)) * 30;
+ *
+ * That is, the fallback generates 30 knots per Bezier segment. For the sake
+ * of stability regarding future changes, the actual number of generated knots
+ * (which only differs from \p num if \p num is 0) is stored in \p actual_num.
+ * If \p num is 1, the point located at the minimum of the domain of \p spline
+ * is evaluated.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[out] points
+ * 	The output parameter.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Must not be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample(const tsBSpline *spline, size_t num,
+	tsReal **points, size_t *actual_num, tsStatus *status);
+
+/**
+ * Creates a plan (cf. tsEvalPlan) that evaluates splines with the degree and
+ * knot vector of \p spline at knots \p us. Like ts_bspline_eval_all, only
+ * the first point is taken if \p spline is discontinuous at a knot in \p us.
+ *
+ * @param[in] spline
+ * 	The spline providing the degree and knot vector.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] plan
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_plan(const tsBSpline *spline,
+	const tsReal *us, size_t num, tsEvalPlan *plan, tsStatus *status);
+
+/**
+ * Evaluates \p spline with \p plan and stores the resultant points in
+ * \p points, which must provide space for at least
+ * ts_evalplan_num_points(plan) * ts_bspline_dimension(spline) values. This
+ * function does not allocate any memory. The degree and knot vector of
+ * \p spline must be equal to the degree and knot vector of the spline
+ * \p plan has been created for. The points are equal to the points of
+ * ts_bspline_eval_all within TS_CONTROL_POINT_EPSILON (relative to the
+ * magnitude of the control points).
+ *
+ * @param[in] plan
+ * 	The plan to apply.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[out] points
+ * 	The output buffer.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the degree or the knots of \p spline differ from the degree or the
+ * 	knots \p plan has been created for.
+ */
+tsError TINYSPLINE_API ts_evalplan_apply(const tsEvalPlan *plan,
+	const tsBSpline *spline, tsReal *points, tsStatus *status);
+
+/**
+ * Returns the basis (collocation) matrix B of \p spline at knots \p us as a
+ * dense banded block. B has \p num rows and
+ * ts_bspline_num_control_points(spline) columns, with B * P being the points
+ * of ts_bspline_eval_all (P are the control points of \p spline). Since at
+ * most ts_bspline_order(spline) consecutive basis functions are non-zero at
+ * a knot, row i of B is stored as the ts_bspline_order(spline) values
+ * \p values[i * order, (i+1) * order), which belong to the columns
+ * [\p first[i], \p first[i] + order). All other entries of row i are 0.
+ * Some of the stored values may be 0 as well (e.g., at knots with
+ * multiplicity equal to the order of \p spline). Like ts_bspline_eval_all,
+ * only the first point is taken if \p spline is discontinuous at a knot in
+ * \p us.
+ *
+ * On error, \p first and \p values are set to NULL.
+ *
+ * @param[in] spline
+ * 	The spline providing the degree and knot vector.
+ * @param[in] us
+ * 	The knot values (rows).
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] first
+ * 	The first column of each row.
+ * @param[out] values
+ * 	The values of each row.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_basis_banded(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t **first, tsReal **values,
+	tsStatus *status);
+
+/**
+ * Returns the basis (collocation) matrix of \p spline at knots \p us (cf.
+ * ts_bspline_basis_banded) in compressed sparse row (CSR) format. Each row
+ * contains exactly ts_bspline_order(spline) entries with ascending column
+ * indices, that is, \p row_ptr has \p num + 1 values and \p col_idx and
+ * \p values have num * order values each. Entries that are 0 (cf.
+ * ts_bspline_basis_banded) are stored explicitly.
+ *
+ * On error, \p row_ptr, \p col_idx, and \p values are set to NULL.
+ *
+ * @param[in] spline
+ * 	The spline providing the degree and knot vector.
+ * @param[in] us
+ * 	The knot values (rows).
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[out] row_ptr
+ * 	The offsets of the rows in \p col_idx and \p values.
+ * @param[out] col_idx
+ * 	The column indices of the entries.
+ * @param[out] values
+ * 	The values of the entries.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_basis_csr(const tsBSpline *spline,
+	const tsReal *us, size_t num, size_t **row_ptr, size_t **col_idx,
+	tsReal **values, tsStatus *status);
+
+/**
+ * Creates an arc length table (cf. tsArcLengthTable) of \p spline. The knot
+ * spans of \p spline are subdivided until the 5-point Gauss-Legendre
+ * quadratures of an interval and its two halves differ by at most the
+ * tolerance of the interval, where the tolerance of a knot span is
+ * \p epsilon and the tolerance of an interval is split evenly among its
+ * halves. In addition, the intervals are subdivided until the Hermite
+ * interpolation of the knots of an interval (cf. tsArcLengthTable) is
+ * accurate to \p epsilon (measured as length). \p epsilon is also the
+ * tolerance of the Newton iteration of ts_arclengthtable_knots. The sign of
+ * \p epsilon is removed with fabs.
+ *
+ * @param[in] spline
+ * 	The spline whose arc length is tabulated.
+ * @param[in] epsilon
+ * 	The tolerance of the lengths.
+ * @param[out] table
+ * 	The output table.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_UNDERIVABLE
+ * 	If \p spline has a gap (i.e., is not continuous) and thus has no
+ * 	length.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_arc_length_table(const tsBSpline *spline,
+	tsReal epsilon, tsArcLengthTable *table, tsStatus *status);
+
+/**
+ * Maps each length in \p lengths to the knot at which the spline \p table
+ * has been created for has this length (measured from the start of its
+ * domain) and stores the knots in \p knots. Lengths less than 0 are mapped to
+ * the minimum of the domain and lengths greater than the total length (cf.
+ * ts_arclengthtable_length) are mapped to the maximum of the domain. Runs of
+ * ascending lengths are mapped in amortized constant time per length (plus
+ * the Newton refinement), other lengths in O(log n). \p lengths and \p knots
+ * may be the same array.
  *
- *     min(1, \p num_points - 1) * 4
+ * @param[in] table
+ * 	The table used to map the lengths.
+ * @param[in] lengths
+ * 	The lengths to map.
+ * @param[in] num
+ * 	The number of lengths in \p lengths.
+ * @param[out] knots
+ * 	The output buffer with space for \p num values.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_arclengthtable_knots(const tsArcLengthTable *table,
+	const tsReal *lengths, size_t num, tsReal *knots, tsStatus *status);
+
+/**
+ * Like ts_bspline_sample, but the points are spaced equally by arc length
+ * (instead of knot value) using \p table, which must have been created for
+ * \p spline. The knots of the points are interpolated without Newton
+ * refinement (cf. ts_bspline_arc_length_table), so that the runtime of this
+ * function is close to the runtime of ts_bspline_sample.
  *
- * Note: \p num_points is the number of points in \p points and not the length
- * of \p points. For instance, the following point vector has
- * \p num_points = 4 and \p dimension = 2:
- * 
- *     [x0, y0, x1, y1, x2, y2, x3, y3]
+ * @param[in] spline
+ * 	The spline to sample.
+ * @param[in] table
+ * 	The arc length table of \p spline.
+ * @param[in] num
+ * 	The number of points to sample. If 0, a default value is used (cf.
+ * 	ts_bspline_sample).
+ * @param[out] points
+ * 	The output parameter.
+ * @param[out] actual_num
+ * 	The actual number of points in \p points.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample_arc_length(const tsBSpline *spline,
+	const tsArcLengthTable *table, size_t num, tsReal **points,
+	size_t *actual_num, tsStatus *status);
+
+/**
+ * Parallel version of ts_bspline_eval_all. The knots in \p us are split into
+ * chunks of consecutive knots, each of which is evaluated by a separate task
+ * (with its own workspace, cf. ts_bspline_eval_batch) scheduled by
+ * \p executor. If \p executor is NULL, ts_executor_default is used. The
+ * resultant points are equal to the points of ts_bspline_eval_all.
  *
- * @param[in] points
- * 	The points to interpolate.
- * @param[in] num_points
- * 	The number of points in \p points.
- * @param[in] dimension
- * 	The dimension of each control point in \p spline.
- * @param[out] spline
- * 	The output spline.
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] us
+ * 	The knot values to evaluate.
+ * @param[in] num
+ * 	The number of knots in \p us.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] points
+ * 	The output parameter.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_eval_all_parallel(const tsBSpline *spline,
+	const tsReal *us, size_t num, const tsExecutor *executor,
+	tsReal **points, tsStatus *status);
+
+/**
+ * Parallel version of ts_bspline_sample. Generates the same knots as
+ * ts_bspline_sample and passes them to ts_bspline_eval_all_parallel.
+ *
+ * @param[in] spline
+ * 	The spline to evaluate.
+ * @param[in] num
+ * 	The number of knots to generate.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] points
+ * 	The output parameter.
+ * @param[out] actual_num
+ * 	The actual number of generated knots. Differs from \p num only if
+ * 	\p num is 0. Must not be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_sample_parallel(const tsBSpline *spline,
+	size_t num, const tsExecutor *executor, tsReal **points,
+	size_t *actual_num, tsStatus *status);
+
+/**
+ * Flattens \p spline into a polyline whose distance to \p spline is at most
+ * \p tolerance. Unlike ts_bspline_sample, the number of points depends on
+ * the curvature of \p spline, i.e., flat regions are represented with few
+ * points and tight bends with many points. For this purpose, \p spline is
+ * decomposed into its Bezier segments (cf. ts_bspline_to_beziers), each of
+ * which is subdivided at its midpoint until the control points of the
+ * resultant pieces are within \p tolerance of their chords (due to the
+ * convex hull property, the pieces are then within \p tolerance of their
+ * chords as well). The polyline consists of the endpoints of the pieces,
+ * starting with the first point of \p spline. Consecutive points that are
+ * equal (within TS_CONTROL_POINT_EPSILON) are merged and gaps between
+ * segments (i.e., discontinuities) are bridged by a line.
+ *
+ * The points are stored in the caller-provided buffer \p points, which has
+ * space for \p max_points points. If \p points is NULL, the number of points
+ * of the polyline is determined only, such that a buffer of appropriate size
+ * can be allocated. \p tolerance is taken as absolute value (using fabs) and
+ * is bounded below by TS_CONTROL_POINT_EPSILON.
+ *
+ * @param[in] spline
+ * 	The spline to flatten.
+ * @param[in] tolerance
+ * 	The maximum distance between \p spline and the polyline.
+ * @param[out] points
+ * 	The output buffer (with space for \p max_points points). May be NULL.
+ * @param[in] max_points
+ * 	The number of points that fit into \p points.
+ * @param[out] num_points
+ * 	The number of points of the polyline. Must not be NULL.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
- * @return TS_DIM_ZERO
- * 	If \p dimension is 0.
  * @return TS_NUM_POINTS
- * 	If \p num_points is 0.
+ * 	If \p points is not NULL and the polyline has more than \p max_points
+ * 	points. In this case, the first \p max_points points are stored in
+ * 	\p points and \p num_points is set to the number of points of the
+ * 	polyline.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_interpolate_cubic_natural(
-	const tsReal *points, size_t num_points, size_t dimension,
-	tsBSpline *spline, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_flatten(const tsBSpline *spline,
+	tsReal tolerance, tsReal *points, size_t max_points,
+	size_t *num_points, tsStatus *status);
 
 /**
- * Interpolates a piecewise cubic spline by translating the given catmull-rom
- * control points into a sequence of bezier curves. In order to avoid division
- * by zero, successive control points with distance less than or equal to
- * \p epsilon are filtered out. If the resultant sequence contains only a
- * single point, a spline of degree 0 (a point) is created. Optionally, the
- * first and last control point can be specified (\p first and \p last).
+ * Creates a projector (cf. tsProjector) that finds the points on \p spline
+ * closest to query points.
+ *
+ * @param[in] spline
+ * 	The spline to project onto.
+ * @param[out] projector
+ * 	The output projector.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_projector(const tsBSpline *spline,
+	tsProjector *projector, tsStatus *status);
+
+/**
+ * Projects \p point onto the spline \p projector has been created for, i.e.,
+ * finds the knot at which the spline is closest to \p point. If the spline
+ * is closest to \p point at several knots, one of them is chosen. If
+ * \p closest is not NULL, the point of the spline at this knot is stored in
+ * \p closest.
+ *
+ * @param[in] projector
+ * 	The projector of the spline.
+ * @param[in] point
+ * 	The query point (with ts_projector_dimension values).
+ * @param[out] knot
+ * 	The knot of the closest point.
+ * @param[out] closest
+ * 	The closest point (with ts_projector_dimension values). May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ */
+tsError TINYSPLINE_API ts_projector_project(const tsProjector *projector,
+	const tsReal *point, tsReal *knot, tsReal *closest, tsStatus *status);
+
+/**
+ * Batch version of ts_projector_project. The points in \p points are split
+ * into chunks of consecutive points, each of which is projected by a separate
+ * task scheduled by \p executor. If \p executor is NULL,
+ * ts_executor_default is used.
  *
+ * @param[in] projector
+ * 	The projector of the spline.
  * @param[in] points
- * 	The points to interpolate.
- * @param[in] num_points
+ * 	The query points (with ts_projector_dimension values each).
+ * @param[in] num
  * 	The number of points in \p points.
- * @param[in] dimension
- * 	The dimensionality of the points.
- * @param[in] alpha
- * 	The knot parameterization: 0 => uniform, 0.5 => centripetal,
- * 	1 => chordal. The input value is automatically trimmed to the [0, 1]
- * 	interval.
- * @param[in] first
- * 	The first control point of the catmull-rom sequence. If NULL, an
- * 	appropriate point is generated based on the first two points in
- * 	\p points. If the distance between \p first and the first control point
- * 	in \p points is less than or equals to \p epsilon, \p first is treated
- * 	as NULL. This is necessary to avoid division by zero.
- * @param[in] last
- * 	The last control point of the catmull-rom sequence. If NULL, an
- * 	appropriate point is generated based on the last two points in
- * 	\p points. If the distance between \p last and the last control point
- * 	in \p points is less than or equals to \p epsilon, \p last is treated
- * 	as NULL. This is necessary to avoid division by zero.
- * @param[in] epsilon
- * 	The maximum distance between points with "same" coordinates. That is,
- * 	if the distance between neighboring points is less than or equal to
- * 	\p epsilon, they are considered equal. For the sake of fail-safeness,
- * 	the sign is removed with fabs. It is advisable to pass a value greater
- * 	than zero, however, it is not necessary.
- * @param[out] spline
- * 	The interpolated spline.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] knots
+ * 	The output buffer of the knots (with space for \p num values).
+ * @param[out] closest
+ * 	The output buffer of the closest points (with space for \p num
+ * 	points). May be NULL.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
- * @return TS_DIM_ZERO
- * 	If \p dimension is 0.
- * @return TS_NUM_POINTS
- * 	If \p num_points is 0.
+ */
+tsError TINYSPLINE_API ts_projector_project_all(const tsProjector *projector,
+	const tsReal *points, size_t num, const tsExecutor *executor,
+	tsReal *knots, tsReal *closest, tsStatus *status);
+
+/**
+ * Evaluates each spline of \p collection at its own knot, i.e., the i-th
+ * spline at \p us[i]. The points are stored consecutively in the order of
+ * the splines passed to ts_bsplinecollection_new. That is, the point of the
+ * i-th spline starts at the sum of the dimensions of the preceding splines.
+ * The tiles of the groups of \p collection are evaluated by separate tasks
+ * scheduled by \p executor. If \p executor is NULL, ts_executor_default is
+ * used. Unlike ts_bspline_eval_point, the points are computed from the
+ * values of the basis functions (rather than with de Boor's algorithm) and
+ * thus may differ from the points of ts_bspline_eval_point in the last bits.
+ *
+ * @param[in] collection
+ * 	The collection to evaluate.
+ * @param[in] us
+ * 	The knot of each spline (with ts_bsplinecollection_num_splines
+ * 	values).
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] points
+ * 	The output buffer of the points (with space for
+ * 	ts_bsplinecollection_len_points values).
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If a spline is not defined at its knot.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_interpolate_catmull_rom(const tsReal *points,
-	size_t num_points, size_t dimension, tsReal alpha, const tsReal *first,
-	const tsReal *last, tsReal epsilon, tsBSpline *spline,
-	tsStatus *status);
+tsError TINYSPLINE_API ts_bsplinecollection_eval(
+	const tsBSplineCollection *collection, const tsReal *us,
+	const tsExecutor *executor, tsReal *points, tsStatus *status);
 
+/**
+ * Evaluates all splines of \p collection at the same knot \p u (cf.
+ * ts_bsplinecollection_eval). The basis functions of a group whose splines
+ * have the same knot vector are computed only once.
+ *
+ * @param[in] collection
+ * 	The collection to evaluate.
+ * @param[in] u
+ * 	The knot at which all splines are evaluated.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] points
+ * 	The output buffer of the points (with space for
+ * 	ts_bsplinecollection_len_points values).
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If a spline is not defined at \p u.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinecollection_eval_at(
+	const tsBSplineCollection *collection, tsReal u,
+	const tsExecutor *executor, tsReal *points, tsStatus *status);
 
+/**
+ * Evaluates \p surface at the grid of knots \p us x \p vs. The point at
+ * (\p us[i], \p vs[j]) is stored at \p points[(i * \p num_v + j) *
+ * dimension]. If \p normals is not NULL, the unit normal (S_u x S_v) of each
+ * point is stored at \p normals[(i * \p num_v + j) * 3]. Normals of
+ * degenerate points (where the partial derivatives are parallel or vanish)
+ * are 0. The basis functions of each knot are calculated only once. The
+ * rows of the grid (i.e., the knots of \p us) are evaluated in blocks by
+ * separate tasks scheduled by \p executor. Each row first combines the rows
+ * of the control net to the control points of the iso-curve at u (a
+ * contiguous array) and then evaluates the iso-curve at all knots of \p vs.
+ * If \p executor is NULL, ts_executor_default is used. At discontinuities,
+ * the left-hand limit is taken.
+ *
+ * @param[in] surface
+ * 	The surface to evaluate.
+ * @param[in] us
+ * 	The knots in u direction.
+ * @param[in] num_u
+ * 	The number of knots in \p us.
+ * @param[in] vs
+ * 	The knots in v direction.
+ * @param[in] num_v
+ * 	The number of knots in \p vs.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] points
+ * 	The output buffer of the points (with space for \p num_u * \p num_v *
+ * 	ts_bsplinesurface_dimension values).
+ * @param[out] normals
+ * 	The output buffer of the normals (with space for \p num_u * \p num_v
+ * 	* 3 values). May be NULL.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p normals is not NULL and the dimension of \p surface is not 3.
+ * @return TS_U_UNDEFINED
+ * 	If \p surface is not defined at one of the knots.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bsplinesurface_eval_grid(
+	const tsBSplineSurface *surface, const tsReal *us, size_t num_u,
+	const tsReal *vs, size_t num_v, const tsExecutor *executor,
+	tsReal *points, tsReal *normals, tsStatus *status);
 
-/******************************************************************************
-*                                                                             *
-* :: Query Functions                                                          *
-*                                                                             *
-******************************************************************************/
 /**
- * Evaluates \p spline at knot \p u and stores the result (cf. tsDeBoorNet) in
- * \p net.
+ * Evaluates \p surface at (\p u, \p v) (cf. ts_bsplinesurface_eval_grid).
  *
- * @param[in] spline
- * 	The spline to evaluate.
+ * @param[in] surface
+ * 	The surface to evaluate.
  * @param[in] u
- * 	The knot to evaluate \p spline at.
- * @param[out] net
- * 	The output parameter
+ * 	The knot in u direction.
+ * @param[in] v
+ * 	The knot in v direction.
+ * @param[out] point
+ * 	The output buffer of the point (with space for
+ * 	ts_bsplinesurface_dimension values).
+ * @param[out] normal
+ * 	The output buffer of the unit normal (with space for 3 values). May
+ * 	be NULL.
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_DIM_ZERO
+ * 	If \p normal is not NULL and the dimension of \p surface is not 3.
  * @return TS_U_UNDEFINED
- * 	If \p spline is not defined at knot value \p u.
+ * 	If \p surface is not defined at (\p u, \p v).
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_eval(const tsBSpline *spline, tsReal u,
-	tsDeBoorNet *net, tsStatus *status);
+tsError TINYSPLINE_API ts_bsplinesurface_eval(const tsBSplineSurface *surface,
+	tsReal u, tsReal v, tsReal *point, tsReal *normal, tsStatus *status);
 
 /**
- * Evaluates \p spline at knots \p us and stores the resultant points in
- * \p points. If \p us contains one or more knots where \p spline is
- * discontinuous at, only the first point of the corresponding evaluation
- * result is taken. After calling this function \p points contains exactly
- * \p num * ts_bspline_dimension(spline) values.
+ * Finds the intersections of the splines \p a and \p b, i.e., the pairs of
+ * knots (u_a, u_b) at which the distance between \p a and \p b is less than
+ * or equal to fabs(\p epsilon). The splines are decomposed into Bezier
+ * segments (cf. ts_bspline_projector), which, based on the convex hull
+ * property of their control points, are subdivided until they are flat. The
+ * intersections of flat pieces are polished with Newton's method. Tangential
+ * contacts are found as well. Pairs of knots whose knots are equal (cf.
+ * ts_knots_equal) are reported once. Yet, intersections with a very small
+ * crossing angle may be reported several times (with knots that are close to
+ * each other).
+ *
+ * @param[in] a
+ * 	The first spline.
+ * @param[in] b
+ * 	The second spline.
+ * @param[in] epsilon
+ * 	The maximum distance between the points of an intersection.
+ * @param[out] knots
+ * 	The pairs of knots (u_a, u_b) of the intersections (sorted in
+ * 	ascending order). NULL if there are no intersections.
+ * @param[out] num
+ * 	The number of intersections (i.e., pairs of knots).
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the dimensions of \p a and \p b differ.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_intersect_curves(const tsBSpline *a,
+	const tsBSpline *b, tsReal epsilon, tsReal **knots, size_t *num,
+	tsStatus *status);
+
+/**
+ * Finds the knots at which the distance between \p spline and the plane
+ * (hyperplane) through \p point with normal \p normal is less than or equal
+ * to fabs(\p epsilon). Apart from that, this function behaves like
+ * ts_bspline_intersect_curves.
  *
- * This function is in particular useful in cases where a multitude of knots
- * need to be evaluated, because only a single instance of tsDeBoorNet is
- * created and reused for all evaluation tasks (therefore the memory footprint
- * is reduced to a minimum).
+ * @param[in] spline
+ * 	The spline.
+ * @param[in] point
+ * 	A point of the plane (with ts_bspline_dimension values).
+ * @param[in] normal
+ * 	The normal of the plane (with ts_bspline_dimension values). Need not
+ * 	be normalized.
+ * @param[in] epsilon
+ * 	The maximum distance between the spline and the plane.
+ * @param[out] knots
+ * 	The knots of the intersections (sorted in ascending order). NULL if
+ * 	there are no intersections.
+ * @param[out] num
+ * 	The number of intersections.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_NO_RESULT
+ * 	If \p normal has length 0.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_intersect_plane(const tsBSpline *spline,
+	const tsReal *point, const tsReal *normal, tsReal epsilon,
+	tsReal **knots, size_t *num, tsStatus *status);
+
+/**
+ * Finds the intersections of \p spline and the ray origin + t * direction
+ * (t >= 0), i.e., the pairs (u, t) at which the distance between \p spline
+ * and the ray is less than or equal to fabs(\p epsilon). The ray is clipped
+ * to the bounding box of the control points of \p spline and then
+ * intersected like a spline (cf. ts_bspline_intersect_curves).
  *
  * @param[in] spline
- * 	The spline to evaluate.
- * @param[in] us
- * 	The knot values to evaluate.
- * @param[in] num
- * 	The number of knots in \p us.
- * @param[out] points
- * 	The output parameter.
+ * 	The spline.
+ * @param[in] origin
+ * 	The origin of the ray (with ts_bspline_dimension values).
+ * @param[in] direction
+ * 	The direction of the ray (with ts_bspline_dimension values). Need not
+ * 	be normalized.
+ * @param[in] epsilon
+ * 	The maximum distance between the spline and the ray.
+ * @param[out] knots
+ * 	The pairs (u, t) of the intersections (sorted in ascending order).
+ * 	NULL if there are no intersections.
+ * @param[out] num
+ * 	The number of intersections (i.e., pairs).
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
- * @return TS_U_UNDEFINED
- * 	If \p spline is not defined at one of the knot values in \p us.
+ * @return TS_NO_RESULT
+ * 	If \p direction has length 0.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_eval_all(const tsBSpline *spline,
-	const tsReal *us, size_t num, tsReal **points, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_intersect_ray(const tsBSpline *spline,
+	const tsReal *origin, const tsReal *direction, tsReal epsilon,
+	tsReal **knots, size_t *num, tsStatus *status);
 
 /**
- * Generates a sequence of \p num different knots (The knots are equally
- * distributed between the minimum and the maximum of the domain of \p spline),
- * passes this sequence to ts_bspline_eval_all, and stores the resultant points
- * in \p points. If \p num is 0, the following default is taken as fallback:
- *
- * 	num = (ts_bspline_num_control_points(spline) -
- * 		ts_bspline_degree(spline)) * 30;
- *
- * That is, the fallback generates 30 knots per Bezier segment. For the sake
- * of stability regarding future changes, the actual number of generated knots
- * (which only differs from \p num if \p num is 0) is stored in \p actual_num.
- * If \p num is 1, the point located at the minimum of the domain of \p spline
- * is evaluated.
+ * Batch version of ts_bspline_intersect_curves that finds the intersections
+ * of all pairs of splines in \p splines (excluding self-intersections).
+ * Pairs of splines whose bounding boxes do not overlap are culled with sweep
+ * and prune. The remaining pairs are culled by the segment hierarchies of
+ * the splines (cf. tsProjector).
  *
- * @param[in] spline
- * 	The spline to evaluate.
+ * @param[in] splines
+ * 	The splines (with equal dimensions).
  * @param[in] num
- * 	The number of knots to generate.
- * @param[out] points
- * 	The output parameter.
- * @param[out] actual_num
- * 	The actual number of generated knots. Differs from \p num only if
- * 	\p num is 0. Must not be NULL.
+ * 	The number of splines in \p splines.
+ * @param[in] epsilon
+ * 	The maximum distance between the points of an intersection.
+ * @param[out] indices
+ * 	The pairs of indices (i, j), i < j, of the intersecting splines. NULL
+ * 	if there are no intersections.
+ * @param[out] knots
+ * 	The pairs of knots (u_i, u_j) of the intersections. NULL if there are
+ * 	no intersections.
+ * @param[out] num_hits
+ * 	The number of intersections (i.e., pairs).
  * @param[out] status
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the dimensions of the splines differ.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
-tsError TINYSPLINE_API ts_bspline_sample(const tsBSpline *spline, size_t num,
-	tsReal **points, size_t *actual_num, tsStatus *status);
+tsError TINYSPLINE_API ts_bspline_intersect_all(const tsBSpline *splines,
+	size_t num, tsReal epsilon, size_t **indices, tsReal **knots,
+	size_t *num_hits, tsStatus *status);
 
 /**
  * Tries to find a point P on \p spline such that:
@@ -1427,10 +3653,30 @@ tsError TINYSPLINE_API ts_bspline_bisect(const tsBSpline *spline, tsReal value,
 void TINYSPLINE_API ts_bspline_domain(const tsBSpline *spline, tsReal *min,
 	tsReal *max);
 
+/**
+ * Returns the domain of \p surface in u and v direction (cf.
+ * ts_bspline_domain).
+ *
+ * @param[in] surface
+ * 	The surface to query.
+ * @param[out] min_u
+ * 	The lower bound of the domain in u direction.
+ * @param[out] max_u
+ * 	The upper bound of the domain in u direction.
+ * @param[out] min_v
+ * 	The lower bound of the domain in v direction.
+ * @param[out] max_v
+ * 	The upper bound of the domain in v direction.
+ */
+void TINYSPLINE_API ts_bsplinesurface_domain(const tsBSplineSurface *surface,
+	tsReal *min_u, tsReal *max_u, tsReal *min_v, tsReal *max_v);
+
 /**
  * Checks whether the distance of the endpoints of \p spline is less than or
  * equal to \p epsilon for the first 'ts_bspline_degree - 1' derivatives
- * (starting with the zeroth derivative).
+ * (starting with the zeroth derivative). Splines of degree 0 are checked for
+ * the zeroth derivative. The derivatives at the endpoints are calculated
+ * with ts_bspline_eval_derivatives_batch.
  *
  * @param[in] spline
  * 	The spline to query.
@@ -1539,7 +3785,8 @@ tsError TINYSPLINE_API ts_bspline_is_closed(const tsBSpline *spline,
  * 
  * where the multiplicity of the first and the last knot value _u_ is _p_
  * rather than _p+1_. The derivative of a point (degree == 0) is another point
- * with coordinate 0.
+ * with coordinate 0. The derivative of a NURBS is not a NURBS. Use
+ * ts_bspline_eval_rational to evaluate the derivatives of NURBS.
  *
  * @param[in] spline
  * 	The spline to derive.
@@ -1596,6 +3843,43 @@ tsError TINYSPLINE_API ts_bspline_insert_knot(const tsBSpline *spline,
 	tsReal knot, size_t num, tsBSpline *result, size_t *k,
 	tsStatus *status);
 
+/**
+ * Inserts the knots \p knots (sorted in ascending order) into the knot vector
+ * of \p spline and stores the result in \p result. Creates a deep copy of
+ * \p spline if \p spline != \p result. Knots that occur several times in
+ * \p knots are inserted several times. Unlike calling ts_bspline_insert_knot
+ * for each knot, the refined spline is computed in a single pass with a
+ * single allocation (Oslo algorithm, cf. The NURBS Book, Algorithm A5.4).
+ * Knots that are equal (cf. ts_knots_equal) to a knot of \p spline are
+ * inserted with the value of the latter.
+ *
+ * @param[in] spline
+ * 	The spline to refine.
+ * @param[in] knots
+ * 	The knots to insert (sorted in ascending order).
+ * @param[in] num
+ * 	The number of knots in \p knots.
+ * @param[out] result
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_KNOTS_DECR
+ * 	If \p knots is not sorted in ascending order.
+ * @return TS_U_UNDEFINED
+ * 	If a knot of \p knots is not within the domain of \p spline.
+ * @return TS_MULTIPLICITY
+ * 	If the multiplicity of a knot in \p result would be greater than the
+ * 	order of \p spline.
+ * @return TS_NUM_KNOTS
+ * 	If \p result would have more than TS_MAX_NUM_KNOTS knots.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_insert_knots(const tsBSpline *spline,
+	const tsReal *knots, size_t num, tsBSpline *result, tsStatus *status);
+
 /**
  * Splits \p spline at knot value \p u and stores the result in \p split. That
  * is, \p u is inserted _n_ times such that the multiplicity of \p u is equal
@@ -1658,6 +3942,11 @@ tsError TINYSPLINE_API ts_bspline_tension(const tsBSpline *spline,
  * Decomposes \p spline into a sequence of Bezier curves by splitting it at
  * each internal knot value. Creates a deep copy of \p spline if
  * \p spline != \p beziers.
+ *
+ * The control points of each segment are computed directly from the
+ * control points and knots of the corresponding span (Boehm's knot
+ * insertion restricted to the span), so the decomposition allocates memory
+ * only once and its runtime is linear in the number of knots.
  * 
  * @param[in] spline
  * 	The spline to decompose.
@@ -1667,12 +3956,173 @@ tsError TINYSPLINE_API ts_bspline_tension(const tsBSpline *spline,
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If the domain of \p spline is empty.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
 tsError TINYSPLINE_API ts_bspline_to_beziers(const tsBSpline *spline,
 	tsBSpline *beziers, tsStatus *status);
 
+/**
+ * Elevates the degree of \p spline by \p amount and stores the result in
+ * \p elevated. Unlike ts_bspline_set_degree, the shape of \p spline is
+ * preserved exactly. \p spline is decomposed into its Bezier segments (cf.
+ * ts_bspline_to_beziers), which are elevated independently (cf. 'The NURBS
+ * Book', Eq. 5.36) by separate tasks scheduled by \p executor. If
+ * \p executor is NULL, ts_executor_default is used. Afterwards, the
+ * segments are merged again by removing the knots between them that are
+ * exactly removable (cf. 'The NURBS Book', algorithm A5.9). That is, each
+ * inner knot of multiplicity m gets multiplicity m + \p amount and the
+ * continuity of \p spline is preserved. For example, elevating a C2
+ * continuous cubic spline with n control points and s segments yields a
+ * spline with n + s * \p amount control points. \p elevated is clamped.
+ * Creates a deep copy of \p spline if \p amount is 0.
+ *
+ * @param[in] spline
+ * 	The spline to elevate.
+ * @param[in] amount
+ * 	The number of degrees to elevate.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] elevated
+ * 	The elevated spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If the domain of \p spline is empty.
+ * @return TS_NUM_KNOTS
+ * 	If \p elevated has too many knots.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_elevate_degree(const tsBSpline *spline,
+	size_t amount, const tsExecutor *executor, tsBSpline *elevated,
+	tsStatus *status);
+
+/**
+ * Reduces the degree of \p spline by \p amount and stores the result in
+ * \p reduced. \p spline is decomposed into its Bezier segments (cf.
+ * ts_bspline_to_beziers), which are reduced independently (one degree at a
+ * time, cf. 'The NURBS Book', Section 5.6) by separate tasks scheduled by
+ * \p executor. If \p executor is NULL, ts_executor_default is used. The
+ * end points of the segments are preserved (unless the degree of
+ * \p reduced is 0) so that adjacent segments whose junction points are
+ * within TS_CONTROL_POINT_EPSILON are joined, i.e., the multiplicity of the
+ * corresponding inner knot is the degree of \p reduced.
+ *
+ * The error of a reduced segment is bounded by the maximum distance between
+ * its control points, elevated back to the degree of \p spline, and the
+ * control points of the original segment (convex hull property). If the
+ * bound of any segment exceeds \p tolerance, TS_NO_RESULT is returned.
+ * Creates a deep copy of \p spline if \p amount is 0.
+ *
+ * @param[in] spline
+ * 	The spline to reduce.
+ * @param[in] amount
+ * 	The number of degrees to reduce.
+ * @param[in] tolerance
+ * 	The maximum distance between \p spline and \p reduced. The sign is
+ * 	removed with fabs.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] reduced
+ * 	The reduced spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_U_UNDEFINED
+ * 	If the domain of \p spline is empty.
+ * @return TS_NO_RESULT
+ * 	If \p amount exceeds the degree of \p spline or if the error bound
+ * 	exceeds \p tolerance.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_reduce_degree(const tsBSpline *spline,
+	size_t amount, tsReal tolerance, const tsExecutor *executor,
+	tsBSpline *reduced, tsStatus *status);
+
+/**
+ * Simplifies \p spline by removing as many of its inner knots (and
+ * corresponding control points) as possible such that the distance between
+ * \p spline and \p result does not exceed \p tolerance, and stores the
+ * result in \p result. Each distinct inner knot is visited once from left to
+ * right and removed as often as possible with Tiller's algorithm (cf. 'The
+ * NURBS Book', algorithm A5.8). The error bounds of all removals are summed
+ * up, i.e., the tolerance is a budget that is consumed by removals that are
+ * not exact. Knots that can be removed exactly (e.g., the knots inserted by
+ * ts_bspline_insert_knot, the full-multiplicity knots of
+ * ts_bspline_to_beziers and ts_bspline_interpolate_cubic_natural at which
+ * the spline is continuous) consume (almost) no tolerance. The control
+ * points and knots are compacted from left to right in a single buffer
+ * (each of them is moved at most twice) and a removal only affects the
+ * control points and knots close to the removed knot. Thus, the runtime is
+ * linear in the number of knots (for a given degree).
+ *
+ * @param[in] spline
+ * 	The spline to simplify.
+ * @param[in] tolerance
+ * 	The maximum distance between \p spline and \p result. The sign is
+ * 	removed with fabs.
+ * @param[out] result
+ * 	The simplified spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_remove_knots(const tsBSpline *spline,
+	tsReal tolerance, tsBSpline *result, tsStatus *status);
+
+/**
+ * Makes \p splines compatible, that is, stores splines in \p results that
+ * have the same shape as \p splines but share their degree, their knot
+ * vector, and thus their number of control points. Compatible splines can
+ * be blended by combining their control points (e.g., to loft a surface
+ * with ts_bsplinesurface_loft). Each spline is elevated to the maximum
+ * degree of \p splines with ts_bspline_elevate_degree (i.e., its continuity
+ * is preserved), clamped, and its domain is mapped to [0, 1]. Afterwards,
+ * the inner knots of all splines are merged (keeping the maximum
+ * multiplicity of each knot) and the missing knots are inserted into each
+ * spline. Thus, the continuity of \p results at a knot is the minimum
+ * continuity of \p splines at this knot and no knot is added that is not
+ * required by one of \p splines. Both steps are done by separate tasks
+ * (one per spline) scheduled by \p executor. If \p executor is NULL,
+ * ts_executor_default is used, unless the tasks allocate memory with
+ * allocators other than the default one (cf. tsAllocator), in which case
+ * the tasks are run sequentially.
+ *
+ * On error, all splines of \p results are freed.
+ *
+ * @param[in] splines
+ * 	The splines to make compatible.
+ * @param[in] num
+ * 	The number of splines in \p splines.
+ * @param[in] executor
+ * 	The executor that runs the tasks. May be NULL.
+ * @param[out] results
+ * 	The compatible splines (with space for \p num splines).
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_INCOMPATIBLE
+ * 	If the dimensions of \p splines differ.
+ * @return TS_U_UNDEFINED
+ * 	If the domain of a spline is empty.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_make_compatible(const tsBSpline *splines,
+	size_t num, const tsExecutor *executor, tsBSpline *results,
+	tsStatus *status);
+
 
 
 /******************************************************************************
@@ -1685,7 +4135,7 @@ tsError TINYSPLINE_API ts_bspline_to_beziers(const tsBSpline *spline,
 ******************************************************************************/
 /**
  * Serializes \p spline to a null-terminated JSON string and stores the result
- * in \p json.
+ * in \p json (cf. ts_bspline_write_json).
  *
  * @param[in] spline
  * 	The spline to serialize.
@@ -1695,6 +4145,8 @@ tsError TINYSPLINE_API ts_bspline_to_beziers(const tsBSpline *spline,
  * 	The status of this function. May be NULL.
  * @return TS_SUCCESS
  * 	On success.
+ * @return TS_IO_ERROR
+ * 	If \p spline contains values that are not finite.
  * @return TS_MALLOC
  * 	If allocating memory failed.
  */
@@ -1702,7 +4154,8 @@ tsError TINYSPLINE_API ts_bspline_to_json(const tsBSpline *spline, char **json,
 	tsStatus *status);
 
 /**
- * Parses \p json and stores the result in \p spline.
+ * Parses \p json and stores the result in \p spline (cf.
+ * ts_bspline_read_json).
  *
  * @param[in] json
  * 	The JSON string to parse.
@@ -1733,6 +4186,61 @@ tsError TINYSPLINE_API ts_bspline_to_json(const tsBSpline *spline, char **json,
 tsError TINYSPLINE_API ts_bspline_parse_json(const char *json,
 	tsBSpline *spline, tsStatus *status);
 
+/**
+ * Writes \p spline as JSON object to \p file. Unlike building a JSON
+ * document first, the control points and knots are formatted one by one
+ * and written straight to \p file. Each value is formatted with the least
+ * number of significant digits that parse back to the same ::tsReal.
+ *
+ * @param[in] spline
+ * 	The spline to write.
+ * @param[in] file
+ * 	The output file. Must be open for writing.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If an error occurred while writing to \p file, or if \p spline
+ * 	contains values that are not finite (which are not supported by
+ * 	JSON).
+ */
+tsError TINYSPLINE_API ts_bspline_write_json(const tsBSpline *spline,
+	FILE *file, tsStatus *status);
+
+/**
+ * Reads a JSON object (cf. ts_bspline_write_json) from \p file and stores
+ * the result in \p spline. The object is parsed in a single pass without
+ * building a JSON document, that is, the control points and knots are read
+ * straight into \p spline. The order of the keys is arbitrary and unknown
+ * keys are skipped.
+ *
+ * @param[in] file
+ * 	The input file. Must be open for reading.
+ * @param[out] spline
+ * 	The deserialized spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_PARSE_ERROR
+ * 	If an error occurred while parsing the contents of \p file, or if
+ * 	the length of the control point vector modulo dimension is not 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots stored in \p file does not match to the
+ * 	number of control points and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_read_json(FILE *file, tsBSpline *spline,
+	tsStatus *status);
+
 /**
  * Saves \p spline as JSON ASCII file.
  *
@@ -1786,6 +4294,120 @@ tsError TINYSPLINE_API ts_bspline_save(const tsBSpline *spline,
 tsError TINYSPLINE_API ts_bspline_load(const char *path, tsBSpline *spline,
 	tsStatus *status);
 
+/**
+ * Saves \p spline as binary file. Unlike ts_bspline_save, the control points
+ * and knots are written as they are stored in memory (i.e., with the byte
+ * order and the size of ::tsReal of the current platform) such that they can
+ * be used directly from a memory-mapped file (cf. ts_bspline_map_binary).
+ *
+ * The file starts with a versioned header that stores the byte order and
+ * the size of the reals, the degree, the dimension, the number of control
+ * points and knots, as well as an Adler-32 checksum of the data. All header
+ * values are stored as little endian integers. The data begins at a fixed
+ * offset (256 bytes), the knots follow the control points.
+ *
+ * @param[in] spline
+ * 	The spline to save.
+ * @param[in] path
+ * 	Path of the binary file.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If an error occurred while saving \p spline.
+ */
+tsError TINYSPLINE_API ts_bspline_save_binary(const tsBSpline *spline,
+	const char *path, tsStatus *status);
+
+/**
+ * Loads \p spline from a binary file (cf. ts_bspline_save_binary) by copying
+ * its contents. Files that have been written on platforms with a different
+ * byte order or a different size of ::tsReal are converted. The checksum
+ * and the knots of the file are always verified.
+ *
+ * @param[in] path
+ * 	Path of the binary file.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If \p path cannot be opened.
+ * @return TS_PARSE_ERROR
+ * 	If \p path is not a binary spline file, if it is truncated, or if
+ * 	the checksum does not match.
+ * @return TS_DIM_ZERO
+ * 	If the dimension is 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots does not match to the number of control points
+ * 	and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_load_binary(const char *path,
+	tsBSpline *spline, tsStatus *status);
+
+/**
+ * Loads \p spline from a binary file (cf. ts_bspline_save_binary) by mapping
+ * the file into memory. The control points and knots of \p spline are not
+ * copied, but refer to the (private, i.e., copy-on-write) mapping. Thus, if
+ * \p verify is 0, loading takes constant time regardless of the size of the
+ * file, and only the pages that are accessed during evaluation are read.
+ * Otherwise, the checksum and the knots of the file are verified (which
+ * reads the whole file once).
+ *
+ * \p spline can be used like any other spline. Modifying \p spline does
+ * not change the file. Copies and splines derived from \p spline are
+ * allocated on the heap (with the global allocator, cf. tsAllocator). The
+ * mapping is released by ts_bspline_free.
+ *
+ * Falls back to ts_bspline_load_binary (which always verifies the file) if
+ * memory-mapped files are not supported by the platform (i.e., TinySpline
+ * has been compiled without TINYSPLINE_HAVE_MMAP), or if the file has been
+ * written on a platform with a different byte order or a different size of
+ * ::tsReal.
+ *
+ * @param[in] path
+ * 	Path of the binary file.
+ * @param[in] verify
+ * 	Whether to verify the checksum and the knots of the file.
+ * @param[out] spline
+ * 	The output spline.
+ * @param[out] status
+ * 	The status of this function. May be NULL.
+ * @return TS_SUCCESS
+ * 	On success.
+ * @return TS_IO_ERROR
+ * 	If \p path cannot be opened.
+ * @return TS_PARSE_ERROR
+ * 	If \p path is not a binary spline file, if it is truncated, or if
+ * 	the checksum does not match.
+ * @return TS_DIM_ZERO
+ * 	If the dimension is 0.
+ * @return TS_DEG_GE_NCTRLP
+ * 	If the degree is greater or equals to the number of control points.
+ * @return TS_NUM_KNOTS
+ * 	If the number of knots does not match to the number of control points
+ * 	and the degree of the spline.
+ * @return TS_KNOTS_DECR
+ * 	If the knot vector is decreasing.
+ * @return TS_MULTIPLICITY
+ * 	If there is a knot with multiplicity greater than order.
+ * @return TS_MALLOC
+ * 	If allocating memory failed.
+ */
+tsError TINYSPLINE_API ts_bspline_map_binary(const char *path, int verify,
+	tsBSpline *spline, tsStatus *status);
+
 
 
 /******************************************************************************
@@ -1840,6 +4462,98 @@ void TINYSPLINE_API ts_arr_fill(tsReal *arr, size_t num, tsReal val);
 tsReal TINYSPLINE_API ts_distance(const tsReal *x, const tsReal *y,
 	size_t dimension);
 
+/**
+ * Returns the default executor of TinySpline. If TinySpline has been built
+ * with POSIX threads (TINYSPLINE_HAVE_PTHREAD), the tasks passed to the
+ * returned executor are distributed among one thread per online processor
+ * (including the calling thread). The worker threads are started when the
+ * executor runs tasks for the first time and are kept alive (waiting for
+ * further tasks) until the process exits, i.e., the cost of starting
+ * threads is paid only once. Idle threads claim chunks of pending tasks
+ * (about four per thread), balancing the load among all threads. The
+ * threads process the tasks of one call at a time. Tasks passed while the
+ * threads are busy (e.g., by a task itself or by another thread) are run
+ * sequentially in the calling thread. Without POSIX threads, all tasks are
+ * run sequentially in the calling thread.
+ *
+ * @return
+ * 	The default executor.
+ */
+tsExecutor TINYSPLINE_API ts_executor_default(void);
+
+/**
+ * Returns the default allocator of TinySpline, which is based on malloc,
+ * realloc, and free.
+ *
+ * @return
+ * 	The default allocator.
+ */
+tsAllocator TINYSPLINE_API ts_allocator_default(void);
+
+/**
+ * Returns the global allocator of TinySpline (cf. tsAllocator).
+ *
+ * @return
+ * 	The global allocator.
+ */
+tsAllocator TINYSPLINE_API ts_allocator_global(void);
+
+/**
+ * Sets the global allocator of TinySpline (cf. tsAllocator). If \p allocator
+ * is NULL, the default allocator (ts_allocator_default) is restored. Objects
+ * that have been allocated before are still released with their allocator.
+ * This function is not thread-safe and must not be called while other
+ * functions of TinySpline are running.
+ *
+ * @param[in] allocator
+ * 	The new global allocator. May be NULL.
+ */
+void TINYSPLINE_API ts_allocator_set_global(const tsAllocator *allocator);
+
+/**
+ * Returns an allocator (cf. tsAllocator) that allocates from \p arena. The
+ * allocator is valid until \p arena is freed.
+ *
+ * @param[in] arena
+ * 	The arena to allocate from.
+ * @return
+ * 	The allocator of \p arena.
+ */
+tsAllocator TINYSPLINE_API ts_arena_allocator(const tsArena *arena);
+
+/**
+ * Releases all chunks allocated from \p arena at once. If \p arena had to
+ * allocate additional blocks, they are merged into a single block such that
+ * subsequent allocations of the same size do not allocate system memory. All
+ * objects allocated from \p arena become invalid and must neither be used
+ * nor freed afterwards.
+ *
+ * @param[in] arena
+ * 	The arena to reset.
+ */
+void TINYSPLINE_API ts_arena_reset(tsArena *arena);
+
+/**
+ * Returns the number of bytes of \p arena that are in use (including
+ * alignment and bookkeeping).
+ *
+ * @param[in] arena
+ * 	The arena to query.
+ * @return
+ * 	The number of used bytes.
+ */
+size_t TINYSPLINE_API ts_arena_used(const tsArena *arena);
+
+/**
+ * Returns the total size of the blocks of \p arena in bytes.
+ *
+ * @param[in] arena
+ * 	The arena to query.
+ * @return
+ * 	The capacity of \p arena.
+ */
+size_t TINYSPLINE_API ts_arena_capacity(const tsArena *arena);
+
 
 
 #ifdef	__cplusplus
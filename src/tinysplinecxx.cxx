@@ -280,6 +280,25 @@ tinyspline::BSpline tinyspline::BSpline::interpolateCatmullRom(
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::approximate(
+	const std_real_vector_in points, size_t dimension,
+	size_t numControlPoints, size_t degree)
+{
+	if (dimension == 0)
+		throw std::runtime_error("unsupported dimension: 0");
+	if (std_real_vector_read(points)size() % dimension != 0)
+		throw std::runtime_error("#points % dimension != 0");
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_approximate(
+			std_real_vector_read(points)data(),
+			std_real_vector_read(points)size()/dimension,
+			dimension, numControlPoints, degree, &data,
+			&status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
 tinyspline::BSpline tinyspline::BSpline::parseJson(std::string json)
 {
 	tsBSpline data = ts_bspline_init();
@@ -298,6 +317,26 @@ tinyspline::BSpline tinyspline::BSpline::load(std::string path)
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::loadBinary(std::string path)
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_load_binary(path.c_str(), &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::mapBinary(std::string path,
+	bool verify)
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_map_binary(path.c_str(), verify ? 1 : 0, &data,
+			&status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
 tinyspline::BSpline & tinyspline::BSpline::operator=(
 	const tinyspline::BSpline &other)
 {
@@ -398,20 +437,109 @@ tinyspline::DeBoorNet tinyspline::BSpline::eval(tinyspline::real u) const
 	return tinyspline::DeBoorNet(net);
 }
 
+std_real_vector_out tinyspline::BSpline::evalPoint(tinyspline::real u) const
+{
+	std_real_vector_out vec = std_real_vector_init(dimension());
+	tsStatus status;
+	if (ts_bspline_eval_point(&spline, u, std_real_vector_read(vec)data(),
+			NULL, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
 std_real_vector_out tinyspline::BSpline::evalAll(
 	const std_real_vector_in us) const
 {
-	tinyspline::real *points;
+	const size_t num = std_real_vector_read(us)size();
+	std::vector<tinyspline::real> workspace(
+		ts_bspline_len_eval_workspace(&spline));
+	std_real_vector_out vec = std_real_vector_init(num * dimension());
+	tsStatus status;
+	if (ts_bspline_eval_batch(&spline, std_real_vector_read(us)data(),
+			num, std_real_vector_read(vec)data(), workspace.data(),
+			&status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::BSpline::evalDerivatives(tinyspline::real u,
+	size_t n) const
+{
+	std_real_vector_out vec = std_real_vector_init((n + 1) * dimension());
 	tsStatus status;
-	if (ts_bspline_eval_all(&spline, std_real_vector_read(us)data(),
-			std_real_vector_read(us)size(), &points, &status)) {
+	if (ts_bspline_eval_derivatives(&spline, u, n,
+			std_real_vector_read(vec)data(), NULL, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::BSpline::evalDerivativesAll(
+	const std_real_vector_in us, size_t n) const
+{
+	const size_t num = std_real_vector_read(us)size();
+	std::vector<tinyspline::real> workspace(
+		ts_bspline_len_eval_derivatives_workspace(&spline, n));
+	std_real_vector_out vec = std_real_vector_init(
+		num * (n + 1) * dimension());
+	tsStatus status;
+	if (ts_bspline_eval_derivatives_batch(&spline,
+			std_real_vector_read(us)data(), num, n,
+			std_real_vector_read(vec)data(), workspace.data(),
+			&status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::BSpline::evalRational(tinyspline::real u,
+	size_t n) const
+{
+	const size_t dim = dimension() > 1 ? dimension() - 1 : 0;
+	std_real_vector_out vec = std_real_vector_init((n + 1) * dim);
+	tsStatus status;
+	if (ts_bspline_eval_rational(&spline, u, n,
+			std_real_vector_read(vec)data(), NULL, &status)) {
+#ifdef SWIG
+		delete vec;
+#endif
+		throw std::runtime_error(status.message);
+	}
+	return vec;
+}
+
+std_real_vector_out tinyspline::BSpline::evalRationalAll(
+	const std_real_vector_in us, size_t n) const
+{
+	const size_t num = std_real_vector_read(us)size();
+	const size_t dim = dimension() > 1 ? dimension() - 1 : 0;
+	std::vector<tinyspline::real> workspace(
+		ts_bspline_len_eval_rational_workspace(&spline, n));
+	std_real_vector_out vec = std_real_vector_init(num * (n + 1) * dim);
+	tsStatus status;
+	if (ts_bspline_eval_rational_batch(&spline,
+			std_real_vector_read(us)data(), num, n,
+			std_real_vector_read(vec)data(), workspace.data(),
+			&status)) {
+#ifdef SWIG
+		delete vec;
+#endif
 		throw std::runtime_error(status.message);
 	}
-	tinyspline::real *begin = points;
-	tinyspline::real *end = begin +
-		std_real_vector_read(us)size() * dimension();
-	std_real_vector_out vec = std_real_vector_init(begin, end);
-	free(points);
 	return vec;
 }
 
@@ -430,6 +558,70 @@ std_real_vector_out tinyspline::BSpline::sample(size_t num) const
 	return vec;
 }
 
+#ifndef SWIG
+void tinyspline::BSpline::evalPoint(tinyspline::real u,
+	std::vector<tinyspline::real> &point,
+	std::vector<tinyspline::real> &workspace) const
+{
+	tsStatus status;
+	/* Reuses the capacity of both vectors in subsequent calls. */
+	point.resize(dimension());
+	workspace.resize(order() * dimension());
+	if (ts_bspline_eval_point(&spline, u, point.data(), workspace.data(),
+			&status)) {
+		throw std::runtime_error(status.message);
+	}
+}
+
+std::vector<tinyspline::real> tinyspline::BSpline::evalAll(
+	const std::vector<tinyspline::real> &us,
+	const tsExecutor &executor) const
+{
+	tinyspline::real *points;
+	tsStatus status;
+	if (ts_bspline_eval_all_parallel(&spline, us.data(), us.size(),
+			&executor, &points, &status)) {
+		throw std::runtime_error(status.message);
+	}
+	std::vector<tinyspline::real> vec(points,
+		points + us.size() * dimension());
+	free(points);
+	return vec;
+}
+
+std::vector<tinyspline::real> tinyspline::BSpline::sample(size_t num,
+	const tsExecutor &executor) const
+{
+	tinyspline::real *points;
+	size_t actualNum;
+	tsStatus status;
+	if (ts_bspline_sample_parallel(&spline, num, &executor, &points,
+			&actualNum, &status)) {
+		throw std::runtime_error(status.message);
+	}
+	std::vector<tinyspline::real> vec(points,
+		points + actualNum * dimension());
+	free(points);
+	return vec;
+}
+#endif
+
+std_real_vector_out tinyspline::BSpline::flatten(
+	tinyspline::real tolerance) const
+{
+	size_t num;
+	tsStatus status;
+	if (ts_bspline_flatten(&spline, tolerance, NULL, 0, &num, &status))
+		throw std::runtime_error(status.message);
+	std::vector<tinyspline::real> points(num * dimension());
+	if (ts_bspline_flatten(&spline, tolerance, points.data(), num, &num,
+			&status))
+		throw std::runtime_error(status.message);
+	std_real_vector_out vec = std_real_vector_init(
+		points.begin(), points.end());
+	return vec;
+}
+
 tinyspline::DeBoorNet tinyspline::BSpline::bisect(tinyspline::real value,
 	tinyspline::real epsilon, bool persnickety, size_t index,
 	bool ascending, size_t maxIter) const
@@ -476,6 +668,13 @@ void tinyspline::BSpline::save(std::string path) const
 		throw std::runtime_error(status.message);
 }
 
+void tinyspline::BSpline::saveBinary(std::string path) const
+{
+	tsStatus status;
+	if (ts_bspline_save_binary(&spline, path.c_str(), &status))
+		throw std::runtime_error(status.message);
+}
+
 void tinyspline::BSpline::setControlPoints(
 	const std::vector<tinyspline::real> &ctrlp)
 {
@@ -516,6 +715,32 @@ void tinyspline::BSpline::setControlPointAt(size_t index,
 		throw std::runtime_error(status.message);
 }
 
+void tinyspline::BSpline::setRationalControlPoints(
+	const std::vector<tinyspline::real> &ctrlp,
+	const std::vector<tinyspline::real> &weights)
+{
+	size_t num = numControlPoints();
+	size_t expected = dimension() > 1 ? num * (dimension() - 1) : 0;
+	size_t actual = ctrlp.size();
+	if (expected != actual || num != weights.size()) {
+		char expected_str[32];
+		char actual_str[32];
+		if (expected == actual) {
+			expected = num;
+			actual = weights.size();
+		}
+		sprintf(expected_str, "%lu", (unsigned long) expected);
+		sprintf(actual_str, "%lu", (unsigned long) actual);
+		throw std::runtime_error(
+			"Expected size: " + std::string(expected_str) +
+			", Actual size: " + std::string(actual_str));
+	}
+	tsStatus status;
+	if (ts_bspline_set_rational_control_points(&spline, ctrlp.data(),
+			weights.data(), &status))
+		throw std::runtime_error(status.message);
+}
+
 void tinyspline::BSpline::setKnots(const std::vector<tinyspline::real> &knots)
 {
 	size_t expected = ts_bspline_num_knots(&spline);
@@ -552,6 +777,18 @@ tinyspline::BSpline tinyspline::BSpline::insertKnot(tinyspline::real u,
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::insertKnots(
+	const std_real_vector_in knots) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_insert_knots(&spline,
+			std_real_vector_read(knots)data(),
+			std_real_vector_read(knots)size(), &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
 tinyspline::BSpline tinyspline::BSpline::split(tinyspline::real u) const
 {
 	tsBSpline data = ts_bspline_init();
@@ -581,6 +818,36 @@ tinyspline::BSpline tinyspline::BSpline::toBeziers() const
 	return BSpline(data);
 }
 
+tinyspline::BSpline tinyspline::BSpline::elevateDegree(size_t amount) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_elevate_degree(&spline, amount, NULL, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::reduceDegree(size_t amount,
+	tinyspline::real tolerance) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_reduce_degree(&spline, amount, tolerance, NULL, &data,
+			&status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
+tinyspline::BSpline tinyspline::BSpline::removeKnots(
+	tinyspline::real tolerance) const
+{
+	tsBSpline data = ts_bspline_init();
+	tsStatus status;
+	if (ts_bspline_remove_knots(&spline, tolerance, &data, &status))
+		throw std::runtime_error(status.message);
+	return BSpline(data);
+}
+
 tinyspline::BSpline tinyspline::BSpline::derive(size_t n, real epsilon) const
 {
 	tsBSpline data = ts_bspline_init();
@@ -123,8 +123,13 @@ public:
 		std::vector<tinyspline::real> *first = NULL,
 		std::vector<tinyspline::real> *last = NULL,
 		tsReal epsilon = TS_CONTROL_POINT_EPSILON);
+	static BSpline approximate(const std_real_vector_in points,
+		size_t dimension, size_t numControlPoints,
+		size_t degree = 3);
 	static BSpline parseJson(std::string json);
 	static BSpline load(std::string path);
+	static BSpline loadBinary(std::string path);
+	static BSpline mapBinary(std::string path, bool verify = true);
 
 	/* Operators */
 	BSpline & operator=(const BSpline &other);
@@ -142,8 +147,24 @@ public:
 	/* Query */
 	size_t numControlPoints() const;
 	DeBoorNet eval(real u) const;
+	std_real_vector_out evalPoint(real u) const;
 	std_real_vector_out evalAll(const std_real_vector_in us) const;
+	std_real_vector_out evalDerivatives(real u, size_t n) const;
+	std_real_vector_out evalDerivativesAll(const std_real_vector_in us,
+		size_t n) const;
+	std_real_vector_out evalRational(real u, size_t n = 0) const;
+	std_real_vector_out evalRationalAll(const std_real_vector_in us,
+		size_t n = 0) const;
 	std_real_vector_out sample(size_t num = 0) const;
+#ifndef SWIG
+	void evalPoint(real u, std::vector<real> &point,
+		std::vector<real> &workspace) const;
+	std::vector<real> evalAll(const std::vector<real> &us,
+		const tsExecutor &executor) const;
+	std::vector<real> sample(size_t num,
+		const tsExecutor &executor) const;
+#endif
+	std_real_vector_out flatten(real tolerance) const;
 	DeBoorNet bisect(real value, real epsilon = TS_CONTROL_POINT_EPSILON,
 		bool persnickety = false, size_t index = 0,
 		bool ascending = true, size_t maxIter = 30) const;
@@ -153,18 +174,25 @@ public:
 	/* Serialization */
 	std::string toJson() const;
 	void save(std::string path) const;
+	void saveBinary(std::string path) const;
 
 	/* Modifications */
 	void setControlPoints(const std::vector<real> &ctrlp);
 	void setControlPointAt(size_t index, const std_real_vector_in ctrlp);
+	void setRationalControlPoints(const std::vector<real> &ctrlp,
+		const std::vector<real> &weights);
 	void setKnots(const std::vector<real> &knots);
 	void setKnotAt(size_t index, real knot);
 
 	/* Transformations */
 	BSpline insertKnot(real u, size_t n) const;
+	BSpline insertKnots(const std_real_vector_in knots) const;
 	BSpline split(real u) const;
 	BSpline tension(real tension) const;
 	BSpline toBeziers() const;
+	BSpline elevateDegree(size_t amount) const;
+	BSpline reduceDegree(size_t amount, real tolerance) const;
+	BSpline removeKnots(real tolerance = TS_CONTROL_POINT_EPSILON) const;
 	BSpline derive(size_t n = 1,
 		real epsilon = TS_CONTROL_POINT_EPSILON) const;
 
@@ -237,6 +265,8 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 	        .class_function("interpolateCatmullRom",
 			&BSpline::interpolateCatmullRom,
 			allow_raw_pointers())
+	        .class_function("approximate",
+			&BSpline::approximate)
 	        .class_function("parseJson", &BSpline::parseJson)
 
 	        .property("degree", &BSpline::degree)
@@ -250,20 +280,35 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 	        /* Property by index */
 	        .function("controlPointAt", &BSpline::controlPointAt)
 	        .function("setControlPointAt", &BSpline::setControlPointAt)
+	        .function("setRationalControlPoints",
+	                  &BSpline::setRationalControlPoints)
 	        .function("knotAt", &BSpline::knotAt)
 	        .function("setKnotAt", &BSpline::setKnotAt)
 
 	        /* Query */
 	        .function("numControlPoints", &BSpline::numControlPoints)
 	        .function("eval", &BSpline::eval)
-	        .function("evalAll", &BSpline::evalAll)
+	        .function("evalPoint",
+			select_overload<std_real_vector_out(real) const>
+			(&BSpline::evalPoint))
+	        .function("evalAll",
+			select_overload<std_real_vector_out(
+				const std_real_vector_in) const>
+			(&BSpline::evalAll))
+	        .function("evalDerivatives", &BSpline::evalDerivatives)
+	        .function("evalDerivativesAll", &BSpline::evalDerivativesAll)
+	        .function("evalRational", &BSpline::evalRational)
+	        .function("evalRationalAll", &BSpline::evalRationalAll)
 	        .function("sample",
 			select_overload<std_real_vector_out() const>
 			(&BSpline::sample0))
 	        .function("sample",
 			select_overload<std_real_vector_out(size_t) const>
 			(&BSpline::sample1))
-	        .function("sample", &BSpline::sample)
+	        .function("sample",
+			select_overload<std_real_vector_out(size_t) const>
+			(&BSpline::sample))
+	        .function("flatten", &BSpline::flatten)
 	        .function("bisect", &BSpline::bisect)
 	        .function("isClosed", &BSpline::isClosed)
 
@@ -272,9 +317,13 @@ EMSCRIPTEN_BINDINGS(tinyspline) {
 
 	        /* Transformations */
 	        .function("insertKnot", &BSpline::insertKnot)
+	        .function("insertKnots", &BSpline::insertKnots)
 	        .function("split", &BSpline::split)
 	        .function("tension", &BSpline::tension)
 	        .function("toBeziers", &BSpline::toBeziers)
+	        .function("elevateDegree", &BSpline::elevateDegree)
+	        .function("reduceDegree", &BSpline::reduceDegree)
+	        .function("removeKnots", &BSpline::removeKnots)
 	        .function("derive",
 			select_overload<BSpline() const>
 			(&BSpline::derive0))
@@ -0,0 +1,404 @@
+#include <stdlib.h>
+#include <string.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* Counts the calls of an allocator based on malloc, realloc, and free. */
+struct allocator_counter
+{
+	size_t num_allocate;
+	size_t num_deallocate;
+};
+
+void * allocator_count_allocate(void *ctx, size_t size)
+{
+	((struct allocator_counter *) ctx)->num_allocate++;
+	return malloc(size);
+}
+
+void * allocator_count_reallocate(void *ctx, void *ptr, size_t size)
+{
+	if (!ptr)
+		((struct allocator_counter *) ctx)->num_allocate++;
+	return realloc(ptr, size);
+}
+
+void allocator_count_deallocate(void *ctx, void *ptr)
+{
+	((struct allocator_counter *) ctx)->num_deallocate++;
+	free(ptr);
+}
+
+tsAllocator allocator_counting(struct allocator_counter *counter)
+{
+	tsAllocator allocator;
+	counter->num_allocate = 0;
+	counter->num_deallocate = 0;
+	allocator.allocate = allocator_count_allocate;
+	allocator.reallocate = allocator_count_reallocate;
+	allocator.deallocate = allocator_count_deallocate;
+	allocator.ctx = counter;
+	return allocator;
+}
+
+void allocator_global(CuTest *tc)
+{
+	tsBSpline before = ts_bspline_init();
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline split = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *points = NULL;
+	struct allocator_counter counter;
+	tsAllocator allocator = allocator_counting(&counter);
+	size_t k, num;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 2, 3, TS_CLAMPED, &before, &status))
+		ts_allocator_set_global(&allocator);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_eval(
+			&spline, 0.4f, &net, &status))
+		TS_CALL(try, status.code, ts_bspline_split(
+			&spline, 0.4f, &split, &k, &status))
+		TS_CALL(try, status.code, ts_bspline_sample(
+			&spline, 50, &points, &num, &status))
+		ts_bspline_free(&before);
+		ts_bspline_free(&spline);
+		ts_bspline_free(&split);
+		ts_deboornet_free(&net);
+
+/* ================================= Then ================================== */
+		/* The spline created before is released with the default
+		 * allocator. Sampled points are allocated with malloc. */
+		CuAssertTrue(tc, counter.num_allocate >= 4);
+		CuAssertIntEquals(tc, (int) counter.num_allocate,
+			(int) counter.num_deallocate);
+		CuAssertIntEquals(tc, 50, (int) num);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&before);
+		ts_bspline_free(&spline);
+		ts_bspline_free(&split);
+		ts_deboornet_free(&net);
+		free(points);
+		ts_allocator_set_global(NULL);
+	TS_END_TRY
+}
+
+void allocator_arena_frames(CuTest *tc)
+{
+	tsArena arena = ts_arena_init();
+	tsAllocator allocator;
+	tsBSpline heap = ts_bspline_init();
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline inserted = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsDeBoorNet expected = ts_deboornet_init();
+	tsReal *result = NULL, *reference = NULL, *ctrlp = NULL;
+	size_t frame, i, k, capacity = 0;
+	struct allocator_counter counter;
+	tsAllocator global = allocator_counting(&counter);
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A tiny arena that must grow in the first frame. */
+		TS_CALL(try, status.code, ts_arena_new(256, &arena, &status))
+		allocator = ts_arena_allocator(&arena);
+		TS_CALL(try, status.code, ts_bspline_new(
+			9, 3, 3, TS_CLAMPED, &heap, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&heap, &ctrlp, &status))
+		for (i = 0; i < 27; i++)
+			ctrlp[i] = (tsReal) ((i * 17) % 11) - 5.f;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&heap, ctrlp, &status))
+		ts_allocator_set_global(&global);
+
+		for (frame = 0; frame < 4; frame++) {
+/* ================================= When ================================== */
+			TS_CALL(try, status.code,
+				ts_bspline_copy_with_allocator(&heap,
+				&allocator, &spline, &status))
+			for (i = 0; i < 100; i++) {
+				TS_CALL(try, status.code, ts_bspline_eval(
+					&spline, (tsReal) i / 99, &net,
+					&status))
+				if (i < 99)
+					ts_deboornet_free(&net);
+			}
+			TS_CALL(try, status.code, ts_bspline_insert_knot(
+				&spline, 0.3f, 2, &inserted, &k, &status))
+			TS_CALL(try, status.code, ts_bspline_to_beziers(
+				&inserted, &beziers, &status))
+
+/* ================================= Then ================================== */
+			CuAssertTrue(tc, ts_arena_used(&arena) > 0);
+			TS_CALL(try, status.code, ts_bspline_eval(
+				&heap, 1.f, &expected, &status))
+			TS_CALL(try, status.code, ts_deboornet_result(
+				&net, &result, &status))
+			TS_CALL(try, status.code, ts_deboornet_result(
+				&expected, &reference, &status))
+			for (i = 0; i < 3; i++) {
+				CuAssertDblEquals(tc, reference[i], result[i],
+					EPSILON);
+			}
+			ts_deboornet_free(&expected);
+			free(result);
+			free(reference);
+			result = reference = NULL;
+			CuAssertIntEquals(tc, 11, (int)
+				ts_bspline_num_control_points(&inserted));
+			CuAssertIntEquals(tc, 0, (int)
+				ts_bspline_num_control_points(&beziers) % 4);
+			/* Reset the arena instead of freeing the objects. */
+			ts_arena_reset(&arena);
+			spline = ts_bspline_init();
+			inserted = ts_bspline_init();
+			beziers = ts_bspline_init();
+			net = ts_deboornet_init();
+			CuAssertIntEquals(tc, 0, (int) ts_arena_used(&arena));
+			/* Subsequent frames do not grow the arena. */
+			if (frame > 0) {
+				CuAssertIntEquals(tc, (int) capacity,
+					(int) ts_arena_capacity(&arena));
+			}
+			capacity = ts_arena_capacity(&arena);
+		}
+		/* Neither the objects derived from the spline in the arena nor
+		 * the reference nets (derived from heap) use the global
+		 * allocator. */
+		CuAssertIntEquals(tc, 0, (int) counter.num_allocate);
+		CuAssertTrue(tc, capacity > 256);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_allocator_set_global(NULL);
+		ts_bspline_free(&heap);
+		ts_deboornet_free(&expected);
+		ts_arena_free(&arena);
+		free(result);
+		free(reference);
+		free(ctrlp);
+	TS_END_TRY
+}
+
+void allocator_arena_copy_out(CuTest *tc)
+{
+	tsArena arena = ts_arena_init();
+	tsAllocator allocator;
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline copy = ts_bspline_init();
+	tsReal ctrlp[6] = { 0.f, 0.f, 1.f, 2.f, 3.f, 1.f };
+	tsReal *actual = NULL;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_arena_new(0, &arena, &status))
+		allocator = ts_arena_allocator(&arena);
+		TS_CALL(try, status.code, ts_bspline_new_with_allocator(
+			3, 2, 2, TS_CLAMPED, &allocator, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_copy(
+			&spline, &copy, &status))
+
+/* ================================= When ================================== */
+		/* Move copy out of the arena (in place). */
+		TS_CALL(try, status.code, ts_bspline_copy_with_allocator(
+			&copy, NULL, &copy, &status))
+		ts_arena_reset(&arena);
+		spline = ts_bspline_init();
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 0, (int) ts_arena_used(&arena));
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&copy, &actual, &status))
+		for (i = 0; i < 6; i++)
+			CuAssertDblEquals(tc, ctrlp[i], actual[i], 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&copy);
+		ts_arena_free(&arena);
+		free(actual);
+	TS_END_TRY
+}
+
+void allocator_arena_chunks(CuTest *tc)
+{
+	tsArena arena = ts_arena_init();
+	tsAllocator allocator;
+	char *a, *b, *c;
+	size_t used;
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_arena_new(1024, &arena, &status));
+	allocator = ts_arena_allocator(&arena);
+	a = (char *) allocator.allocate(allocator.ctx, 10);
+	CuAssertPtrNotNull(tc, a);
+	memset(a, 'a', 10);
+
+/* =============================== When/Then =============================== */
+	/* The most recent chunk grows in place. */
+	CuAssertPtrEquals(tc, a, allocator.reallocate(allocator.ctx, a, 100));
+	CuAssertIntEquals(tc, 0, (int) (((size_t) a) % sizeof(double)));
+	used = ts_arena_used(&arena);
+
+	/* Other chunks are moved. */
+	b = (char *) allocator.allocate(allocator.ctx, 1);
+	CuAssertPtrNotNull(tc, b);
+	c = (char *) allocator.reallocate(allocator.ctx, a, 200);
+	CuAssertPtrNotNull(tc, c);
+	CuAssertTrue(tc, c != a);
+	CuAssertTrue(tc, memcmp(c, "aaaaaaaaaa", 10) == 0);
+
+	/* Releasing the most recent chunk reclaims its memory. */
+	allocator.deallocate(allocator.ctx, c);
+	allocator.deallocate(allocator.ctx, b);
+	CuAssertIntEquals(tc, (int) used, (int) ts_arena_used(&arena));
+
+	/* Chunks that do not fit are served from a new block. */
+	a = (char *) allocator.allocate(allocator.ctx, 4096);
+	CuAssertPtrNotNull(tc, a);
+	memset(a, 0, 4096);
+	CuAssertTrue(tc, ts_arena_capacity(&arena) >= 1024 + 4096);
+	ts_arena_reset(&arena);
+	CuAssertIntEquals(tc, 0, (int) ts_arena_used(&arena));
+
+	ts_arena_free(&arena);
+	CuAssertPtrEquals(tc, NULL, arena.pImpl);
+}
+
+void allocator_arena_compatible(CuTest *tc)
+{
+	tsArena arena = ts_arena_init();
+	tsAllocator allocator;
+	tsBSpline splines[2], results[2];
+	tsReal line[4] = { 0.f, 0.f, 2.f, 2.f };
+	tsReal parabola[6] = { 0.f, 0.f, 1.f, 2.f, 2.f, 0.f };
+	tsReal point[2];
+	size_t i;
+	tsStatus status;
+
+	for (i = 0; i < 2; i++) {
+		splines[i] = ts_bspline_init();
+		results[i] = ts_bspline_init();
+	}
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_arena_new(0, &arena, &status))
+		allocator = ts_arena_allocator(&arena);
+		TS_CALL(try, status.code, ts_bspline_new_with_allocator(
+			2, 2, 1, TS_CLAMPED, &allocator, splines, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			splines, line, &status))
+		TS_CALL(try, status.code, ts_bspline_new_with_allocator(
+			3, 2, 2, TS_CLAMPED, &allocator, splines + 1, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			splines + 1, parabola, &status))
+
+/* ================================= When ================================== */
+		/* The tasks allocate with the arena, which is not
+		 * thread-safe. Thus, they are run sequentially. */
+		TS_CALL(try, status.code, ts_bspline_make_compatible(
+			splines, 2, NULL, results, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < 2; i++) {
+			CuAssertIntEquals(tc, 2,
+				(int) ts_bspline_degree(results + i));
+			CuAssertIntEquals(tc, 3,
+				(int) ts_bspline_num_control_points(
+					results + i));
+		}
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			results, 0.5f, point, NULL, &status))
+		CuAssertDblEquals(tc, 1, point[0], EPSILON);
+		CuAssertDblEquals(tc, 1, point[1], EPSILON);
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			results + 1, 0.5f, point, NULL, &status))
+		CuAssertDblEquals(tc, 1, point[0], EPSILON);
+		CuAssertDblEquals(tc, 1, point[1], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		for (i = 0; i < 2; i++) {
+			ts_bspline_free(splines + i);
+			ts_bspline_free(results + i);
+		}
+		ts_arena_free(&arena);
+	TS_END_TRY
+}
+
+void allocator_json(CuTest *tc)
+{
+	tsArena arena = ts_arena_init();
+	tsAllocator allocator;
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline parsed = ts_bspline_init();
+	char *json = NULL;
+	tsReal ctrlp[15] = {
+		1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f,
+		13.f, 14.f, 15.f
+	};
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			5, 3, 2, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_arena_new(0, &arena, &status))
+		allocator = ts_arena_allocator(&arena);
+		ts_allocator_set_global(&allocator);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_to_json(
+			&spline, &json, &status))
+		TS_CALL(try, status.code, ts_bspline_parse_json(
+			json, &parsed, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 5,
+			(int) ts_bspline_num_control_points(&parsed));
+		CuAssertIntEquals(tc, 3, (int) ts_bspline_dimension(&parsed));
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_allocator_set_global(NULL);
+		/* The string is allocated with malloc. */
+		free(json);
+		ts_bspline_free(&spline);
+		ts_bspline_free(&parsed);
+		ts_arena_free(&arena);
+	TS_END_TRY
+}
+
+CuSuite* get_allocator_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, allocator_global);
+	SUITE_ADD_TEST(suite, allocator_arena_frames);
+	SUITE_ADD_TEST(suite, allocator_arena_copy_out);
+	SUITE_ADD_TEST(suite, allocator_arena_chunks);
+	SUITE_ADD_TEST(suite, allocator_arena_compatible);
+	SUITE_ADD_TEST(suite, allocator_json);
+	return suite;
+}
@@ -0,0 +1,214 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* Evaluates \p spline at the chord length parameters of \p points and
+ * returns the maximum distance to the corresponding points. */
+tsReal approximation_max_error(CuTest *tc, const tsBSpline *spline,
+	const tsReal *points, size_t num, size_t dim)
+{
+	tsReal *us = NULL, *result = NULL;
+	tsReal min, max, len, dist, err = 0;
+	size_t i;
+
+	us = (tsReal *) malloc(num * sizeof(tsReal));
+	CuAssertPtrNotNull(tc, us);
+	us[0] = 0;
+	for (i = 1; i < num; i++) {
+		us[i] = us[i-1] + ts_distance(points + (i-1) * dim,
+			points + i * dim, dim);
+	}
+	len = us[num - 1];
+	ts_bspline_domain(spline, &min, &max);
+	for (i = 0; i < num; i++)
+		us[i] = min + (us[i] / len) * (max - min);
+	us[num - 1] = max;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_all(
+		spline, us, num, &result, NULL));
+	for (i = 0; i < num; i++) {
+		dist = ts_distance(points + i * dim, result + i * dim, dim);
+		err = dist > err ? dist : err;
+	}
+	free(us);
+	free(result);
+	return err;
+}
+
+void approximation_line(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 50];
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		for (i = 0; i < 50; i++) {
+			points[i * 2] = (tsReal) i / 10;
+			points[i * 2 + 1] = 2.f - (tsReal) i / 5;
+		}
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_approximate(
+			points, 50, 2, 6, 3, &spline, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 6,
+			(int) ts_bspline_num_control_points(&spline));
+		CuAssertIntEquals(tc, 3, (int) ts_bspline_degree(&spline));
+		/* Lines are reproduced exactly. */
+		CuAssertDblEquals(tc, 0, approximation_max_error(
+			tc, &spline, points, 50, 2), EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void approximation_interpolates(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	tsStatus status;
+
+	tsReal points[14] = {
+		 1.f, -1.f,
+		-1.f,  2.f,
+		 1.f,  4.f,
+		 4.f,  3.f,
+		 7.f,  5.f,
+		 8.f,  2.f,
+		 6.f,  0.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_approximate(
+			points, 7, 2, 7, 3, &spline, &status))
+
+/* ================================= Then ================================== */
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		CuAssertDblEquals(tc,  1.f, ctrlp[0],  EPSILON);
+		CuAssertDblEquals(tc, -1.f, ctrlp[1],  EPSILON);
+		CuAssertDblEquals(tc,  6.f, ctrlp[12], EPSILON);
+		CuAssertDblEquals(tc,  0.f, ctrlp[13], EPSILON);
+		CuAssertDblEquals(tc, 0, approximation_max_error(
+			tc, &spline, points, 7, 2), EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(ctrlp);
+	TS_END_TRY
+}
+
+void approximation_point_cloud(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *points = NULL;
+	tsReal x, noise;
+	const size_t num = 20000;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A cubic polynomial (with some deterministic noise). */
+		points = (tsReal *) malloc(num * 3 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, points);
+		for (i = 0; i < num; i++) {
+			x = (tsReal) i / (num - 1) * 2 - 1;
+			noise = (tsReal) ((i * 7919) % 11) / 10000;
+			points[i * 3] = x;
+			points[i * 3 + 1] = x * x * x - x + noise;
+			points[i * 3 + 2] = x * x - noise;
+		}
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_approximate(
+			points, num, 3, 12, 3, &spline, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 12,
+			(int) ts_bspline_num_control_points(&spline));
+		CuAssertTrue(tc, approximation_max_error(
+			tc, &spline, points, num, 3) < 0.01f);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(points);
+	TS_END_TRY
+}
+
+void approximation_degrees(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 40];
+	size_t deg, i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (i = 0; i < 40; i++) {
+			points[i * 2] = (tsReal) ((i * 13) % 7);
+			points[i * 2 + 1] = (tsReal) i;
+		}
+		for (deg = 0; deg <= 5; deg++) {
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_approximate(
+				points, 40, 2, 8, deg, &spline, &status))
+
+/* ================================= Then ================================== */
+			CuAssertIntEquals(tc, (int) deg,
+				(int) ts_bspline_degree(&spline));
+			CuAssertIntEquals(tc, 8,
+				(int) ts_bspline_num_control_points(&spline));
+			ts_bspline_free(&spline);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void approximation_invalid_input(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 5] = { 0.f, 0.f, 1.f, 1.f, 2.f, 0.f, 3.f, 1.f,
+		4.f, 0.f };
+	tsStatus status;
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_approximate(
+		points, 5, 0, 4, 3, &spline, &status));
+	CuAssertIntEquals(tc, TS_DIM_ZERO, status.code);
+
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_approximate(
+		points, 5, 2, 1, 0, &spline, &status));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, status.code);
+
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_approximate(
+		points, 5, 2, 6, 3, &spline, &status));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, status.code);
+
+	CuAssertIntEquals(tc, TS_DEG_GE_NCTRLP, ts_bspline_approximate(
+		points, 5, 2, 4, 4, &spline, &status));
+	CuAssertIntEquals(tc, TS_DEG_GE_NCTRLP, status.code);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+}
+
+CuSuite* get_approximation_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, approximation_line);
+	SUITE_ADD_TEST(suite, approximation_interpolates);
+	SUITE_ADD_TEST(suite, approximation_point_cloud);
+	SUITE_ADD_TEST(suite, approximation_degrees);
+	SUITE_ADD_TEST(suite, approximation_invalid_input);
+	return suite;
+}
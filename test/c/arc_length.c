@@ -0,0 +1,275 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+void arc_length_line(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsArcLengthTable table = ts_arclengthtable_init();
+	tsReal lengths[3] = { 2.5f, 0.f, 5.f };
+	tsReal knots[3];
+	tsReal ctrlp[4] = { 0.f, 0.f, 3.f, 4.f };
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			2, 2, 1, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_arc_length_table(
+			&spline, 1e-6f, &table, &status))
+		TS_CALL(try, status.code, ts_arclengthtable_knots(
+			&table, lengths, 3, knots, &status))
+
+/* ================================= Then ================================== */
+		CuAssertDblEquals(tc, 5.f, ts_arclengthtable_length(&table),
+			EPSILON);
+		CuAssertDblEquals(tc, 0.5f, knots[0], EPSILON);
+		CuAssertDblEquals(tc, 0.f, knots[1], EPSILON);
+		CuAssertDblEquals(tc, 1.f, knots[2], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_arclengthtable_free(&table);
+	TS_END_TRY
+}
+
+void arc_length_non_uniform_speed(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsArcLengthTable table = ts_arclengthtable_init();
+	tsReal *points = NULL;
+	size_t num, i;
+	tsStatus status;
+
+	tsReal ctrlp[8] = {
+		 0.f, 0.f,
+		 0.1f, 0.f,
+		 0.2f, 0.f,
+		10.f, 0.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A straight line along the x-axis with varying speed. */
+		TS_CALL(try, status.code, ts_bspline_new(
+			4, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_arc_length_table(
+			&spline, 1e-6f, &table, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_sample_arc_length(
+			&spline, &table, 101, &points, &num, &status))
+
+/* ================================= Then ================================== */
+		CuAssertDblEquals(tc, 10.f, ts_arclengthtable_length(&table),
+			EPSILON);
+		CuAssertIntEquals(tc, 101, (int) num);
+		for (i = 0; i < num; i++) {
+			CuAssertDblEquals(tc, (tsReal) i / 10, points[i * 2],
+				EPSILON);
+			CuAssertDblEquals(tc, 0.f, points[i * 2 + 1], EPSILON);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_arclengthtable_free(&table);
+		free(points);
+	TS_END_TRY
+}
+
+void arc_length_equals_polyline(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsArcLengthTable table = ts_arclengthtable_init();
+	tsReal *ctrlp = NULL, *points = NULL, *lengths = NULL, *knots = NULL;
+	tsReal polyline = 0;
+	const size_t num = 20001;
+	size_t i, actual;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			12, 3, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		for (i = 0; i < 36; i++)
+			ctrlp[i] = (tsReal) ((i * 31) % 17) / 4;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_sample(
+			&spline, num, &points, &actual, &status))
+		for (i = 1; i < num; i++) {
+			polyline += ts_distance(points + (i-1) * 3,
+				points + i * 3, 3);
+		}
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_arc_length_table(
+			&spline, 1e-7f, &table, &status))
+
+/* ================================= Then ================================== */
+		CuAssertDblEquals(tc, polyline,
+			ts_arclengthtable_length(&table), polyline * 1e-4f);
+
+		/* Unordered lengths yield the same knots as ordered ones. */
+		lengths = (tsReal *) malloc(200 * sizeof(tsReal));
+		knots = (tsReal *) malloc(200 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, lengths);
+		CuAssertPtrNotNull(tc, knots);
+		for (i = 0; i < 100; i++) {
+			lengths[i] = polyline * i / 99;
+			lengths[100 + i] = polyline * ((i * 37) % 100) / 99;
+		}
+		TS_CALL(try, status.code, ts_arclengthtable_knots(
+			&table, lengths, 200, knots, &status))
+		for (i = 0; i < 100; i++) {
+			CuAssertDblEquals(tc, knots[(i * 37) % 100],
+				knots[100 + i], EPSILON);
+			if (i > 0)
+				CuAssertTrue(tc, knots[i] > knots[i - 1]);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_arclengthtable_free(&table);
+		free(ctrlp);
+		free(points);
+		free(lengths);
+		free(knots);
+	TS_END_TRY
+}
+
+void arc_length_sample_equals_knots(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsArcLengthTable table = ts_arclengthtable_init();
+	tsReal *ctrlp = NULL, *points = NULL, *expected = NULL;
+	tsReal knots[201], length;
+	size_t i, num;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			40, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		for (i = 0; i < 80; i++)
+			ctrlp[i] = (tsReal) ((i * 7919) % 101) / 10;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_arc_length_table(
+			&spline, 1e-4f, &table, &status))
+		length = ts_arclengthtable_length(&table);
+		for (i = 0; i < 201; i++)
+			knots[i] = length * i / 200;
+		TS_CALL(try, status.code, ts_arclengthtable_knots(
+			&table, knots, 201, knots, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			&spline, knots, 201, &expected, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_sample_arc_length(
+			&spline, &table, 201, &points, &num, &status))
+
+/* ================================= Then ================================== */
+		/* The interpolated knots are as accurate as the refined ones. */
+		CuAssertIntEquals(tc, 201, (int) num);
+		for (i = 0; i < 201; i++) {
+			CuAssertDblEquals(tc, 0, ts_distance(points + i * 2,
+				expected + i * 2, 2), 1e-3f);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_arclengthtable_free(&table);
+		free(ctrlp);
+		free(points);
+		free(expected);
+	TS_END_TRY
+}
+
+void arc_length_copy(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsArcLengthTable table = ts_arclengthtable_init();
+	tsArcLengthTable copy = ts_arclengthtable_init();
+	tsReal length = 1.f, expected, knot;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			5, 2, 2, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_arc_length_table(
+			&spline, 1e-6f, &table, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_arclengthtable_copy(
+			&table, &copy, &status))
+		/* The copy does not depend on spline and table. */
+		ts_bspline_free(&spline);
+		TS_CALL(try, status.code, ts_arclengthtable_knots(
+			&table, &length, 1, &expected, &status))
+		ts_arclengthtable_free(&table);
+
+/* ================================= Then ================================== */
+		CuAssertTrue(tc, ts_arclengthtable_num_entries(&copy) >= 4);
+		TS_CALL(try, status.code, ts_arclengthtable_knots(
+			&copy, &length, 1, &knot, &status))
+		CuAssertDblEquals(tc, expected, knot, 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_arclengthtable_free(&table);
+		ts_arclengthtable_free(&copy);
+	TS_END_TRY
+}
+
+void arc_length_gap(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsArcLengthTable table = ts_arclengthtable_init();
+	tsReal ctrlp[8] = { 0.f, 0.f, 1.f, 1.f, 2.f, 2.f, 3.f, 3.f };
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 2, 1, TS_BEZIERS, &spline, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		&spline, ctrlp, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_UNDERIVABLE, ts_bspline_arc_length_table(
+		&spline, 1e-6f, &table, &status));
+	CuAssertIntEquals(tc, TS_UNDERIVABLE, status.code);
+	CuAssertPtrEquals(tc, NULL, table.pImpl);
+
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_arc_length_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, arc_length_line);
+	SUITE_ADD_TEST(suite, arc_length_non_uniform_speed);
+	SUITE_ADD_TEST(suite, arc_length_equals_polyline);
+	SUITE_ADD_TEST(suite, arc_length_sample_equals_knots);
+	SUITE_ADD_TEST(suite, arc_length_copy);
+	SUITE_ADD_TEST(suite, arc_length_gap);
+	return suite;
+}
@@ -0,0 +1,166 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+void basis_matrix_setup(CuTest *tc, tsBSpline *spline, tsReal *us,
+	size_t num)
+{
+	tsReal *ctrlp = NULL;
+	size_t i;
+	tsReal knots[12] = {
+		0.f, 0.f, 0.f, 0.f, 0.2f, 0.5f, 0.5f, 0.5f, 1.f, 1.f, 1.f, 1.f
+	};
+
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		8, 2, 3, TS_CLAMPED, spline, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_knots(
+		spline, knots, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		spline, &ctrlp, NULL));
+	for (i = 0; i < 16; i++)
+		ctrlp[i] = (tsReal) ((i * 29) % 13) - 6.f;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		spline, ctrlp, NULL));
+	free(ctrlp);
+	/* Ascending knots followed by some unordered ones. */
+	for (i = 0; i < num; i++)
+		us[i] = (tsReal) i / (num - 1);
+	us[num / 2] = 0.5f;
+	us[num - 2] = 0.2f;
+	us[num - 1] = 0.f;
+}
+
+void basis_matrix_banded(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[41];
+	size_t *first = NULL;
+	tsReal *values = NULL, *ctrlp = NULL, *expected = NULL;
+	tsReal sum, point[2];
+	size_t i, j, d;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		basis_matrix_setup(tc, &spline, us, 41);
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			&spline, us, 41, &expected, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_basis_banded(
+			&spline, us, 41, &first, &values, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < 41; i++) {
+			CuAssertTrue(tc, first[i] + 4 <= 8);
+			sum = 0;
+			point[0] = point[1] = 0;
+			for (j = 0; j < 4; j++) {
+				CuAssertTrue(tc, values[i * 4 + j] >= 0);
+				sum += values[i * 4 + j];
+				for (d = 0; d < 2; d++) {
+					point[d] += values[i * 4 + j] *
+						ctrlp[(first[i] + j) * 2 + d];
+				}
+			}
+			/* Partition of unity. */
+			CuAssertDblEquals(tc, 1.f, sum, EPSILON);
+			CuAssertDblEquals(tc, expected[i * 2], point[0],
+				EPSILON);
+			CuAssertDblEquals(tc, expected[i * 2 + 1], point[1],
+				EPSILON);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(first);
+		free(values);
+		free(ctrlp);
+		free(expected);
+	TS_END_TRY
+}
+
+void basis_matrix_csr(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[41];
+	size_t *row_ptr = NULL, *col_idx = NULL, *first = NULL;
+	tsReal *values = NULL, *banded = NULL;
+	size_t i, j;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		basis_matrix_setup(tc, &spline, us, 41);
+		TS_CALL(try, status.code, ts_bspline_basis_banded(
+			&spline, us, 41, &first, &banded, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_basis_csr(
+			&spline, us, 41, &row_ptr, &col_idx, &values, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i <= 41; i++)
+			CuAssertIntEquals(tc, (int) (i * 4), (int) row_ptr[i]);
+		for (i = 0; i < 41; i++) {
+			for (j = 0; j < 4; j++) {
+				CuAssertIntEquals(tc, (int) (first[i] + j),
+					(int) col_idx[row_ptr[i] + j]);
+				CuAssertDblEquals(tc, banded[i * 4 + j],
+					values[row_ptr[i] + j], 0);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(row_ptr);
+		free(col_idx);
+		free(values);
+		free(first);
+		free(banded);
+	TS_END_TRY
+}
+
+void basis_matrix_undefined_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[3] = { 0.f, 0.5f, -1.f };
+	size_t *row_ptr = NULL, *col_idx = NULL, *first = NULL;
+	tsReal *values = NULL;
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		5, 2, 2, TS_CLAMPED, &spline, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_basis_banded(
+		&spline, us, 3, &first, &values, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertPtrEquals(tc, NULL, first);
+	CuAssertPtrEquals(tc, NULL, values);
+
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_basis_csr(
+		&spline, us, 3, &row_ptr, &col_idx, &values, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertPtrEquals(tc, NULL, row_ptr);
+	CuAssertPtrEquals(tc, NULL, col_idx);
+	CuAssertPtrEquals(tc, NULL, values);
+
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_basis_matrix_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, basis_matrix_banded);
+	SUITE_ADD_TEST(suite, basis_matrix_csr);
+	SUITE_ADD_TEST(suite, basis_matrix_undefined_knot);
+	return suite;
+}
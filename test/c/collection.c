@@ -0,0 +1,241 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+#include "fixtures.h"
+
+#define EPSILON 0.0001
+
+/* Number of splines of the tests. Exceeds the size of a tile. */
+#define NUM_SPLINES 600
+
+/* Frees the first \p num splines of \p splines. */
+void collection_free_splines(tsBSpline *splines, size_t num)
+{
+	size_t i;
+	for (i = 0; i < num; i++)
+		ts_bspline_free(splines + i);
+}
+
+void collection_eval_equals_eval_point(CuTest *tc)
+{
+	tsBSplineCollection collection = ts_bsplinecollection_init();
+	tsBSpline splines[NUM_SPLINES];
+	tsReal us[NUM_SPLINES], *points = NULL, expected[3], min, max;
+	size_t i, deg, dim, offset;
+	tsStatus status;
+
+	const tsBSplineType types[3] = { TS_CLAMPED, TS_OPENED, TS_BEZIERS };
+
+	for (i = 0; i < NUM_SPLINES; i++)
+		splines[i] = ts_bspline_init();
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* Splines of different degree, dimension, number of control
+		 * points, and type (in arbitrary order). The knots include the
+		 * ends of the domains as well as discontinuities. */
+		for (i = 0; i < NUM_SPLINES; i++) {
+			deg = i % 4;
+			dim = 1 + (i / 4) % 3;
+			TS_CALL(try, status.code, ts_bspline_new(
+				(deg + 1) * (2 + (i % 5 == 0)), dim, deg,
+				types[(i / 12) % 3], splines + i, &status))
+			fixtures_control_points(tc, splines + i, i);
+			ts_bspline_domain(splines + i, &min, &max);
+			us[i] = min + (max - min) * ((i * 7) % 9) / 8;
+		}
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinecollection_new(
+			splines, NUM_SPLINES, &collection, &status))
+		points = (tsReal *) malloc(ts_bsplinecollection_len_points(
+			&collection) * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, points);
+		TS_CALL(try, status.code, ts_bsplinecollection_eval(
+			&collection, us, NULL, points, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, NUM_SPLINES,
+			(int) ts_bsplinecollection_num_splines(&collection));
+		CuAssertIntEquals(tc, 4 * 3 * 2,
+			(int) ts_bsplinecollection_num_groups(&collection));
+		offset = 0;
+		for (i = 0; i < NUM_SPLINES; i++) {
+			dim = ts_bspline_dimension(splines + i);
+			TS_CALL(try, status.code, ts_bspline_eval_point(
+				splines + i, us[i], expected, NULL, &status))
+			CuAssertDblEquals(tc, 0, ts_distance(expected,
+				points + offset, dim), EPSILON);
+			offset += dim;
+		}
+		CuAssertIntEquals(tc, (int) offset,
+			(int) ts_bsplinecollection_len_points(&collection));
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		collection_free_splines(splines, NUM_SPLINES);
+		ts_bsplinecollection_free(&collection);
+		free(points);
+	TS_END_TRY
+}
+
+void collection_eval_at(CuTest *tc)
+{
+	tsBSplineCollection collection = ts_bsplinecollection_init();
+	tsBSpline splines[NUM_SPLINES];
+	tsReal points[NUM_SPLINES * 2], expected[2], knots[9], u;
+	size_t i, j;
+	tsStatus status;
+
+	for (i = 0; i < NUM_SPLINES; i++)
+		splines[i] = ts_bspline_init();
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* The first group shares its knot vector, the knot vectors
+		 * of the second group differ. */
+		for (i = 0; i < NUM_SPLINES; i++) {
+			TS_CALL(try, status.code, ts_bspline_new(
+				i < NUM_SPLINES / 2 ? 5 : 6, 2, 2,
+				TS_CLAMPED, splines + i, &status))
+			fixtures_control_points(tc, splines + i, i);
+			if (i >= NUM_SPLINES / 2) {
+				ts_arr_fill(knots, 3, 0);
+				knots[3] = (tsReal) (1 + i % 7) / 18;
+				knots[4] = 0.5f;
+				knots[5] = 0.75f;
+				ts_arr_fill(knots + 6, 3, 1);
+				TS_CALL(try, status.code,
+					ts_bspline_set_knots(splines + i,
+					knots, &status))
+			}
+		}
+		TS_CALL(try, status.code, ts_bsplinecollection_new(
+			splines, NUM_SPLINES, &collection, &status))
+		CuAssertIntEquals(tc, 2,
+			(int) ts_bsplinecollection_num_groups(&collection));
+
+		for (j = 0; j <= 12; j++) {
+			u = (tsReal) j / 12;
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bsplinecollection_eval_at(
+				&collection, u, NULL, points, &status))
+
+/* ================================= Then ================================== */
+			for (i = 0; i < NUM_SPLINES; i++) {
+				TS_CALL(try, status.code, ts_bspline_eval_point(
+					splines + i, u, expected, NULL,
+					&status))
+				CuAssertDblEquals(tc, 0, ts_distance(expected,
+					points + i * 2, 2), EPSILON);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		collection_free_splines(splines, NUM_SPLINES);
+		ts_bsplinecollection_free(&collection);
+	TS_END_TRY
+}
+
+void collection_copy(CuTest *tc)
+{
+	tsBSplineCollection collection = ts_bsplinecollection_init();
+	tsBSplineCollection copy = ts_bsplinecollection_init();
+	tsBSpline splines[2];
+	tsReal expected[5], points[5], us[2] = { 0.25f, 0.75f };
+	tsStatus status;
+
+	splines[0] = ts_bspline_init();
+	splines[1] = ts_bspline_init();
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 3, 3, TS_CLAMPED, splines, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			4, 2, 1, TS_OPENED, splines + 1, &status))
+		fixtures_control_points(tc, splines, 0);
+		fixtures_control_points(tc, splines + 1, 1);
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			splines, us[0], expected, NULL, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			splines + 1, us[1], expected + 3, NULL, &status))
+		TS_CALL(try, status.code, ts_bsplinecollection_new(
+			splines, 2, &collection, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinecollection_copy(
+			&collection, &copy, &status))
+		/* The copy does not depend on splines and collection. */
+		collection_free_splines(splines, 2);
+		ts_bsplinecollection_free(&collection);
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 2,
+			(int) ts_bsplinecollection_num_splines(&copy));
+		CuAssertIntEquals(tc, 5,
+			(int) ts_bsplinecollection_len_points(&copy));
+		TS_CALL(try, status.code, ts_bsplinecollection_eval(
+			&copy, us, NULL, points, &status))
+		CuAssertDblEquals(tc, 0, ts_distance(expected, points, 5),
+			EPSILON);
+
+		/* Empty collections are valid. */
+		ts_bsplinecollection_free(&copy);
+		TS_CALL(try, status.code, ts_bsplinecollection_new(
+			NULL, 0, &copy, &status))
+		CuAssertIntEquals(tc, 0,
+			(int) ts_bsplinecollection_len_points(&copy));
+		TS_CALL(try, status.code, ts_bsplinecollection_eval_at(
+			&copy, 0.5f, NULL, points, &status))
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		collection_free_splines(splines, 2);
+		ts_bsplinecollection_free(&collection);
+		ts_bsplinecollection_free(&copy);
+	TS_END_TRY
+}
+
+void collection_undefined_knot(CuTest *tc)
+{
+	tsBSplineCollection collection = ts_bsplinecollection_init();
+	tsBSpline splines[2];
+	tsReal points[4], us[2] = { 0.5f, 1.5f };
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	splines[0] = ts_bspline_init();
+	splines[1] = ts_bspline_init();
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		5, 2, 2, TS_CLAMPED, splines, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		5, 2, 2, TS_CLAMPED, splines + 1, &status));
+	fixtures_control_points(tc, splines, 0);
+	fixtures_control_points(tc, splines + 1, 1);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bsplinecollection_new(
+		splines, 2, &collection, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bsplinecollection_eval(
+		&collection, us, NULL, points, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bsplinecollection_eval_at(
+		&collection, -0.5f, NULL, points, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+
+	collection_free_splines(splines, 2);
+	ts_bsplinecollection_free(&collection);
+}
+
+CuSuite* get_collection_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, collection_eval_equals_eval_point);
+	SUITE_ADD_TEST(suite, collection_eval_at);
+	SUITE_ADD_TEST(suite, collection_copy);
+	SUITE_ADD_TEST(suite, collection_undefined_knot);
+	return suite;
+}
@@ -0,0 +1,300 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+#include "fixtures.h"
+
+#define EPSILON 0.0001
+
+/* Asserts that \p a and \p b have the same domain and shape. */
+void degree_assert_same_shape(CuTest *tc, const tsBSpline *a,
+	const tsBSpline *b, tsReal epsilon)
+{
+	tsReal min_a, max_a, min_b, max_b, u, point_a[3], point_b[3];
+	size_t i;
+
+	ts_bspline_domain(a, &min_a, &max_a);
+	ts_bspline_domain(b, &min_b, &max_b);
+	CuAssertDblEquals(tc, min_a, min_b, EPSILON);
+	CuAssertDblEquals(tc, max_a, max_b, EPSILON);
+	for (i = 0; i <= 50; i++) {
+		u = min_a + (max_a - min_a) * i / 50;
+		CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_point(
+			a, u, point_a, NULL, NULL));
+		CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_point(
+			b, u, point_b, NULL, NULL));
+		CuAssertDblEquals(tc, 0, ts_distance(point_a, point_b,
+			ts_bspline_dimension(a)), epsilon);
+	}
+}
+
+void degree_elevate_preserves_shape(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline elevated = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	size_t deg, amount, n_segs;
+	tsStatus status;
+
+	const tsBSplineType types[2] = { TS_CLAMPED, TS_OPENED };
+
+	TS_TRY(try, status.code, &status)
+		for (deg = 1; deg <= 3; deg++) {
+			for (amount = 1; amount <= 2; amount++) {
+/* ================================= Given ================================= */
+				TS_CALL(try, status.code, ts_bspline_new(
+					(deg + 1) * 3, 3, deg,
+					types[(deg + amount) % 2], &spline,
+					&status))
+				fixtures_control_points(tc, &spline,
+					deg * amount);
+				TS_CALL(try, status.code, ts_bspline_to_beziers(
+					&spline, &beziers, &status))
+				n_segs = ts_bspline_num_control_points(
+					&beziers) / (deg + 1);
+
+/* ================================= When ================================== */
+				TS_CALL(try, status.code,
+					ts_bspline_elevate_degree(&spline,
+					amount, NULL, &elevated, &status))
+
+/* ================================= Then ================================== */
+				CuAssertIntEquals(tc, (int) (deg + amount),
+					(int) ts_bspline_degree(&elevated));
+				/* The continuity is preserved, i.e., each
+				 * segment gets amount control points. */
+				CuAssertIntEquals(tc,
+					(int) (n_segs * (amount + 1) + deg),
+					(int) ts_bspline_num_control_points(
+						&elevated));
+				degree_assert_same_shape(tc, &spline,
+					&elevated, EPSILON);
+
+				ts_bspline_free(&spline);
+				ts_bspline_free(&elevated);
+				ts_bspline_free(&beziers);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&elevated);
+		ts_bspline_free(&beziers);
+	TS_END_TRY
+}
+
+void degree_elevate_many_segments(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline elevated = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* More segments than a single task processes. */
+		TS_CALL(try, status.code, ts_bspline_new(
+			300, 2, 3, TS_CLAMPED, &spline, &status))
+		fixtures_control_points(tc, &spline, 0);
+		TS_CALL(try, status.code, ts_bspline_to_beziers(
+			&spline, &beziers, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_elevate_degree(
+			&spline, 1, NULL, &elevated, &status))
+
+/* ================================= Then ================================== */
+		/* n + s * t control points. */
+		CuAssertIntEquals(tc,
+			300 + (int) ts_bspline_num_control_points(&beziers) / 4,
+			(int) ts_bspline_num_control_points(&elevated));
+		degree_assert_same_shape(tc, &spline, &elevated, EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&elevated);
+		ts_bspline_free(&beziers);
+	TS_END_TRY
+}
+
+void degree_elevate_knots(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline elevated = ts_bspline_init();
+	tsReal *knots = NULL;
+	size_t i;
+	tsStatus status;
+
+	tsReal ctrlp[16] = {
+		0,  0,   1,  2,   2, -1,   3,  1,
+		4,  3,   5, -2,   6,  0,   7,  1
+	};
+	/* C2 at 0.25 and 0.75, C1 at 0.5. */
+	tsReal init[12] = { 0, 0, 0, 0, 0.25f, 0.5f, 0.5f, 0.75f, 1, 1, 1, 1 };
+	/* Each multiplicity m becomes m + 1. */
+	tsReal expected[17] = {
+		0, 0, 0, 0, 0,
+		0.25f, 0.25f,
+		0.5f, 0.5f, 0.5f,
+		0.75f, 0.75f,
+		1, 1, 1, 1, 1
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			8, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			&spline, init, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_elevate_degree(
+			&spline, 1, NULL, &elevated, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 4, (int) ts_bspline_degree(&elevated));
+		CuAssertIntEquals(tc, 12,
+			(int) ts_bspline_num_control_points(&elevated));
+		TS_CALL(try, status.code, ts_bspline_knots(
+			&elevated, &knots, &status))
+		for (i = 0; i < 17; i++)
+			CuAssertDblEquals(tc, expected[i], knots[i], EPSILON);
+		degree_assert_same_shape(tc, &spline, &elevated, EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&elevated);
+		free(knots);
+	TS_END_TRY
+}
+
+void degree_reduce_elevated(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline elevated = ts_bspline_init();
+	tsBSpline reduced = ts_bspline_init();
+	size_t deg;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (deg = 1; deg <= 3; deg++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				7, 2, deg, TS_CLAMPED, &spline, &status))
+			fixtures_control_points(tc, &spline, deg);
+			TS_CALL(try, status.code, ts_bspline_elevate_degree(
+				&spline, 2, NULL, &elevated, &status))
+
+/* ================================= When ================================== */
+			/* Elevated splines are reduced exactly. */
+			TS_CALL(try, status.code, ts_bspline_reduce_degree(
+				&elevated, 2, EPSILON, NULL, &reduced,
+				&status))
+
+/* ================================= Then ================================== */
+			CuAssertIntEquals(tc, (int) deg,
+				(int) ts_bspline_degree(&reduced));
+			degree_assert_same_shape(tc, &spline, &reduced,
+				EPSILON);
+
+			ts_bspline_free(&spline);
+			ts_bspline_free(&elevated);
+			ts_bspline_free(&reduced);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&elevated);
+		ts_bspline_free(&reduced);
+	TS_END_TRY
+}
+
+void degree_reduce_tolerance(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline reduced = ts_bspline_init();
+	tsReal min, max, first[2], last[2], point[2];
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 2, 3, TS_CLAMPED, &spline, &status))
+		fixtures_control_points(tc, &spline, 0);
+		ts_bspline_domain(&spline, &min, &max);
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&spline, min, first, NULL, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&spline, max, last, NULL, &status))
+
+/* =============================== When/Then =============================== */
+		/* A cubic spline cannot be reduced exactly ... */
+		CuAssertIntEquals(tc, TS_NO_RESULT, ts_bspline_reduce_degree(
+			&spline, 1, EPSILON, NULL, &reduced, &status));
+		CuAssertIntEquals(tc, TS_NO_RESULT, status.code);
+		/* ... but approximately. */
+		TS_CALL(try, status.code, ts_bspline_reduce_degree(
+			&spline, 1, 100, NULL, &reduced, &status))
+		CuAssertIntEquals(tc, 2, (int) ts_bspline_degree(&reduced));
+		/* The end points are preserved. */
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&reduced, min, point, NULL, &status))
+		CuAssertDblEquals(tc, 0, ts_distance(first, point, 2),
+			EPSILON);
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&reduced, max, point, NULL, &status))
+		CuAssertDblEquals(tc, 0, ts_distance(last, point, 2),
+			EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&reduced);
+	TS_END_TRY
+}
+
+void degree_amount_zero_and_too_large(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		7, 2, 3, TS_OPENED, &spline, &status));
+	fixtures_control_points(tc, &spline, 0);
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_elevate_degree(
+		&spline, 0, NULL, &result, &status));
+	CuAssertIntEquals(tc, 7, (int) ts_bspline_num_control_points(&result));
+	CuAssertIntEquals(tc, 3, (int) ts_bspline_degree(&result));
+	ts_bspline_free(&result);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_reduce_degree(
+		&spline, 0, 0, NULL, &result, &status));
+	CuAssertIntEquals(tc, 7, (int) ts_bspline_num_control_points(&result));
+	ts_bspline_free(&result);
+	CuAssertIntEquals(tc, TS_NO_RESULT, ts_bspline_reduce_degree(
+		&spline, 4, 100, NULL, &result, &status));
+	CuAssertIntEquals(tc, TS_NO_RESULT, status.code);
+
+	ts_bspline_free(&spline);
+	ts_bspline_free(&result);
+}
+
+CuSuite* get_degree_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, degree_elevate_preserves_shape);
+	SUITE_ADD_TEST(suite, degree_elevate_many_segments);
+	SUITE_ADD_TEST(suite, degree_elevate_knots);
+	SUITE_ADD_TEST(suite, degree_reduce_elevated);
+	SUITE_ADD_TEST(suite, degree_reduce_tolerance);
+	SUITE_ADD_TEST(suite, degree_amount_zero_and_too_large);
+	return suite;
+}
@@ -430,6 +430,107 @@ void eval_near_miss_knot(CuTest *tc)
 	TS_END_TRY
 }
 
+void eval_point_equals_eval(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *ctrlp = NULL, *result = NULL, *workspace = NULL;
+	tsReal point[20];
+	tsReal knots[20] = {
+		0.f, 0.f, 0.f, 0.f, 0.2f, 0.4f, 0.4f, 0.4f, 0.4f, 0.7f,
+		1.f, 1.f, 1.f, 1.f
+	};
+	size_t num[2] = { 10, 12 }, dim[2] = { 3, 20 }, deg[2] = { 3, 7 };
+	size_t c, i, j, d;
+	tsReal u;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		/* The second spline requires more than the workspace on the
+		 * stack. */
+		for (c = 0; c < 2; c++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				num[c], dim[c], deg[c], TS_CLAMPED, &spline,
+				&status))
+			if (c == 0) {
+				/* Contains a discontinuity at 0.4. */
+				TS_CALL(try, status.code, ts_bspline_set_knots(
+					&spline, knots, &status))
+			}
+			TS_CALL(try, status.code, ts_bspline_control_points(
+				&spline, &ctrlp, &status))
+			for (i = 0; i < num[c] * dim[c]; i++)
+				ctrlp[i] = (tsReal) ((i * 13) % 7) - 3.f;
+			TS_CALL(try, status.code,
+				ts_bspline_set_control_points(
+				&spline, ctrlp, &status))
+			workspace = (tsReal *) malloc(
+				ts_bspline_len_eval_workspace(&spline) *
+				sizeof(tsReal));
+			CuAssertPtrNotNull(tc, workspace);
+
+			for (i = 0; i <= 50; i++) {
+				u = (tsReal) i / 50;
+				TS_CALL(try, status.code, ts_bspline_eval(
+					&spline, u, &net, &status))
+				TS_CALL(try, status.code, ts_deboornet_result(
+					&net, &result, &status))
+				for (j = 0; j < 2; j++) {
+/* ================================= When ================================== */
+					TS_CALL(try, status.code,
+						ts_bspline_eval_point(&spline,
+						u, point, j ? workspace : NULL,
+						&status))
+
+/* ================================= Then ================================== */
+					for (d = 0; d < dim[c]; d++) {
+						CuAssertDblEquals(tc,
+							result[d], point[d],
+							0);
+					}
+				}
+				ts_deboornet_free(&net);
+				free(result);
+				result = NULL;
+			}
+			ts_bspline_free(&spline);
+			free(ctrlp);
+			free(workspace);
+			ctrlp = workspace = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_deboornet_free(&net);
+		free(ctrlp);
+		free(result);
+		free(workspace);
+	TS_END_TRY
+}
+
+void eval_point_undefined_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal point[3];
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		7, 3, 3, TS_OPENED, &spline, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_point(
+		&spline, TS_DOMAIN_DEFAULT_MIN, point, NULL, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_point(
+		&spline, TS_DOMAIN_DEFAULT_MAX, point, NULL, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+
+	ts_bspline_free(&spline);
+}
+
 CuSuite* get_eval_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -441,5 +542,7 @@ CuSuite* get_eval_suite()
 	SUITE_ADD_TEST(suite, eval_two_points);
 	SUITE_ADD_TEST(suite, eval_undefined_knot);
 	SUITE_ADD_TEST(suite, eval_near_miss_knot);
+	SUITE_ADD_TEST(suite, eval_point_equals_eval);
+	SUITE_ADD_TEST(suite, eval_point_undefined_knot);
 	return suite;
 }
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+void eval_batch_equals_eval(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *result = NULL;
+	tsReal points[3 * 23];
+	tsReal *workspace = NULL;
+	tsReal us[23];
+	size_t i, d;
+	tsStatus status;
+
+	tsReal ctrlp[21] = {
+		 1.0f, -2.0f,  0.5f,
+		 2.0f,  1.0f,  3.0f,
+		-1.5f,  4.0f,  0.0f,
+		 0.25f, 3.0f, -1.0f,
+		 5.0f, -3.0f,  2.0f,
+		 6.0f,  0.5f,  1.5f,
+		-2.0f,  1.0f,  4.0f
+	};
+	tsReal knots[11] = {
+		0.f, 0.f, 0.f, 0.f, 0.2f, 0.5f, 0.5f, 1.f, 1.f, 1.f, 1.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 3, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			&spline, knots, &status))
+		for (i = 0; i < 21; i++)
+			us[i] = (tsReal) i / 20;
+		us[21] = 0.5f;
+		us[22] = 0.2f;
+		CuAssertTrue(tc, ts_bspline_len_eval_workspace(&spline) >= 12);
+		workspace = (tsReal *) malloc(
+			ts_bspline_len_eval_workspace(&spline) *
+			sizeof(tsReal));
+		CuAssertPtrNotNull(tc, workspace);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_batch(
+			&spline, us, 23, points, workspace, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < 23; i++) {
+			TS_CALL(try, status.code, ts_bspline_eval(
+				&spline, us[i], &net, &status))
+			TS_CALL(try, status.code, ts_deboornet_result(
+				&net, &result, &status))
+			for (d = 0; d < 3; d++) {
+				CuAssertDblEquals(tc, result[d],
+					points[i * 3 + d],
+					TS_CONTROL_POINT_EPSILON);
+			}
+			ts_deboornet_free(&net);
+			free(result);
+			result = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(workspace);
+		ts_deboornet_free(&net);
+		free(result);
+	TS_END_TRY
+}
+
+void eval_batch_discontinuous(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 3];
+	tsReal *workspace = NULL;
+	tsStatus status;
+
+	tsReal ctrlp[12] = {
+		0.f, 0.f,
+		1.f, 1.f,
+		2.f, 0.f,
+		3.f, 3.f,
+		4.f, 4.f,
+		5.f, 3.f
+	};
+	tsReal knots[9] = {
+		0.f, 0.f, 0.f, 0.5f, 0.5f, 0.5f, 1.f, 1.f, 1.f
+	};
+	tsReal us[3] = { 0.f, 0.5f, 1.f };
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			6, 2, 2, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			&spline, knots, &status))
+		workspace = (tsReal *) malloc(
+			ts_bspline_len_eval_workspace(&spline) *
+			sizeof(tsReal));
+		CuAssertPtrNotNull(tc, workspace);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_batch(
+			&spline, us, 3, points, workspace, &status))
+
+/* ================================= Then ================================== */
+		/* Only the first point is taken at a discontinuity. */
+		CuAssertDblEquals(tc, 0.f, points[0], EPSILON);
+		CuAssertDblEquals(tc, 0.f, points[1], EPSILON);
+		CuAssertDblEquals(tc, 2.f, points[2], EPSILON);
+		CuAssertDblEquals(tc, 0.f, points[3], EPSILON);
+		CuAssertDblEquals(tc, 5.f, points[4], EPSILON);
+		CuAssertDblEquals(tc, 3.f, points[5], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(workspace);
+	TS_END_TRY
+}
+
+void eval_batch_ascending(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *ctrlp = NULL, *knots = NULL, *result = NULL;
+	tsReal *us = NULL, *points = NULL;
+	tsReal *workspace = NULL;
+	const size_t num = 1000;
+	size_t i, d;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			200, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		for (i = 0; i < 400; i++)
+			ctrlp[i] = (tsReal) ((i * 7919) % 101) / 10;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_knots(
+			&spline, &knots, &status))
+
+		us = (tsReal *) malloc(num * sizeof(tsReal));
+		points = (tsReal *) malloc(num * 2 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, us);
+		CuAssertPtrNotNull(tc, points);
+		workspace = (tsReal *) malloc(
+			ts_bspline_len_eval_workspace(&spline) *
+			sizeof(tsReal));
+		CuAssertPtrNotNull(tc, workspace);
+		/* Ascending knots, some of them being (near) knot values, with
+		 * a single descent in the middle. */
+		for (i = 0; i < num; i++)
+			us[i] = (tsReal) i / (num - 1);
+		us[100] = knots[20];
+		us[101] = knots[21] - TS_KNOT_EPSILON / 2;
+		us[102] = knots[22] + TS_KNOT_EPSILON / 2;
+		us[500] = (tsReal) 0.25f;
+		us[998] = knots[200];
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_batch(
+			&spline, us, num, points, workspace, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < num; i++) {
+			TS_CALL(try, status.code, ts_bspline_eval(
+				&spline, us[i], &net, &status))
+			TS_CALL(try, status.code, ts_deboornet_result(
+				&net, &result, &status))
+			for (d = 0; d < 2; d++) {
+				CuAssertDblEquals(tc, result[d],
+					points[i * 2 + d],
+					TS_CONTROL_POINT_EPSILON);
+			}
+			ts_deboornet_free(&net);
+			free(result);
+			result = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(workspace);
+		ts_deboornet_free(&net);
+		free(ctrlp);
+		free(knots);
+		free(result);
+		free(us);
+		free(points);
+	TS_END_TRY
+}
+
+void eval_batch_dimensions(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsDeBoorNet net = ts_deboornet_init();
+	tsReal *ctrlp = NULL, *result = NULL, *workspace = NULL;
+	tsReal us[61], points[5 * 61];
+	size_t dim, i, d;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (dim = 1; dim <= 5; dim++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				9, dim, 3, TS_CLAMPED, &spline, &status))
+			TS_CALL(try, status.code, ts_bspline_control_points(
+				&spline, &ctrlp, &status))
+			for (i = 0; i < 9 * dim; i++)
+				ctrlp[i] = (tsReal) ((i * 37) % 17) - 8.f;
+			TS_CALL(try, status.code,
+				ts_bspline_set_control_points(
+					&spline, ctrlp, &status))
+			workspace = (tsReal *) malloc(
+				ts_bspline_len_eval_workspace(&spline) *
+				sizeof(tsReal));
+			CuAssertPtrNotNull(tc, workspace);
+			/* Ascending followed by descending knots. */
+			for (i = 0; i < 61; i++) {
+				us[i] = i < 41 ? (tsReal) i / 40
+					: (tsReal) (60 - i) / 20;
+			}
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_eval_batch(
+				&spline, us, 61, points, workspace, &status))
+
+/* ================================= Then ================================== */
+			for (i = 0; i < 61; i++) {
+				TS_CALL(try, status.code, ts_bspline_eval(
+					&spline, us[i], &net, &status))
+				TS_CALL(try, status.code, ts_deboornet_result(
+					&net, &result, &status))
+				for (d = 0; d < dim; d++) {
+					CuAssertDblEquals(tc, result[d],
+						points[i * dim + d],
+						TS_CONTROL_POINT_EPSILON);
+				}
+				ts_deboornet_free(&net);
+				free(result);
+				result = NULL;
+			}
+			ts_bspline_free(&spline);
+			free(ctrlp);
+			ctrlp = NULL;
+			free(workspace);
+			workspace = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_deboornet_free(&net);
+		free(ctrlp);
+		free(result);
+		free(workspace);
+	TS_END_TRY
+}
+
+void eval_batch_undefined_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 2];
+	tsReal *workspace = NULL;
+	tsReal us[2] = { 0.5f, 1.5f };
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 2, 3, TS_CLAMPED, &spline, &status));
+	workspace = (tsReal *) malloc(
+		ts_bspline_len_eval_workspace(&spline) * sizeof(tsReal));
+	CuAssertPtrNotNull(tc, workspace);
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_batch(
+		&spline, us, 2, points, workspace, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+
+	ts_bspline_free(&spline);
+	free(workspace);
+}
+
+CuSuite* get_eval_batch_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, eval_batch_equals_eval);
+	SUITE_ADD_TEST(suite, eval_batch_discontinuous);
+	SUITE_ADD_TEST(suite, eval_batch_ascending);
+	SUITE_ADD_TEST(suite, eval_batch_dimensions);
+	SUITE_ADD_TEST(suite, eval_batch_undefined_knot);
+	return suite;
+}
@@ -0,0 +1,323 @@
+#include <stdlib.h>
+#include <math.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+#include "fixtures.h"
+
+#define EPSILON 0.0001
+
+/* Returns the largest absolute value of the control points of \p spline.
+ * The rounding error of derivatives scales with this magnitude. */
+tsReal eval_derivatives_magnitude(CuTest *tc, const tsBSpline *spline)
+{
+	tsReal *ctrlp = NULL;
+	tsReal max = 0;
+	size_t i, len;
+
+	len = ts_bspline_len_control_points(spline);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		spline, &ctrlp, NULL));
+	for (i = 0; i < len; i++)
+		max = fabs(ctrlp[i]) > max ? (tsReal) fabs(ctrlp[i]) : max;
+	free(ctrlp);
+	return max;
+}
+
+void eval_derivatives_equals_derive(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline derivative = ts_bspline_init();
+	tsReal points[7 * 3], expected[3], u, tol;
+	size_t deg, n, i, d;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (deg = 0; deg <= 5; deg++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				9, 3, deg, TS_CLAMPED, &spline, &status))
+			fixtures_control_points(tc, &spline, 0);
+
+			for (i = 0; i <= 37; i++) {
+				/* 37 is prime, i.e., no u is an inner knot. */
+				u = (tsReal) i / 37;
+
+/* ================================= When ================================== */
+				TS_CALL(try, status.code,
+					ts_bspline_eval_derivatives(&spline,
+						u, deg + 1, points, NULL,
+						&status))
+
+/* ================================= Then ================================== */
+				for (n = 0; n <= deg; n++) {
+					TS_CALL(try, status.code,
+						ts_bspline_derive(&spline, n,
+						-1.f, &derivative, &status))
+					TS_CALL(try, status.code,
+						ts_bspline_eval_point(
+						&derivative, u, expected, NULL,
+						&status))
+					tol = (tsReal) EPSILON * (1 +
+						eval_derivatives_magnitude(tc,
+						&derivative));
+					for (d = 0; d < 3; d++) {
+						CuAssertDblEquals(tc,
+							expected[d],
+							points[n * 3 + d], tol);
+					}
+					ts_bspline_free(&derivative);
+				}
+				/* Derivatives of higher order vanish. */
+				for (d = 0; d < 3; d++) {
+					CuAssertDblEquals(tc, 0.f,
+						points[(deg + 1) * 3 + d], 0);
+				}
+			}
+			ts_bspline_free(&spline);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&derivative);
+	TS_END_TRY
+}
+
+void eval_derivatives_batch(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[64], expected[3 * 3], *points = NULL, *workspace = NULL;
+	size_t i, len;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			20, 3, 4, TS_OPENED, &spline, &status))
+		fixtures_control_points(tc, &spline, 0);
+		/* Unordered knots within the domain. */
+		for (i = 0; i < 64; i++)
+			us[i] = 0.25f + (tsReal) ((i * 29) % 64) / 126;
+		len = ts_bspline_len_eval_derivatives_workspace(&spline, 2);
+		workspace = (tsReal *) malloc(len * sizeof(tsReal));
+		points = (tsReal *) malloc(64 * 3 * 3 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, workspace);
+		CuAssertPtrNotNull(tc, points);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_derivatives_batch(
+			&spline, us, 64, 2, points, workspace, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < 64; i++) {
+			TS_CALL(try, status.code, ts_bspline_eval_derivatives(
+				&spline, us[i], 2, expected, NULL, &status))
+			CuAssertDblEquals(tc, 0, ts_distance(expected,
+				points + i * 9, 9), 0);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(points);
+		free(workspace);
+	TS_END_TRY
+}
+
+void eval_derivatives_discontinuous(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 2], point[2];
+	tsStatus status;
+
+	tsReal ctrlp[12] = {
+		0.f, 0.f,
+		1.f, 2.f,
+		2.f, 0.f,
+		5.f, 5.f,
+		6.f, 3.f,
+		7.f, 5.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* Two separate Beziers joined at knot 0.5. */
+		TS_CALL(try, status.code, ts_bspline_new(
+			6, 2, 2, TS_BEZIERS, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_derivatives(
+			&spline, 0.5f, 1, points, NULL, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&spline, 0.5f, point, NULL, &status))
+
+/* ================================= Then ================================== */
+		/* The left-hand side limit is taken. */
+		CuAssertDblEquals(tc, point[0], points[0], EPSILON);
+		CuAssertDblEquals(tc, point[1], points[1], EPSILON);
+		CuAssertDblEquals(tc, 2.f, points[0], EPSILON);
+		CuAssertDblEquals(tc, 0.f, points[1], EPSILON);
+		/* P'(1) of the first Bezier: 2 * (P2 - P1) / 0.5 */
+		CuAssertDblEquals(tc, 4.f, points[2], EPSILON);
+		CuAssertDblEquals(tc, -8.f, points[3], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void eval_derivatives_inner_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline derivative = ts_bspline_init();
+	tsReal points[2], expected;
+	size_t i;
+	tsStatus status;
+
+	/* A line with kink at 0.5 and a parabola with kink at 0.5. */
+	tsReal line[3] = { 0.f, 1.f, 3.f };
+	tsReal line_knots[5] = { 0.f, 0.f, 0.5f, 1.f, 1.f };
+	tsReal parabola[5] = { 0.f, 1.f, 2.f, 4.f, 3.f };
+	tsReal parabola_knots[8] = {
+		0.f, 0.f, 0.f, 0.5f, 0.5f, 1.f, 1.f, 1.f
+	};
+	const size_t num_ctrlp[2] = { 3, 5 };
+	const tsReal *ctrlp[2] = { line, parabola };
+	const tsReal *knots[2] = { line_knots, parabola_knots };
+	/* P'(0.5) of the left segment. */
+	const tsReal left[2] = { 2.f, 4.f };
+
+	TS_TRY(try, status.code, &status)
+		for (i = 0; i < 2; i++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				num_ctrlp[i], 1, i + 1, TS_CLAMPED, &spline,
+				&status))
+			TS_CALL(try, status.code,
+				ts_bspline_set_control_points(&spline,
+				ctrlp[i], &status))
+			TS_CALL(try, status.code, ts_bspline_set_knots(
+				&spline, knots[i], &status))
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_eval_derivatives(
+				&spline, 0.5f, 1, points, NULL, &status))
+			TS_CALL(try, status.code, ts_bspline_derive(
+				&spline, 1, -1.f, &derivative, &status))
+			TS_CALL(try, status.code, ts_bspline_eval_point(
+				&derivative, 0.5f, &expected, NULL, &status))
+
+/* ================================= Then ================================== */
+			/* The left-hand side limit is taken. */
+			CuAssertDblEquals(tc, expected, points[1], EPSILON);
+			CuAssertDblEquals(tc, left[i], points[1], EPSILON);
+
+			ts_bspline_free(&spline);
+			ts_bspline_free(&derivative);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&derivative);
+	TS_END_TRY
+}
+
+void eval_derivatives_undefined_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[3 * 2];
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		7, 2, 3, TS_CLAMPED, &spline, &status));
+	fixtures_control_points(tc, &spline, 0);
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_derivatives(
+		&spline, 1.5f, 2, points, NULL, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+
+	ts_bspline_free(&spline);
+}
+
+void eval_derivatives_is_closed(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	int closed;
+	tsStatus status;
+
+	tsReal ctrlp[16] = {
+		 1.f,  0.f,
+		 0.f,  1.f,
+		-1.f,  0.f,
+		 0.f, -1.f,
+		 1.f,  0.f,
+		 0.f,  1.f,
+		-1.f,  0.f,
+		 0.f, -1.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A periodic cubic spline (the first three control points are
+		 * repeated at the end). */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 2, 3, TS_OPENED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp + 2, &status))
+
+/* =============================== When/Then =============================== */
+		TS_CALL(try, status.code, ts_bspline_is_closed(
+			&spline, EPSILON, &closed, &status))
+		CuAssertIntEquals(tc, 1, closed);
+
+		/* Endpoints match, but tangents do not. */
+		ts_bspline_free(&spline);
+		TS_CALL(try, status.code, ts_bspline_new(
+			5, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_is_closed(
+			&spline, EPSILON, &closed, &status))
+		CuAssertIntEquals(tc, 0, closed);
+
+		/* Degree 0 compares the endpoints only. */
+		ts_bspline_free(&spline);
+		TS_CALL(try, status.code, ts_bspline_new(
+			5, 2, 0, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_is_closed(
+			&spline, EPSILON, &closed, &status))
+		CuAssertIntEquals(tc, 1, closed);
+		ts_bspline_free(&spline);
+		TS_CALL(try, status.code, ts_bspline_new(
+			4, 2, 0, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_is_closed(
+			&spline, EPSILON, &closed, &status))
+		CuAssertIntEquals(tc, 0, closed);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+CuSuite* get_eval_derivatives_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, eval_derivatives_equals_derive);
+	SUITE_ADD_TEST(suite, eval_derivatives_batch);
+	SUITE_ADD_TEST(suite, eval_derivatives_discontinuous);
+	SUITE_ADD_TEST(suite, eval_derivatives_inner_knot);
+	SUITE_ADD_TEST(suite, eval_derivatives_undefined_knot);
+	SUITE_ADD_TEST(suite, eval_derivatives_is_closed);
+	return suite;
+}
@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* Runs the tasks in reverse order and counts the number of calls. */
+void reverse_run(void *ctx, tsTask task, void *args, size_t num)
+{
+	size_t *num_calls = (size_t *) ctx;
+	size_t i;
+	(*num_calls)++;
+	for (i = num; i > 0; i--)
+		task(args, i - 1);
+}
+
+void setup_spline(CuTest *tc, tsBSpline *spline)
+{
+	tsReal *ctrlp = NULL;
+	size_t i;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		50, 3, 3, TS_CLAMPED, spline, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		spline, &ctrlp, NULL));
+	for (i = 0; i < 150; i++)
+		ctrlp[i] = (tsReal) ((i * 31) % 23) / 4;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		spline, ctrlp, NULL));
+	free(ctrlp);
+}
+
+void eval_all_parallel_default_executor(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *us = NULL, *expected = NULL, *points = NULL;
+	const size_t num = 10007;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		setup_spline(tc, &spline);
+		us = (tsReal *) malloc(num * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, us);
+		for (i = 0; i < num; i++)
+			us[i] = (tsReal) ((i * 7) % num) / (num - 1);
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			&spline, us, num, &expected, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_all_parallel(
+			&spline, us, num, NULL, &points, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < num * 3; i++)
+			CuAssertDblEquals(tc, expected[i], points[i], 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(us);
+		free(expected);
+		free(points);
+	TS_END_TRY
+}
+
+void eval_all_parallel_custom_executor(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *expected = NULL, *points = NULL;
+	tsExecutor executor;
+	size_t num_calls = 0, num_expected, num_points, i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		setup_spline(tc, &spline);
+		executor.run = reverse_run;
+		executor.ctx = &num_calls;
+		TS_CALL(try, status.code, ts_bspline_sample(
+			&spline, 5000, &expected, &num_expected, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_sample_parallel(
+			&spline, 5000, &executor, &points, &num_points,
+			&status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 1, (int) num_calls);
+		CuAssertIntEquals(tc, (int) num_expected, (int) num_points);
+		for (i = 0; i < num_points * 3; i++)
+			CuAssertDblEquals(tc, expected[i], points[i], 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(expected);
+		free(points);
+	TS_END_TRY
+}
+
+void eval_all_parallel_undefined_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *us = NULL, *points = NULL;
+	const size_t num = 5000;
+	size_t i;
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	setup_spline(tc, &spline);
+	us = (tsReal *) malloc(num * sizeof(tsReal));
+	CuAssertPtrNotNull(tc, us);
+	for (i = 0; i < num; i++)
+		us[i] = (tsReal) i / (num - 1);
+	us[4321] = (tsReal) 1.5f;
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_all_parallel(
+		&spline, us, num, NULL, &points, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertPtrEquals(tc, NULL, points);
+
+	ts_bspline_free(&spline);
+	free(us);
+}
+
+CuSuite* get_eval_parallel_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, eval_all_parallel_default_executor);
+	SUITE_ADD_TEST(suite, eval_all_parallel_custom_executor);
+	SUITE_ADD_TEST(suite, eval_all_parallel_undefined_knot);
+	return suite;
+}
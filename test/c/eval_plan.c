@@ -0,0 +1,296 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+/* Compares the points of \p plan applied to \p spline with the points
+ * calculated by ts_bspline_eval_all. */
+void assert_plan_equals_eval_all(CuTest *tc, const tsBSpline *spline,
+	const tsReal *us, size_t num)
+{
+	tsEvalPlan plan = ts_evalplan_init();
+	tsReal *expected = NULL, *points = NULL;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			spline, us, num, &expected, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_plan(
+			spline, us, num, &plan, &status))
+		CuAssertIntEquals(tc, (int) num,
+			(int) ts_evalplan_num_points(&plan));
+		points = (tsReal *) malloc(
+			num * ts_bspline_dimension(spline) * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, points);
+		TS_CALL(try, status.code, ts_evalplan_apply(
+			&plan, spline, points, &status))
+		for (i = 0; i < num * ts_bspline_dimension(spline); i++) {
+			CuAssertDblEquals(tc, expected[i], points[i],
+				TS_CONTROL_POINT_EPSILON);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_evalplan_free(&plan);
+		free(expected);
+		free(points);
+	TS_END_TRY
+}
+
+void eval_plan_equals_eval_all(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal us[25];
+	size_t i;
+	tsStatus status;
+
+	tsReal ctrlp[21] = {
+		 1.0f, -2.0f,  0.5f,
+		 2.0f,  1.0f,  3.0f,
+		-1.5f,  4.0f,  0.0f,
+		 0.25f, 3.0f, -1.0f,
+		 5.0f, -3.0f,  2.0f,
+		 6.0f,  0.5f,  1.5f,
+		-2.0f,  1.0f,  4.0f
+	};
+	tsReal knots[11] = {
+		0.f, 0.f, 0.f, 0.f, 0.2f, 0.5f, 0.5f, 1.f, 1.f, 1.f, 1.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 3, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			&spline, knots, &status))
+		/* Ascending knots followed by some unordered ones. */
+		for (i = 0; i < 21; i++)
+			us[i] = (tsReal) i / 20;
+		us[21] = 0.5f;
+		us[22] = 0.2f;
+		us[23] = 0.f;
+		us[24] = 0.75f;
+
+/* ============================= When/Then ================================= */
+		assert_plan_equals_eval_all(tc, &spline, us, 25);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void eval_plan_discontinuous(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsStatus status;
+
+	tsReal ctrlp[12] = {
+		0.f, 0.f,
+		1.f, 1.f,
+		2.f, 0.f,
+		3.f, 3.f,
+		4.f, 4.f,
+		5.f, 3.f
+	};
+	tsReal knots[9] = {
+		0.f, 0.f, 0.f, 0.5f, 0.5f, 0.5f, 1.f, 1.f, 1.f
+	};
+	tsReal us[5] = { 0.f, 0.25f, 0.5f, 0.75f, 1.f };
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			6, 2, 2, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			&spline, knots, &status))
+
+/* ============================= When/Then ================================= */
+		assert_plan_equals_eval_all(tc, &spline, us, 5);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void eval_plan_opened(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	tsReal us[3];
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			8, 2, 3, TS_OPENED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		for (i = 0; i < 16; i++)
+			ctrlp[i] = (tsReal) ((i * 13) % 7);
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		ts_bspline_domain(&spline, &us[0], &us[2]);
+		us[1] = (us[0] + us[2]) / 2;
+
+/* ============================= When/Then ================================= */
+		assert_plan_equals_eval_all(tc, &spline, us, 3);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(ctrlp);
+	TS_END_TRY
+}
+
+void eval_plan_changed_control_points(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsEvalPlan plan = ts_evalplan_init();
+	tsReal *ctrlp = NULL, *expected = NULL;
+	tsReal us[101], points[3 * 101];
+	size_t i, j;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			30, 3, 3, TS_CLAMPED, &spline, &status))
+		for (i = 0; i < 101; i++)
+			us[i] = (tsReal) i / 100;
+		TS_CALL(try, status.code, ts_bspline_eval_plan(
+			&spline, us, 101, &plan, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+
+		for (j = 1; j <= 3; j++) {
+/* ================================= When ================================== */
+			for (i = 0; i < 90; i++)
+				ctrlp[i] = (tsReal) ((i * j * 31) % 23) / 4;
+			TS_CALL(try, status.code, ts_bspline_set_control_points(
+				&spline, ctrlp, &status))
+			TS_CALL(try, status.code, ts_evalplan_apply(
+				&plan, &spline, points, &status))
+
+/* ================================= Then ================================== */
+			TS_CALL(try, status.code, ts_bspline_eval_all(
+				&spline, us, 101, &expected, &status))
+			for (i = 0; i < 3 * 101; i++) {
+				CuAssertDblEquals(tc, expected[i], points[i],
+					TS_CONTROL_POINT_EPSILON);
+			}
+			free(expected);
+			expected = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_evalplan_free(&plan);
+		free(ctrlp);
+		free(expected);
+	TS_END_TRY
+}
+
+void eval_plan_copy(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsEvalPlan plan = ts_evalplan_init();
+	tsEvalPlan copy = ts_evalplan_init();
+	tsReal us[3] = { 0.f, 0.3f, 1.f };
+	tsReal expected[2 * 3], points[2 * 3];
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			5, 2, 2, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_plan(
+			&spline, us, 3, &plan, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_evalplan_copy(
+			&plan, &copy, &status))
+
+/* ================================= Then ================================== */
+		CuAssertTrue(tc, plan.pImpl != copy.pImpl);
+		CuAssertIntEquals(tc, 3, (int) ts_evalplan_num_points(&copy));
+		CuAssertIntEquals(tc, 2, (int) ts_evalplan_degree(&copy));
+		CuAssertIntEquals(tc, 5,
+			(int) ts_evalplan_num_control_points(&copy));
+		TS_CALL(try, status.code, ts_evalplan_apply(
+			&plan, &spline, expected, &status))
+		TS_CALL(try, status.code, ts_evalplan_apply(
+			&copy, &spline, points, &status))
+		for (i = 0; i < 2 * 3; i++)
+			CuAssertDblEquals(tc, expected[i], points[i], 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_evalplan_free(&plan);
+		ts_evalplan_free(&copy);
+	TS_END_TRY
+}
+
+void eval_plan_incompatible(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline other = ts_bspline_init();
+	tsEvalPlan plan = ts_evalplan_init();
+	tsReal us[2] = { 0.25f, 0.75f };
+	tsReal points[2 * 2];
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		7, 2, 3, TS_CLAMPED, &spline, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_plan(
+		&spline, us, 2, &plan, &status));
+
+/* =============================== When/Then =============================== */
+	/* Different degree. */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		7, 2, 2, TS_CLAMPED, &other, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_evalplan_apply(
+		&plan, &other, points, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, status.code);
+	ts_bspline_free(&other);
+
+	/* Same degree and number of knots, but different knots. */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		7, 2, 3, TS_OPENED, &other, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_evalplan_apply(
+		&plan, &other, points, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, status.code);
+
+	/* Undefined knot. */
+	us[1] = 1.5f;
+	ts_evalplan_free(&plan);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_eval_plan(
+		&spline, us, 2, &plan, &status));
+	CuAssertPtrEquals(tc, NULL, plan.pImpl);
+
+	ts_bspline_free(&spline);
+	ts_bspline_free(&other);
+	ts_evalplan_free(&plan);
+}
+
+CuSuite* get_eval_plan_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, eval_plan_equals_eval_all);
+	SUITE_ADD_TEST(suite, eval_plan_discontinuous);
+	SUITE_ADD_TEST(suite, eval_plan_opened);
+	SUITE_ADD_TEST(suite, eval_plan_changed_control_points);
+	SUITE_ADD_TEST(suite, eval_plan_copy);
+	SUITE_ADD_TEST(suite, eval_plan_incompatible);
+	return suite;
+}
@@ -0,0 +1,19 @@
+#include <stdlib.h>
+#include "fixtures.h"
+
+void fixtures_control_points(CuTest *tc, tsBSpline *spline, size_t seed)
+{
+	tsReal *ctrlp = NULL;
+	size_t i, len;
+
+	len = ts_bspline_len_control_points(spline);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		spline, &ctrlp, NULL));
+	/* 7919 is prime and coprime to 23, the squares break up runs of
+	 * collinear values. */
+	for (i = 0; i < len; i++)
+		ctrlp[i] = (tsReal) (((i * i + seed) * 7919) % 23) / 4 - 2;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		spline, ctrlp, NULL));
+	free(ctrlp);
+}
@@ -0,0 +1,14 @@
+#ifndef TINYSPLINE_TESTS_FIXTURES_H
+#define TINYSPLINE_TESTS_FIXTURES_H
+
+#include <tinyspline.h>
+#include "CuTest.h"
+
+/* Fills the control points of \p spline with deterministic, scattered values
+ * in [-2, 3.5] that depend on \p seed. Unlike values that grow linearly with
+ * the index, adjacent control points are (in general) not collinear, so that
+ * the knots of \p spline cannot be removed exactly. Used by tests that
+ * compare different representations of an arbitrary spline. */
+void fixtures_control_points(CuTest *tc, tsBSpline *spline, size_t seed);
+
+#endif /* TINYSPLINE_TESTS_FIXTURES_H */
@@ -0,0 +1,214 @@
+#include <stdlib.h>
+#include <math.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* Returns the distance between \p point and the polyline \p points. */
+tsReal flatten_distance_polyline(const tsReal *point, const tsReal *points,
+	size_t num, size_t dim)
+{
+	tsReal min = -1, len_sq, t, dist, v;
+	size_t i, d;
+	for (i = 0; i + 1 < num; i++) {
+		len_sq = t = dist = 0;
+		for (d = 0; d < dim; d++) {
+			v = points[(i+1) * dim + d] - points[i * dim + d];
+			len_sq += v * v;
+			t += (point[d] - points[i * dim + d]) * v;
+		}
+		t = len_sq > 0 ? t / len_sq : 0;
+		t = t < 0 ? 0 : (t > 1 ? 1 : t);
+		for (d = 0; d < dim; d++) {
+			v = point[d] - points[i * dim + d] - t *
+				(points[(i+1) * dim + d] - points[i * dim + d]);
+			dist += v * v;
+		}
+		if (min < 0 || dist < min)
+			min = dist;
+	}
+	return (tsReal) sqrt(min);
+}
+
+void flatten_line(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 4];
+	size_t num;
+	tsStatus status;
+
+	tsReal ctrlp[10] = {
+		0.f, 0.f,
+		1.f, 1.f,
+		2.f, 2.f,
+		3.f, 3.f,
+		4.f, 4.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			5, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_flatten(
+			&spline, 0.01f, points, 4, &num, &status))
+
+/* ================================= Then ================================== */
+		/* The Bezier segments of a line are flat. */
+		CuAssertIntEquals(tc, 3, (int) num);
+		CuAssertDblEquals(tc, 0.f, points[0], EPSILON);
+		CuAssertDblEquals(tc, 0.f, points[1], EPSILON);
+		CuAssertDblEquals(tc, 4.f, points[4], EPSILON);
+		CuAssertDblEquals(tc, 4.f, points[5], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void flatten_within_tolerance(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL, *points = NULL, *samples = NULL;
+	tsReal tolerance;
+	size_t num, num_samples, i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			10, 3, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		for (i = 0; i < 30; i++)
+			ctrlp[i] = (tsReal) ((i * 31) % 17) / 4;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_sample(
+			&spline, 5000, &samples, &num_samples, &status))
+
+		for (tolerance = 0.1f; tolerance > 0.0005f; tolerance /= 10) {
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_flatten(
+				&spline, tolerance, NULL, 0, &num, &status))
+			points = (tsReal *) malloc(num * 3 * sizeof(tsReal));
+			CuAssertPtrNotNull(tc, points);
+			TS_CALL(try, status.code, ts_bspline_flatten(
+				&spline, tolerance, points, num, &num, &status))
+
+/* ================================= Then ================================== */
+			CuAssertDblEquals(tc, samples[0], points[0], EPSILON);
+			CuAssertDblEquals(tc, samples[(num_samples-1) * 3],
+				points[(num-1) * 3], EPSILON);
+			for (i = 0; i < num_samples; i++) {
+				CuAssertTrue(tc, flatten_distance_polyline(
+					samples + i * 3, points, num, 3) <=
+					tolerance);
+			}
+			free(points);
+			points = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(ctrlp);
+		free(points);
+		free(samples);
+	TS_END_TRY
+}
+
+void flatten_adaptive(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	size_t num_flat, num_bent;
+	tsStatus status;
+
+	/* The first segment is flat, the second one is bent. */
+	tsReal ctrlp[16] = {
+		0.f, 0.f,
+		1.f, 0.f,
+		2.f, 0.f,
+		3.f, 0.f,
+		3.f, 0.f,
+		3.f, 3.f,
+		0.f, 3.f,
+		0.f, 1.f
+	};
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			8, 2, 3, TS_BEZIERS, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_flatten(
+			&spline, 0.001f, NULL, 0, &num_bent, &status))
+		ctrlp[11] = ctrlp[13] = ctrlp[15] = 0.f;
+		ctrlp[10] = 4.f;
+		ctrlp[12] = 5.f;
+		ctrlp[14] = 6.f;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_flatten(
+			&spline, 0.001f, NULL, 0, &num_flat, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 3, (int) num_flat);
+		CuAssertTrue(tc, num_bent > 10);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void flatten_buffer_too_small(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[2 * 3];
+	size_t num, expected;
+	tsStatus status;
+
+	tsReal ctrlp[10] = {
+		0.f, 0.f,
+		1.f, 2.f,
+		2.f, 0.f,
+		3.f, 2.f,
+		4.f, 0.f
+	};
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		5, 2, 3, TS_CLAMPED, &spline, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		&spline, ctrlp, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_flatten(
+		&spline, 0.001f, NULL, 0, &expected, &status));
+	CuAssertTrue(tc, expected > 3);
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bspline_flatten(
+		&spline, 0.001f, points, 3, &num, &status));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, status.code);
+	CuAssertIntEquals(tc, (int) expected, (int) num);
+
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_flatten_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, flatten_line);
+	SUITE_ADD_TEST(suite, flatten_within_tolerance);
+	SUITE_ADD_TEST(suite, flatten_adaptive);
+	SUITE_ADD_TEST(suite, flatten_buffer_too_small);
+	return suite;
+}
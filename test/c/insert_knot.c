@@ -460,6 +460,145 @@ void insert_knot_way_too_many(CuTest *tc) {
 	TS_END_TRY
 }
 
+void insert_knots_equals_insert_knot(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline expected = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal *vals = NULL, *evals = NULL, *rvals = NULL;
+	tsReal knots[7], min, max, tmp;
+	size_t deg, num, i, k = 0;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (deg = 0; deg <= 4; deg++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				8, DIMENSION, deg, TS_OPENED, &spline, &status))
+			TS_CALL(try, status.code, ts_bspline_control_points(
+				&spline, &vals, &status))
+			for (i = 0; i < 8 * DIMENSION; i++)
+				vals[i] = (tsReal) ((i * 13) % 7) - 3.f;
+			TS_CALL(try, status.code, ts_bspline_set_control_points(
+				&spline, vals, &status))
+			free(vals);
+			vals = NULL;
+			TS_CALL(try, status.code, ts_bspline_knots(
+				&spline, &vals, &status))
+			/* Knots within the spans (inserted twice if
+			 * possible), an existing knot, and the domain
+			 * boundaries. */
+			min = vals[deg];
+			max = vals[8];
+			knots[0] = min + (max - min) * 0.31f;
+			knots[1] = min + (max - min) * 0.77f;
+			num = 2;
+			if (deg > 0) {
+				knots[2] = knots[0];
+				knots[3] = knots[1];
+				knots[4] = vals[deg + 1];
+				knots[5] = min;
+				knots[6] = max;
+				num = 7;
+			}
+			free(vals);
+			vals = NULL;
+			/* Sort knots (insertion sort). */
+			for (i = 1; i < num; i++) {
+				tmp = knots[i];
+				for (k = i; k > 0 && knots[k-1] > tmp; k--)
+					knots[k] = knots[k-1];
+				knots[k] = tmp;
+			}
+			TS_CALL(try, status.code, ts_bspline_copy(
+				&spline, &expected, &status))
+			for (i = 0; i < num; i++) {
+				TS_CALL(try, status.code,
+					ts_bspline_insert_knot(&expected,
+						knots[i], 1, &expected, &k,
+						&status))
+			}
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_insert_knots(
+				&spline, knots, num, &result, &status))
+
+/* ================================= Then ================================== */
+			CuAssertIntEquals(tc,
+				(int) ts_bspline_num_control_points(&expected),
+				(int) ts_bspline_num_control_points(&result));
+			TS_CALL(try, status.code, ts_bspline_knots(
+				&expected, &evals, &status))
+			TS_CALL(try, status.code, ts_bspline_knots(
+				&result, &rvals, &status))
+			for (i = 0; i < ts_bspline_num_knots(&result); i++) {
+				CuAssertDblEquals(tc, evals[i], rvals[i],
+					TS_KNOT_EPSILON);
+			}
+			free(evals);
+			free(rvals);
+			evals = rvals = NULL;
+			TS_CALL(try, status.code, ts_bspline_control_points(
+				&expected, &evals, &status))
+			TS_CALL(try, status.code, ts_bspline_control_points(
+				&result, &rvals, &status))
+			num = ts_bspline_len_control_points(&result);
+			for (i = 0; i < num; i++) {
+				CuAssertDblEquals(tc, evals[i], rvals[i],
+					CTRLP_EPSILON);
+			}
+			free(evals);
+			free(rvals);
+			evals = rvals = NULL;
+			ts_bspline_free(&spline);
+			ts_bspline_free(&expected);
+			ts_bspline_free(&result);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&expected);
+		ts_bspline_free(&result);
+		free(vals);
+		free(evals);
+		free(rvals);
+	TS_END_TRY
+}
+
+void insert_knots_invalid_input(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal decreasing[2] = { 0.5f, 0.25f };
+	tsReal outside[2] = { 0.5f, 1.5f };
+	tsReal too_many[4] = { 0.25f, 0.25f, 0.25f, 0.25f };
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(NUM_CTRLP,
+		DIMENSION, DEGREE, TS_CLAMPED, &spline, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_KNOTS_DECR, ts_bspline_insert_knots(
+		&spline, decreasing, 2, &result, &status));
+	CuAssertIntEquals(tc, TS_KNOTS_DECR, status.code);
+	CuAssertPtrEquals(tc, NULL, result.pImpl);
+
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bspline_insert_knots(
+		&spline, outside, 2, &result, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertPtrEquals(tc, NULL, result.pImpl);
+
+	/* 0.25 already has multiplicity 1. */
+	CuAssertIntEquals(tc, TS_MULTIPLICITY, ts_bspline_insert_knots(
+		&spline, too_many, 4, &result, &status));
+	CuAssertIntEquals(tc, TS_MULTIPLICITY, status.code);
+	CuAssertPtrEquals(tc, NULL, result.pImpl);
+
+	ts_bspline_free(&spline);
+}
+
 CuSuite* get_insert_knot_suite()
 {
 	CuSuite* suite = CuSuiteNew();
@@ -468,5 +607,7 @@ CuSuite* get_insert_knot_suite()
 	SUITE_ADD_TEST(suite, insert_knot_three_times);
 	SUITE_ADD_TEST(suite, insert_knot_too_many);
 	SUITE_ADD_TEST(suite, insert_knot_way_too_many);
+	SUITE_ADD_TEST(suite, insert_knots_equals_insert_knot);
+	SUITE_ADD_TEST(suite, insert_knots_invalid_input);
 	return suite;
 }
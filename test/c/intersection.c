@@ -0,0 +1,312 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* Creates the parabola (2u, 4u(1-u)) in [0, 1] and the line segment
+ * ((0, y), (2, y)). */
+void intersection_setup(CuTest *tc, tsBSpline *parabola, tsBSpline *line,
+	tsReal y)
+{
+	tsReal ctrlp_parabola[6] = { 0.f, 0.f, 1.f, 2.f, 2.f, 0.f };
+	tsReal ctrlp_line[4];
+	ctrlp_line[0] = 0.f; ctrlp_line[1] = y;
+	ctrlp_line[2] = 2.f; ctrlp_line[3] = y;
+
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		3, 2, 2, TS_CLAMPED, parabola, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		parabola, ctrlp_parabola, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		2, 2, 1, TS_CLAMPED, line, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		line, ctrlp_line, NULL));
+}
+
+void intersection_curves(CuTest *tc)
+{
+	tsBSpline parabola = ts_bspline_init();
+	tsBSpline line = ts_bspline_init();
+	tsReal *knots = NULL;
+	size_t num;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		intersection_setup(tc, &parabola, &line, 0.75f);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_intersect_curves(
+			&parabola, &line, 1e-5f, &knots, &num, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 2, (int) num);
+		CuAssertDblEquals(tc, 0.25f, knots[0], EPSILON);
+		CuAssertDblEquals(tc, 0.25f, knots[1], EPSILON);
+		CuAssertDblEquals(tc, 0.75f, knots[2], EPSILON);
+		CuAssertDblEquals(tc, 0.75f, knots[3], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&parabola);
+		ts_bspline_free(&line);
+		free(knots);
+	TS_END_TRY
+}
+
+void intersection_tangential(CuTest *tc)
+{
+	tsBSpline parabola = ts_bspline_init();
+	tsBSpline line = ts_bspline_init();
+	tsReal *knots = NULL, *plane = NULL;
+	tsReal point[2] = { 5.f, 1.f }, normal[2] = { 0.f, -3.f };
+	size_t num, num_plane;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* The line touches the apex of the parabola. */
+		intersection_setup(tc, &parabola, &line, 1.f);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_intersect_curves(
+			&parabola, &line, 1e-5f, &knots, &num, &status))
+		TS_CALL(try, status.code, ts_bspline_intersect_plane(
+			&parabola, point, normal, 1e-5f, &plane, &num_plane,
+			&status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 1, (int) num);
+		CuAssertDblEquals(tc, 0.5f, knots[0], EPSILON);
+		CuAssertDblEquals(tc, 0.5f, knots[1], EPSILON);
+		CuAssertIntEquals(tc, 1, (int) num_plane);
+		CuAssertDblEquals(tc, 0.5f, plane[0], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&parabola);
+		ts_bspline_free(&line);
+		free(knots);
+		free(plane);
+	TS_END_TRY
+}
+
+void intersection_tolerance(CuTest *tc)
+{
+	tsBSpline a = ts_bspline_init();
+	tsBSpline b = ts_bspline_init();
+	tsReal *ctrlp = NULL, *knots = NULL, *pa = NULL, *pb = NULL;
+	const tsReal eps = 1e-4f;
+	size_t i, num;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* Two wiggly curves with many intersections. */
+		TS_CALL(try, status.code, ts_bspline_new(
+			30, 2, 3, TS_CLAMPED, &a, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			25, 2, 3, TS_CLAMPED, &b, &status))
+		ctrlp = (tsReal *) malloc(60 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, ctrlp);
+		for (i = 0; i < 30; i++) {
+			ctrlp[i * 2] = (tsReal) i;
+			ctrlp[i * 2 + 1] = (tsReal) ((i * 7) % 5);
+		}
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&a, ctrlp, &status))
+		for (i = 0; i < 25; i++) {
+			ctrlp[i * 2] = (tsReal) ((i * 11) % 6);
+			ctrlp[i * 2 + 1] = (tsReal) i / 6;
+		}
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&b, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_intersect_curves(
+			&a, &b, eps, &knots, &num, &status))
+
+/* ================================= Then ================================== */
+		CuAssertTrue(tc, num > 4);
+		free(ctrlp);
+		ctrlp = (tsReal *) malloc(num * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, ctrlp);
+		for (i = 0; i < num; i++)
+			ctrlp[i] = knots[i * 2];
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			&a, ctrlp, num, &pa, &status))
+		for (i = 0; i < num; i++)
+			ctrlp[i] = knots[i * 2 + 1];
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			&b, ctrlp, num, &pb, &status))
+		for (i = 0; i < num; i++) {
+			CuAssertTrue(tc, ts_distance(pa + i * 2, pb + i * 2, 2)
+				<= eps);
+			/* Sorted by the knots of a. */
+			if (i > 0)
+				CuAssertTrue(tc, knots[i*2] >= knots[i*2 - 2]);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&a);
+		ts_bspline_free(&b);
+		free(ctrlp);
+		free(knots);
+		free(pa);
+		free(pb);
+	TS_END_TRY
+}
+
+void intersection_plane_and_ray(CuTest *tc)
+{
+	tsBSpline parabola = ts_bspline_init();
+	tsBSpline line = ts_bspline_init();
+	tsReal *plane = NULL, *ray = NULL, *away = NULL;
+	tsReal point[2] = { 0.f, 0.75f }, normal[2] = { 0.f, 1.f };
+	tsReal origin[2] = { -1.f, 0.75f }, direction[2] = { 2.f, 0.f };
+	size_t num_plane, num_ray, num_away;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		intersection_setup(tc, &parabola, &line, 0.f);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_intersect_plane(
+			&parabola, point, normal, 1e-5f, &plane, &num_plane,
+			&status))
+		TS_CALL(try, status.code, ts_bspline_intersect_ray(
+			&parabola, origin, direction, 1e-5f, &ray, &num_ray,
+			&status))
+		direction[0] = -2.f;
+		TS_CALL(try, status.code, ts_bspline_intersect_ray(
+			&parabola, origin, direction, 1e-5f, &away, &num_away,
+			&status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 2, (int) num_plane);
+		CuAssertDblEquals(tc, 0.25f, plane[0], EPSILON);
+		CuAssertDblEquals(tc, 0.75f, plane[1], EPSILON);
+
+		CuAssertIntEquals(tc, 2, (int) num_ray);
+		CuAssertDblEquals(tc, 0.25f, ray[0], EPSILON);
+		CuAssertDblEquals(tc, 0.75f, ray[1], EPSILON);
+		CuAssertDblEquals(tc, 0.75f, ray[2], EPSILON);
+		CuAssertDblEquals(tc, 1.25f, ray[3], EPSILON);
+
+		CuAssertIntEquals(tc, 0, (int) num_away);
+		CuAssertPtrEquals(tc, NULL, away);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&parabola);
+		ts_bspline_free(&line);
+		free(plane);
+		free(ray);
+		free(away);
+	TS_END_TRY
+}
+
+void intersection_all(CuTest *tc)
+{
+	tsBSpline splines[4];
+	tsReal *knots = NULL;
+	size_t *indices = NULL;
+	size_t num, i, counts[4] = { 0, 0, 0, 0 };
+	tsStatus status;
+
+	tsReal vertical[4] = { 1.f, -1.f, 1.f, 2.f };
+	tsReal far[4] = { 10.f, 10.f, 11.f, 11.f };
+
+	for (i = 0; i < 4; i++)
+		splines[i] = ts_bspline_init();
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		intersection_setup(tc, &splines[0], &splines[1], 0.75f);
+		TS_CALL(try, status.code, ts_bspline_new(
+			2, 2, 1, TS_CLAMPED, &splines[2], &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&splines[2], vertical, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			2, 2, 1, TS_CLAMPED, &splines[3], &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&splines[3], far, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_intersect_all(
+			splines, 4, 1e-5f, &indices, &knots, &num, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 4, (int) num);
+		for (i = 0; i < num; i++) {
+			CuAssertTrue(tc, indices[i * 2] < indices[i * 2 + 1]);
+			CuAssertTrue(tc, indices[i * 2 + 1] < 3);
+			counts[indices[i * 2] + indices[i * 2 + 1]]++;
+			if (indices[i * 2 + 1] == 2) {
+				/* Vertical line at x = 1. */
+				CuAssertDblEquals(tc, 0.5f, knots[i * 2],
+					EPSILON);
+			}
+		}
+		/* (0, 1): 2 hits, (0, 2): 1 hit, (1, 2): 1 hit. */
+		CuAssertIntEquals(tc, 2, (int) counts[1]);
+		CuAssertIntEquals(tc, 1, (int) counts[2]);
+		CuAssertIntEquals(tc, 1, (int) counts[3]);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		for (i = 0; i < 4; i++)
+			ts_bspline_free(&splines[i]);
+		free(indices);
+		free(knots);
+	TS_END_TRY
+}
+
+void intersection_invalid_input(CuTest *tc)
+{
+	tsBSpline a = ts_bspline_init();
+	tsBSpline b = ts_bspline_init();
+	tsReal *knots = NULL;
+	tsReal point[3] = { 0.f, 0.f, 0.f }, zero[3] = { 0.f, 0.f, 0.f };
+	size_t num;
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 2, 3, TS_CLAMPED, &a, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 3, 3, TS_CLAMPED, &b, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_bspline_intersect_curves(
+		&a, &b, 1e-5f, &knots, &num, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, status.code);
+	CuAssertPtrEquals(tc, NULL, knots);
+
+	CuAssertIntEquals(tc, TS_NO_RESULT, ts_bspline_intersect_plane(
+		&b, point, zero, 1e-5f, &knots, &num, &status));
+	CuAssertIntEquals(tc, TS_NO_RESULT, status.code);
+	CuAssertPtrEquals(tc, NULL, knots);
+
+	CuAssertIntEquals(tc, TS_NO_RESULT, ts_bspline_intersect_ray(
+		&b, point, zero, 1e-5f, &knots, &num, &status));
+	CuAssertIntEquals(tc, TS_NO_RESULT, status.code);
+	CuAssertPtrEquals(tc, NULL, knots);
+
+	ts_bspline_free(&a);
+	ts_bspline_free(&b);
+}
+
+CuSuite* get_intersection_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, intersection_curves);
+	SUITE_ADD_TEST(suite, intersection_tangential);
+	SUITE_ADD_TEST(suite, intersection_tolerance);
+	SUITE_ADD_TEST(suite, intersection_plane_and_ray);
+	SUITE_ADD_TEST(suite, intersection_all);
+	SUITE_ADD_TEST(suite, intersection_invalid_input);
+	return suite;
+}
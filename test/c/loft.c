@@ -0,0 +1,360 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+#include "fixtures.h"
+
+#define EPSILON 0.0001
+
+/* Number of sections of the tests. */
+#define NUM_SECTIONS 4
+
+/* Fills the control points of \p spline (cf. fixtures_control_points) and
+ * sets the last component of each control point to \p offset. */
+void loft_setup(CuTest *tc, tsBSpline *spline, size_t seed, tsReal offset)
+{
+	tsReal *ctrlp = NULL;
+	size_t i, len, dim;
+
+	fixtures_control_points(tc, spline, seed);
+	len = ts_bspline_len_control_points(spline);
+	dim = ts_bspline_dimension(spline);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		spline, &ctrlp, NULL));
+	for (i = dim - 1; i < len; i += dim)
+		ctrlp[i] = offset;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		spline, ctrlp, NULL));
+	free(ctrlp);
+}
+
+/* Creates splines of degree 1, 2, and 3 with different types and number of
+ * control points. */
+void loft_setup_mixed(CuTest *tc, tsBSpline *splines)
+{
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 2, 1, TS_OPENED, splines, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		5, 2, 2, TS_CLAMPED, splines + 1, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		8, 2, 3, TS_BEZIERS, splines + 2, NULL));
+	loft_setup(tc, splines, 0, 0);
+	loft_setup(tc, splines + 1, 1, 1);
+	loft_setup(tc, splines + 2, 2, 2);
+}
+
+/* Evaluates \p spline at \p t mapped from [0, 1] to the domain of
+ * \p spline. */
+void loft_eval_normalized(CuTest *tc, const tsBSpline *spline, tsReal t,
+	tsReal *point)
+{
+	tsReal min, max;
+	ts_bspline_domain(spline, &min, &max);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_point(
+		spline, min + (max - min) * t, point, NULL, NULL));
+}
+
+/* Frees the first \p num splines of \p splines. */
+void loft_free_splines(tsBSpline *splines, size_t num)
+{
+	size_t i;
+	for (i = 0; i < num; i++)
+		ts_bspline_free(splines + i);
+}
+
+void loft_translated_sections(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsBSpline sections[NUM_SECTIONS];
+	tsReal *knots = NULL, inserted[2] = { 0.3f, 0.6f };
+	tsReal point[3], expected[3], t;
+	size_t i, j, k;
+	tsStatus status;
+
+	for (k = 0; k < NUM_SECTIONS; k++)
+		sections[k] = ts_bspline_init();
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* Translated copies of a single curve with different
+		 * representations: plain, Bezier segments, inserted knots,
+		 * and scaled domain. */
+		for (k = 0; k < NUM_SECTIONS; k++) {
+			TS_CALL(try, status.code, ts_bspline_new(
+				6, 3, 2, TS_CLAMPED, sections + k, &status))
+			loft_setup(tc, sections + k, 0, (tsReal) k);
+		}
+		TS_CALL(try, status.code, ts_bspline_to_beziers(
+			sections + 1, sections + 1, &status))
+		TS_CALL(try, status.code, ts_bspline_insert_knots(
+			sections + 2, inserted, 2, sections + 2, &status))
+		TS_CALL(try, status.code, ts_bspline_knots(
+			sections + 3, &knots, &status))
+		for (i = 0; i < ts_bspline_num_knots(sections + 3); i++)
+			knots[i] = knots[i] * 2 + 1;
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			sections + 3, knots, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinesurface_loft(
+			sections, NUM_SECTIONS, 3, NULL, &surface, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 3,
+			(int) ts_bsplinesurface_degree_u(&surface));
+		CuAssertIntEquals(tc, 2,
+			(int) ts_bsplinesurface_degree_v(&surface));
+		CuAssertIntEquals(tc, NUM_SECTIONS,
+			(int) ts_bsplinesurface_num_control_points_u(&surface));
+		/* Equidistant sections are located at equidistant knots. */
+		for (k = 0; k < NUM_SECTIONS; k++) {
+			for (j = 0; j <= 10; j++) {
+				t = (tsReal) j / 10;
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface,
+					(tsReal) k / (NUM_SECTIONS - 1), t,
+					point, NULL, &status))
+				loft_eval_normalized(tc, sections + k, t,
+					expected);
+				CuAssertDblEquals(tc, 0, ts_distance(
+					expected, point, 3), EPSILON);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		loft_free_splines(sections, NUM_SECTIONS);
+		ts_bsplinesurface_free(&surface);
+		free(knots);
+	TS_END_TRY
+}
+
+void loft_make_compatible(CuTest *tc)
+{
+	tsBSpline splines[3], results[3];
+	tsReal *knots = NULL, *other = NULL, point[2], expected[2], min, max;
+	size_t i, j;
+	tsStatus status;
+
+	for (i = 0; i < 3; i++) {
+		splines[i] = ts_bspline_init();
+		results[i] = ts_bspline_init();
+	}
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		loft_setup_mixed(tc, splines);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_make_compatible(
+			splines, 3, NULL, results, &status))
+
+/* ================================= Then ================================== */
+		TS_CALL(try, status.code, ts_bspline_knots(
+			results, &knots, &status))
+		for (i = 0; i < 3; i++) {
+			CuAssertIntEquals(tc, 3,
+				(int) ts_bspline_degree(results + i));
+			CuAssertIntEquals(tc,
+				(int) ts_bspline_num_control_points(results),
+				(int) ts_bspline_num_control_points(
+					results + i));
+			ts_bspline_domain(results + i, &min, &max);
+			CuAssertDblEquals(tc, 0, min, EPSILON);
+			CuAssertDblEquals(tc, 1, max, EPSILON);
+			TS_CALL(try, status.code, ts_bspline_knots(
+				results + i, &other, &status))
+			for (j = 0; j < ts_bspline_num_knots(results); j++)
+				CuAssertDblEquals(tc, knots[j], other[j], 0);
+			free(other);
+			other = NULL;
+			/* The shape is preserved. */
+			for (j = 0; j <= 20; j++) {
+				loft_eval_normalized(tc, splines + i,
+					(tsReal) j / 20, expected);
+				TS_CALL(try, status.code, ts_bspline_eval_point(
+					results + i, (tsReal) j / 20, point,
+					NULL, &status))
+				CuAssertDblEquals(tc, 0, ts_distance(
+					expected, point, 2), EPSILON);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		loft_free_splines(splines, 3);
+		loft_free_splines(results, 3);
+		free(knots);
+		free(other);
+	TS_END_TRY
+}
+
+void loft_ends(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsBSpline sections[3];
+	tsReal point[2], expected[2], min_u, max_u, min_v, max_v, t;
+	size_t i, j;
+	tsStatus status;
+
+	for (i = 0; i < 3; i++)
+		sections[i] = ts_bspline_init();
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		loft_setup_mixed(tc, sections);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinesurface_loft(
+			sections, 3, 5, NULL, &surface, &status))
+
+/* ================================= Then ================================== */
+		/* The degree in u is limited by the number of sections. */
+		CuAssertIntEquals(tc, 2,
+			(int) ts_bsplinesurface_degree_u(&surface));
+		ts_bsplinesurface_domain(&surface, &min_u, &max_u,
+			&min_v, &max_v);
+		CuAssertDblEquals(tc, 0, min_u, EPSILON);
+		CuAssertDblEquals(tc, 1, max_u, EPSILON);
+		CuAssertDblEquals(tc, 0, min_v, EPSILON);
+		CuAssertDblEquals(tc, 1, max_v, EPSILON);
+		for (i = 0; i < 3; i += 2) {
+			for (j = 0; j <= 20; j++) {
+				t = (tsReal) j / 20;
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface,
+					(tsReal) i / 2, t, point, NULL,
+					&status))
+				loft_eval_normalized(tc, sections + i, t,
+					expected);
+				CuAssertDblEquals(tc, 0, ts_distance(
+					expected, point, 2), EPSILON);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		loft_free_splines(sections, 3);
+		ts_bsplinesurface_free(&surface);
+	TS_END_TRY
+}
+
+void loft_mixed_degrees(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsBSpline sections[3];
+	tsReal *knots = NULL, point[3], expected[3], t;
+	size_t i, j;
+	tsStatus status;
+
+	/* A polyline and two parabolas at z = 0, 1, and 2. */
+	tsReal line[9] = { 0, 0, 0,   1, 1, 0,   2, 0, 0 };
+	tsReal line_knots[5] = { 0, 0, 0.5f, 1, 1 };
+	tsReal para_a[12] = { 0, 0, 1,   1, 2, 1,   2, 2, 1,   3, 0, 1 };
+	tsReal para_a_knots[7] = { 0, 0, 0, 0.5f, 1, 1, 1 };
+	tsReal para_b[12] = { 0, 1, 2,   0, 2, 2,   2, 3, 2,   3, 1, 2 };
+	tsReal para_b_knots[7] = { 0, 0, 0, 0.25f, 1, 1, 1 };
+	/* The polyline is C0 at 0.5 and the parabolas are C1 at 0.5 and
+	 * 0.25, respectively. */
+	tsReal v_knots[9] = { 0, 0, 0, 0.25f, 0.5f, 0.5f, 1, 1, 1 };
+
+	for (i = 0; i < 3; i++)
+		sections[i] = ts_bspline_init();
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			3, 3, 1, TS_CLAMPED, sections, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			sections, line, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			sections, line_knots, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			4, 3, 2, TS_CLAMPED, sections + 1, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			sections + 1, para_a, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			sections + 1, para_a_knots, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			4, 3, 2, TS_CLAMPED, sections + 2, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			sections + 2, para_b, &status))
+		TS_CALL(try, status.code, ts_bspline_set_knots(
+			sections + 2, para_b_knots, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinesurface_loft(
+			sections, 3, 2, NULL, &surface, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 2,
+			(int) ts_bsplinesurface_degree_v(&surface));
+		/* No knot has a higher multiplicity than required. */
+		CuAssertIntEquals(tc, 9,
+			(int) ts_bsplinesurface_num_knots_v(&surface));
+		CuAssertIntEquals(tc, 6,
+			(int) ts_bsplinesurface_num_control_points_v(&surface));
+		TS_CALL(try, status.code, ts_bsplinesurface_knots_v(
+			&surface, &knots, &status))
+		for (i = 0; i < 9; i++)
+			CuAssertDblEquals(tc, v_knots[i], knots[i], EPSILON);
+		for (i = 0; i < 3; i += 2) {
+			for (j = 0; j <= 20; j++) {
+				t = (tsReal) j / 20;
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface,
+					(tsReal) i / 2, t, point, NULL,
+					&status))
+				loft_eval_normalized(tc, sections + i, t,
+					expected);
+				CuAssertDblEquals(tc, 0, ts_distance(
+					expected, point, 3), EPSILON);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		loft_free_splines(sections, 3);
+		ts_bsplinesurface_free(&surface);
+		free(knots);
+	TS_END_TRY
+}
+
+void loft_errors(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsBSpline sections[2], results[2];
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	sections[0] = ts_bspline_init();
+	sections[1] = ts_bspline_init();
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 2, 2, TS_CLAMPED, sections, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 3, 2, TS_CLAMPED, sections + 1, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_NUM_POINTS, ts_bsplinesurface_loft(
+		sections, 1, 3, NULL, &surface, &status));
+	CuAssertIntEquals(tc, TS_NUM_POINTS, status.code);
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_bsplinesurface_loft(
+		sections, 2, 3, NULL, &surface, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, status.code);
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, ts_bspline_make_compatible(
+		sections, 2, NULL, results, &status));
+	CuAssertIntEquals(tc, TS_INCOMPATIBLE, status.code);
+
+	loft_free_splines(sections, 2);
+	ts_bsplinesurface_free(&surface);
+}
+
+CuSuite* get_loft_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, loft_translated_sections);
+	SUITE_ADD_TEST(suite, loft_make_compatible);
+	SUITE_ADD_TEST(suite, loft_ends);
+	SUITE_ADD_TEST(suite, loft_mixed_degrees);
+	SUITE_ADD_TEST(suite, loft_errors);
+	return suite;
+}
@@ -0,0 +1,238 @@
+#include <stdlib.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* A wavy 3D spline with 20 control points and some knots of higher
+ * multiplicity. */
+void projection_setup(CuTest *tc, tsBSpline *spline)
+{
+	tsReal *ctrlp = NULL;
+	size_t i;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		20, 3, 3, TS_CLAMPED, spline, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		spline, &ctrlp, NULL));
+	for (i = 0; i < 60; i++)
+		ctrlp[i] = (tsReal) ((i * 37) % 23) / 4;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		spline, ctrlp, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_insert_knot(
+		spline, 0.5f, 2, spline, &i, NULL));
+	free(ctrlp);
+}
+
+void projection_points_on_spline(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsProjector projector = ts_projector_init();
+	tsReal us[3] = { 0.f, 0.37f, 1.f };
+	tsReal *points = NULL, knot, closest[3];
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			7, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &points, &status))
+		/* A curve without self-intersections. */
+		points[0] = 0.f; points[1] = 0.f;
+		points[2] = 1.f; points[3] = 2.f;
+		points[4] = 2.f; points[5] = 3.f;
+		points[6] = 4.f; points[7] = 3.f;
+		points[8] = 5.f; points[9] = 1.f;
+		points[10] = 6.f; points[11] = 0.f;
+		points[12] = 8.f; points[13] = 1.f;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, points, &status))
+		free(points);
+		points = NULL;
+		TS_CALL(try, status.code, ts_bspline_eval_all(
+			&spline, us, 3, &points, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_projector(
+			&spline, &projector, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 2,
+			(int) ts_projector_dimension(&projector));
+		CuAssertIntEquals(tc, 4,
+			(int) ts_projector_num_segments(&projector));
+		for (i = 0; i < 3; i++) {
+			TS_CALL(try, status.code, ts_projector_project(
+				&projector, points + i * 2, &knot, closest,
+				&status))
+			CuAssertDblEquals(tc, us[i], knot, EPSILON);
+			CuAssertDblEquals(tc, points[i * 2], closest[0],
+				EPSILON);
+			CuAssertDblEquals(tc, points[i * 2 + 1], closest[1],
+				EPSILON);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_projector_free(&projector);
+		free(points);
+	TS_END_TRY
+}
+
+void projection_equals_brute_force(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsProjector projector = ts_projector_init();
+	tsReal *samples = NULL, *point = NULL;
+	tsReal query[3], knot, closest[3], dist, min;
+	size_t num, i, j;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		projection_setup(tc, &spline);
+		TS_CALL(try, status.code, ts_bspline_sample(
+			&spline, 20000, &samples, &num, &status))
+		TS_CALL(try, status.code, ts_bspline_projector(
+			&spline, &projector, &status))
+
+		for (i = 0; i < 50; i++) {
+			query[0] = (tsReal) ((i * 13) % 29) / 4 - 1;
+			query[1] = (tsReal) ((i * 7) % 31) / 4 - 1;
+			query[2] = (tsReal) ((i * 17) % 37) / 4 - 1;
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_projector_project(
+				&projector, query, &knot, closest, &status))
+
+/* ================================= Then ================================== */
+			min = -1;
+			for (j = 0; j < num; j++) {
+				dist = ts_distance(query, samples + j * 3, 3);
+				min = min < 0 || dist < min ? dist : min;
+			}
+			dist = ts_distance(query, closest, 3);
+			/* The projection is at least as close as the closest
+			 * sample, but not much closer. */
+			CuAssertTrue(tc, dist <= min + EPSILON);
+			CuAssertTrue(tc, dist >= min - 0.01f);
+			/* The closest point is the point at the knot. */
+			TS_CALL(try, status.code, ts_bspline_eval_all(
+				&spline, &knot, 1, &point, &status))
+			CuAssertDblEquals(tc, 0, ts_distance(point, closest,
+				3), EPSILON);
+			free(point);
+			point = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_projector_free(&projector);
+		free(samples);
+		free(point);
+	TS_END_TRY
+}
+
+void projection_batch(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsProjector projector = ts_projector_init();
+	tsReal *queries = NULL, *knots = NULL, *closest = NULL;
+	tsReal knot, point[3];
+	const size_t num = 5000;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		projection_setup(tc, &spline);
+		TS_CALL(try, status.code, ts_bspline_projector(
+			&spline, &projector, &status))
+		queries = (tsReal *) malloc(num * 3 * sizeof(tsReal));
+		knots = (tsReal *) malloc(num * sizeof(tsReal));
+		closest = (tsReal *) malloc(num * 3 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, queries);
+		CuAssertPtrNotNull(tc, knots);
+		CuAssertPtrNotNull(tc, closest);
+		for (i = 0; i < num * 3; i++)
+			queries[i] = (tsReal) ((i * 7919) % 1009) / 100 - 2;
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_projector_project_all(
+			&projector, queries, num, NULL, knots, closest,
+			&status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < num; i++) {
+			TS_CALL(try, status.code, ts_projector_project(
+				&projector, queries + i * 3, &knot, point,
+				&status))
+			CuAssertDblEquals(tc, knot, knots[i], 0);
+			CuAssertDblEquals(tc, point[0], closest[i * 3], 0);
+			CuAssertDblEquals(tc, point[1], closest[i * 3 + 1], 0);
+			CuAssertDblEquals(tc, point[2], closest[i * 3 + 2], 0);
+		}
+		/* The closest points are optional. */
+		TS_CALL(try, status.code, ts_projector_project_all(
+			&projector, queries, num, NULL, knots, NULL, &status))
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_projector_free(&projector);
+		free(queries);
+		free(knots);
+		free(closest);
+	TS_END_TRY
+}
+
+void projection_copy(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsProjector projector = ts_projector_init();
+	tsProjector copy = ts_projector_init();
+	tsReal query[3] = { 1.f, 2.f, 3.f };
+	tsReal expected, knot;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		projection_setup(tc, &spline);
+		TS_CALL(try, status.code, ts_bspline_projector(
+			&spline, &projector, &status))
+		TS_CALL(try, status.code, ts_projector_project(
+			&projector, query, &expected, NULL, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_projector_copy(
+			&projector, &copy, &status))
+		/* The copy does not depend on spline and projector. */
+		ts_bspline_free(&spline);
+		ts_projector_free(&projector);
+
+/* ================================= Then ================================== */
+		CuAssertTrue(tc, copy.pImpl != NULL);
+		TS_CALL(try, status.code, ts_projector_project(
+			&copy, query, &knot, NULL, &status))
+		CuAssertDblEquals(tc, expected, knot, 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_projector_free(&projector);
+		ts_projector_free(&copy);
+	TS_END_TRY
+}
+
+CuSuite* get_projection_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, projection_points_on_spline);
+	SUITE_ADD_TEST(suite, projection_equals_brute_force);
+	SUITE_ADD_TEST(suite, projection_batch);
+	SUITE_ADD_TEST(suite, projection_copy);
+	return suite;
+}
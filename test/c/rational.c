@@ -0,0 +1,260 @@
+#include <stdlib.h>
+#include <math.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+#include "fixtures.h"
+
+#define EPSILON 0.0001
+
+/* Creates a unit circle in the xy-plane from nine rational control points
+ * (cf. The NURBS Book, Example 7.2). */
+void rational_setup_circle(CuTest *tc, tsBSpline *spline)
+{
+	const tsReal w = (tsReal) (sqrt(2.0) / 2.0);
+	const tsReal ctrlp[27] = {
+		 1.f,  0.f, 0.f,
+		 1.f,  1.f, 0.f,
+		 0.f,  1.f, 0.f,
+		-1.f,  1.f, 0.f,
+		-1.f,  0.f, 0.f,
+		-1.f, -1.f, 0.f,
+		 0.f, -1.f, 0.f,
+		 1.f, -1.f, 0.f,
+		 1.f,  0.f, 0.f
+	};
+	const tsReal weights[9] = { 1.f, w, 1.f, w, 1.f, w, 1.f, w, 1.f };
+	const tsReal knots[12] = {
+		0.f, 0.f, 0.f, 0.25f, 0.25f, 0.5f,
+		0.5f, 0.75f, 0.75f, 1.f, 1.f, 1.f
+	};
+
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		9, 4, 2, TS_CLAMPED, spline, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS,
+		ts_bspline_set_rational_control_points(
+			spline, ctrlp, weights, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_knots(
+		spline, knots, NULL));
+}
+
+/* Returns the dot product of the 3D vectors \p x and \p y. */
+tsReal rational_dot(const tsReal *x, const tsReal *y)
+{
+	return x[0] * y[0] + x[1] * y[1] + x[2] * y[2];
+}
+
+void rational_circle(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[3 * 3], u;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		rational_setup_circle(tc, &spline);
+
+		for (i = 0; i <= 37; i++) {
+			u = (tsReal) i / 37;
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_eval_rational(
+				&spline, u, 2, points, NULL, &status))
+
+/* ================================= Then ================================== */
+			/* C lies on the unit circle ... */
+			CuAssertDblEquals(tc, 1.f, sqrt(
+				rational_dot(points, points)), EPSILON);
+			CuAssertDblEquals(tc, 0.f, points[2], EPSILON);
+			/* ... thus, C' is perpendicular to C ... */
+			CuAssertDblEquals(tc, 0.f, rational_dot(
+				points, points + 3), EPSILON);
+			/* ... and |C'|^2 + C * C'' = 0. */
+			CuAssertDblEquals(tc, 0.f, rational_dot(
+				points + 3, points + 3) + rational_dot(
+				points, points + 6), 0.01f);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void rational_finite_differences(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal points[3 * 3], left[3 * 2], right[3 * 2], u;
+	size_t i, d;
+	tsStatus status;
+
+	const tsReal h = 0.001f;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		rational_setup_circle(tc, &spline);
+
+		for (i = 1; i < 37; i++) {
+			/* Stay away from inner knots. */
+			u = (tsReal) i / 37;
+			if (fabs(u * 4 - floor(u * 4 + 0.5f)) * 37 < 2)
+				continue;
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_eval_rational(
+				&spline, u, 1, points, NULL, &status))
+			TS_CALL(try, status.code, ts_bspline_eval_rational(
+				&spline, u - h, 1, left, NULL, &status))
+			TS_CALL(try, status.code, ts_bspline_eval_rational(
+				&spline, u + h, 1, right, NULL, &status))
+
+/* ================================= Then ================================== */
+			for (d = 0; d < 3; d++) {
+				/* Central differences of C and C'. */
+				CuAssertDblEquals(tc, points[3 + d],
+					(right[d] - left[d]) / (2 * h), 0.01f);
+			}
+			TS_CALL(try, status.code, ts_bspline_eval_rational(
+				&spline, u, 2, points, NULL, &status))
+			for (d = 0; d < 3; d++) {
+				CuAssertDblEquals(tc, points[6 + d],
+					(right[3 + d] - left[3 + d]) / (2 * h),
+					0.1f);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+	TS_END_TRY
+}
+
+void rational_unit_weights(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline polynomial = ts_bspline_init();
+	tsReal *ctrlp = NULL, weights[8], us[16], *workspace = NULL;
+	tsReal points[16 * 3 * 2], expected[3 * 2], origin[3 * 2], tol;
+	size_t i, len;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			8, 2, 3, TS_OPENED, &polynomial, &status))
+		fixtures_control_points(tc, &polynomial, 0);
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&polynomial, &ctrlp, &status))
+		ts_arr_fill(weights, 8, 1);
+		TS_CALL(try, status.code, ts_bspline_new(
+			8, 3, 3, TS_OPENED, &spline, &status))
+		TS_CALL(try, status.code,
+			ts_bspline_set_rational_control_points(
+				&spline, ctrlp, weights, &status))
+		for (i = 0; i < 16; i++)
+			us[i] = 0.375f + (tsReal) ((i * 5) % 16) / 64;
+		len = ts_bspline_len_eval_rational_workspace(&spline, 2);
+		workspace = (tsReal *) malloc(len * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, workspace);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_eval_rational_batch(
+			&spline, us, 16, 2, points, workspace, &status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < 16; i++) {
+			TS_CALL(try, status.code, ts_bspline_eval_derivatives(
+				&polynomial, us[i], 2, expected, NULL,
+				&status))
+			/* The rounding error scales with the magnitude of
+			 * the derivatives. */
+			ts_arr_fill(origin, 6, 0);
+			tol = (tsReal) EPSILON * (1 + ts_distance(
+				expected, origin, 6));
+			CuAssertDblEquals(tc, 0, ts_distance(expected,
+				points + i * 6, 6), tol);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&polynomial);
+		free(ctrlp);
+		free(workspace);
+	TS_END_TRY
+}
+
+void rational_control_points(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL, *weights = NULL, *homogeneous = NULL;
+	const tsReal w = (tsReal) (sqrt(2.0) / 2.0);
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		rational_setup_circle(tc, &spline);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_rational_control_points(
+			&spline, &ctrlp, &weights, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &homogeneous, &status))
+
+/* ================================= Then ================================== */
+		/* Cartesian control points. */
+		CuAssertDblEquals(tc,  1.f, ctrlp[3], EPSILON);
+		CuAssertDblEquals(tc,  1.f, ctrlp[4], EPSILON);
+		CuAssertDblEquals(tc,  0.f, ctrlp[5], EPSILON);
+		CuAssertDblEquals(tc, -1.f, ctrlp[15], EPSILON);
+		CuAssertDblEquals(tc, -1.f, ctrlp[16], EPSILON);
+		CuAssertDblEquals(tc,    w, weights[1], EPSILON);
+		CuAssertDblEquals(tc,  1.f, weights[2], EPSILON);
+		/* Homogeneous control points. */
+		CuAssertDblEquals(tc,    w, homogeneous[4], EPSILON);
+		CuAssertDblEquals(tc,    w, homogeneous[5], EPSILON);
+		CuAssertDblEquals(tc,  0.f, homogeneous[6], EPSILON);
+		CuAssertDblEquals(tc,    w, homogeneous[7], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(ctrlp);
+		free(weights);
+		free(homogeneous);
+	TS_END_TRY
+}
+
+void rational_dimension_one(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL, *weights = NULL, points[2];
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		4, 1, 2, TS_CLAMPED, &spline, &status));
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_eval_rational(
+		&spline, 0.5f, 1, points, NULL, &status));
+	CuAssertIntEquals(tc, TS_DIM_ZERO, status.code);
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bspline_rational_control_points(
+		&spline, &ctrlp, &weights, &status));
+	CuAssertIntEquals(tc, TS_DIM_ZERO, status.code);
+	CuAssertPtrEquals(tc, NULL, ctrlp);
+	CuAssertPtrEquals(tc, NULL, weights);
+
+	ts_bspline_free(&spline);
+}
+
+CuSuite* get_rational_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, rational_circle);
+	SUITE_ADD_TEST(suite, rational_finite_differences);
+	SUITE_ADD_TEST(suite, rational_unit_weights);
+	SUITE_ADD_TEST(suite, rational_control_points);
+	SUITE_ADD_TEST(suite, rational_dimension_one);
+	return suite;
+}
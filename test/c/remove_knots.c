@@ -0,0 +1,236 @@
+#include <stdlib.h>
+#include <math.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+#include "fixtures.h"
+
+#define EPSILON 0.0001
+
+/* Returns the maximum distance between \p a and \p b sampled at equidistant
+ * knots of the domain of \p a. */
+tsReal remove_knots_max_dist(CuTest *tc, const tsBSpline *a,
+	const tsBSpline *b)
+{
+	tsReal min, max, u, point_a[3], point_b[3], dist, max_dist = 0;
+	size_t i;
+
+	ts_bspline_domain(a, &min, &max);
+	for (i = 0; i <= 200; i++) {
+		u = min + (max - min) * i / 200;
+		CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_point(
+			a, u, point_a, NULL, NULL));
+		CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_eval_point(
+			b, u, point_b, NULL, NULL));
+		dist = ts_distance(point_a, point_b, ts_bspline_dimension(a));
+		if (dist > max_dist)
+			max_dist = dist;
+	}
+	return max_dist;
+}
+
+void remove_knots_inserted(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline refined = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal knots[4] = { 0.3f, 0.3f, 0.55f, 0.8f };
+	size_t deg;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (deg = 1; deg <= 3; deg++) {
+/* ================================= Given ================================= */
+			TS_CALL(try, status.code, ts_bspline_new(
+				7, 3, deg, TS_CLAMPED, &spline, &status))
+			fixtures_control_points(tc, &spline, deg);
+			TS_CALL(try, status.code, ts_bspline_insert_knots(
+				&spline, knots, 4, &refined, &status))
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_remove_knots(
+				&refined, EPSILON, &result, &status))
+
+/* ================================= Then ================================== */
+			CuAssertIntEquals(tc, 7, (int)
+				ts_bspline_num_control_points(&result));
+			CuAssertIntEquals(tc, (int) deg,
+				(int) ts_bspline_degree(&result));
+			CuAssertDblEquals(tc, 0, remove_knots_max_dist(
+				tc, &spline, &result), EPSILON);
+
+			ts_bspline_free(&spline);
+			ts_bspline_free(&refined);
+			ts_bspline_free(&result);
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&refined);
+		ts_bspline_free(&result);
+	TS_END_TRY
+}
+
+void remove_knots_beziers(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			9, 2, 3, TS_OPENED, &spline, &status))
+		fixtures_control_points(tc, &spline, 0);
+		TS_CALL(try, status.code, ts_bspline_to_beziers(
+			&spline, &beziers, &status))
+
+/* ================================= When ================================== */
+		/* In place. */
+		TS_CALL(try, status.code, ts_bspline_remove_knots(
+			&beziers, EPSILON, &beziers, &status))
+
+/* ================================= Then ================================== */
+		/* The clamped equivalent of the opened spline (6 segments). */
+		CuAssertIntEquals(tc, 6 + 3, (int)
+			ts_bspline_num_control_points(&beziers));
+		CuAssertDblEquals(tc, 0, remove_knots_max_dist(
+			tc, &spline, &beziers), EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&beziers);
+	TS_END_TRY
+}
+
+void remove_knots_cubic_natural(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal points[20] = {
+		0, 0,   1, 2,   2, 1,   3, 3,   4, -1,
+		5, 0,   6, 2,   7, 2,   8, -2,   9, 1
+	};
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_interpolate_cubic_natural(
+			points, 10, 2, &spline, &status))
+		CuAssertIntEquals(tc, 9 * 4,
+			(int) ts_bspline_num_control_points(&spline));
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_remove_knots(
+			&spline, EPSILON, &result, &status))
+
+/* ================================= Then ================================== */
+		/* The natural spline is C2 continuous. */
+		CuAssertIntEquals(tc, 9 + 3,
+			(int) ts_bspline_num_control_points(&result));
+		CuAssertDblEquals(tc, 0, remove_knots_max_dist(
+			tc, &spline, &result), EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&result);
+	TS_END_TRY
+}
+
+void remove_knots_tolerance(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal ctrlp[30 * 2];
+	const tsReal tolerance = 0.01f;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A smooth spline with dense control points on an arc. */
+		for (i = 0; i < 30; i++) {
+			ctrlp[i * 2] = (tsReal) cos(i * 0.2);
+			ctrlp[i * 2 + 1] = (tsReal) sin(i * 0.2);
+		}
+		TS_CALL(try, status.code, ts_bspline_new(
+			30, 2, 3, TS_CLAMPED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* =============================== When/Then =============================== */
+		/* No knot can be removed exactly ... */
+		TS_CALL(try, status.code, ts_bspline_remove_knots(
+			&spline, 0, &result, &status))
+		CuAssertIntEquals(tc, 30,
+			(int) ts_bspline_num_control_points(&result));
+		ts_bspline_free(&result);
+		/* ... but approximately. */
+		TS_CALL(try, status.code, ts_bspline_remove_knots(
+			&spline, tolerance, &result, &status))
+		CuAssertTrue(tc, ts_bspline_num_control_points(&result) < 30);
+		CuAssertTrue(tc, remove_knots_max_dist(
+			tc, &spline, &result) <= tolerance);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&result);
+	TS_END_TRY
+}
+
+void remove_knots_degree_zero(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline result = ts_bspline_init();
+	tsReal ctrlp[4] = { 1.f, 1.f, 2.f, 2.f };
+	tsReal doubled[5] = { 0.f, 0.25f, 0.5f, 0.5f, 1.f };
+	tsReal knots[3], expected[3] = { 0.f, 0.5f, 1.f };
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A step function with equal adjacent pieces. */
+		TS_CALL(try, status.code, ts_bspline_new(
+			4, 1, 0, TS_OPENED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* =============================== When/Then =============================== */
+		/* A multiplicity of order + 1 must be rejected ... */
+		CuAssertIntEquals(tc, TS_MULTIPLICITY, ts_bspline_set_knots(
+			&spline, doubled, NULL));
+		/* ... and the knots between equal pieces are removed. */
+		TS_CALL(try, status.code, ts_bspline_remove_knots(
+			&spline, 0, &result, &status))
+		CuAssertIntEquals(tc, 2, (int)
+			ts_bspline_num_control_points(&result));
+		CuAssertIntEquals(tc, 0, (int) ts_bspline_degree(&result));
+		for (i = 0; i < 3; i++) {
+			TS_CALL(try, status.code, ts_bspline_knot_at(
+				&result, i, &knots[i], &status))
+			CuAssertDblEquals(tc, expected[i], knots[i], EPSILON);
+		}
+		CuAssertDblEquals(tc, 0, remove_knots_max_dist(
+			tc, &spline, &result), EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&result);
+	TS_END_TRY
+}
+
+CuSuite* get_remove_knots_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, remove_knots_inserted);
+	SUITE_ADD_TEST(suite, remove_knots_beziers);
+	SUITE_ADD_TEST(suite, remove_knots_cubic_natural);
+	SUITE_ADD_TEST(suite, remove_knots_tolerance);
+	SUITE_ADD_TEST(suite, remove_knots_degree_zero);
+	return suite;
+}
@@ -1,5 +1,7 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <math.h>
 #include <tinyspline.h>
 #include "CuTest.h"
 
@@ -99,9 +101,477 @@ void save_load_load_equals_save(CuTest *tc)
 	TS_END_TRY
 }
 
+/* Returns whether the control points and knots of \p a and \p b are equal
+ * bitwise. */
+int save_load_equal(CuTest *tc, const tsBSpline *a, const tsBSpline *b)
+{
+	tsReal *avals = NULL, *bvals = NULL;
+	int equal;
+	CuAssertIntEquals(tc, (int) ts_bspline_degree(a),
+		(int) ts_bspline_degree(b));
+	CuAssertIntEquals(tc, (int) ts_bspline_dimension(a),
+		(int) ts_bspline_dimension(b));
+	CuAssertIntEquals(tc, (int) ts_bspline_num_control_points(a),
+		(int) ts_bspline_num_control_points(b));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		a, &avals, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_control_points(
+		b, &bvals, NULL));
+	equal = memcmp(avals, bvals, ts_bspline_sof_control_points(a)) == 0;
+	free(avals);
+	free(bvals);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_knots(a, &avals, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_knots(b, &bvals, NULL));
+	equal = equal && memcmp(avals, bvals, ts_bspline_sof_knots(a)) == 0;
+	free(avals);
+	free(bvals);
+	return equal;
+}
+
+void save_load_binary(CuTest *tc)
+{
+	tsBSpline save = ts_bspline_init();
+	tsBSpline load = ts_bspline_init();
+	tsBSpline map = ts_bspline_init();
+	tsBSpline copy = ts_bspline_init();
+	tsReal *ctrlp = NULL, point[3], expected[3];
+	tsReal zero[3] = { 0.f, 0.f, 0.f };
+	char *file = "save_load_test_file.bin";
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			500, 3, 3, TS_CLAMPED, &save, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&save, &ctrlp, &status))
+		for (i = 0; i < 1500; i++)
+			ctrlp[i] = (tsReal) ((i * 7919) % 1013) / 7;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&save, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_save_binary(
+			&save, file, &status))
+		TS_CALL(try, status.code, ts_bspline_load_binary(
+			file, &load, &status))
+		TS_CALL(try, status.code, ts_bspline_map_binary(
+			file, 0, &map, &status))
+
+/* ================================= Then ================================== */
+		/* Both are exact copies. */
+		CuAssertTrue(tc, save_load_equal(tc, &save, &load));
+		CuAssertTrue(tc, save_load_equal(tc, &save, &map));
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&save, 0.3f, expected, NULL, &status))
+		TS_CALL(try, status.code, ts_bspline_eval_point(
+			&map, 0.3f, point, NULL, &status))
+		CuAssertDblEquals(tc, 0, ts_distance(expected, point, 3), 0);
+
+		/* Copies of mapped splines outlive the mapping. */
+		TS_CALL(try, status.code, ts_bspline_copy(
+			&map, &copy, &status))
+		ts_bspline_free(&map);
+		CuAssertTrue(tc, save_load_equal(tc, &save, &copy));
+		ts_bspline_free(&copy);
+
+		/* Modifying mapped splines does not change the file. */
+		TS_CALL(try, status.code, ts_bspline_map_binary(
+			file, 1, &map, &status))
+		TS_CALL(try, status.code, ts_bspline_set_control_point_at(
+			&map, 0, zero, &status))
+		CuAssertTrue(tc, !save_load_equal(tc, &save, &map));
+		ts_bspline_free(&map);
+		TS_CALL(try, status.code, ts_bspline_map_binary(
+			file, 1, &map, &status))
+		CuAssertTrue(tc, save_load_equal(tc, &save, &map));
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&save);
+		ts_bspline_free(&load);
+		ts_bspline_free(&map);
+		ts_bspline_free(&copy);
+		free(ctrlp);
+		remove(file);
+	TS_END_TRY
+}
+
+/* Writes \p num little endian bytes of \p val to \p buf. */
+void save_load_put(unsigned char *buf, size_t num, unsigned long val)
+{
+	size_t i;
+	for (i = 0; i < num; i++) {
+		buf[i] = (unsigned char) (val & 0xff);
+		val >>= 8;
+	}
+}
+
+void save_load_binary_foreign(CuTest *tc)
+{
+	tsBSpline load = ts_bspline_init();
+	tsBSpline map = ts_bspline_init();
+	tsReal *ctrlp = NULL, *knots = NULL;
+	char *file = "save_load_test_file.bin";
+	unsigned char bytes[256 + 11 * sizeof(double)];
+	unsigned char *data = bytes + 256;
+	unsigned long a = 1, b = 0;
+	const unsigned int one = 1;
+	const int little = *((const unsigned char *) &one);
+	float values[11] = {
+		1.f, -2.f, 3.5f, 4.f, 0.f, 0.f,   /* control points */
+		0.f, 0.f, 0.5f, 1.f, 1.f          /* knots */
+	};
+	size_t i, j;
+	FILE *out;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* A line with float values in the foreign byte order. */
+		memset(bytes, 0, sizeof(bytes));
+		memcpy(bytes, "TSBS", 4);
+		bytes[4] = 1;
+		bytes[5] = little ? 2 : 1;
+		bytes[6] = sizeof(float);
+		save_load_put(bytes + 8, 8, 256);
+		save_load_put(bytes + 16, 8, 1);
+		save_load_put(bytes + 24, 8, 2);
+		save_load_put(bytes + 32, 8, 3);
+		save_load_put(bytes + 40, 8, 5);
+		for (i = 0; i < 11; i++) {
+			for (j = 0; j < sizeof(float); j++) {
+				data[i * sizeof(float) + j] = ((unsigned char *)
+					&values[i])[sizeof(float) - 1 - j];
+			}
+		}
+		for (i = 0; i < 11 * sizeof(float); i++) {
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		save_load_put(bytes + 48, 4, (b << 16) | a);
+		out = fopen(file, "wb");
+		CuAssertPtrNotNull(tc, out);
+		CuAssertIntEquals(tc, (int) (256 + 11 * sizeof(float)), (int)
+			fwrite(bytes, 1, 256 + 11 * sizeof(float), out));
+		fclose(out);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_load_binary(
+			file, &load, &status))
+		TS_CALL(try, status.code, ts_bspline_map_binary(
+			file, 0, &map, &status))
+
+/* ================================= Then ================================== */
+		/* Mapping falls back to conversion. */
+		CuAssertTrue(tc, save_load_equal(tc, &load, &map));
+		CuAssertIntEquals(tc, 1, (int) ts_bspline_degree(&load));
+		CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&load));
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&load, &ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_knots(
+			&load, &knots, &status))
+		for (i = 0; i < 6; i++)
+			CuAssertDblEquals(tc, values[i], ctrlp[i], 0);
+		for (i = 0; i < 5; i++)
+			CuAssertDblEquals(tc, values[6 + i], knots[i], 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&load);
+		ts_bspline_free(&map);
+		free(ctrlp);
+		free(knots);
+		remove(file);
+	TS_END_TRY
+}
+
+void save_load_binary_corrupt(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	char *file = "save_load_test_file.bin";
+	unsigned char byte;
+	FILE *io;
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		10, 2, 3, TS_CLAMPED, &spline, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_save_binary(
+		&spline, file, &status));
+	ts_bspline_free(&spline);
+	/* Flip a bit of the first control point. */
+	io = fopen(file, "r+b");
+	CuAssertPtrNotNull(tc, io);
+	fseek(io, 256, SEEK_SET);
+	byte = (unsigned char) fgetc(io);
+	fseek(io, 256, SEEK_SET);
+	fputc(byte ^ 1, io);
+	fclose(io);
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_load_binary(
+		file, &spline, &status));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, status.code);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_map_binary(
+		file, 1, &spline, &status));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, status.code);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+
+	/* Unverified mapping does not read the data. */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_map_binary(
+		file, 0, &spline, &status));
+	ts_bspline_free(&spline);
+
+	/* Truncated file. */
+	io = fopen(file, "wb");
+	CuAssertPtrNotNull(tc, io);
+	fwrite("TSBS", 1, 4, io);
+	fclose(io);
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_load_binary(
+		file, &spline, &status));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_map_binary(
+		file, 0, &spline, &status));
+	remove(file);
+
+	/* Missing file. */
+	CuAssertIntEquals(tc, TS_IO_ERROR, ts_bspline_load_binary(
+		file, &spline, &status));
+	CuAssertIntEquals(tc, TS_IO_ERROR, ts_bspline_map_binary(
+		file, 0, &spline, &status));
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+}
+
+void save_load_binary_oversized(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	char *file = "save_load_test_file.bin";
+	unsigned char bytes[256];
+	FILE *out;
+	tsStatus status;
+
+/* ================================= Given ================================= */
+	/* num(control_points) == SIZE_MAX, i.e., num(control_points) +
+	 * degree + 1 wraps around to num(knots). */
+	memset(bytes, 0, sizeof(bytes));
+	memcpy(bytes, "TSBS", 4);
+	bytes[4] = 1;
+	bytes[5] = 1;
+	bytes[6] = sizeof(double);
+	save_load_put(bytes + 8, 8, 256);
+	save_load_put(bytes + 16, 8, 10);
+	save_load_put(bytes + 24, 8, 2);
+	memset(bytes + 32, 0xff, 8);
+	save_load_put(bytes + 40, 8, 10);
+	out = fopen(file, "wb");
+	CuAssertPtrNotNull(tc, out);
+	CuAssertIntEquals(tc, 256, (int) fwrite(bytes, 1, 256, out));
+	fclose(out);
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_load_binary(
+		file, &spline, &status));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, status.code);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_map_binary(
+		file, 0, &spline, &status));
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, status.code);
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+	CuAssertIntEquals(tc, TS_PARSE_ERROR, ts_bspline_map_binary(
+		file, 1, &spline, &status));
+	CuAssertPtrEquals(tc, NULL, spline.pImpl);
+	remove(file);
+}
+
+void save_load_json_round_trip(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline parsed = ts_bspline_init();
+	tsBSpline read = ts_bspline_init();
+	tsReal *ctrlp = NULL;
+	char *json = NULL;
+	FILE *file = NULL;
+	size_t i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		TS_CALL(try, status.code, ts_bspline_new(
+			200, 3, 3, TS_OPENED, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		for (i = 0; i < 600; i++) {
+			ctrlp[i] = (tsReal) ((i * 7919) % 1013) / 3 - 100;
+			if (i % 7 == 0)
+				ctrlp[i] *= (tsReal) 1e-20;
+		}
+		ctrlp[1] = (tsReal) 0.1;
+		ctrlp[2] = (tsReal) -0.0;
+		TS_CALL(try, status.code, ts_bspline_set_control_points(
+			&spline, ctrlp, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_to_json(
+			&spline, &json, &status))
+		TS_CALL(try, status.code, ts_bspline_parse_json(
+			json, &parsed, &status))
+		file = tmpfile();
+		CuAssertPtrNotNull(tc, file);
+		TS_CALL(try, status.code, ts_bspline_write_json(
+			&spline, file, &status))
+		rewind(file);
+		TS_CALL(try, status.code, ts_bspline_read_json(
+			file, &read, &status))
+
+/* ================================= Then ================================== */
+		/* Values are restored exactly. */
+		CuAssertTrue(tc, save_load_equal(tc, &spline, &parsed));
+		CuAssertTrue(tc, save_load_equal(tc, &spline, &read));
+		/* Values are formatted with the least number of digits. */
+		CuAssertPtrNotNull(tc, strstr(json, "\n        0.1,\n"));
+		CuAssertPtrNotNull(tc, strstr(json, "\"degree\": 3,\n"));
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&parsed);
+		ts_bspline_free(&read);
+		free(ctrlp);
+		free(json);
+		if (file)
+			fclose(file);
+	TS_END_TRY
+}
+
+void save_load_json_key_order(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL, *knots = NULL;
+	tsStatus status;
+
+	const char *json =
+		"{\"knots\":[0,0,0.5,1,1],\"name\":\"a \\\"line\\\"\","
+		"\"meta\": {\"tags\": [1, [true, null], {}], \"x\": -1e3},"
+		"\t\"control_points\" : [ 1, 2, 3.5, 4,\n5e0, -6 ] ,"
+		"\"dimension\":2 , \"degree\": 1}  \n";
+
+	TS_TRY(try, status.code, &status)
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bspline_parse_json(
+			json, &spline, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 1, (int) ts_bspline_degree(&spline));
+		CuAssertIntEquals(tc, 2, (int) ts_bspline_dimension(&spline));
+		CuAssertIntEquals(tc, 3,
+			(int) ts_bspline_num_control_points(&spline));
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		TS_CALL(try, status.code, ts_bspline_knots(
+			&spline, &knots, &status))
+		CuAssertDblEquals(tc, 1.f, ctrlp[0], 0);
+		CuAssertDblEquals(tc, 3.5f, ctrlp[2], 0);
+		CuAssertDblEquals(tc, -6.f, ctrlp[5], 0);
+		CuAssertDblEquals(tc, 0.f, knots[1], 0);
+		CuAssertDblEquals(tc, 0.5f, knots[2], 0);
+		CuAssertDblEquals(tc, 1.f, knots[4], 0);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(ctrlp);
+		free(knots);
+	TS_END_TRY
+}
+
+void save_load_json_invalid(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal ctrlp[3];
+	char *json = NULL;
+	size_t i;
+	tsStatus status;
+
+	const char *inputs[16] = {
+		"",
+		"[]",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1]",
+		"{\"dimension\": 2, \"control_points\": [0, 0, 1, 1],"
+			" \"knots\": [0, 0, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": 5,"
+			" \"knots\": [0, 0, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" \"1\", 1], \"knots\": [0, 0, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1]} x",
+		"{\"degree\": 1, \"dimension\": 3, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1]}",
+		"{\"degree\": 2, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 1, 0.5, 1]}",
+		"{\"degree\": 1e300, \"dimension\": 2, \"control_points\": [0,"
+			" 0, 1, 1], \"knots\": [0, 0, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1], \"x\": tru}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1], \"x\": nulx}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1e999], \"knots\": [0, 0, 1, 1]}",
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+			" 1, 1], \"knots\": [0, 0, 1, 1], \"x\": [1, -1e999]}"
+	};
+	const tsError expected[16] = {
+		TS_PARSE_ERROR, TS_PARSE_ERROR, TS_PARSE_ERROR, TS_PARSE_ERROR,
+		TS_PARSE_ERROR, TS_PARSE_ERROR, TS_PARSE_ERROR, TS_PARSE_ERROR,
+		TS_NUM_KNOTS, TS_DEG_GE_NCTRLP, TS_KNOTS_DECR, TS_NUM_KNOTS,
+		TS_PARSE_ERROR, TS_PARSE_ERROR, TS_PARSE_ERROR, TS_PARSE_ERROR
+	};
+
+/* =============================== When/Then =============================== */
+	for (i = 0; i < 16; i++) {
+		CuAssertIntEquals(tc, expected[i], ts_bspline_parse_json(
+			inputs[i], &spline, &status));
+		CuAssertIntEquals(tc, expected[i], status.code);
+		CuAssertPtrEquals(tc, NULL, spline.pImpl);
+	}
+
+	/* Literals of unknown keys are skipped. */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_parse_json(
+		"{\"degree\": 1, \"dimension\": 2, \"control_points\": [0, 0,"
+		" 1, 1], \"knots\": [0, 0, 1, 1], \"x\": [true, false, null]}",
+		&spline, &status));
+	ts_bspline_free(&spline);
+
+	/* JSON does not support infinity. */
+	ctrlp[0] = ctrlp[2] = 0.f;
+	ctrlp[1] = (tsReal) HUGE_VAL;
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_new(
+		3, 1, 1, TS_CLAMPED, &spline, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bspline_set_control_points(
+		&spline, ctrlp, &status));
+	CuAssertIntEquals(tc, TS_IO_ERROR, ts_bspline_to_json(
+		&spline, &json, &status));
+	CuAssertIntEquals(tc, TS_IO_ERROR, status.code);
+	CuAssertPtrEquals(tc, NULL, json);
+	ts_bspline_free(&spline);
+}
+
 CuSuite* get_save_load_suite()
 {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, save_load_load_equals_save);
+	SUITE_ADD_TEST(suite, save_load_binary);
+	SUITE_ADD_TEST(suite, save_load_binary_foreign);
+	SUITE_ADD_TEST(suite, save_load_binary_corrupt);
+	SUITE_ADD_TEST(suite, save_load_binary_oversized);
+	SUITE_ADD_TEST(suite, save_load_json_round_trip);
+	SUITE_ADD_TEST(suite, save_load_json_key_order);
+	SUITE_ADD_TEST(suite, save_load_json_invalid);
 	return suite;
 }
\ No newline at end of file
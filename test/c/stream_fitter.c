@@ -0,0 +1,209 @@
+#include <stdlib.h>
+#include <string.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+void stream_fitter_points(tsReal *points, size_t num)
+{
+	size_t i;
+	for (i = 0; i < num; i++) {
+		points[i * 2] = (tsReal) i / 10;
+		points[i * 2 + 1] = (tsReal) ((i * 7919) % 23) / 5 - 2.f;
+	}
+}
+
+/* Pushes \p points in chunks of \p chunk points, finishes \p fitter, and
+ * compares the resultant segments with the control points of
+ * ts_bspline_interpolate_cubic_natural. */
+void assert_stream_equals_natural(CuTest *tc, tsStreamFitter *fitter,
+	const tsReal *points, size_t num, size_t chunk)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsReal *ctrlp = NULL, *all = NULL, *segments = NULL;
+	size_t pushed, n, num_segments, total = 0, i;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		TS_CALL(try, status.code, ts_bspline_interpolate_cubic_natural(
+			points, num, 2, &spline, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&spline, &ctrlp, &status))
+		all = (tsReal *) malloc(
+			ts_bspline_len_control_points(&spline) *
+			sizeof(tsReal));
+		CuAssertPtrNotNull(tc, all);
+
+		for (pushed = 0; pushed < num; pushed += n) {
+			n = num - pushed < chunk ? num - pushed : chunk;
+			TS_CALL(try, status.code, ts_streamfitter_push(
+				fitter, points + pushed * 2, n, &segments,
+				&num_segments, &status))
+			CuAssertTrue(tc, (total + num_segments) * 4 <=
+				ts_bspline_num_control_points(&spline));
+			if (num_segments > 0) {
+				memcpy(all + total * 8, segments,
+					num_segments * 8 * sizeof(tsReal));
+			}
+			total += num_segments;
+			free(segments);
+			segments = NULL;
+		}
+		CuAssertIntEquals(tc, (int) num,
+			(int) ts_streamfitter_num_points(fitter));
+		TS_CALL(try, status.code, ts_streamfitter_finish(
+			fitter, &segments, &num_segments, &status))
+		CuAssertIntEquals(tc, 0,
+			(int) ts_streamfitter_num_points(fitter));
+		memcpy(all + total * 8, segments,
+			num_segments * 8 * sizeof(tsReal));
+		total += num_segments;
+
+		CuAssertIntEquals(tc,
+			(int) ts_bspline_num_control_points(&spline),
+			(int) total * 4);
+		for (i = 0; i < total * 8; i++)
+			CuAssertDblEquals(tc, ctrlp[i], all[i], EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		free(ctrlp);
+		free(all);
+		free(segments);
+	TS_END_TRY
+}
+
+void stream_fitter_equals_natural(CuTest *tc)
+{
+	tsStreamFitter fitter = ts_streamfitter_init();
+	tsReal points[2 * 500];
+	size_t chunks[5] = { 1, 3, 20, 41, 500 };
+	size_t i;
+
+/* ================================= Given ================================= */
+	stream_fitter_points(points, 500);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_new(
+		2, 20, &fitter, NULL));
+	CuAssertIntEquals(tc, 2, (int) ts_streamfitter_dimension(&fitter));
+
+/* ============================= When/Then ================================= */
+	/* The fitter is reused after finishing. */
+	for (i = 0; i < 5; i++)
+		assert_stream_equals_natural(tc, &fitter, points, 500,
+			chunks[i]);
+
+	ts_streamfitter_free(&fitter);
+}
+
+void stream_fitter_few_points(CuTest *tc)
+{
+	tsStreamFitter fitter = ts_streamfitter_init();
+	tsReal points[2 * 4];
+	size_t num;
+
+/* ================================= Given ================================= */
+	stream_fitter_points(points, 4);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_new(
+		2, 0, &fitter, NULL));
+
+/* ============================= When/Then ================================= */
+	for (num = 1; num <= 4; num++)
+		assert_stream_equals_natural(tc, &fitter, points, num, 1);
+
+	ts_streamfitter_free(&fitter);
+}
+
+void stream_fitter_bounded_window(CuTest *tc)
+{
+	tsStreamFitter fitter = ts_streamfitter_init();
+	tsReal points[2 * 100];
+	tsReal *segments = NULL;
+	size_t num_segments, total = 0, i;
+
+/* ================================= Given ================================= */
+	stream_fitter_points(points, 100);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_new(
+		2, 5, &fitter, NULL));
+
+	for (i = 0; i < 100; i++) {
+/* ================================= When ================================== */
+		CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_push(
+			&fitter, points + i * 2, 1, &segments, &num_segments,
+			NULL));
+
+/* ================================= Then ================================== */
+		/* Segments are finalized in chunks of 'lookahead' segments as
+		 * soon as 'lookahead' points follow them. */
+		CuAssertTrue(tc, num_segments == 0 || num_segments == 5);
+		CuAssertTrue(tc, num_segments > 0 || segments == NULL);
+		total += num_segments;
+		CuAssertTrue(tc, total == 0 || total + 1 + 5 <= i + 1);
+		CuAssertTrue(tc, total + 2 * 5 + 1 > i + 1);
+		free(segments);
+		segments = NULL;
+	}
+
+	ts_streamfitter_free(&fitter);
+}
+
+void stream_fitter_copy(CuTest *tc)
+{
+	tsStreamFitter fitter = ts_streamfitter_init();
+	tsStreamFitter copy = ts_streamfitter_init();
+	tsReal points[2 * 30];
+	tsReal *expected = NULL, *segments = NULL;
+	size_t num_expected, num_segments, i;
+
+/* ================================= Given ================================= */
+	stream_fitter_points(points, 30);
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_new(
+		2, 4, &fitter, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_push(
+		&fitter, points, 17, &segments, &num_segments, NULL));
+	free(segments);
+
+/* ================================= When ================================== */
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_copy(
+		&fitter, &copy, NULL));
+
+/* ================================= Then ================================== */
+	CuAssertTrue(tc, fitter.pImpl != copy.pImpl);
+	CuAssertIntEquals(tc, 17, (int) ts_streamfitter_num_points(&copy));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_finish(
+		&fitter, &expected, &num_expected, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_streamfitter_finish(
+		&copy, &segments, &num_segments, NULL));
+	CuAssertIntEquals(tc, (int) num_expected, (int) num_segments);
+	for (i = 0; i < num_segments * 8; i++)
+		CuAssertDblEquals(tc, expected[i], segments[i], 0);
+
+	ts_streamfitter_free(&fitter);
+	ts_streamfitter_free(&copy);
+	free(expected);
+	free(segments);
+}
+
+void stream_fitter_dim_zero(CuTest *tc)
+{
+	tsStreamFitter fitter = ts_streamfitter_init();
+	tsStatus status;
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_streamfitter_new(
+		0, 20, &fitter, &status));
+	CuAssertIntEquals(tc, TS_DIM_ZERO, status.code);
+	CuAssertPtrEquals(tc, NULL, fitter.pImpl);
+}
+
+CuSuite* get_stream_fitter_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, stream_fitter_equals_natural);
+	SUITE_ADD_TEST(suite, stream_fitter_few_points);
+	SUITE_ADD_TEST(suite, stream_fitter_bounded_window);
+	SUITE_ADD_TEST(suite, stream_fitter_copy);
+	SUITE_ADD_TEST(suite, stream_fitter_dim_zero);
+	return suite;
+}
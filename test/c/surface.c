@@ -0,0 +1,320 @@
+#include <stdlib.h>
+#include <math.h>
+#include <tinyspline.h>
+#include "CuTest.h"
+
+#define EPSILON 0.0001
+
+/* Creates a surface with a deterministic, wavy control net. */
+void surface_setup(CuTest *tc, tsBSplineSurface *surface, size_t num_u,
+	size_t num_v, size_t deg_u, size_t deg_v, tsBSplineType type)
+{
+	tsReal *ctrlp = NULL;
+	size_t i, j, idx;
+
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bsplinesurface_new(num_u, num_v,
+		3, deg_u, deg_v, type, surface, NULL));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bsplinesurface_control_points(
+		surface, &ctrlp, NULL));
+	for (i = 0; i < num_u; i++) {
+		for (j = 0; j < num_v; j++) {
+			idx = (i * num_v + j) * 3;
+			ctrlp[idx] = (tsReal) i;
+			ctrlp[idx + 1] = (tsReal) j;
+			ctrlp[idx + 2] = (tsReal) (((i + 3 * j) * 7919) % 11)
+				/ 4 - 1;
+		}
+	}
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bsplinesurface_set_control_points(
+		surface, ctrlp, NULL));
+	free(ctrlp);
+}
+
+void surface_eval_equals_curves(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsBSpline column = ts_bspline_init();
+	tsBSpline iso = ts_bspline_init();
+	tsReal *net = NULL, *ctrlp = NULL, us[9], vs[7], points[9 * 7 * 3];
+	tsReal expected[3];
+	size_t i, j, c;
+	tsStatus status;
+
+	const size_t num_u = 6, num_v = 5;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		surface_setup(tc, &surface, num_u, num_v, 3, 2, TS_CLAMPED);
+		for (i = 0; i < 9; i++)
+			us[i] = (tsReal) ((i * 5) % 9) / 8;
+		for (j = 0; j < 7; j++)
+			vs[j] = (tsReal) j / 6;
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinesurface_eval_grid(
+			&surface, us, 9, vs, 7, NULL, points, NULL, &status))
+
+/* ================================= Then ================================== */
+		/* The iso-curve at u is a spline in v direction whose control
+		 * points are the columns of the control net evaluated at u. */
+		TS_CALL(try, status.code, ts_bsplinesurface_control_points(
+			&surface, &net, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			num_u, 3, 3, TS_CLAMPED, &column, &status))
+		TS_CALL(try, status.code, ts_bspline_new(
+			num_v, 3, 2, TS_CLAMPED, &iso, &status))
+		TS_CALL(try, status.code, ts_bspline_control_points(
+			&column, &ctrlp, &status))
+		for (i = 0; i < 9; i++) {
+			for (j = 0; j < num_v; j++) {
+				for (c = 0; c < num_u; c++) {
+					ctrlp[c * 3] = net[(c * num_v + j) * 3];
+					ctrlp[c * 3 + 1] =
+						net[(c * num_v + j) * 3 + 1];
+					ctrlp[c * 3 + 2] =
+						net[(c * num_v + j) * 3 + 2];
+				}
+				TS_CALL(try, status.code,
+					ts_bspline_set_control_points(
+					&column, ctrlp, &status))
+				TS_CALL(try, status.code,
+					ts_bspline_eval_point(&column, us[i],
+					expected, NULL, &status))
+				TS_CALL(try, status.code,
+					ts_bspline_set_control_point_at(
+					&iso, j, expected, &status))
+			}
+			for (j = 0; j < 7; j++) {
+				TS_CALL(try, status.code,
+					ts_bspline_eval_point(&iso, vs[j],
+					expected, NULL, &status))
+				CuAssertDblEquals(tc, 0, ts_distance(expected,
+					points + (i * 7 + j) * 3, 3), EPSILON);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bsplinesurface_free(&surface);
+		ts_bspline_free(&column);
+		ts_bspline_free(&iso);
+		free(net);
+		free(ctrlp);
+	TS_END_TRY
+}
+
+void surface_normals(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsReal point[3], normal[3], pu[2 * 3], pv[2 * 3], su[3], sv[3], n[3];
+	tsReal u, v, len;
+	size_t i, j, d;
+	tsStatus status;
+
+	const tsReal h = 0.0005f;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		surface_setup(tc, &surface, 7, 6, 3, 3, TS_OPENED);
+
+		for (i = 1; i < 8; i++) {
+			for (j = 1; j < 8; j++) {
+				/* Stay away from the knots. */
+				u = 0.33f + (tsReal) i / 24 + 0.003f;
+				v = 0.33f + (tsReal) j / 24 + 0.003f;
+
+/* ================================= When ================================== */
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface, u, v,
+					point, normal, &status))
+
+/* ================================= Then ================================== */
+				/* Compare with central differences. */
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface, u - h,
+					v, pu, NULL, &status))
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface, u + h,
+					v, pu + 3, NULL, &status))
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface, u,
+					v - h, pv, NULL, &status))
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface, u,
+					v + h, pv + 3, NULL, &status))
+				for (d = 0; d < 3; d++) {
+					su[d] = pu[3 + d] - pu[d];
+					sv[d] = pv[3 + d] - pv[d];
+				}
+				n[0] = su[1] * sv[2] - su[2] * sv[1];
+				n[1] = su[2] * sv[0] - su[0] * sv[2];
+				n[2] = su[0] * sv[1] - su[1] * sv[0];
+				len = (tsReal) sqrt(n[0] * n[0] + n[1] * n[1] +
+					n[2] * n[2]);
+				for (d = 0; d < 3; d++)
+					n[d] /= len;
+				CuAssertDblEquals(tc, 0, ts_distance(
+					n, normal, 3), 0.001f);
+			}
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bsplinesurface_free(&surface);
+	TS_END_TRY
+}
+
+void surface_grid_equals_eval(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsReal us[40], vs[3], *points = NULL, *normals = NULL;
+	tsReal point[3], normal[3], min_u, max_u, min_v, max_v;
+	size_t i, j;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		/* Discontinuities at the knots of the Beziers. More knots
+		 * than rows of a single task. */
+		surface_setup(tc, &surface, 9, 4, 2, 3, TS_BEZIERS);
+		ts_bsplinesurface_domain(&surface, &min_u, &max_u, &min_v,
+			&max_v);
+		for (i = 0; i < 40; i++)
+			us[i] = min_u + (max_u - min_u) * i / 39;
+		for (j = 0; j < 3; j++)
+			vs[j] = min_v + (max_v - min_v) * j / 2;
+		points = (tsReal *) malloc(40 * 3 * 3 * sizeof(tsReal));
+		normals = (tsReal *) malloc(40 * 3 * 3 * sizeof(tsReal));
+		CuAssertPtrNotNull(tc, points);
+		CuAssertPtrNotNull(tc, normals);
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinesurface_eval_grid(
+			&surface, us, 40, vs, 3, NULL, points, normals,
+			&status))
+
+/* ================================= Then ================================== */
+		for (i = 0; i < 40; i++) {
+			for (j = 0; j < 3; j++) {
+				TS_CALL(try, status.code,
+					ts_bsplinesurface_eval(&surface, us[i],
+					vs[j], point, normal, &status))
+				CuAssertDblEquals(tc, 0, ts_distance(point,
+					points + (i * 3 + j) * 3, 3), 0);
+				CuAssertDblEquals(tc, 0, ts_distance(normal,
+					normals + (i * 3 + j) * 3, 3), 0);
+			}
+		}
+		/* The corners of clamped surfaces are control points. */
+		CuAssertDblEquals(tc, 0.f, points[0], EPSILON);
+		CuAssertDblEquals(tc, 0.f, points[1], EPSILON);
+		CuAssertDblEquals(tc, 8.f, points[(39 * 3 + 2) * 3], EPSILON);
+		CuAssertDblEquals(tc, 3.f, points[(39 * 3 + 2) * 3 + 1],
+			EPSILON);
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bsplinesurface_free(&surface);
+		free(points);
+		free(normals);
+	TS_END_TRY
+}
+
+void surface_copy_knots(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsBSplineSurface copy = ts_bsplinesurface_init();
+	tsReal *knots = NULL, expected[3], point[3];
+	tsReal min_u, max_u, min_v, max_v;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+/* ================================= Given ================================= */
+		surface_setup(tc, &surface, 5, 4, 2, 1, TS_CLAMPED);
+		TS_CALL(try, status.code, ts_bsplinesurface_eval(
+			&surface, 0.3f, 0.6f, expected, NULL, &status))
+
+/* ================================= When ================================== */
+		TS_CALL(try, status.code, ts_bsplinesurface_copy(
+			&surface, &copy, &status))
+		ts_bsplinesurface_free(&surface);
+		TS_CALL(try, status.code, ts_bsplinesurface_knots_v(
+			&copy, &knots, &status))
+		knots[0] = knots[1] = -1.f;
+		TS_CALL(try, status.code, ts_bsplinesurface_set_knots_v(
+			&copy, knots, &status))
+
+/* ================================= Then ================================== */
+		CuAssertIntEquals(tc, 5,
+			(int) ts_bsplinesurface_num_control_points_u(&copy));
+		CuAssertIntEquals(tc, 4,
+			(int) ts_bsplinesurface_num_control_points_v(&copy));
+		CuAssertIntEquals(tc, 8,
+			(int) ts_bsplinesurface_num_knots_u(&copy));
+		CuAssertIntEquals(tc, 6,
+			(int) ts_bsplinesurface_num_knots_v(&copy));
+		CuAssertIntEquals(tc, 5 * 4 * 3,
+			(int) ts_bsplinesurface_len_control_points(&copy));
+		ts_bsplinesurface_domain(&copy, &min_u, &max_u, &min_v,
+			&max_v);
+		CuAssertDblEquals(tc, 0.f, min_u, EPSILON);
+		CuAssertDblEquals(tc, 1.f, max_u, EPSILON);
+		CuAssertDblEquals(tc, -1.f, min_v, EPSILON);
+		CuAssertDblEquals(tc, 1.f, max_v, EPSILON);
+		/* The knots in u direction are unchanged. */
+		TS_CALL(try, status.code, ts_bsplinesurface_eval(
+			&copy, 0.3f, 0.6f, point, NULL, &status))
+		CuAssertDblEquals(tc, expected[0], point[0], EPSILON);
+
+		/* Decreasing knot vectors are rejected. */
+		knots[0] = 2.f;
+		CuAssertIntEquals(tc, TS_KNOTS_DECR,
+			ts_bsplinesurface_set_knots_v(&copy, knots, NULL));
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bsplinesurface_free(&surface);
+		ts_bsplinesurface_free(&copy);
+		free(knots);
+	TS_END_TRY
+}
+
+void surface_errors(CuTest *tc)
+{
+	tsBSplineSurface surface = ts_bsplinesurface_init();
+	tsReal point[3], normal[3];
+	tsStatus status;
+
+/* =============================== When/Then =============================== */
+	CuAssertIntEquals(tc, TS_DEG_GE_NCTRLP, ts_bsplinesurface_new(
+		4, 3, 3, 2, 3, TS_CLAMPED, &surface, &status));
+	CuAssertPtrEquals(tc, NULL, surface.pImpl);
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bsplinesurface_new(
+		4, 3, 0, 2, 1, TS_CLAMPED, &surface, &status));
+
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bsplinesurface_new(
+		4, 3, 2, 2, 1, TS_CLAMPED, &surface, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bsplinesurface_eval(
+		&surface, 0.5f, 1.5f, point, NULL, &status));
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, status.code);
+	CuAssertIntEquals(tc, TS_U_UNDEFINED, ts_bsplinesurface_eval(
+		&surface, -0.5f, 0.5f, point, NULL, &status));
+	/* Normals require dimension 3. */
+	CuAssertIntEquals(tc, TS_DIM_ZERO, ts_bsplinesurface_eval(
+		&surface, 0.5f, 0.5f, point, normal, &status));
+	CuAssertIntEquals(tc, TS_SUCCESS, ts_bsplinesurface_eval(
+		&surface, 0.5f, 0.5f, point, NULL, &status));
+
+	ts_bsplinesurface_free(&surface);
+}
+
+CuSuite* get_surface_suite()
+{
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, surface_eval_equals_curves);
+	SUITE_ADD_TEST(suite, surface_normals);
+	SUITE_ADD_TEST(suite, surface_grid_equals_eval);
+	SUITE_ADD_TEST(suite, surface_copy_knots);
+	SUITE_ADD_TEST(suite, surface_errors);
+	return suite;
+}
@@ -6,14 +6,32 @@ CuSuite* get_free_suite();
 CuSuite* get_new_suite();
 CuSuite* get_move_suite();
 CuSuite* get_eval_suite();
+CuSuite* get_eval_batch_suite();
+CuSuite* get_eval_derivatives_suite();
+CuSuite* get_eval_parallel_suite();
+CuSuite* get_eval_plan_suite();
+CuSuite* get_collection_suite();
+CuSuite* get_rational_suite();
+CuSuite* get_surface_suite();
+CuSuite* get_loft_suite();
+CuSuite* get_basis_matrix_suite();
 CuSuite* get_set_knots_suite();
 CuSuite* get_insert_knot_suite();
+CuSuite* get_remove_knots_suite();
 CuSuite* get_sample_suite();
 CuSuite* get_to_beziers_suite();
+CuSuite* get_degree_suite();
 CuSuite* get_interpolation_suite();
+CuSuite* get_approximation_suite();
+CuSuite* get_stream_fitter_suite();
+CuSuite* get_arc_length_suite();
+CuSuite* get_flatten_suite();
+CuSuite* get_projection_suite();
+CuSuite* get_intersection_suite();
 CuSuite* get_derive_suite();
 CuSuite* get_bisect_suite();
 CuSuite* get_save_load_suite();
+CuSuite* get_allocator_suite();
 
 int main()
 {
@@ -25,14 +43,32 @@ int main()
 	CuSuiteAddSuite(suite, get_new_suite());
 	CuSuiteAddSuite(suite, get_move_suite());
 	CuSuiteAddSuite(suite, get_eval_suite());
+	CuSuiteAddSuite(suite, get_eval_batch_suite());
+	CuSuiteAddSuite(suite, get_eval_derivatives_suite());
+	CuSuiteAddSuite(suite, get_eval_parallel_suite());
+	CuSuiteAddSuite(suite, get_eval_plan_suite());
+	CuSuiteAddSuite(suite, get_collection_suite());
+	CuSuiteAddSuite(suite, get_rational_suite());
+	CuSuiteAddSuite(suite, get_surface_suite());
+	CuSuiteAddSuite(suite, get_loft_suite());
+	CuSuiteAddSuite(suite, get_basis_matrix_suite());
 	CuSuiteAddSuite(suite, get_set_knots_suite());
 	CuSuiteAddSuite(suite, get_insert_knot_suite());
+	CuSuiteAddSuite(suite, get_remove_knots_suite());
 	CuSuiteAddSuite(suite, get_sample_suite());
 	CuSuiteAddSuite(suite, get_to_beziers_suite());
+	CuSuiteAddSuite(suite, get_degree_suite());
 	CuSuiteAddSuite(suite, get_interpolation_suite());
+	CuSuiteAddSuite(suite, get_approximation_suite());
+	CuSuiteAddSuite(suite, get_stream_fitter_suite());
+	CuSuiteAddSuite(suite, get_arc_length_suite());
+	CuSuiteAddSuite(suite, get_flatten_suite());
+	CuSuiteAddSuite(suite, get_projection_suite());
+	CuSuiteAddSuite(suite, get_intersection_suite());
 	CuSuiteAddSuite(suite, get_derive_suite());
 	CuSuiteAddSuite(suite, get_bisect_suite());
 	CuSuiteAddSuite(suite, get_save_load_suite());
+	CuSuiteAddSuite(suite, get_allocator_suite());
 
 	CuSuiteRun(suite);
 	CuSuiteSummary(suite, output);
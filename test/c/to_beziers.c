@@ -300,11 +300,83 @@ void to_beziers_opened(CuTest *tc)
 	TS_END_TRY
 }
 
+void to_beziers_multiple_knots(CuTest *tc)
+{
+	tsBSpline spline = ts_bspline_init();
+	tsBSpline beziers = ts_bspline_init();
+	tsReal *knots = NULL, *expected = NULL, *actual = NULL;
+	tsReal us[101];
+	size_t i, deg;
+	tsStatus status;
+
+	TS_TRY(try, status.code, &status)
+		for (deg = 1; deg <= 5; deg++) {
+/* ================================= Given ================================= */
+			/* An opened spline with an interior knot of
+			 * multiplicity 2. */
+			TS_CALL(try, status.code, ts_bspline_new(
+				12, 2, deg, TS_OPENED, &spline, &status))
+			TS_CALL(try, status.code, ts_bspline_control_points(
+				&spline, &knots, &status))
+			for (i = 0; i < 24; i++)
+				knots[i] = (tsReal) ((i * 37) % 11);
+			TS_CALL(try, status.code, ts_bspline_set_control_points(
+				&spline, knots, &status))
+			free(knots);
+			knots = NULL;
+			TS_CALL(try, status.code, ts_bspline_knots(
+				&spline, &knots, &status))
+			knots[7] = knots[6];
+			TS_CALL(try, status.code, ts_bspline_set_knots(
+				&spline, knots, &status))
+			for (i = 0; i <= 100; i++) {
+				us[i] = knots[deg] + (knots[12] - knots[deg]) *
+					i / 100;
+			}
+			us[100] = knots[12];
+			free(knots);
+			knots = NULL;
+
+/* ================================= When ================================== */
+			TS_CALL(try, status.code, ts_bspline_to_beziers(
+				&spline, &beziers, &status))
+
+/* ================================= Then ================================== */
+			/* One segment per span that is not empty. */
+			CuAssertIntEquals(tc, (int) ((11 - deg) * (deg + 1)),
+				(int) ts_bspline_num_control_points(&beziers));
+			TS_CALL(try, status.code, ts_bspline_eval_all(
+				&spline, us, 101, &expected, &status))
+			TS_CALL(try, status.code, ts_bspline_eval_all(
+				&beziers, us, 101, &actual, &status))
+			for (i = 0; i <= 100; i++) {
+				CuAssertDblEquals(tc, 0, ts_distance(
+					expected + i * 2, actual + i * 2, 2),
+					CTRLP_EPSILON);
+			}
+			ts_bspline_free(&spline);
+			ts_bspline_free(&beziers);
+			free(expected);
+			free(actual);
+			expected = actual = NULL;
+		}
+	TS_CATCH(status.code)
+		CuFail(tc, status.message);
+	TS_FINALLY
+		ts_bspline_free(&spline);
+		ts_bspline_free(&beziers);
+		free(knots);
+		free(expected);
+		free(actual);
+	TS_END_TRY
+}
+
 CuSuite* get_to_beziers_suite()
 {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, to_beziers_issue143);
 	SUITE_ADD_TEST(suite, to_beziers_clamped);
 	SUITE_ADD_TEST(suite, to_beziers_opened);
+	SUITE_ADD_TEST(suite, to_beziers_multiple_knots);
 	return suite;
 }